@@ -0,0 +1,14 @@
+#!/bin/bash
+
+#############################################################################
+# Engine benchmark. Any arguments are passed to benchmark_engine, see
+# "./benchmark.sh --help".
+#############################################################################
+
+pushd .
+cd engine/benchmark
+DYLD_FALLBACK_LIBRARY_PATH=$DYLD_FALLBACK_LIBRARY_PATH:../src \
+	LD_LIBRARY_PATH=$LD_LIBRARY_PATH:../src ./benchmark_engine "$@"
+RESULT=$?
+popd
+exit $RESULT
@@ -0,0 +1,116 @@
+/*
+  Q Light Controller - Engine benchmark
+  allocationcounter.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QAtomicInt>
+#include <stdlib.h>
+#include <new>
+
+#include "allocationcounter.h"
+
+/* A plain POD atomic, so that it is usable before any constructors run */
+static QBasicAtomicInt s_allocations = Q_BASIC_ATOMIC_INITIALIZER(0);
+static QBasicAtomicInt s_bytes = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static inline void countAllocation(size_t size)
+{
+    s_allocations.fetchAndAddRelaxed(1);
+    s_bytes.fetchAndAddRelaxed(int(size));
+}
+
+quint32 AllocationCounter::count()
+{
+    return quint32(int(s_allocations));
+}
+
+quint32 AllocationCounter::bytes()
+{
+    return quint32(int(s_bytes));
+}
+
+#if defined(__GLIBC__)
+
+/*****************************************************************************
+ * glibc: interpose the malloc family. libstdc++'s operator new ends up here.
+ *****************************************************************************/
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t nmemb, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+extern "C" void* malloc(size_t size) throw()
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t nmemb, size_t size) throw()
+{
+    countAllocation(nmemb * size);
+    return __libc_calloc(nmemb, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) throw()
+{
+    countAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+
+bool AllocationCounter::countsMalloc()
+{
+    return true;
+}
+
+#else
+
+/*****************************************************************************
+ * Others: replace global operator new
+ *****************************************************************************/
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+    countAllocation(size);
+    void* ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == NULL)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) throw()
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+    free(ptr);
+}
+
+bool AllocationCounter::countsMalloc()
+{
+    return false;
+}
+
+#endif
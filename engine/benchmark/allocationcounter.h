@@ -0,0 +1,53 @@
+/*
+  Q Light Controller - Engine benchmark
+  allocationcounter.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/**
+ * AllocationCounter counts heap allocations made by all threads of the
+ * process. With glibc, malloc(), calloc() and realloc() are interposed, so
+ * allocations made by Qt containers are counted too. Elsewhere only C++
+ * operator new is replaced and Qt's own qMalloc() calls go uncounted.
+ */
+class AllocationCounter
+{
+public:
+    /**
+     * Get the number of allocations made so far. The counter wraps around,
+     * so only differences between two counts are meaningful.
+     */
+    static quint32 count();
+
+    /**
+     * Get the number of bytes requested by the allocations made so far. The
+     * counter wraps around, so only differences between two counts are
+     * meaningful.
+     */
+    static quint32 bytes();
+
+    /** Check, whether plain malloc() family calls are counted as well */
+    static bool countsMalloc();
+};
+
+#endif
@@ -0,0 +1,28 @@
+include(../../variables.pri)
+
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = benchmark_engine
+
+CONFIG  += console
+CONFIG  -= app_bundle
+QT      += core xml
+QT      -= gui
+QTPLUGIN =
+
+INCLUDEPATH += ../src
+DEPENDPATH  += ../src
+INCLUDEPATH += ../../plugins/interfaces
+QMAKE_LIBDIR += ../src
+LIBS   += -lqlcengine
+
+HEADERS += allocationcounter.h \
+           benchmarktimer.h \
+           enginebenchmark.h \
+           showgenerator.h
+
+SOURCES += allocationcounter.cpp \
+           benchmarktimer.cpp \
+           enginebenchmark.cpp \
+           showgenerator.cpp \
+           main.cpp
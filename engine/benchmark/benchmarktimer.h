@@ -0,0 +1,50 @@
+/*
+  Q Light Controller - Engine benchmark
+  benchmarktimer.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef BENCHMARKTIMER_H
+#define BENCHMARKTIMER_H
+
+#include "mastertimer.h"
+
+class OutputMap;
+
+/**
+ * A MasterTimer that can also be ticked directly from the calling thread,
+ * without sleeping between ticks, for measuring the cost of a tick.
+ */
+class BenchmarkTimer : public MasterTimer
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(BenchmarkTimer)
+
+public:
+    BenchmarkTimer(QObject* parent, OutputMap* outputMap);
+    ~BenchmarkTimer();
+
+    /** Run one timer tick in the calling thread. The timer must not be
+        running in its own thread at the same time. */
+    void tick();
+
+    /** Sleep in the calling thread; QThread::msleep() is not public */
+    static void pause(unsigned long msecs);
+};
+
+#endif
@@ -0,0 +1,306 @@
+/*
+  Q Light Controller - Engine benchmark
+  enginebenchmark.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtCore>
+
+#include "allocationcounter.h"
+#include "enginebenchmark.h"
+#include "benchmarktimer.h"
+#include "showgenerator.h"
+
+#include "outputmap.h"
+#include "function.h"
+#include "doc.h"
+
+#include "qlctypes.h"
+
+#define KStubPluginName "Output Plugin Stub"
+
+/*****************************************************************************
+ * Initialization
+ *****************************************************************************/
+
+EngineBenchmark::EngineBenchmark(QObject* parent)
+    : QObject(parent)
+    , m_doc(NULL)
+    , m_outputMap(NULL)
+    , m_timer(NULL)
+    , m_generator(NULL)
+{
+    m_doc = new Doc(this, m_fixtureDefCache);
+    m_outputMap = new OutputMap(this, m_doc->universes());
+    m_timer = new BenchmarkTimer(this, m_outputMap);
+    m_generator = new ShowGenerator(m_doc);
+
+    /* Generated fixtures grow the workspace; output follows */
+    connect(m_doc, SIGNAL(universesChanged(quint32)),
+            m_outputMap, SLOT(setUniverses(quint32)));
+}
+
+EngineBenchmark::~EngineBenchmark()
+{
+    /* Functions have been stopped already, so the timer stops at once */
+    delete m_timer;
+    m_timer = NULL;
+
+    delete m_outputMap;
+    m_outputMap = NULL;
+
+    delete m_doc;
+    m_doc = NULL;
+
+    /* Owns the fixture definition, so it must go after Doc */
+    delete m_generator;
+    m_generator = NULL;
+}
+
+bool EngineBenchmark::init(const QDir& pluginDir, int fixtures, int scenes,
+                           int chasers, int efxs)
+{
+    m_outputMap->loadPlugins(pluginDir);
+    if (m_outputMap->pluginNames().contains(KStubPluginName) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Output plugin stub not found in"
+                   << pluginDir.absolutePath();
+        return false;
+    }
+
+    m_generator->generate(fixtures, scenes, chasers, efxs);
+
+    /* Route every universe to the stub's outputs */
+    int outputs = m_outputMap->pluginOutputs(KStubPluginName).size();
+    for (quint32 i = 0; i < m_outputMap->universes(); i++)
+        m_outputMap->setPatch(i, KStubPluginName, i % quint32(qMax(outputs, 1)));
+
+    /* Arm all functions */
+    m_doc->setMode(Doc::Operate);
+
+    return true;
+}
+
+void EngineBenchmark::setRenderThreads(int threads)
+{
+    m_timer->setRenderThreads(threads);
+}
+
+QString EngineBenchmark::workspaceInfo() const
+{
+    int scenes = 0, chasers = 0, efxs = 0;
+
+    QListIterator <Function*> it(m_generator->functions());
+    while (it.hasNext() == true)
+    {
+        Function* function = it.next();
+        if (function->type() == Function::Scene)
+            scenes++;
+        else if (function->type() == Function::Chaser)
+            chasers++;
+        else if (function->type() == Function::EFX)
+            efxs++;
+    }
+
+    return QString("%1 fixtures in %2 universes, %3 scenes, %4 chasers, %5 EFX")
+            .arg(m_doc->fixtures().size()).arg(m_doc->universes())
+            .arg(scenes).arg(chasers).arg(efxs);
+}
+
+/*****************************************************************************
+ * Results
+ *****************************************************************************/
+
+EngineBenchmark::Result::Result()
+    : ticks(0)
+    , meanTick(0)
+    , medianTick(0)
+    , p99Tick(0)
+    , maxTick(0)
+    , p99Jitter(0)
+    , allocationsPerTick(0)
+    , bytesPerTick(0)
+    , realtime(false)
+{
+}
+
+QString EngineBenchmark::Result::toString() const
+{
+    QString str;
+
+    str += QString("mode: %1\n").arg(realtime ? "realtime" : "free-running");
+    str += QString("ticks: %1\n").arg(ticks);
+    str += QString("ns/tick mean: %1\n").arg(meanTick);
+    if (realtime == false)
+    {
+        str += QString("ns/tick p50: %1\n").arg(medianTick);
+        str += QString("ns/tick p99: %1\n").arg(p99Tick);
+    }
+    str += QString("ns/tick max: %1\n").arg(maxTick);
+    str += QString("jitter p99 ns: %1\n").arg(p99Jitter);
+    str += QString("allocations/tick: %1\n").arg(allocationsPerTick, 0, 'f', 2);
+    str += QString("bytes allocated/tick: %1\n").arg(bytesPerTick, 0, 'f', 2);
+    if (AllocationCounter::countsMalloc() == false)
+        str += QString("(allocations counted from operator new only)\n");
+
+    return str;
+}
+
+/*****************************************************************************
+ * Running
+ *****************************************************************************/
+
+EngineBenchmark::Result EngineBenchmark::run(int ticks, int warmup)
+{
+    Result result;
+    if (ticks <= 0)
+        return result;
+
+    startFunctions();
+    for (int i = 0; i < warmup; i++)
+        m_timer->tick();
+
+    /* Reserved up front so that measuring doesn't allocate */
+    QVector <qint64> durations(ticks, 0);
+
+    quint32 allocations = AllocationCounter::count();
+    quint32 bytes = AllocationCounter::bytes();
+    qint64 start = MasterTimer::monotonicTime();
+    qint64 previous = start;
+    for (int i = 0; i < ticks; i++)
+    {
+        m_timer->tick();
+
+        qint64 now = MasterTimer::monotonicTime();
+        durations[i] = now - previous;
+        previous = now;
+    }
+    allocations = AllocationCounter::count() - allocations;
+    bytes = AllocationCounter::bytes() - bytes;
+
+    stopFunctions(false);
+
+    result.ticks = ticks;
+    result.meanTick = (previous - start) / ticks;
+    result.allocationsPerTick = double(allocations) / double(ticks);
+    result.bytesPerTick = double(bytes) / double(ticks);
+
+    qSort(durations.begin(), durations.end());
+    result.medianTick = percentile(durations, 50);
+    result.p99Tick = percentile(durations, 99);
+    result.maxTick = durations.last();
+
+    QVector <qint64> deviations(ticks, 0);
+    for (int i = 0; i < ticks; i++)
+        deviations[i] = qAbs(durations[i] - result.medianTick);
+    qSort(deviations.begin(), deviations.end());
+    result.p99Jitter = percentile(deviations, 99);
+
+    return result;
+}
+
+EngineBenchmark::Result EngineBenchmark::runRealtime(int ticks)
+{
+    Result result;
+    result.realtime = true;
+    if (ticks <= 0)
+        return result;
+
+    /* start() clears the function list, so functions go in after it */
+    m_timer->start();
+    m_timer->setProfiling(true);
+    m_timer->resetProfile();
+    startFunctions();
+
+    quint32 allocations = AllocationCounter::count();
+    quint32 bytes = AllocationCounter::bytes();
+    quint64 first = m_timer->ticks();
+    while (m_timer->ticks() - first < quint64(ticks))
+        BenchmarkTimer::pause(10);
+    allocations = AllocationCounter::count() - allocations;
+    bytes = AllocationCounter::bytes() - bytes;
+    quint64 ran = m_timer->ticks() - first;
+
+    /* Let the timer publish its latest profile */
+    while (m_timer->profile().ticks < ran)
+        BenchmarkTimer::pause(10);
+
+    TickProfile profile = m_timer->profile();
+    QVector <quint32> histogram = m_timer->jitterHistogram();
+
+    stopFunctions(true);
+    m_timer->setProfiling(false);
+    m_timer->stop();
+
+    result.ticks = ran;
+    result.meanTick = profile.spans[TickProfile::TickSpan].average();
+    result.maxTick = profile.spans[TickProfile::TickSpan].max;
+    result.allocationsPerTick = double(allocations) / double(ran);
+    result.bytesPerTick = double(bytes) / double(ran);
+
+    /* Upper edge of the bin that reaches the 99th percentile */
+    quint64 total = 0;
+    for (int i = 0; i < histogram.size(); i++)
+        total += histogram[i];
+
+    quint64 sum = 0;
+    for (int i = 0; i < histogram.size(); i++)
+    {
+        sum += histogram[i];
+        if (sum * 100 >= total * 99)
+        {
+            result.p99Jitter = qint64(i + 1) * MasterTimer::histogramBinWidth() * 1000;
+            break;
+        }
+    }
+
+    return result;
+}
+
+void EngineBenchmark::startFunctions()
+{
+    QListIterator <Function*> it(m_generator->functions());
+    while (it.hasNext() == true)
+        m_timer->startFunction(it.next(), false);
+}
+
+void EngineBenchmark::stopFunctions(bool realtime)
+{
+    if (realtime == true)
+    {
+        m_timer->stopAllFunctions();
+    }
+    else
+    {
+        QListIterator <Function*> it(m_generator->functions());
+        while (it.hasNext() == true)
+            it.next()->stop();
+
+        while (m_timer->runningFunctions() > 0)
+            m_timer->tick();
+    }
+}
+
+qint64 EngineBenchmark::percentile(const QVector <qint64>& values, int percent)
+{
+    if (values.isEmpty() == true)
+        return 0;
+
+    int index = (values.size() * percent) / 100;
+    return values.at(qMin(index, values.size() - 1));
+}
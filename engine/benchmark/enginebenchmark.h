@@ -0,0 +1,126 @@
+/*
+  Q Light Controller - Engine benchmark
+  enginebenchmark.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef ENGINEBENCHMARK_H
+#define ENGINEBENCHMARK_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include <QDir>
+
+#include "qlcfixturedefcache.h"
+
+class BenchmarkTimer;
+class ShowGenerator;
+class OutputMap;
+class Doc;
+
+/**
+ * EngineBenchmark runs a synthetic workspace on a real Doc, MasterTimer
+ * and OutputMap, with every universe patched to the output plugin stub,
+ * and measures the cost of timer ticks.
+ */
+class EngineBenchmark : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(EngineBenchmark)
+
+public:
+    EngineBenchmark(QObject* parent);
+    ~EngineBenchmark();
+
+    /**
+     * Load the output plugin stub from the given directory and generate a
+     * workspace. See ShowGenerator::generate().
+     *
+     * @return true if the plugin stub was found, otherwise false
+     */
+    bool init(const QDir& pluginDir, int fixtures, int scenes, int chasers,
+              int efxs);
+
+    /** Set the number of MasterTimer render threads */
+    void setRenderThreads(int threads);
+
+    /** Get a one-line description of the generated workspace */
+    QString workspaceInfo() const;
+
+    /*********************************************************************
+     * Results
+     *********************************************************************/
+public:
+    class Result
+    {
+    public:
+        Result();
+
+        /** Format the results as "key: value" lines */
+        QString toString() const;
+
+        quint64 ticks;
+        qint64 meanTick;        /** Nanoseconds */
+        qint64 medianTick;      /** Nanoseconds */
+        qint64 p99Tick;         /** Nanoseconds */
+        qint64 maxTick;         /** Nanoseconds */
+        qint64 p99Jitter;       /** Nanoseconds */
+        double allocationsPerTick;
+        double bytesPerTick;    /** Bytes allocated */
+        bool realtime;
+    };
+
+    /*********************************************************************
+     * Running
+     *********************************************************************/
+public:
+    /**
+     * Tick the timer $ticks times as fast as possible in the calling
+     * thread, after $warmup unmeasured ticks. Jitter is the spread of tick
+     * durations: the 99th percentile of their distance from the median.
+     */
+    Result run(int ticks, int warmup);
+
+    /**
+     * Run the timer in its own thread at the current MasterTimer
+     * frequency for $ticks ticks. Tick costs come from the timer's tick
+     * profile; jitter is the 99th percentile of the timer's own jitter
+     * histogram, i.e. how much tick intervals differed from the period.
+     */
+    Result runRealtime(int ticks);
+
+protected:
+    /** Start all generated functions */
+    void startFunctions();
+
+    /** Stop all functions and tick until they are gone */
+    void stopFunctions(bool realtime);
+
+    /** Get the $percent'th percentile of sorted $values */
+    static qint64 percentile(const QVector <qint64>& values, int percent);
+
+protected:
+    QLCFixtureDefCache m_fixtureDefCache;
+    Doc* m_doc;
+    OutputMap* m_outputMap;
+    BenchmarkTimer* m_timer;
+    ShowGenerator* m_generator;
+};
+
+#endif
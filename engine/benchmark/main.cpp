@@ -0,0 +1,125 @@
+/*
+  Q Light Controller - Engine benchmark
+  main.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <QDir>
+
+#include "enginebenchmark.h"
+#include "mastertimer.h"
+#include "bus.h"
+
+#include "qlctypes.h"
+#include "qlcfile.h"
+
+#define KDefaultPluginDir "../outputpluginstub"
+
+static void usage(QTextStream& out)
+{
+    out << "Usage: benchmark_engine [options]" << endl
+        << "  --fixtures <n>   Number of fixtures (default 512)" << endl
+        << "  --scenes <n>     Number of scenes (default 64)" << endl
+        << "  --chasers <n>    Number of chasers (default 16)" << endl
+        << "  --efx <n>        Number of EFX (default 16)" << endl
+        << "  --ticks <n>      Number of measured ticks (default 5000)" << endl
+        << "  --warmup <n>     Number of unmeasured ticks first (default 500)" << endl
+        << "  --threads <n>    Number of render threads (default 1)" << endl
+        << "  --realtime       Run the timer thread at its real frequency" << endl
+        << "  --frequency <hz> Timer frequency for --realtime (default "
+        << MasterTimer::defaultFrequency() << ")" << endl
+        << "  --plugins <dir>  Output plugin stub directory (default "
+        << KDefaultPluginDir << ")" << endl;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    int fixtures = 512;
+    int scenes = 64;
+    int chasers = 16;
+    int efxs = 16;
+    int ticks = 5000;
+    int warmup = 500;
+    int threads = 1;
+    bool realtime = false;
+    QString pluginDir(KDefaultPluginDir);
+
+    QStringList args(app.arguments());
+    for (int i = 1; i < args.size(); i++)
+    {
+        QString arg(args.at(i));
+
+        if (arg == "--fixtures")
+            fixtures = args.value(++i).toInt();
+        else if (arg == "--scenes")
+            scenes = args.value(++i).toInt();
+        else if (arg == "--chasers")
+            chasers = args.value(++i).toInt();
+        else if (arg == "--efx")
+            efxs = args.value(++i).toInt();
+        else if (arg == "--ticks")
+            ticks = args.value(++i).toInt();
+        else if (arg == "--warmup")
+            warmup = args.value(++i).toInt();
+        else if (arg == "--threads")
+            threads = args.value(++i).toInt();
+        else if (arg == "--frequency")
+            MasterTimer::setFrequency(args.value(++i).toUInt());
+        else if (arg == "--plugins")
+            pluginDir = args.value(++i);
+        else if (arg == "--realtime")
+            realtime = true;
+        else
+        {
+            usage(out);
+            return (arg == "--help" || arg == "-h") ? 0 : 1;
+        }
+    }
+
+    Bus::init(&app);
+
+    QDir dir(pluginDir);
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters(QStringList() << QString("*%1").arg(KExtPlugin));
+
+    EngineBenchmark benchmark(&app);
+    if (benchmark.init(dir, fixtures, scenes, chasers, efxs) == false)
+        return 1;
+    benchmark.setRenderThreads(threads);
+
+    out << "workspace: " << benchmark.workspaceInfo() << endl;
+    out << "render threads: " << threads << endl;
+    if (realtime == true)
+        out << "frequency: " << MasterTimer::frequency() << " Hz" << endl;
+
+    EngineBenchmark::Result result;
+    if (realtime == true)
+        result = benchmark.runRealtime(ticks);
+    else
+        result = benchmark.run(ticks, warmup);
+
+    out << result.toString();
+
+    return 0;
+}
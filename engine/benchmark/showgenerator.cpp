@@ -0,0 +1,238 @@
+/*
+  Q Light Controller - Engine benchmark
+  showgenerator.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtCore>
+
+#include "qlcfixturemode.h"
+#include "qlcfixturedef.h"
+#include "qlcchannel.h"
+
+#include "showgenerator.h"
+#include "efxfixture.h"
+#include "fixture.h"
+#include "chaser.h"
+#include "scene.h"
+#include "efx.h"
+#include "doc.h"
+
+/** Number of scenes in each chaser */
+#define KChaserSteps 4
+
+/** Number of fixtures moved by each EFX */
+#define KEFXFixtures 16
+
+/** Seed for the pseudo-random workspace contents */
+#define KSeed 1
+
+ShowGenerator::ShowGenerator(Doc* doc)
+    : m_doc(doc)
+    , m_fixtureDef(NULL)
+    , m_fixtureMode(NULL)
+{
+    Q_ASSERT(doc != NULL);
+    createFixtureDef();
+}
+
+ShowGenerator::~ShowGenerator()
+{
+    /* Owns also the mode and channels */
+    delete m_fixtureDef;
+}
+
+int ShowGenerator::fixtureChannels()
+{
+    return 8;
+}
+
+int ShowGenerator::maxFixtures()
+{
+    return int(KUniverseCountMax) * (512 / fixtureChannels());
+}
+
+void ShowGenerator::generate(int fixtures, int scenes, int chasers, int efxs)
+{
+    qsrand(KSeed);
+
+    createFixtures(qMin(fixtures, maxFixtures()));
+    createScenes(scenes);
+    createChasers(chasers);
+    createEFXs(efxs);
+}
+
+QList <Function*> ShowGenerator::functions() const
+{
+    return m_functions;
+}
+
+void ShowGenerator::createFixtureDef()
+{
+    m_fixtureDef = new QLCFixtureDef();
+    m_fixtureDef->setManufacturer("QLC");
+    m_fixtureDef->setModel("Benchmark Head");
+    m_fixtureDef->setType("Moving Head");
+
+    m_fixtureMode = new QLCFixtureMode(m_fixtureDef);
+    m_fixtureMode->setName("8 Channel");
+    m_fixtureDef->addMode(m_fixtureMode);
+
+    struct
+    {
+        const char* name;
+        QLCChannel::Group group;
+        QLCChannel::ControlByte byte;
+    } channels[] =
+    {
+        { "Dimmer", QLCChannel::Intensity, QLCChannel::MSB },
+        { "Pan", QLCChannel::Pan, QLCChannel::MSB },
+        { "Pan Fine", QLCChannel::Pan, QLCChannel::LSB },
+        { "Tilt", QLCChannel::Tilt, QLCChannel::MSB },
+        { "Tilt Fine", QLCChannel::Tilt, QLCChannel::LSB },
+        { "Red", QLCChannel::Colour, QLCChannel::MSB },
+        { "Green", QLCChannel::Colour, QLCChannel::MSB },
+        { "Blue", QLCChannel::Colour, QLCChannel::MSB }
+    };
+
+    Q_ASSERT(int(sizeof(channels) / sizeof(channels[0])) == fixtureChannels());
+    for (int i = 0; i < fixtureChannels(); i++)
+    {
+        QLCChannel* channel = new QLCChannel();
+        channel->setName(channels[i].name);
+        channel->setGroup(channels[i].group);
+        channel->setControlByte(channels[i].byte);
+        m_fixtureDef->addChannel(channel);
+        m_fixtureMode->insertChannel(channel, i);
+    }
+}
+
+void ShowGenerator::createFixtures(int count)
+{
+    int perUniverse = 512 / fixtureChannels();
+
+    for (int i = 0; i < count; i++)
+    {
+        Fixture* fxi = new Fixture(m_doc);
+        fxi->setName(QString("Head %1").arg(i + 1));
+        fxi->setFixtureDefinition(m_fixtureDef, m_fixtureMode);
+        fxi->setUniverse(i / perUniverse);
+        fxi->setAddress((i % perUniverse) * fixtureChannels());
+
+        if (m_doc->addFixture(fxi) == true)
+        {
+            m_fixtures << fxi->id();
+        }
+        else
+        {
+            delete fxi;
+            break;
+        }
+    }
+}
+
+void ShowGenerator::createScenes(int count)
+{
+    if (m_fixtures.isEmpty() == true)
+        return;
+
+    /* Each scene covers a quarter of the rig, starting from a different
+       fixture, so that scenes overlap and HTP/LTP both get exercised. */
+    int width = qMax(1, m_fixtures.size() / 4);
+
+    for (int i = 0; i < count; i++)
+    {
+        Scene* scene = new Scene(m_doc);
+        scene->setName(QString("Scene %1").arg(i + 1));
+
+        int first = (i * m_fixtures.size()) / qMax(count, 1);
+        for (int f = 0; f < width; f++)
+        {
+            quint32 fxi = m_fixtures.at((first + f) % m_fixtures.size());
+            for (int ch = 0; ch < fixtureChannels(); ch++)
+                scene->setValue(fxi, ch, uchar(qrand() % 256));
+        }
+
+        if (m_doc->addFunction(scene) == true)
+        {
+            m_scenes << scene->id();
+            m_functions << scene;
+        }
+        else
+        {
+            delete scene;
+            break;
+        }
+    }
+}
+
+void ShowGenerator::createChasers(int count)
+{
+    if (m_scenes.isEmpty() == true)
+        return;
+
+    for (int i = 0; i < count; i++)
+    {
+        Chaser* chaser = new Chaser(m_doc);
+        chaser->setName(QString("Chaser %1").arg(i + 1));
+        for (int s = 0; s < KChaserSteps; s++)
+            chaser->addStep(m_scenes.at((i * KChaserSteps + s) % m_scenes.size()));
+
+        if (m_doc->addFunction(chaser) == true)
+        {
+            m_functions << chaser;
+        }
+        else
+        {
+            delete chaser;
+            break;
+        }
+    }
+}
+
+void ShowGenerator::createEFXs(int count)
+{
+    if (m_fixtures.isEmpty() == true)
+        return;
+
+    for (int i = 0; i < count; i++)
+    {
+        EFX* efx = new EFX(m_doc);
+        efx->setName(QString("EFX %1").arg(i + 1));
+        efx->setAlgorithm(EFX::Algorithm(i % (EFX::Lissajous + 1)));
+
+        int first = i * KEFXFixtures;
+        for (int f = 0; f < KEFXFixtures && f < m_fixtures.size(); f++)
+        {
+            EFXFixture* ef = new EFXFixture(efx);
+            ef->setFixture(m_fixtures.at((first + f) % m_fixtures.size()));
+            if (efx->addFixture(ef) == false)
+                delete ef;
+        }
+
+        if (m_doc->addFunction(efx) == true)
+        {
+            m_functions << efx;
+        }
+        else
+        {
+            delete efx;
+            break;
+        }
+    }
+}
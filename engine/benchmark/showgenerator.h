@@ -0,0 +1,88 @@
+/*
+  Q Light Controller - Engine benchmark
+  showgenerator.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef SHOWGENERATOR_H
+#define SHOWGENERATOR_H
+
+#include <QList>
+
+#include "qlctypes.h"
+
+class QLCFixtureMode;
+class QLCFixtureDef;
+class Function;
+class Doc;
+
+/**
+ * ShowGenerator fills a Doc with a synthetic workspace: a number of
+ * identical 8-channel moving heads (intensity, pan, tilt with fine
+ * channels and RGB), patched one after another, and scenes, chasers and
+ * EFX using them. Contents are pseudo-random but the same on every run.
+ *
+ * Fixtures refer to the generator's own fixture definition, so the
+ * generator must outlive the Doc that it has filled.
+ */
+class ShowGenerator
+{
+public:
+    ShowGenerator(Doc* doc);
+    ~ShowGenerator();
+
+    /** Number of channels in each generated fixture */
+    static int fixtureChannels();
+
+    /** Largest number of fixtures that fit into the available universes */
+    static int maxFixtures();
+
+    /**
+     * Generate the workspace. Each scene sets all channels of a quarter of
+     * the fixtures, each chaser steps thru four scenes and each EFX moves
+     * a group of 16 fixtures.
+     *
+     * @param fixtures Number of fixtures, at most maxFixtures()
+     * @param scenes Number of scenes
+     * @param chasers Number of chasers
+     * @param efxs Number of EFX
+     */
+    void generate(int fixtures, int scenes, int chasers, int efxs);
+
+    /** Get all generated functions, in the order they should be started */
+    QList <Function*> functions() const;
+
+protected:
+    void createFixtureDef();
+    void createFixtures(int count);
+    void createScenes(int count);
+    void createChasers(int count);
+    void createEFXs(int count);
+
+protected:
+    Doc* m_doc;
+
+    QLCFixtureDef* m_fixtureDef;
+    QLCFixtureMode* m_fixtureMode;
+
+    QList <quint32> m_fixtures;
+    QList <t_function_id> m_scenes;
+    QList <Function*> m_functions;
+};
+
+#endif
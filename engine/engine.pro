@@ -5,3 +5,6 @@ SUBDIRS += src
 SUBDIRS += inputpluginstub
 SUBDIRS += outputpluginstub
 SUBDIRS += test
+
+# Benchmarking
+SUBDIRS += benchmark
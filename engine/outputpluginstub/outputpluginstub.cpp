@@ -33,8 +33,9 @@ OutputPluginStub::~OutputPluginStub()
 void OutputPluginStub::init()
 {
     m_configureCalled = 0;
+    m_flushCalled = 0;
     m_canConfigure = false;
-    m_array = QByteArray(int(KUniverseCount * 512), char(0));
+    m_array = QByteArray(int(KUniverseCountMax * 512), char(0));
 }
 
 QString OutputPluginStub::name()
@@ -48,7 +49,7 @@ QString OutputPluginStub::name()
 
 void OutputPluginStub::open(quint32 output)
 {
-    if (m_openLines.contains(output) == false && output < KUniverseCount)
+    if (m_openLines.contains(output) == false && output < KUniverseCountMax)
         m_openLines.append(output);
 }
 
@@ -61,7 +62,7 @@ QStringList OutputPluginStub::outputs()
 {
     QStringList list;
 
-    for (quint32 i = 0; i < KUniverseCount; i++)
+    for (quint32 i = 0; i < KUniverseCountMax; i++)
         list << QString("%1: Stub %1").arg(i + 1);
 
     return list;
@@ -78,6 +79,11 @@ void OutputPluginStub::outputDMX(quint32 output, const QByteArray& universe)
     m_array = m_array.replace(output * 512, universe.size(), universe);
 }
 
+void OutputPluginStub::flushDMX()
+{
+    m_flushCalled++;
+}
+
 /*****************************************************************************
  * Configuration
  *****************************************************************************/
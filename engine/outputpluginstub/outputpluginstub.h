@@ -66,9 +66,13 @@ public:
     /** @reimp */
     void outputDMX(quint32 output, const QByteArray& universe);
 
+    /** @reimp */
+    void flushDMX();
+
 public:
     QList <quint32> m_openLines;
     QByteArray m_array;
+    int m_flushCalled;
 
     /*********************************************************************
      * Configuration
@@ -22,6 +22,7 @@
 #include <QDebug>
 #include <QtXml>
 
+#include "mastertimer.h"
 #include "bus.h"
 
 #define KBusCount 32
@@ -41,13 +42,17 @@
  * emit signals. BusEntries act just as storing locations for the values and
  * names for each of the buses, while Bus itself handles signal emission and
  * set/get methods.
+ *
+ * The value is stored in milliseconds so that it keeps its real-time meaning
+ * even if MasterTimer's tick frequency is changed. Bus converts it to and from
+ * timer ticks.
  */
 class BusEntry
 {
 public:
     BusEntry()
     {
-        value = 0;
+        msecs = 0;
     }
 
     ~BusEntry()
@@ -57,13 +62,26 @@ public:
     BusEntry(const BusEntry& entry)
     {
         name = entry.name;
-        value = entry.value;
+        msecs = entry.msecs;
     }
 
     QString name;
-    quint32 value;
+    quint64 msecs;
 };
 
+/** Convert $ticks at $frequency Hz to milliseconds, rounding to nearest */
+static quint64 ticksToMsecs(quint32 ticks, quint32 frequency)
+{
+    return (quint64(ticks) * 1000 + (frequency / 2)) / frequency;
+}
+
+/** Convert $msecs to ticks at $frequency Hz, rounding to nearest */
+static quint32 msecsToTicks(quint64 msecs, quint32 frequency)
+{
+    quint64 ticks = (msecs * frequency + 500) / 1000;
+    return quint32(qMin(ticks, quint64(UINT_MAX)));
+}
+
 /****************************************************************************
  * Initialization
  ****************************************************************************/
@@ -168,7 +186,7 @@ void Bus::setName(quint32 bus, const QString& name)
 quint32 Bus::value(quint32 bus) const
 {
     if (bus < KBusCount)
-        return m_buses[bus]->value;
+        return msecsToTicks(m_buses[bus]->msecs, MasterTimer::frequency());
     else
         return 0;
 }
@@ -177,7 +195,7 @@ void Bus::setValue(quint32 bus, quint32 value)
 {
     if (bus < KBusCount)
     {
-        m_buses[bus]->value = value;
+        m_buses[bus]->msecs = ticksToMsecs(value, MasterTimer::frequency());
         emit valueChanged(bus, value);
     }
 }
@@ -223,7 +241,13 @@ bool Bus::loadXML(const QDomElement* root)
         if (tag.tagName() == KXMLQLCBusName)
             setName(id, tag.text());
         else if (tag.tagName() == KXMLQLCBusValue)
-            setValue(id, tag.text().toULong());
+        {
+            /* Values are saved as ticks at the default frequency to keep
+               workspace files independent of the current tick rate. */
+            m_buses[id]->msecs = ticksToMsecs(tag.text().toULong(),
+                                              MasterTimer::defaultFrequency());
+            emit valueChanged(id, value(id));
+        }
         else
             qWarning() << Q_FUNC_INFO << "Unknown Bus tag:" << tag.tagName();
 
@@ -258,7 +282,8 @@ bool Bus::saveXML(QDomDocument* doc, QDomElement* wksp_root)
         /* Value */
         tag = doc->createElement(KXMLQLCBusValue);
         root.appendChild(tag);
-        text = doc->createTextNode(QString("%1").arg(m_buses[i]->value));
+        text = doc->createTextNode(QString("%1").arg(
+                    msecsToTicks(m_buses[i]->msecs, MasterTimer::defaultFrequency())));
         tag.appendChild(text);
     }
 
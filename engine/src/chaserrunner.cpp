@@ -19,6 +19,7 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QtAlgorithms>
 #include <QDebug>
 
 #include "universearray.h"
@@ -49,6 +50,7 @@ ChaserRunner::ChaserRunner(Doc* doc, QList <Function*> steps,
     , m_currentStep(0)
     , m_newCurrent(-1)
 {
+    compileSteps();
     reset();
 }
 
@@ -105,7 +107,7 @@ void ChaserRunner::reset()
     m_elapsed = 0;
     m_next = false;
     m_previous = false;
-    m_channelMap.clear();
+    m_channels.resize(0);
 }
 
 bool ChaserRunner::write(UniverseArray* universes)
@@ -124,7 +126,7 @@ bool ChaserRunner::write(UniverseArray* universes)
         // always within m_steps limits.
 
         m_elapsed = 1;
-        m_channelMap = createFadeChannels(universes);
+        createFadeChannels(universes);
 
         emit currentStepChanged(m_currentStep);
     }
@@ -132,7 +134,7 @@ bool ChaserRunner::write(UniverseArray* universes)
     {
         // First step
         m_elapsed = 1;
-        m_channelMap = createFadeChannels(universes);
+        createFadeChannels(universes);
 
         emit currentStepChanged(m_currentStep);
     }
@@ -163,7 +165,7 @@ bool ChaserRunner::write(UniverseArray* universes)
         m_elapsed = 1;
         m_next = false;
         m_previous = false;
-        m_channelMap = createFadeChannels(universes);
+        createFadeChannels(universes);
 
         emit currentStepChanged(m_currentStep);
     }
@@ -173,28 +175,36 @@ bool ChaserRunner::write(UniverseArray* universes)
         m_elapsed++;
     }
 
-    QMutableMapIterator <quint32,FadeChannel> it(m_channelMap);
-    while (it.hasNext() == true)
-    {
-        Scene* scene = qobject_cast<Scene*> (m_steps.at(m_currentStep));
-        if (scene == NULL)
-            continue;
+    const Step& step(m_compiledSteps.at(m_currentStep));
+    if (step.scene == false)
+        return true;
+
+    quint32 fadeTime = Bus::instance()->value(step.fadeBusId);
 
-        quint32 fadeTime = Bus::instance()->value(scene->busID());
+    m_writeAddresses.resize(0);
+    m_writeValues.resize(0);
+    m_writeGroups.resize(0);
 
-        FadeChannel& channel(it.next().value());
+    for (int i = 0; i < m_channels.size(); i++)
+    {
+        FadeChannel& channel(m_channels[i]);
         if (channel.current() == channel.target() && channel.group() != QLCChannel::Intensity)
         {
             /* Write the final value to LTP channels only once */
         }
         else
         {
-            universes->write(channel.address(),
-                             channel.calculateCurrent(fadeTime, m_elapsed),
-                             channel.group());
+            m_writeAddresses.append(channel.address());
+            m_writeValues.append(channel.calculateCurrent(fadeTime, m_elapsed));
+            m_writeGroups.append(channel.group());
         }
     }
 
+    universes->writeBlock(m_writeAddresses.constData(),
+                          m_writeValues.constData(),
+                          m_writeGroups.constData(),
+                          m_writeAddresses.size());
+
     return true;
 }
 
@@ -262,74 +272,138 @@ bool ChaserRunner::roundCheck()
     return true;
 }
 
-QMap <quint32,FadeChannel> ChaserRunner::createFadeChannels(
-                                        const UniverseArray* universes) const
+void ChaserRunner::createFadeChannels(const UniverseArray* universes)
 {
-    QMap <quint32,FadeChannel> map;
-    if (m_currentStep >= m_steps.size() || m_currentStep < 0)
-        return map;
-
-    // Put all current channels to a map of channels that will be faded to zero
-    QMap <quint32,FadeChannel> zeroChannels(m_channelMap);
+    m_nextChannels.resize(0);
 
     // If the step is not a scene, don't attempt to create fade channels
-    Scene* scene = qobject_cast<Scene*> (m_steps.at(m_currentStep));
-    if (scene == NULL)
-        return map;
-
-    QListIterator <SceneValue> it(scene->values());
-    while (it.hasNext() == true)
+    if (m_currentStep < m_compiledSteps.size() && m_currentStep >= 0 &&
+        m_compiledSteps.at(m_currentStep).scene == true)
     {
-        SceneValue value(it.next());
-        Fixture* fxi = m_doc->fixture(value.fxi);
-        if (fxi == NULL || fxi->channel(value.channel) == NULL)
-            continue;
-
-        FadeChannel channel;
-        channel.setAddress(fxi->universeAddress() + value.channel);
-        channel.setGroup(fxi->channel(value.channel)->group());
-        channel.setTarget(value.value);
+        const QVector <StepChannel>& stepChannels(
+                m_compiledSteps.at(m_currentStep).channels);
 
-        // Get starting value from universes. For HTP channels it's always 0.
-        channel.setStart(uchar(universes->preGMValues()[channel.address()]));
+        int prev = 0;
+        int next = 0;
+        while (prev < m_channels.size() || next < stepChannels.size())
+        {
+            if (next == stepChannels.size() ||
+                (prev < m_channels.size() &&
+                 m_channels.at(prev).address() < stepChannels.at(next).address))
+            {
+                // This channel was present in the previous step, but is
+                // absent in the current. Non-HTP channels and HTP channels
+                // that are already at zero are left alone, but other HTP
+                // channels are faded back to zero, rather than just let
+                // them drop straight to zero.
+                const FadeChannel& old(m_channels.at(prev++));
+                if (old.current() != 0 && old.group() == QLCChannel::Intensity)
+                {
+                    m_nextChannels.append(FadeChannel(old.address(), old.group(),
+                                                      old.current(), 0,
+                                                      old.current()));
+                }
+            }
+            else
+            {
+                const StepChannel& value(stepChannels.at(next++));
+
+                // Transfer last step's current value to current step's
+                // starting value. If there is none, get the starting value
+                // from universes. For HTP channels it's always 0.
+                uchar start;
+                if (prev < m_channels.size() &&
+                    m_channels.at(prev).address() == value.address)
+                {
+                    start = m_channels.at(prev++).current();
+                }
+                else
+                {
+                    start = universes->preGMValue(value.address);
+                }
+
+                m_nextChannels.append(FadeChannel(value.address, value.group,
+                                                  start, value.value, start));
+            }
+        }
+    }
 
-        // Transfer last step's current value to current step's starting value.
-        if (m_channelMap.contains(channel.address()) == true)
-            channel.setStart(m_channelMap[channel.address()].current());
-        channel.setCurrent(channel.start());
+    // Both vectors keep their reserved memory
+    qSwap(m_channels, m_nextChannels);
+}
 
-        // Append the channel to the channel map
-        map[channel.address()] = channel;
+bool ChaserRunner::stepChannelLessThan(const StepChannel& a,
+                                       const StepChannel& b)
+{
+    return a.address < b.address;
+}
 
-        // Remove the channel from a map of to-be-zeroed channels since now it
-        // has a new value to fade to.
-        zeroChannels.remove(channel.address());
-    }
+void ChaserRunner::compileSteps()
+{
+    QVector <quint32> addresses;
 
-    // All channels that were present in the previous step but are not present
-    // in the current step will go through this zeroing process.
-    QMutableMapIterator <quint32,FadeChannel> zit(zeroChannels);
-    while (zit.hasNext() == true)
+    m_compiledSteps.resize(m_steps.size());
+    for (int i = 0; i < m_steps.size(); i++)
     {
-        zit.next();
-        FadeChannel& channel(zit.value());
-        if (channel.current() == 0 || channel.group() != QLCChannel::Intensity)
+        Step& step(m_compiledSteps[i]);
+        step.channels.resize(0);
+
+        Scene* scene = qobject_cast<Scene*> (m_steps.at(i));
+        step.scene = (scene != NULL);
+        if (scene == NULL)
         {
-            // Remove all non-HTP channels and such HTP channels that are
-            // already at zero. There's nothing to do for them.
-            zit.remove();
+            step.fadeBusId = Bus::defaultFade();
+            continue;
         }
-        else
+
+        step.fadeBusId = scene->busID();
+
+        QListIterator <SceneValue> it(scene->values());
+        while (it.hasNext() == true)
+        {
+            SceneValue value(it.next());
+            Fixture* fxi = m_doc->fixture(value.fxi);
+            if (fxi == NULL || fxi->channel(value.channel) == NULL)
+                continue;
+
+            StepChannel channel;
+            channel.address = fxi->universeAddress() + value.channel;
+            channel.group = fxi->channel(value.channel)->group();
+            channel.value = value.value;
+            step.channels.append(channel);
+        }
+
+        // Of channels with the same address, the last one counts
+        qStableSort(step.channels.begin(), step.channels.end(),
+                    stepChannelLessThan);
+        int count = 0;
+        for (int j = 0; j < step.channels.size(); j++)
         {
-            // This HTP channel was present in the previous step, but is absent
-            // in the current. It's nicer that we fade it back to zero, rather
-            // than just let it drop straight to zero.
-            channel.setStart(channel.current());
-            channel.setTarget(0);
+            if (count > 0 && step.channels.at(count - 1).address ==
+                             step.channels.at(j).address)
+            {
+                count--;
+            }
+            step.channels[count++] = step.channels.at(j);
         }
+        step.channels.resize(count);
+
+        for (int j = 0; j < step.channels.size(); j++)
+            addresses.append(step.channels.at(j).address);
     }
 
-    map.unite(zeroChannels);
+    // A step can't have more fade channels than all steps have addresses
+    qSort(addresses.begin(), addresses.end());
+    int unique = 0;
+    for (int i = 0; i < addresses.size(); i++)
+    {
+        if (i == 0 || addresses.at(i) != addresses.at(i - 1))
+            unique++;
+    }
 
-    return map;
+    m_channels.reserve(unique);
+    m_nextChannels.reserve(unique);
+    m_writeAddresses.reserve(unique);
+    m_writeValues.reserve(unique);
+    m_writeGroups.reserve(unique);
 }
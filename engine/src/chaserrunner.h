@@ -22,13 +22,14 @@
 #ifndef CHASERRUNNER_H
 #define CHASERRUNNER_H
 
+#include <QVector>
 #include <QList>
-#include <QMap>
 
+#include "fadechannel.h"
+#include "qlcchannel.h"
 #include "function.h"
 
 class UniverseArray;
-class FadeChannel;
 class Function;
 class Doc;
 
@@ -106,10 +107,10 @@ private:
     bool roundCheck();
 
     /**
-     * Create FadeChannel map for the currently active scene. If m_channelMap
-     * is not empty, then the created FadeChannels' starting values are taken
-     * from the old m_channelMap's current values. If the old map doesn't contain
-     * a FadeChannel for a new channel, then the new FadeChannel will start
+     * Create fade channels for the currently active scene into m_channels.
+     * If m_channels is not empty, then the created FadeChannels' starting
+     * values are taken from the old channels' current values. If there is no
+     * old FadeChannel for a new channel, then the new FadeChannel will start
      * from whatever is currently in $universes[address].
      *
      * This handover must be done for HTP channels to work since UniverseArray's
@@ -117,9 +118,19 @@ private:
      * making Function::write() calls. If this handover isn't done, all intensity
      * channels would always fade from 0 to the target value.
      *
+     * Both the old channels and the step's compiled channels are sorted by
+     * address, so this is a single merge of the two, without allocation.
+     *
      * @param universes Current UniverseArray
      */
-    QMap <quint32,FadeChannel> createFadeChannels(const UniverseArray* universes) const;
+    void createFadeChannels(const UniverseArray* universes);
+
+    /**
+     * Resolve the channels of each step to absolute addresses once, so that
+     * changing steps doesn't need to look up fixtures or scene values. Also
+     * reserves room for fade channels, so that running doesn't allocate.
+     */
+    void compileSteps();
 
     /************************************************************************
      * Constant parameters
@@ -131,18 +142,50 @@ private:
     const Function::Direction m_originalDirection; //! Set during constructor
     const Function::RunOrder m_runOrder;
 
+    /** A scene value resolved to an absolute DMX address */
+    struct StepChannel
+    {
+        quint32 address;
+        QLCChannel::Group group;
+        uchar value;
+    };
+
+    /** A step, compiled by compileSteps() */
+    struct Step
+    {
+        /** False if the step is not a scene, i.e. has nothing to fade */
+        bool scene;
+
+        /** The scene's fade bus */
+        quint32 fadeBusId;
+
+        /** The scene's channels, sorted by address, one per address */
+        QVector <StepChannel> channels;
+    };
+
+    QVector <Step> m_compiledSteps; //! Compiled m_steps
+
+    /** Orders step channels by their addresses */
+    static bool stepChannelLessThan(const StepChannel& a, const StepChannel& b);
+
     /************************************************************************
      * Run-time parameters
      ************************************************************************/
 private:
     bool m_autoStep; //! Automatic stepping
     Function::Direction m_direction; //! Run-time direction
-    QMap <quint32,FadeChannel> m_channelMap; //! Current step channels
+    QVector <FadeChannel> m_channels; //! Current step channels, sorted by address
+    QVector <FadeChannel> m_nextChannels; //! Channels being created for the next step
     quint32 m_elapsed; //! Elapsed timer ticks (==write() calls)
     bool m_next; //! If true, skips to the next step when write is called
     bool m_previous; //! If true, skips to the previous step when write is called
     int m_currentStep; //! Current step from m_steps
     int m_newCurrent; //! Used to manually set the current step
+
+    /** Values gathered from m_channels for one UniverseArray::writeBlock() */
+    QVector <int> m_writeAddresses;
+    QVector <uchar> m_writeValues;
+    QVector <QLCChannel::Group> m_writeGroups;
 };
 
 #endif
@@ -142,7 +142,22 @@ QList <t_function_id> Collection::functions() const
 
 void Collection::slotFunctionRemoved(t_function_id fid)
 {
-    removeFunction(fid);
+    if (removeFunction(fid) == false || m_armedFunctions.isEmpty() == true)
+        return;
+
+    /* The removed function has already been destroyed, so resolve the
+       remaining members again instead of looking for its pointer */
+    Doc* doc = qobject_cast <Doc*> (parent());
+    Q_ASSERT(doc != NULL);
+
+    m_armedFunctions.clear();
+    QListIterator <t_function_id> it(m_functions);
+    while (it.hasNext() == true)
+    {
+        Function* function = doc->function(it.next());
+        if (function != NULL)
+            m_armedFunctions << function;
+    }
 }
 
 /*****************************************************************************
@@ -236,43 +251,47 @@ void Collection::arm()
 
     /* Check that all member functions exist (nonexistent functions can
        be present only when a corrupted file has been loaded) */
+    m_armedFunctions.clear();
     QMutableListIterator<t_function_id> it(m_functions);
     while (it.hasNext() == true)
     {
         /* Remove any nonexistent member functions */
-        if (doc->function(it.next()) == NULL)
+        Function* function = doc->function(it.next());
+        if (function == NULL)
             it.remove();
+        else
+            m_armedFunctions << function;
     }
 
+    m_runningChildren.reserve(m_armedFunctions.size());
+
     resetElapsed();
 }
 
 void Collection::disarm()
 {
+    m_armedFunctions.clear();
+    m_runningChildren.clear();
 }
 
 void Collection::preRun(MasterTimer* timer)
 {
-    m_runningChildren.clear();
+    m_runningChildren.resize(0);
     Function::preRun(timer);
 }
 
 void Collection::postRun(MasterTimer* timer, UniverseArray* universes)
 {
-    Doc* doc = qobject_cast <Doc*> (parent());
-    Q_ASSERT(doc != NULL);
-
     /** Stop the member functions only if they have been started by this
-        collection. */
-    QSetIterator <t_function_id> it(m_runningChildren);
-    while (it.hasNext() == true)
+        collection and haven't been stopped since. */
+    for (int i = 0; i < m_runningChildren.size(); i++)
     {
-        Function* function = doc->function(it.next());
-        Q_ASSERT(function != NULL);
-        function->stop();
+        const Child& child(m_runningChildren.at(i));
+        if (child.function->stopCount() == child.stopCount)
+            child.function->stop();
     }
 
-    m_runningChildren.clear();
+    m_runningChildren.resize(0);
     Function::postRun(timer, universes);
 }
 
@@ -282,43 +301,45 @@ void Collection::write(MasterTimer* timer, UniverseArray* universes)
 
     if (elapsed() == 0)
     {
-        Doc* doc = qobject_cast <Doc*> (parent());
-        Q_ASSERT(doc != NULL);
-
-        QListIterator <t_function_id> it(m_functions);
+        // Take each member's stop count before starting it, so that this
+        // collection can later tell which of them have stopped since and
+        // which are still controlled by it, without listening to signals.
+        QListIterator <Function*> it(m_armedFunctions);
         while (it.hasNext() == true)
         {
-            Function* function = doc->function(it.next());
-            Q_ASSERT(function != NULL);
-
-            // Append the IDs of all functions started by this collection
-            // to a set so that we can track which of them are still controlled
-            // by this collection which are not.
-            m_runningChildren << function->id();
-
-            // Listen to the children's stopped signals so that this collection
-            // can give up its rights to stop the function later.
-            connect(function, SIGNAL(stopped(t_function_id)),
-                    this, SLOT(slotChildStopped(t_function_id)));
-
-            timer->startFunction(function, true);
+            Child child;
+            child.function = it.next();
+            child.stopCount = child.function->stopCount();
+            m_runningChildren.append(child);
         }
+
+        timer->startFunctions(m_armedFunctions, true);
     }
 
     incrementElapsed();
 
+    /* Forget children that have stopped, keeping the rest in order */
+    int running = 0;
+    for (int i = 0; i < m_runningChildren.size(); i++)
+    {
+        const Child& child(m_runningChildren.at(i));
+        if (child.function->stopCount() == child.stopCount)
+            m_runningChildren[running++] = child;
+    }
+    m_runningChildren.resize(running);
+
     if (m_runningChildren.size() == 0)
         stop();
 }
 
-void Collection::slotChildStopped(t_function_id fid)
+bool Collection::isRunningChild(const Function* function) const
 {
-    Doc* doc = qobject_cast <Doc*> (parent());
-    Q_ASSERT(doc != NULL);
-
-    Function* function = doc->function(fid);
-    disconnect(function, SIGNAL(stopped(t_function_id)),
-               this, SLOT(slotChildStopped(t_function_id)));
+    for (int i = 0; i < m_runningChildren.size(); i++)
+    {
+        const Child& child(m_runningChildren.at(i));
+        if (child.function == function)
+            return (function->stopCount() == child.stopCount);
+    }
 
-    m_runningChildren.remove(fid);
+    return false;
 }
@@ -22,8 +22,8 @@
 #ifndef COLLECTION_H
 #define COLLECTION_H
 
+#include <QVector>
 #include <QList>
-#include <QSet>
 
 #include "function.h"
 
@@ -34,6 +34,8 @@ class Collection : public Function
     Q_OBJECT
     Q_DISABLE_COPY(Collection)
 
+    friend class Collection_Test;
+
     /*********************************************************************
      * Initialization
      *********************************************************************/
@@ -125,13 +127,29 @@ public:
     /** @reimpl */
     void write(MasterTimer* timer, UniverseArray* universes);
 
-protected slots:
-    /** Called whenever one of this function's child functions stops */
-    void slotChildStopped(t_function_id fid);
-
 protected:
-    /** Number of currently running children */
-    QSet <t_function_id> m_runningChildren;
+    /** A member function started by this collection */
+    struct Child
+    {
+        Function* function;
+
+        /** The function's stopCount() when it was started */
+        quint32 stopCount;
+    };
+
+    /** Member functions resolved in arm(), so write() needn't look up Doc */
+    QList <Function*> m_armedFunctions;
+
+    /** Children that haven't stopped since this collection started them */
+    QVector <Child> m_runningChildren;
+
+private:
+    /**
+     * Check, whether the given function has been started by this collection
+     * and hasn't stopped since, i.e. whether the collection still controls
+     * it and stops it along with itself.
+     */
+    bool isRunningChild(const Function* function) const;
 };
 
 #endif
@@ -43,6 +43,7 @@ Doc::Doc(QObject* parent, const QLCFixtureDefCache& fixtureDefCache)
     : QObject(parent)
     , m_mode(Design)
     , m_fixtureDefCache(fixtureDefCache)
+    , m_universes(KUniverseCount)
     , m_latestFixtureId(0)
 {
     // Allocate function array
@@ -143,6 +144,26 @@ const QLCFixtureDefCache& Doc::fixtureDefCache() const
     return m_fixtureDefCache;
 }
 
+/*****************************************************************************
+ * Universes
+ *****************************************************************************/
+
+quint32 Doc::universes() const
+{
+    return m_universes;
+}
+
+void Doc::setUniverses(quint32 universes)
+{
+    universes = MIN(universes, KUniverseCountMax);
+    if (universes <= m_universes)
+        return;
+
+    m_universes = universes;
+    emit universesChanged(universes);
+    setModified();
+}
+
 /*****************************************************************************
  * Fixtures
  *****************************************************************************/
@@ -182,6 +203,7 @@ bool Doc::addFixture(Fixture* fixture, quint32 id)
 
         fixture->setID(id);
         m_fixtures[id] = fixture;
+        setUniverses(fixture->universe() + 1);
         emit fixtureAdded(id);
         setModified();
 
@@ -224,10 +246,28 @@ Fixture* Doc::fixture(quint32 id) const
 
 quint32 Doc::findAddress(quint32 numChannels) const
 {
+    /* Construct a map of allocated channels in all universes with one pass
+       thru the fixtures, instead of one pass per universe. */
+    QVector <bool> map(universes() * 512, false);
+
+    QListIterator <Fixture*> fxit(fixtures());
+    while (fxit.hasNext() == true)
+    {
+        Fixture* fxi(fxit.next());
+        Q_ASSERT(fxi != NULL);
+
+        quint32 address = fxi->universeAddress();
+        for (quint32 ch = 0; ch < fxi->channels(); ch++)
+        {
+            if (address + ch < quint32(map.size()))
+                map[address + ch] = true;
+        }
+    }
+
     /* Try to find contiguous space from one universe at a time */
-    for (quint32 universe = 0; universe < KUniverseCount; universe++)
+    for (quint32 universe = 0; universe < universes(); universe++)
     {
-        quint32 ch = findAddress(universe, numChannels);
+        quint32 ch = findAddress(map, universe, numChannels);
         if (ch != QLCChannel::invalid())
             return ch;
     }
@@ -235,38 +275,23 @@ quint32 Doc::findAddress(quint32 numChannels) const
     return QLCChannel::invalid();
 }
 
-quint32 Doc::findAddress(quint32 universe, quint32 numChannels) const
+quint32 Doc::findAddress(const QVector <bool>& map, quint32 universe,
+                         quint32 numChannels) const
 {
     quint32 freeSpace = 0;
     quint32 maxChannels = 512;
-
-    /* Construct a map of unallocated channels */
-    int map[maxChannels];
-    std::fill(map, map + maxChannels, 0);
-
-    QListIterator <Fixture*> fxit(fixtures());
-    while (fxit.hasNext() == true)
-    {
-        Fixture* fxi(fxit.next());
-        Q_ASSERT(fxi != NULL);
-
-        if (fxi->universe() != universe)
-            continue;
-
-        for (quint32 ch = 0; ch < fxi->channels(); ch++)
-            map[fxi->universeAddress() + ch] = 1;
-    }
+    quint32 base = universe << 9;
 
     /* Try to find the next contiguous free address space */
     for (quint32 ch = 0; ch < maxChannels; ch++)
     {
-        if (map[ch] == 0)
+        if (map[base + ch] == false)
             freeSpace++;
         else
             freeSpace = 0;
 
         if (freeSpace == numChannels)
-            return (ch - freeSpace + 1) | (universe << 9);
+            return (ch - freeSpace + 1) | base;
     }
 
     return QLCChannel::invalid();
@@ -432,6 +457,11 @@ void Doc::slotFunctionChanged(t_function_id fid)
 
 void Doc::slotFixtureChanged(quint32 id)
 {
+    /* Fixture may have moved to a universe beyond the current count */
+    Fixture* fxi = fixture(id);
+    if (fxi != NULL)
+        setUniverses(fxi->universe() + 1);
+
     setModified();
     emit fixtureChanged(id);
 }
@@ -458,6 +488,10 @@ bool Doc::loadXML(const QDomElement* root)
         return false;
     }
 
+    /* Older workspaces don't have this and they use the default count */
+    if (root->hasAttribute(KXMLQLCEngineUniverses) == true)
+        setUniverses(root->attribute(KXMLQLCEngineUniverses).toUInt());
+
     node = root->firstChild();
     while (node.isNull() == false)
     {
@@ -497,6 +531,7 @@ bool Doc::saveXML(QDomDocument* doc, QDomElement* wksp_root)
 
     /* Create the master Engine node */
     root = doc->createElement(KXMLQLCEngine);
+    root.setAttribute(KXMLQLCEngineUniverses, universes());
     wksp_root->appendChild(root);
 
     /* Write fixtures into an XML document */
@@ -23,6 +23,7 @@
 #define DOC_H
 
 #include <QObject>
+#include <QVector>
 #include <QList>
 #include <QFile>
 #include <QMap>
@@ -35,6 +36,7 @@ class QDomDocument;
 class QString;
 
 #define KXMLQLCEngine "Engine"
+#define KXMLQLCEngineUniverses "Universes"
 
 class Doc : public QObject
 {
@@ -88,6 +90,32 @@ public:
 protected:
     const QLCFixtureDefCache& m_fixtureDefCache;
 
+    /*********************************************************************
+     * Universes
+     *********************************************************************/
+public:
+    /**
+     * Get the number of DMX universes used by the workspace
+     */
+    quint32 universes() const;
+
+    /**
+     * Grow the number of DMX universes used by the workspace. The number
+     * never shrinks and it can't exceed KUniverseCountMax. Adding fixtures
+     * to universes beyond the current count grows it automatically.
+     *
+     * @param universes The new number of universes
+     */
+    void setUniverses(quint32 universes);
+
+signals:
+    /** Signal that the number of universes has changed */
+    void universesChanged(quint32 universes);
+
+protected:
+    /** Number of DMX universes used by the workspace */
+    quint32 m_universes;
+
     /*********************************************************************
      * Modified status
      *********************************************************************/
@@ -175,11 +203,13 @@ protected:
      * the given number of channels. QLCChannel::invalid() is returned if
      * an adequate address range cannot be found.
      *
+     * @param map Allocation map of all universes' channels (true == taken)
      * @param universe The universe to search from
      * @param numChannels Number of free channels required
      * @return An address or QLCChannel::invalid() if address space not available
      */
-    quint32 findAddress(quint32 universe, quint32 numChannels) const;
+    quint32 findAddress(const QVector <bool>& map, quint32 universe,
+                        quint32 numChannels) const;
 
     /**
      * Create a new fixture ID
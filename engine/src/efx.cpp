@@ -39,6 +39,42 @@
 #include "efx.h"
 #include "bus.h"
 
+/** Number of cosine table entries per full circle, a power of two */
+#define KEFXCosTableSize 4096
+
+/** Cosine of each table step, with one extra entry for interpolation. The
+    table is filled when the library is loaded, before any thread uses it. */
+class EFXCosTable
+{
+public:
+    EFXCosTable()
+    {
+        for (int i = 0; i <= KEFXCosTableSize; i++)
+            values[i] = cos((M_PI * 2.0 * i) / KEFXCosTableSize);
+    }
+
+    qreal values[KEFXCosTableSize + 1];
+};
+
+static const EFXCosTable s_cosTable;
+
+/**
+ * Table-based cosine with linear interpolation between table entries. The
+ * error is below 3e-7, far less than one 16-bit pan/tilt step.
+ */
+static inline qreal tableCos(qreal radians)
+{
+    qreal position = radians * (KEFXCosTableSize / (M_PI * 2.0));
+    qreal whole = floor(position);
+    qreal fraction = position - whole;
+
+    /* Wrap around to the table, also for negative angles */
+    int index = int(qint64(whole) & (KEFXCosTableSize - 1));
+
+    const qreal* values = s_cosTable.values;
+    return values[index] + (values[index + 1] - values[index]) * fraction;
+}
+
 /* Supported EFX algorithms */
 
 /*****************************************************************************
@@ -52,6 +88,8 @@ EFX::EFX(Doc* doc) : Function(doc)
     m_xOffset = 127;
     m_yOffset = 127;
     m_rotation = 0;
+    m_rotationCos = 1;
+    m_rotationSin = 0;
 
     m_xFrequency = 2;
     m_yFrequency = 3;
@@ -149,6 +187,8 @@ bool EFX::copyFrom(const Function* function)
     m_xOffset = efx->m_xOffset;
     m_yOffset = efx->m_yOffset;
     m_rotation = efx->m_rotation;
+    m_rotationCos = efx->m_rotationCos;
+    m_rotationSin = efx->m_rotationSin;
 
     m_xFrequency = efx->m_xFrequency;
     m_yFrequency = efx->m_yFrequency;
@@ -292,18 +332,71 @@ void EFX::calculatePoint(qreal iterator, qreal* x, qreal* y) const
     rotateAndScale(x, y);
 }
 
+void EFX::calculatePoints(const qreal* iterators, qreal* x, qreal* y,
+                          int count) const
+{
+    int i;
+
+    switch (algorithm())
+    {
+    default:
+    case Circle:
+        for (i = 0; i < count; i++)
+        {
+            x[i] = tableCos(iterators[i] + M_PI_2);
+            y[i] = tableCos(iterators[i]);
+        }
+        break;
+
+    case Eight:
+        for (i = 0; i < count; i++)
+        {
+            x[i] = tableCos((iterators[i] * 2) + M_PI_2);
+            y[i] = tableCos(iterators[i]);
+        }
+        break;
+
+    case Line:
+        for (i = 0; i < count; i++)
+        {
+            x[i] = tableCos(iterators[i]);
+            y[i] = x[i];
+        }
+        break;
+
+    case Diamond:
+        for (i = 0; i < count; i++)
+        {
+            qreal xx = tableCos(iterators[i] - M_PI_2);
+            qreal yy = tableCos(iterators[i]);
+            x[i] = xx * xx * xx;
+            y[i] = yy * yy * yy;
+        }
+        break;
+
+    case Lissajous:
+        for (i = 0; i < count; i++)
+        {
+            x[i] = tableCos((m_xFrequency * iterators[i]) - m_xPhase);
+            y[i] = tableCos((m_yFrequency * iterators[i]) - m_yPhase);
+        }
+        break;
+    }
+
+    for (i = 0; i < count; i++)
+        rotateAndScale(&x[i], &y[i]);
+}
+
 void EFX::rotateAndScale(qreal* x, qreal* y) const
 {
     qreal xx;
     qreal yy;
-    qreal r;
 
     xx = *x;
     yy = *y;
 
-    r = M_PI/180 * m_rotation;
-    *x = m_xOffset + (xx * cos(r) + yy  * sin(r)) * m_width;
-    *y = m_yOffset + (-xx * sin(r) + yy * cos(r))  * m_height;
+    *x = m_xOffset + (xx * m_rotationCos + yy * m_rotationSin) * m_width;
+    *y = m_yOffset + (-xx * m_rotationSin + yy * m_rotationCos) * m_height;
 }
 
 /*****************************************************************************
@@ -343,6 +436,10 @@ int EFX::height() const
 void EFX::setRotation(int rot)
 {
     m_rotation = static_cast<int> (CLAMP(rot, 0, 359));
+
+    qreal r = M_PI/180 * m_rotation;
+    m_rotationCos = cos(r);
+    m_rotationSin = sin(r);
     emit changed(m_id);
 }
 
@@ -1094,6 +1191,15 @@ void EFX::arm()
         }
     }
 
+    /* Reserve room for every fixture, so that writing doesn't allocate */
+    m_batchFixtures.reserve(m_fixtures.size());
+    m_batchIterators.reserve(m_fixtures.size());
+    m_batchPan.reserve(m_fixtures.size());
+    m_batchTilt.reserve(m_fixtures.size());
+    m_writeChannels.reserve(m_fixtures.size() * 4);
+    m_writeValues.reserve(m_fixtures.size() * 4);
+    m_writeGroups.reserve(m_fixtures.size() * 4);
+
     resetElapsed();
 }
 
@@ -1131,19 +1237,81 @@ void EFX::write(MasterTimer* timer, UniverseArray* universes)
 
     Q_UNUSED(timer);
 
+    /* Advance all fixtures first, then calculate their points in one go */
+    m_batchFixtures.resize(0);
+    m_batchIterators.resize(0);
+
     QListIterator <EFXFixture*> it(m_fixtures);
     while (it.hasNext() == true)
     {
         EFXFixture* ef = it.next();
-        if (ef->isReady() == false)
-            ef->nextStep(universes);
-        else
+        qreal iterator = 0;
+        if (ef->isReady() == true)
+        {
             ready++;
+        }
+        else if (ef->step(universes, &iterator) == true)
+        {
+            m_batchFixtures.append(ef);
+            m_batchIterators.append(iterator);
+        }
     }
 
+    int count = m_batchFixtures.size();
+    m_batchPan.resize(count);
+    m_batchTilt.resize(count);
+    calculatePoints(m_batchIterators.constData(), m_batchPan.data(),
+                    m_batchTilt.data(), count);
+
+    /* Gather coarse & fine pan/tilt values of all fixtures */
+    m_writeChannels.resize(0);
+    m_writeValues.resize(0);
+    m_writeGroups.resize(0);
+
+    for (int i = 0; i < count; i++)
+    {
+        EFXFixture* ef = m_batchFixtures.at(i);
+        qreal pan = m_batchPan.at(i);
+        qreal tilt = m_batchTilt.at(i);
+        ef->m_panValue = pan;
+        ef->m_tiltValue = tilt;
+
+        m_writeChannels.append(ef->m_msbPanChannel);
+        m_writeValues.append(uchar(int(pan)));
+        m_writeGroups.append(QLCChannel::Pan);
+
+        m_writeChannels.append(ef->m_msbTiltChannel);
+        m_writeValues.append(uchar(int(tilt)));
+        m_writeGroups.append(QLCChannel::Tilt);
+
+        if (ef->m_lsbPanChannel != QLCChannel::invalid())
+        {
+            m_writeChannels.append(ef->m_lsbPanChannel);
+            m_writeValues.append(EFXFixture::fineValue(pan));
+            m_writeGroups.append(QLCChannel::Pan);
+        }
+
+        if (ef->m_lsbTiltChannel != QLCChannel::invalid())
+        {
+            m_writeChannels.append(ef->m_lsbTiltChannel);
+            m_writeValues.append(EFXFixture::fineValue(tilt));
+            m_writeGroups.append(QLCChannel::Tilt);
+        }
+    }
+
+    universes->writeBlock(m_writeChannels.constData(),
+                          m_writeValues.constData(),
+                          m_writeGroups.constData(),
+                          m_writeChannels.size());
+
     incrementElapsed();
 
     /* Check for stop condition */
     if (ready == m_fixtures.count())
         stop();
 }
+
+bool EFX::canWriteInParallel() const
+{
+    return true;
+}
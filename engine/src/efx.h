@@ -26,6 +26,7 @@
 #include <QPoint>
 #include <QList>
 
+#include "qlcchannel.h"
 #include "qlctypes.h"
 
 #include "efxfixture.h"
@@ -142,6 +143,20 @@ public:
      */
     void calculatePoint(qreal iterator, qreal* x, qreal* y) const;
 
+    /**
+     * Calculate a batch of points with the currently selected algorithm.
+     * Gives the same points as calculatePoint() for each iterator, within
+     * a millionth of the pattern size, but uses table-based trigonometry
+     * and selects the algorithm only once for the whole batch.
+     *
+     * @param iterators Step numbers (input)
+     * @param x Used to store the calculated X coordinates (output)
+     * @param y Used to store the calculated Y coordinates (output)
+     * @param count The number of items in each of the above arrays
+     */
+    void calculatePoints(const qreal* iterators, qreal* x, qreal* y,
+                         int count) const;
+
     /**
      * Rotate a point of the pattern by rot degrees and scale the point
      * within w/h and xOff/yOff.
@@ -232,6 +247,10 @@ protected:
      */
     int m_rotation;
 
+    /** Cosine & sine of m_rotation, updated by setRotation() */
+    qreal m_rotationCos;
+    qreal m_rotationSin;
+
     /*********************************************************************
      * Offset
      *********************************************************************/
@@ -508,12 +527,27 @@ public:
     /** @reimpl */
     void write(MasterTimer* timer, UniverseArray* universes);
 
+    /** EFX never reads universes, so it can always be written in parallel */
+    bool canWriteInParallel() const;
+
 protected:
     /**
      * The size of one step derived from m_cycleDuration. If m_cycleDuration
      * is 64, then this is 1/64.
      */
     qreal m_stepSize;
+
+    /** Fixtures that have a point to write on the current write() call and
+        the iterators to calculate their points with */
+    QVector <EFXFixture*> m_batchFixtures;
+    QVector <qreal> m_batchIterators;
+    QVector <qreal> m_batchPan;
+    QVector <qreal> m_batchTilt;
+
+    /** Pan & tilt values of all fixtures, for one writeBlock() call */
+    QVector <int> m_writeChannels;
+    QVector <uchar> m_writeValues;
+    QVector <QLCChannel::Group> m_writeGroups;
 };
 
 #endif
@@ -291,12 +291,12 @@ bool EFXFixture::isReady() const
  * Running
  *****************************************************************************/
 
-void EFXFixture::nextStep(UniverseArray* universes)
+bool EFXFixture::step(UniverseArray* universes, qreal* iterator)
 {
     /* Bail out without doing anything if this EFX is ready
       (after single-shot), or it has no pan&tilt channels (not valid). */
     if (m_ready == true || isValid() == false)
-        return;
+        return false;
 
     if (m_iterator == 0)
         updateSkipThreshold();
@@ -324,17 +324,11 @@ void EFXFixture::nextStep(UniverseArray* universes)
         }
 
         if (m_runTimeDirection == Function::Forward)
-        {
-            m_parent->calculatePoint(m_iterator, &m_panValue, &m_tiltValue);
-        }
+            *iterator = m_iterator;
         else
-        {
-            m_parent->calculatePoint((M_PI * 2.0) - m_iterator,
-                                     &m_panValue, &m_tiltValue);
-        }
+            *iterator = (M_PI * 2.0) - m_iterator;
 
-        /* Write this fixture's data to universes. */
-        setPoint(universes);
+        return true;
     }
     else
     {
@@ -359,6 +353,20 @@ void EFXFixture::nextStep(UniverseArray* universes)
 
         /* Reset iterator, since we've gone a full cycle. */
         m_iterator = 0;
+
+        return false;
+    }
+}
+
+void EFXFixture::nextStep(UniverseArray* universes)
+{
+    qreal iterator = 0;
+    if (step(universes, &iterator) == true)
+    {
+        m_parent->calculatePoint(iterator, &m_panValue, &m_tiltValue);
+
+        /* Write this fixture's data to universes. */
+        setPoint(universes);
     }
 }
 
@@ -400,17 +408,19 @@ void EFXFixture::setPoint(UniverseArray* universes)
     /* Write fine point data to universes if applicable */
     if (m_lsbPanChannel != QLCChannel::invalid())
     {
-        /* Leave only the fraction */
-        char value = static_cast<char> ((m_panValue - floor(m_panValue))
-                                        * double(UCHAR_MAX));
-        universes->write(m_lsbPanChannel, value, QLCChannel::Pan);
+        universes->write(m_lsbPanChannel, fineValue(m_panValue),
+                         QLCChannel::Pan);
     }
 
     if (m_lsbTiltChannel != QLCChannel::invalid())
     {
-        /* Leave only the fraction */
-        char value = static_cast<char> ((m_tiltValue - floor(m_tiltValue))
-                                        * double(UCHAR_MAX));
-        universes->write(m_lsbTiltChannel, value, QLCChannel::Tilt);
+        universes->write(m_lsbTiltChannel, fineValue(m_tiltValue),
+                         QLCChannel::Tilt);
     }
 }
+
+uchar EFXFixture::fineValue(qreal value)
+{
+    /* Leave only the fraction */
+    return uchar((value - floor(value)) * double(UCHAR_MAX));
+}
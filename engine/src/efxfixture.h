@@ -214,11 +214,27 @@ protected:
      * Running
      *********************************************************************/
 protected:
-    /** Calculate the next step data for this fixture */
+    /**
+     * Advance this fixture to its next step without calculating the point.
+     * Runs start & stop scenes as necessary.
+     *
+     * @param universes The universes to write scene values to
+     * @param iterator Set to the iterator to calculate the point with
+     * @return true if the fixture has a point to write, otherwise false
+     */
+    bool step(UniverseArray* universes, qreal* iterator);
+
+    /** Calculate the next step data for this fixture and write it */
     void nextStep(UniverseArray* universes);
 
     /** Write this EFXFixture's channel data to universes */
     void setPoint(UniverseArray* universes);
+
+    /**
+     * Get the fine (LSB) channel value for a pan/tilt value, which is the
+     * fraction left over from the coarse (MSB) value scaled to 0-255.
+     */
+    static uchar fineValue(qreal value);
 };
 
 #endif
@@ -0,0 +1,268 @@
+/*
+  Q Light Controller
+  fadeplan.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtAlgorithms>
+
+#include "universearray.h"
+#include "fadeplan.h"
+
+/** Orders indices to a FadePlan's channels by the channels' addresses */
+class AddressLessThan
+{
+public:
+    AddressLessThan(const QVector <int>& addresses) : m_addresses(addresses) { }
+
+    bool operator()(int a, int b) const
+    {
+        return m_addresses.at(a) < m_addresses.at(b);
+    }
+
+private:
+    const QVector <int>& m_addresses;
+};
+
+/** Reorder $vector so that its i'th item is the old $order[i]'th item */
+template <typename T>
+static void permute(QVector <T>& vector, const QVector <int>& order)
+{
+    QVector <T> copy(vector);
+    for (int i = 0; i < order.size(); i++)
+        vector[i] = copy.at(order.at(i));
+}
+
+/****************************************************************************
+ * Initialization
+ ****************************************************************************/
+
+FadePlan::FadePlan()
+    : m_finishCached(false)
+{
+}
+
+FadePlan::~FadePlan()
+{
+}
+
+/****************************************************************************
+ * Building
+ ****************************************************************************/
+
+void FadePlan::clear()
+{
+    m_fixtures.resize(0);
+    m_addresses.resize(0);
+    m_groups.resize(0);
+    m_starts.resize(0);
+    m_targets.resize(0);
+    m_current.resize(0);
+    m_ready.resize(0);
+
+    m_finishAddresses.resize(0);
+    m_finishValues.resize(0);
+    m_finishGroups.resize(0);
+    m_finishCached = false;
+}
+
+void FadePlan::append(quint32 fixture, int address, QLCChannel::Group group,
+                      uchar target)
+{
+    m_fixtures.append(fixture);
+    m_addresses.append(address);
+    m_groups.append(group);
+    m_starts.append(0);
+    m_targets.append(target);
+    m_current.append(0);
+    m_ready.append(0);
+}
+
+void FadePlan::sort()
+{
+    QVector <int> order(size());
+    for (int i = 0; i < order.size(); i++)
+        order[i] = i;
+
+    qStableSort(order.begin(), order.end(), AddressLessThan(m_addresses));
+
+    permute(m_fixtures, order);
+    permute(m_addresses, order);
+    permute(m_groups, order);
+    permute(m_starts, order);
+    permute(m_targets, order);
+    permute(m_current, order);
+    permute(m_ready, order);
+
+    /* Reserve the finish block now, so that running doesn't allocate */
+    m_finishAddresses.reserve(size());
+    m_finishValues.reserve(size());
+    m_finishGroups.reserve(size());
+    m_finishCached = false;
+}
+
+int FadePlan::size() const
+{
+    return m_addresses.size();
+}
+
+/****************************************************************************
+ * Channels
+ ****************************************************************************/
+
+quint32 FadePlan::fixture(int index) const
+{
+    return m_fixtures.at(index);
+}
+
+int FadePlan::address(int index) const
+{
+    return m_addresses.at(index);
+}
+
+QLCChannel::Group FadePlan::group(int index) const
+{
+    return m_groups.at(index);
+}
+
+uchar FadePlan::start(int index) const
+{
+    return uchar(m_starts.at(index));
+}
+
+uchar FadePlan::target(int index) const
+{
+    return uchar(m_targets.at(index));
+}
+
+uchar FadePlan::current(int index) const
+{
+    return m_current.at(index);
+}
+
+bool FadePlan::isReady(int index) const
+{
+    return (m_ready.at(index) != 0);
+}
+
+/****************************************************************************
+ * Fading
+ ****************************************************************************/
+
+int FadePlan::begin(const UniverseArray* universes)
+{
+    Q_ASSERT(universes != NULL);
+
+    int ready = 0;
+    for (int i = 0; i < size(); i++)
+    {
+        m_starts[i] = universes->preGMValue(m_addresses.at(i));
+        m_current[i] = uchar(m_starts.at(i));
+
+        /* Don't touch the value at all if it's already on target */
+        if (m_starts.at(i) == m_targets.at(i))
+        {
+            m_ready[i] = 1;
+            if (m_groups.at(i) != QLCChannel::Intensity)
+                ready++;
+        }
+        else
+        {
+            m_ready[i] = 0;
+        }
+    }
+
+    m_finishCached = false;
+
+    return ready;
+}
+
+void FadePlan::fade(UniverseArray* universes, quint32 fadeTime,
+                    quint32 elapsed)
+{
+    Q_ASSERT(universes != NULL);
+    Q_ASSERT(elapsed < fadeTime);
+
+    // Same calculation as in FadeChannel::calculateCurrent(), with the time
+    // scale shared by all channels. Channels that are ready have their start
+    // equal to target, so they don't need to be handled separately.
+    qreal timeScale = qreal(elapsed + 1.0) / qreal(fadeTime + 1.0);
+
+    const qint32* starts = m_starts.constData();
+    const qint32* targets = m_targets.constData();
+    uchar* current = m_current.data();
+    int count = size();
+
+    for (int i = 0; i < count; i++)
+    {
+        qint32 delta = targets[i] - starts[i];
+        current[i] = uchar(qint32(qreal(delta) * timeScale) + starts[i]);
+    }
+
+    universes->writeBlock(m_addresses.constData(), current,
+                          m_groups.constData(), count);
+}
+
+int FadePlan::finish(UniverseArray* universes)
+{
+    Q_ASSERT(universes != NULL);
+
+    int readied = 0;
+
+    if (m_finishCached == false)
+    {
+        m_finishAddresses.resize(0);
+        m_finishValues.resize(0);
+        m_finishGroups.resize(0);
+
+        for (int i = 0; i < size(); i++)
+        {
+            if (m_groups.at(i) == QLCChannel::Intensity)
+            {
+                // Keep intensity channels up for as long as the scene runs
+                m_ready[i] = 1;
+            }
+            else if (m_ready.at(i) == 0)
+            {
+                // Write LTP channels just once so that they stay LTP
+                m_ready[i] = 1;
+                readied++;
+            }
+            else
+            {
+                continue;
+            }
+
+            m_current[i] = uchar(m_targets.at(i));
+            m_finishAddresses.append(m_addresses.at(i));
+            m_finishValues.append(uchar(m_targets.at(i)));
+            m_finishGroups.append(m_groups.at(i));
+        }
+
+        /* Without new ready channels, the next block would be the same */
+        if (readied == 0)
+            m_finishCached = true;
+    }
+
+    universes->writeBlock(m_finishAddresses.constData(),
+                          m_finishValues.constData(),
+                          m_finishGroups.constData(),
+                          m_finishAddresses.size());
+
+    return readied;
+}
@@ -0,0 +1,139 @@
+/*
+  Q Light Controller
+  fadeplan.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef FADEPLAN_H
+#define FADEPLAN_H
+
+#include <QVector>
+
+#include "qlcchannel.h"
+
+class UniverseArray;
+
+/**
+ * FadePlan is a precompiled list of channels that a Scene fades from their
+ * starting values to their targets. Instead of a list of FadeChannel objects,
+ * the plan keeps each property in an array of its own and the channels are
+ * sorted by their absolute DMX address, so that a whole fade step can be
+ * calculated in one tight loop and written to universes in address order
+ * with a single UniverseArray::write() call.
+ *
+ * Channels with the same address keep the order they were added in, so
+ * HTP and LTP resolve exactly as if the channels were written one by one.
+ */
+class FadePlan
+{
+public:
+    FadePlan();
+    ~FadePlan();
+
+    /************************************************************************
+     * Building
+     ************************************************************************/
+public:
+    /** Remove all channels from the plan, keeping the allocated memory */
+    void clear();
+
+    /**
+     * Add a channel to the plan. Call sort() after all channels have been
+     * added.
+     *
+     * @param fixture The ID of the fixture that the channel belongs to
+     * @param address The channel's absolute DMX address
+     * @param group The channel's channel group
+     * @param target The channel's target value
+     */
+    void append(quint32 fixture, int address, QLCChannel::Group group,
+                uchar target);
+
+    /** Sort the channels by address, keeping the order of equal addresses */
+    void sort();
+
+    /** Get the number of channels in the plan */
+    int size() const;
+
+    /************************************************************************
+     * Channels
+     ************************************************************************/
+public:
+    quint32 fixture(int index) const;
+    int address(int index) const;
+    QLCChannel::Group group(int index) const;
+    uchar start(int index) const;
+    uchar target(int index) const;
+    uchar current(int index) const;
+    bool isReady(int index) const;
+
+    /************************************************************************
+     * Fading
+     ************************************************************************/
+public:
+    /**
+     * Take the channels' current values from $universes as their starting
+     * values. Channels that are already on target are marked ready and the
+     * rest are marked not ready.
+     *
+     * @param universes The universes to read starting values from
+     * @return The number of ready non-intensity channels
+     */
+    int begin(const UniverseArray* universes);
+
+    /**
+     * Calculate the current value of each channel when $elapsed ticks of
+     * $fadeTime have passed and write them to $universes. Values are the
+     * same as FadeChannel::calculateCurrent() gives. Must not be called
+     * when elapsed >= fadeTime.
+     *
+     * @param universes The universes to write to
+     * @param fadeTime Number of ticks to fade from start to target
+     * @param elapsed Number of ticks already spent
+     */
+    void fade(UniverseArray* universes, quint32 fadeTime, quint32 elapsed);
+
+    /**
+     * Write target values after the fade time has been consumed. Intensity
+     * channels are written on every call to keep them up. Other channels
+     * are written only once and then marked ready, so that they stay LTP.
+     *
+     * @param universes The universes to write to
+     * @return The number of non-intensity channels that became ready
+     */
+    int finish(UniverseArray* universes);
+
+protected:
+    QVector <quint32> m_fixtures;
+    QVector <int> m_addresses;
+    QVector <QLCChannel::Group> m_groups;
+    QVector <qint32> m_starts;
+    QVector <qint32> m_targets;
+    QVector <uchar> m_current;
+    QVector <uchar> m_ready;
+
+    /** Channels written by finish(), gathered from the arrays above. Once
+        all non-intensity channels are ready, the same block is written on
+        every call, so it is gathered only once. */
+    QVector <int> m_finishAddresses;
+    QVector <uchar> m_finishValues;
+    QVector <QLCChannel::Group> m_finishGroups;
+    bool m_finishCached;
+};
+
+#endif
@@ -127,7 +127,7 @@ bool Fixture::isDimmer() const
 
 void Fixture::setUniverse(quint32 universe)
 {
-    /* The universe part is stored in the highest 7 bits */
+    /* The universe part is stored above the lowest 9 bits */
     m_address = (m_address & 0x01FF) | (universe << 9);
 
     emit changed(m_id);
@@ -135,7 +135,7 @@ void Fixture::setUniverse(quint32 universe)
 
 quint32 Fixture::universe() const
 {
-    /* The universe part is stored in the highest 7 bits */
+    /* The universe part is stored above the lowest 9 bits */
     return (m_address >> 9);
 }
 
@@ -150,7 +150,7 @@ void Fixture::setAddress(quint32 address)
         return;
 
     /* The address part is stored in the lowest 9 bits */
-    m_address = (m_address & 0xFE00) | (address & 0x01FF);
+    m_address = (m_address & ~quint32(0x01FF)) | (address & 0x01FF);
 
     emit changed(m_id);
 }
@@ -266,6 +266,43 @@ QSet <quint32> Fixture::channels(const QString& name, Qt::CaseSensitivity cs,
     return set;
 }
 
+QList <QPair <quint32,quint32> > Fixture::fineChannels() const
+{
+    QList <QPair <quint32,quint32> > pairs;
+    if (m_fixtureDef == NULL || m_fixtureMode == NULL)
+        return pairs;
+
+    QList <QLCChannel::Group> groups;
+    groups << QLCChannel::Pan << QLCChannel::Tilt;
+
+    QListIterator <QLCChannel::Group> it(groups);
+    while (it.hasNext() == true)
+    {
+        QLCChannel::Group group = it.next();
+        quint32 msb = QLCChannel::invalid();
+        quint32 lsb = QLCChannel::invalid();
+
+        /* The first MSB & LSB channels of the group make the pair */
+        for (quint32 i = 0; i < quint32(m_fixtureMode->channels().size()); i++)
+        {
+            const QLCChannel* ch = m_fixtureMode->channel(i);
+            Q_ASSERT(ch != NULL);
+
+            if (ch->group() != group)
+                continue;
+            else if (ch->controlByte() == QLCChannel::MSB && msb == QLCChannel::invalid())
+                msb = i;
+            else if (ch->controlByte() == QLCChannel::LSB && lsb == QLCChannel::invalid())
+                lsb = i;
+        }
+
+        if (msb != QLCChannel::invalid() && lsb != QLCChannel::invalid())
+            pairs << QPair <quint32,quint32> (msb, lsb);
+    }
+
+    return pairs;
+}
+
 void Fixture::createGenericChannel()
 {
     if (m_genericChannel == NULL)
@@ -462,7 +499,7 @@ bool Fixture::loadXML(const QDomElement* root,
     }
 
     /* Make sure that universe is something sensible */
-    if (universe >= KUniverseCount)
+    if (universe >= KUniverseCountMax)
     {
         qWarning() << Q_FUNC_INFO << "Fixture universe" << universe << "out of bounds";
         universe = 0;
@@ -23,6 +23,7 @@
 #define FIXTURE_H
 
 #include <QObject>
+#include <QPair>
 #include <QList>
 
 #include "qlcchannel.h"
@@ -251,6 +252,14 @@ public:
                     Qt::CaseSensitivity cs = Qt::CaseSensitive,
                     QLCChannel::Group group = QLCChannel::NoGroup) const;
 
+    /**
+     * Get the channels that together hold 16-bit pan & tilt values, as
+     * (MSB, LSB) pairs of channel numbers. Generic dimmers have none.
+     *
+     * @return A list of (coarse, fine) channel number pairs
+     */
+    QList <QPair <quint32,quint32> > fineChannels() const;
+
 protected:
     /** Create a generic intensity channel */
     void createGenericChannel();
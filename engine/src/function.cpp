@@ -64,6 +64,10 @@ Function::Function(Doc* doc) : QObject(doc)
     m_flashing = false;
     m_elapsed = 0;
     m_stop = true;
+    m_initiatedByOtherFunction = false;
+    m_stopCount = 0;
+    m_timerListed = 0;
+    m_profileSlot = -1;
 }
 
 Function::~Function()
@@ -375,16 +379,19 @@ void Function::preRun(MasterTimer* timer)
     emit running(m_id);
 }
 
+bool Function::canWriteInParallel() const
+{
+    return false;
+}
+
 void Function::postRun(MasterTimer* timer, UniverseArray* universes)
 {
     Q_UNUSED(timer);
     Q_UNUSED(universes);
 
-    m_stopMutex.lock();
     resetElapsed();
     m_stop = true;
-    m_functionStopped.wakeAll();
-    m_stopMutex.unlock();
+    m_stopCount.ref();
     emit stopped(m_id);
 }
 
@@ -398,6 +405,11 @@ void Function::setInitiatedByOtherFunction(bool state)
     m_initiatedByOtherFunction = state;
 }
 
+quint32 Function::stopCount() const
+{
+    return quint32(int(m_stopCount));
+}
+
 /*****************************************************************************
  * Elapsed ticks while running
  *****************************************************************************/
@@ -430,30 +442,3 @@ bool Function::stopped() const
 {
     return m_stop;
 }
-
-bool Function::stopAndWait()
-{
-    bool result = true;
-
-    m_stopMutex.lock();
-    m_stop = true;
-
-    QTime watchdog;
-    watchdog.start();
-
-    // block thread for maximum 2 seconds
-    while (m_elapsed > 0)
-    {
-        if (watchdog.elapsed() > 2000)
-        {
-              result = false;
-              break;
-        }
-
-        // wait until the function has stopped
-        m_functionStopped.wait(&m_stopMutex, 100);
-    }
-
-    m_stopMutex.unlock();
-    return result;
-}
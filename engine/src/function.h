@@ -22,10 +22,9 @@
 #ifndef FUNCTION_H
 #define FUNCTION_H
 
-#include <QWaitCondition>
+#include <QAtomicInt>
 #include <QObject>
 #include <QString>
-#include <QMutex>
 #include <QList>
 
 #include "qlctypes.h"
@@ -62,6 +61,8 @@ class Function : public QObject
     Q_OBJECT
     Q_DISABLE_COPY(Function)
 
+    friend class MasterTimer;
+
 public:
     /*********************************************************************
      * Initialization
@@ -347,10 +348,10 @@ public:
     virtual void disarm() = 0;
 
     /**
-     * Called by MasterTimer when the function is started. MasterTimer's
-     * function list mutex is locked during this call, so functions must
-     * not attempt to start/stop additional functions from their preRun()
-     * methods because it would result in a deadlock.
+     * Called by MasterTimer when the function is started. MasterTimer is
+     * going thru its list of running functions during this call, so
+     * functions must not attempt to start/stop additional functions from
+     * their preRun() methods.
      *
      * @param timer The MasterTimer instance that takes care of running
      *              the function in correct intervals.
@@ -374,14 +375,27 @@ public:
      */
     virtual void write(MasterTimer* timer, UniverseArray* universes) = 0;
 
+    /**
+     * Check, whether MasterTimer may call write() in a render thread of
+     * its own, in parallel with other functions' write() calls. This is
+     * never done on the function's first pass (elapsed() == 0).
+     *
+     * Functions that return true must not read values from the universes,
+     * start or stop other functions or emit signals in write(), since the
+     * given universes are just a UniverseLayer view that records the writes.
+     *
+     * @return true if write() is safe to call in parallel, otherwise false
+     */
+    virtual bool canWriteInParallel() const;
+
     /**
      * Called by MasterTimer when the function is stopped. No more write()
      * calls will arrive to the function after this call. The function may
      * still write its last data packet to universes during this call.
-     * Used by e.g. EFX to write its stop scene values. MasterTimer's
-     * function list mutex is locked during this call, so functions must
-     * not attempt to start/stop additional functions from their postRun()
-     * methods because it would result in a deadlock.
+     * Used by e.g. EFX to write its stop scene values. MasterTimer is
+     * going thru its list of running functions during this call, so
+     * functions must not attempt to start additional functions from their
+     * postRun() methods. Marking them stopped with stop() is fine.
      *
      * @param timer The MasterTimer that has stopped running the function
      * @param universes Universe buffer to write the function's exit data
@@ -403,6 +417,16 @@ public:
      */
     void setInitiatedByOtherFunction(bool state);
 
+    /**
+     * Get the number of times the function has been stopped, i.e. how many
+     * times postRun() has been called. Whoever starts the function can take
+     * the count and later tell whether that run has finished by comparing
+     * it to the current count, instead of listening to stopped().
+     *
+     * @return Number of finished runs
+     */
+    quint32 stopCount() const;
+
 signals:
     /**
      * Emitted when a function is started (i.e. added to MasterTimer's
@@ -423,6 +447,17 @@ signals:
 private:
     bool m_initiatedByOtherFunction;
 
+    /** Incremented in postRun(), read from any thread */
+    QAtomicInt m_stopCount;
+
+    /** Non-zero from MasterTimer::startFunction() until MasterTimer has
+        removed the function from its list of running functions */
+    QAtomicInt m_timerListed;
+
+    /** Index of this function's costs in MasterTimer's tick profile, set
+        by MasterTimer when it takes the function into its list */
+    int m_profileSlot;
+
     /*********************************************************************
      * Elapsed
      *********************************************************************/
@@ -464,21 +499,9 @@ public:
      */
     virtual bool stopped() const;
 
-    /**
-     * Mark the function to be stopped and block the calling thread until it is
-     * actually stopped. To prevent deadlocks the function only waits for 2s.
-     *
-     * @return true if the function was stopped. false if the function did not
-     *              stop withing two seconds
-     */
-    bool stopAndWait();
-
 private:
     /** Stop flag, private to keep functions from modifying it. */
     bool m_stop;
-
-    QMutex m_stopMutex;
-    QWaitCondition m_functionStopped;
 };
 
 #endif
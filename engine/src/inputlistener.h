@@ -0,0 +1,49 @@
+/*
+  Q Light Controller
+  inputlistener.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef INPUTLISTENER_H
+#define INPUTLISTENER_H
+
+#include <QtGlobal>
+
+/**
+ * InputListener should be inherited/implemented by such objects that wish
+ * to receive values from specific input universe & channel pairs. Listeners
+ * are added to InputMap with InputMap::addListener(), which then delivers
+ * only the values of those particular channels to them.
+ */
+class InputListener
+{
+public:
+    virtual ~InputListener() {}
+
+    /**
+     * Receive a value from an input channel that this listener has been
+     * added to.
+     *
+     * @param universe The input universe that the value came from
+     * @param channel The input channel that the value came from
+     * @param value The new value
+     */
+    virtual void receiveInput(quint32 universe, quint32 channel, uchar value) = 0;
+};
+
+#endif
@@ -34,11 +34,13 @@
 
 #include "qlcinputchannel.h"
 #include "qlcinplugin.h"
+#include "qlcclock.h"
 #include "qlcconfig.h"
 #include "qlctypes.h"
 #include "qlcfile.h"
 #include "qlci18n.h"
 
+#include "inputlistener.h"
 #include "inputpatch.h"
 #include "inputmap.h"
 
@@ -86,6 +88,19 @@ quint32 InputMap::universes() const
     return m_universes;
 }
 
+void InputMap::setUniverses(quint32 universes)
+{
+    universes = MIN(universes, KUniverseCountMax);
+    if (universes <= m_universes)
+        return;
+
+    for (quint32 i = m_universes; i < universes; i++)
+        m_patch.append(new InputPatch(this));
+    m_universes = universes;
+
+    emit universesChanged(universes);
+}
+
 quint32 InputMap::editorUniverse() const
 {
     return m_editorUniverse;
@@ -109,12 +124,18 @@ void InputMap::slotValueChanged(quint32 input, quint32 channel, uchar value)
     if (plugin == NULL)
         return;
 
+    /* Plugins that don't know when the value was received get it now */
+    qint64 timestamp = plugin->valueTimestamp();
+    if (timestamp == 0)
+        timestamp = QLCClock::monotonicTime();
+
     for (quint32 i = 0; i < m_universes; i++)
     {
         if (m_patch[i]->plugin() == plugin &&
                 m_patch[i]->input() == input)
         {
             emit inputValueChanged(i, channel, value);
+            queueRoutedValue(i, channel, value, timestamp);
         }
     }
 }
@@ -145,6 +166,132 @@ void InputMap::slotConfigurationChanged()
         emit pluginConfigurationChanged(plugin->name());
 }
 
+/*****************************************************************************
+ * Input routing
+ *****************************************************************************/
+
+void InputMap::addListener(quint32 universe, quint32 channel,
+                           InputListener* listener)
+{
+    Q_ASSERT(listener != NULL);
+
+    if (universe >= KUniverseCountMax || channel == KInputChannelInvalid)
+        return;
+
+    QList <InputListener*>& list = m_routes[routeKey(universe, channel)];
+    if (list.contains(listener) == false)
+        list.append(listener);
+}
+
+void InputMap::removeListener(quint32 universe, quint32 channel,
+                              InputListener* listener)
+{
+    quint64 key = routeKey(universe, channel);
+
+    QHash <quint64, QList <InputListener*> >::iterator it = m_routes.find(key);
+    if (it == m_routes.end())
+        return;
+
+    it.value().removeAll(listener);
+    if (it.value().isEmpty() == true)
+        m_routes.erase(it);
+}
+
+void InputMap::removeListener(InputListener* listener)
+{
+    QMutableHashIterator <quint64, QList <InputListener*> > it(m_routes);
+    while (it.hasNext() == true)
+    {
+        it.next();
+        it.value().removeAll(listener);
+        if (it.value().isEmpty() == true)
+            it.remove();
+    }
+}
+
+QList <InputListener*> InputMap::listeners(quint32 universe,
+                                           quint32 channel) const
+{
+    return m_routes.value(routeKey(universe, channel));
+}
+
+quint64 InputMap::routeKey(quint32 universe, quint32 channel)
+{
+    return (quint64(universe) << 32) | quint64(channel);
+}
+
+void InputMap::queueRoutedValue(quint32 universe, quint32 channel, uchar value,
+                                qint64 timestamp)
+{
+    quint64 key = routeKey(universe, channel);
+    if (m_routes.contains(key) == false)
+        return;
+
+    /* Replace the channel's pending value, unless either one of them is
+       zero, so that presses and releases get delivered separately. The
+       pending value's timestamp is kept, since it's the oldest one. */
+    QHash <quint64, int>::const_iterator it = m_routedIndex.find(key);
+    if (it != m_routedIndex.end())
+    {
+        RoutedValue& pending = m_routedValues[it.value()];
+        if (pending.value != 0 && value != 0)
+        {
+            pending.value = value;
+            return;
+        }
+    }
+
+    /* The first queued value posts a delivery event for the whole batch.
+       Plugin values that have already been posted to the event queue get
+       into the same batch, since they are processed before the delivery. */
+    if (m_routedValues.isEmpty() == true)
+    {
+        QMetaObject::invokeMethod(this, "slotDeliverRoutedValues",
+                                  Qt::QueuedConnection);
+    }
+
+    RoutedValue routed;
+    routed.universe = universe;
+    routed.channel = channel;
+    routed.value = value;
+    routed.timestamp = timestamp;
+    m_routedIndex[key] = m_routedValues.size();
+    m_routedValues.append(routed);
+}
+
+void InputMap::slotDeliverRoutedValues()
+{
+    /* Take the batch, since listeners may cause new values to be queued */
+    QVector <RoutedValue> batch(m_routedValues);
+    m_routedValues.clear();
+    m_routedIndex.clear();
+
+    qint64 oldest = 0;
+    for (int i = 0; i < batch.size(); i++)
+    {
+        const RoutedValue& routed = batch.at(i);
+        quint64 key = routeKey(routed.universe, routed.channel);
+
+        if (oldest == 0 || routed.timestamp < oldest)
+            oldest = routed.timestamp;
+
+        /* Iterate over a copy, since listeners may add or remove listeners.
+           Skip those that have been removed (and possibly deleted) by an
+           earlier value or listener during the delivery. */
+        QList <InputListener*> list(m_routes.value(key));
+        QListIterator <InputListener*> it(list);
+        while (it.hasNext() == true)
+        {
+            InputListener* listener = it.next();
+            if (m_routes.value(key).contains(listener) == true)
+                listener->receiveInput(routed.universe, routed.channel, routed.value);
+        }
+    }
+
+    if (batch.isEmpty() == false)
+        emit inputDelivered(oldest);
+}
+
 /*****************************************************************************
  * Patch
  *****************************************************************************/
@@ -556,6 +703,15 @@ void InputMap::loadDefaults()
     QString input;
     QString key;
 
+    /* Grow to hold all universes that have been patched before */
+    for (quint32 i = m_universes; i < KUniverseCountMax; i++)
+    {
+        key = QString("/inputmap/universe%2/plugin/").arg(i);
+        plugin = settings.value(key).toString();
+        if (plugin.length() > 0 && plugin != KInputNone)
+            setUniverses(i + 1);
+    }
+
     /* Editor universe */
     key = QString("/inputmap/editoruniverse/");
     value = settings.value(key);
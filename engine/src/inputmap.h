@@ -24,12 +24,14 @@
 
 #include <QObject>
 #include <QVector>
+#include <QHash>
 #include <QList>
 #include <QDir>
 
 #include "qlcinputprofile.h"
 #include "qlctypes.h"
 
+class InputListener;
 class QLCInPlugin;
 class InputPatch;
 class InputMap;
@@ -82,12 +84,113 @@ public:
     bool feedBack(quint32 universe, quint32 channel, uchar value);
 
 signals:
-    /** Everyone interested in input data should connect to this signal */
+    /**
+     * Emitted for each input value. Objects interested in all input data
+     * should connect to this signal. Those interested in specific channels
+     * only should use addListener() instead.
+     */
     void inputValueChanged(quint32 universe, quint32 channel, uchar value);
 
     /** Notifies (InputManager) of plugin configuration changes */
     void pluginConfigurationChanged(const QString& pluginName);
 
+    /*************************************************************************
+     * Input routing
+     *************************************************************************/
+public:
+    /**
+     * Deliver values from the given input universe & channel to the given
+     * listener. Unlike inputValueChanged(), which goes to everyone for every
+     * value, routed values go only to the listeners of each channel.
+     *
+     * Routed values are delivered in batches from the event loop. If more
+     * than one value arrives for a channel before its batch is delivered,
+     * only the latest one is delivered, unless the value goes to or from
+     * zero in between. So button presses and releases are never lost.
+     *
+     * @param universe The input universe to listen to
+     * @param channel The input channel to listen to
+     * @param listener The listener to deliver values to
+     */
+    void addListener(quint32 universe, quint32 channel,
+                     InputListener* listener);
+
+    /**
+     * Stop delivering values from the given input universe & channel to
+     * the given listener.
+     *
+     * @param universe The input universe to stop listening to
+     * @param channel The input channel to stop listening to
+     * @param listener The listener to remove
+     */
+    void removeListener(quint32 universe, quint32 channel,
+                        InputListener* listener);
+
+    /**
+     * Stop delivering values from all universes & channels to the given
+     * listener. This should be called in the listener's destructor at the
+     * latest, unless the listener has removed itself from each of its
+     * channels already.
+     *
+     * @param listener The listener to remove
+     */
+    void removeListener(InputListener* listener);
+
+    /** Get the listeners of the given input universe & channel */
+    QList <InputListener*> listeners(quint32 universe, quint32 channel) const;
+
+protected:
+    /** Make a routing table key from an input universe & channel */
+    static quint64 routeKey(quint32 universe, quint32 channel);
+
+    /**
+     * Queue a value for delivery to the channel's listeners
+     *
+     * @param universe The input universe that the value came from
+     * @param channel The input channel that the value came from
+     * @param value The new value
+     * @param timestamp The time when the plugin received the value, in
+     *                  QLCClock::monotonicTime() nanoseconds
+     */
+    void queueRoutedValue(quint32 universe, quint32 channel, uchar value,
+                          qint64 timestamp);
+
+protected slots:
+    /** Deliver all queued values to their listeners */
+    void slotDeliverRoutedValues();
+
+signals:
+    /**
+     * Emitted when a batch of routed values has been delivered to their
+     * listeners. MasterTimer uses this to measure input latency.
+     *
+     * @param timestamp The time when the oldest value in the batch was
+     *                  received, in QLCClock::monotonicTime() nanoseconds
+     */
+    void inputDelivered(qint64 timestamp);
+
+protected:
+    /** A value waiting for delivery */
+    struct RoutedValue
+    {
+        quint32 universe;
+        quint32 channel;
+        uchar value;
+
+        /** When the oldest of the values merged into this one was
+            received */
+        qint64 timestamp;
+    };
+
+    /** Listeners for each routeKey() */
+    QHash <quint64, QList <InputListener*> > m_routes;
+
+    /** Values waiting for delivery, in the order they arrived */
+    QVector <RoutedValue> m_routedValues;
+
+    /** Index of each routeKey()'s latest value in m_routedValues */
+    QHash <quint64, int> m_routedIndex;
+
     /*************************************************************************
      * Universes
      *************************************************************************/
@@ -102,6 +205,21 @@ public:
      */
     quint32 universes() const;
 
+public slots:
+    /**
+     * Grow the number of input universes. Existing universes and their
+     * patches are kept as they are. The number of universes never shrinks
+     * and it can't exceed KUniverseCountMax.
+     *
+     * @param universes The new number of input universes
+     */
+    void setUniverses(quint32 universes);
+
+signals:
+    /** Signal that the number of input universes has changed */
+    void universesChanged(quint32 universes);
+
+public:
     /**
      * Get the universe that is used for editing functions etc.
      */
@@ -19,30 +19,45 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QSettings>
 #include <QThread>
 #include <QDebug>
 #include <QTime>
 
-#ifndef WIN32
-#include <sys/types.h>
-#include <sys/time.h>
-#include <stdlib.h>
-#include <unistd.h>
-#include <stdio.h>
-#include <fcntl.h>
-#include <errno.h>
-#else
-#include <windows.h>
-#endif
-
+#include "universelayer.h"
 #include "universearray.h"
+#include "renderworker.h"
 #include "mastertimer.h"
 #include "outputmap.h"
 #include "dmxsource.h"
 #include "function.h"
 
+#include "qlcclock.h"
+#include "qlctypes.h"
+
+#define KDefaultFrequency 50
+#define KMinFrequency     10
+#define KMaxFrequency     1000
+
+#define KMaxRenderThreads 16
+
+#define KHistogramSize     32
+#define KHistogramBinWidth 100 // Microseconds
+
+/* Must be a power of two */
+#define KCommandRingSize 1024
+
+#define SETTINGS_FREQUENCY "/mastertimer/frequency"
+#define SETTINGS_RENDERTHREADS "/mastertimer/renderthreads"
+#define SETTINGS_PROFILING "/mastertimer/profiling"
+
+/** How often the timer thread publishes its profile (nanoseconds) */
+#define KProfilePublishInterval Q_INT64_C(250000000)
+
 /** The timer tick frequency in Hertz */
-const quint32 MasterTimer::s_frequency = 50;
+QAtomicInt MasterTimer::s_frequency(KDefaultFrequency);
+QAtomicInt MasterTimer::s_requestedFrequency(KDefaultFrequency);
+QAtomicInt MasterTimer::s_timerThreads(0);
 
 /*****************************************************************************
  * Initialization
@@ -51,19 +66,83 @@ const quint32 MasterTimer::s_frequency = 50;
 MasterTimer::MasterTimer(QObject* parent, OutputMap* outputMap)
         : QThread(parent),
         m_outputMap(outputMap),
-        m_stopAllFunctions(false),
-        m_running(false)
+        m_runningFunctions(0),
+        m_commandRing(new Command[KCommandRingSize]),
+        m_commandHead(0),
+        m_commandTail(0),
+        m_finishedCommands(0),
+        m_tickWaiters(0),
+        m_renderThreads(defaultRenderThreads()),
+        m_batchSize(0),
+        m_nextBatched(0),
+        m_running(false),
+        m_latenessHistogram(KHistogramSize, 0),
+        m_jitterHistogram(KHistogramSize, 0),
+        m_statisticsSequence(0),
+        m_statisticsReset(0),
+        m_profiling(false),
+        m_tickProfiling(false),
+        m_profileReset(0),
+        m_profilePublished(0),
+        m_inputTimestamp(0)
 {
+    /* Each slot is free for the first round of positions */
+    for (int i = 0; i < KCommandRingSize; i++)
+        m_commandRing[i].sequence = i;
+
+    resetStatistics();
 }
 
 MasterTimer::~MasterTimer()
 {
     stop();
+
+    while (m_layers.isEmpty() == false)
+        delete m_layers.takeLast();
+
+    delete [] m_commandRing;
 }
 
 quint32 MasterTimer::frequency()
 {
-    return s_frequency;
+    return quint32(int(s_frequency));
+}
+
+void MasterTimer::setFrequency(quint32 hz)
+{
+    hz = CLAMP(hz, quint32(KMinFrequency), quint32(KMaxFrequency));
+    s_requestedFrequency.fetchAndStoreOrdered(int(hz));
+
+    /* Without timer threads there's nobody to wait for */
+    if (int(s_timerThreads) == 0)
+        s_frequency.fetchAndStoreOrdered(int(hz));
+}
+
+void MasterTimer::applyFrequency()
+{
+    int hz = s_requestedFrequency;
+    if (hz == int(s_frequency))
+        return;
+
+    /* Elapsed times of running functions are counted in ticks of the
+       current frequency, so they must run to completion first. */
+    if (m_functionList.isEmpty() == true && int(m_runningFunctions) == 0)
+        s_frequency.fetchAndStoreOrdered(hz);
+}
+
+quint32 MasterTimer::defaultFrequency()
+{
+    return KDefaultFrequency;
+}
+
+quint32 MasterTimer::minFrequency()
+{
+    return KMinFrequency;
+}
+
+quint32 MasterTimer::maxFrequency()
+{
+    return KMaxFrequency;
 }
 
 OutputMap* MasterTimer::outputMap() const
@@ -77,10 +156,7 @@ OutputMap* MasterTimer::outputMap() const
 
 int MasterTimer::runningFunctions()
 {
-    m_functionListMutex.lock();
-    int n = m_functionList.size();
-    m_functionListMutex.unlock();
-    return n;
+    return int(m_runningFunctions);
 }
 
 void MasterTimer::startFunction(Function* function, bool initiatedByOtherFunction)
@@ -88,26 +164,327 @@ void MasterTimer::startFunction(Function* function, bool initiatedByOtherFunctio
     if (function == NULL)
         return;
 
-    m_functionListMutex.lock();
-    if (m_functionList.contains(function) == false)
+    if (claimFunction(function, initiatedByOtherFunction) == false)
+        return;
+
+    if (QThread::currentThread() == this)
+    {
+        appendFunction(function);
+    }
+    else if (postCommand(Command::Start, function) == false)
     {
-        m_functionList.append(function);
-        function->setInitiatedByOtherFunction(initiatedByOtherFunction);
+        qWarning() << Q_FUNC_INFO << "Command queue full, can't start"
+                   << function->name();
+        releaseFunction(function);
+        return;
     }
-    m_functionListMutex.unlock();
 
     emit functionListChanged();
 }
 
+void MasterTimer::startFunctions(const QList <Function*>& functions,
+                                 bool initiatedByOtherFunction)
+{
+    if (functions.isEmpty() == true)
+        return;
+
+    bool direct = (QThread::currentThread() == this);
+    QListIterator <Function*> it(functions);
+    while (it.hasNext() == true)
+    {
+        Function* function = it.next();
+        if (function == NULL)
+            continue;
+
+        if (claimFunction(function, initiatedByOtherFunction) == false)
+            continue;
+
+        if (direct == true)
+        {
+            appendFunction(function);
+        }
+        else if (postCommand(Command::Start, function) == false)
+        {
+            qWarning() << Q_FUNC_INFO << "Command queue full, can't start"
+                       << function->name();
+            releaseFunction(function);
+        }
+    }
+
+    emit functionListChanged();
+}
+
+TimerFuture MasterTimer::stopFunction(Function* function)
+{
+    if (function == NULL)
+        return TimerFuture();
+
+    int command = 0;
+    if (postCommand(Command::Stop, function, &command) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Command queue full, can't stop"
+                   << function->name();
+        return TimerFuture();
+    }
+
+    return TimerFuture(this, command);
+}
+
+void MasterTimer::flashFunction(Function* function, bool flash)
+{
+    if (function == NULL)
+        return;
+
+    if (flash == true)
+        postCommand(Command::Flash, function);
+    else
+        postCommand(Command::UnFlash, function);
+}
+
 void MasterTimer::stopAllFunctions()
 {
-    m_stopAllFunctions = true;
+    int command = 0;
+    bool posted = postCommand(Command::StopAll, NULL, &command);
 
-    /* Wait until all functions have been stopped */
-    while (runningFunctions() > 0)
-        msleep(10);
+    if (isRunning() == true)
+    {
+        waitForCommand(command);
+    }
+    else if (m_outputMap != NULL)
+    {
+        /* Nobody else is going to run the commands. If the queue was full,
+           it's emptied first to make room for this command. */
+        UniverseArray* universes = m_outputMap->claimUniverses();
+        if (posted == false)
+        {
+            runCommands(universes);
+            postCommand(Command::StopAll, NULL);
+        }
+        runFunctions(universes);
+        m_outputMap->releaseUniverses();
+    }
+}
 
-    m_stopAllFunctions = false;
+bool MasterTimer::claimFunction(Function* function, bool initiatedByOtherFunction)
+{
+    Q_ASSERT(function != NULL);
+
+    if (function->m_timerListed.testAndSetOrdered(0, 1) == false)
+        return false;
+
+    function->setInitiatedByOtherFunction(initiatedByOtherFunction);
+    m_runningFunctions.ref();
+    return true;
+}
+
+void MasterTimer::releaseFunction(Function* function)
+{
+    Q_ASSERT(function != NULL);
+
+    function->m_timerListed.fetchAndStoreOrdered(0);
+    m_runningFunctions.deref();
+}
+
+void MasterTimer::appendFunction(Function* function)
+{
+    Q_ASSERT(function != NULL);
+
+    /* Look the function's profile slot up only once, here */
+    int slot = m_functionCostSlots.value(function->id(), -1);
+    if (slot == -1)
+    {
+        slot = m_functionCosts.size();
+        m_functionCosts.append(TickProfile::Cost());
+        m_functionCostSlots.insert(function->id(), slot);
+    }
+    function->m_profileSlot = slot;
+
+    m_functionList.append(function);
+}
+
+/****************************************************************************
+ * Commands
+ ****************************************************************************/
+
+bool MasterTimer::isCommandFinished(int command) const
+{
+    /* Subtraction keeps the comparison valid when the counters wrap */
+    return (int(m_finishedCommands) - command >= 0);
+}
+
+bool MasterTimer::waitForCommand(int command, int msecs)
+{
+    if (isCommandFinished(command) == true)
+        return true;
+
+    QTime time;
+    time.start();
+
+    m_tickWaiters.ref();
+    m_tickMutex.lock();
+    while (isCommandFinished(command) == false && isRunning() == true)
+    {
+        if (msecs < 0)
+        {
+            m_tickFinished.wait(&m_tickMutex);
+        }
+        else
+        {
+            int remaining = msecs - time.elapsed();
+            if (remaining <= 0)
+                break;
+            m_tickFinished.wait(&m_tickMutex, remaining);
+        }
+    }
+    m_tickMutex.unlock();
+    m_tickWaiters.deref();
+
+    return isCommandFinished(command);
+}
+
+bool MasterTimer::postCommand(Command::Type type, Function* function, int* command)
+{
+    /* A slot whose sequence equals the position is free for it. Anything
+       less means that the slot still holds a command from the previous
+       round, i.e. the ring is full. */
+    int position = m_commandHead;
+    while (true)
+    {
+        Command& slot = m_commandRing[position & (KCommandRingSize - 1)];
+        int diff = int(slot.sequence) - position;
+        if (diff == 0)
+        {
+            if (m_commandHead.testAndSetOrdered(position, position + 1) == true)
+                break;
+        }
+        else if (diff < 0)
+        {
+            /* Nobody's going to make room while we're waiting */
+            if (isRunning() == false || QThread::currentThread() == this)
+                return false;
+
+            /* Wait for the slot's previous command to be run */
+            waitForCommand(position - KCommandRingSize + 1, 100);
+        }
+
+        /* Somebody else took the position, try the next one */
+        position = m_commandHead;
+    }
+
+    Command& slot = m_commandRing[position & (KCommandRingSize - 1)];
+    slot.type = type;
+    slot.function = function;
+
+    /* Hand the slot over to the timer thread */
+    slot.sequence.fetchAndStoreOrdered(position + 1);
+
+    if (command != NULL)
+        *command = position + 1;
+
+    return true;
+}
+
+void MasterTimer::runCommands(UniverseArray* universes)
+{
+    /* Commands posted while these are being run wait for the next tick */
+    int end = m_commandHead;
+
+    bool listChanged = false;
+    int index;
+    while (m_commandTail - end < 0)
+    {
+        Command& slot = m_commandRing[m_commandTail & (KCommandRingSize - 1)];
+
+        /* A position may have been reserved but not yet published */
+        if (int(slot.sequence) != m_commandTail + 1)
+            break;
+
+        Command::Type type = slot.type;
+        Function* function = slot.function;
+
+        /* Free the slot for the next round of positions */
+        slot.sequence.fetchAndStoreOrdered(m_commandTail + KCommandRingSize);
+        m_commandTail++;
+
+        switch (type)
+        {
+        case Command::Start:
+            appendFunction(function);
+            break;
+        case Command::Stop:
+            /* Stop right away, so that nothing gets written on this tick.
+               The search is linear, but explicit stops are rare. */
+            function->stop();
+            index = m_functionList.indexOf(function);
+            if (index != -1)
+            {
+                removeFunctionAt(index, universes);
+                listChanged = true;
+            }
+            break;
+        case Command::StopAll:
+            while (m_functionList.isEmpty() == false)
+            {
+                removeFunctionAt(0, universes);
+                listChanged = true;
+            }
+            break;
+        case Command::Flash:
+            function->flash(this);
+            break;
+        case Command::UnFlash:
+            function->unFlash(this);
+            break;
+        }
+    }
+
+    if (listChanged == true)
+        emit functionListChanged();
+}
+
+void MasterTimer::removeFunctionAt(int index, UniverseArray* universes)
+{
+    Function* function = m_functionList.takeAt(index);
+    releaseFunction(function);
+    function->postRun(this, universes);
+}
+
+void MasterTimer::finishTick()
+{
+    m_finishedCommands.fetchAndStoreOrdered(m_commandTail);
+
+    if (int(m_tickWaiters) > 0)
+    {
+        m_tickMutex.lock();
+        m_tickFinished.wakeAll();
+        m_tickMutex.unlock();
+    }
+}
+
+/****************************************************************************
+ * TimerFuture
+ ****************************************************************************/
+
+TimerFuture::TimerFuture(MasterTimer* timer, int command)
+    : m_timer(timer)
+    , m_command(command)
+{
+}
+
+bool TimerFuture::isFinished() const
+{
+    if (m_timer == NULL)
+        return true;
+    else
+        return m_timer->isCommandFinished(m_command);
+}
+
+bool TimerFuture::waitForFinished(int msecs) const
+{
+    if (m_timer == NULL)
+        return true;
+    else
+        return m_timer->waitForCommand(m_command, msecs);
 }
 
 /****************************************************************************
@@ -133,194 +510,186 @@ void MasterTimer::unregisterDMXSource(DMXSource* source)
     m_dmxSourceListMutex.unlock();
 }
 
+QList <DMXSource*> MasterTimer::dmxSources()
+{
+    QMutexLocker locker(&m_dmxSourceListMutex);
+    return m_dmxSourceList;
+}
+
 /****************************************************************************
  * Thread running / stopping
  ****************************************************************************/
 
 void MasterTimer::start(Priority priority)
 {
-    /* Start with a clean slate */
-    m_functionList.clear();
+    /* Start with a clean slate. Commands posted before starting are still
+       run on the first tick. */
+    while (m_functionList.isEmpty() == false)
+        releaseFunction(m_functionList.takeFirst());
     m_dmxSourceList.clear();
+    resetStatistics();
 
     m_running = true;
     QThread::start(priority);
 }
 
-#ifndef WIN32
-void MasterTimer::run()
+qint64 MasterTimer::monotonicTime()
 {
-    /* How long to wait each loop */
-    int tickTime = 1000000 / frequency();
-
-    /* Allocate this from stack here so that GCC doesn't have
-       to do it everytime implicitly when gettimeofday() is called */
-    int tod = 0;
+    return QLCClock::monotonicTime();
+}
 
-    /* Allocate all the memory at the start so we don't waste any time */
-    timeval* finish = static_cast<timeval*> (malloc(sizeof(timeval)));
-    timeval* current = static_cast<timeval*> (malloc(sizeof(timeval)));
-    timespec* sleepTime = static_cast<timespec*> (malloc(sizeof(timespec)));
-    timespec* remainingTime = static_cast<timespec*> (malloc(sizeof(timespec)));
+void MasterTimer::run()
+{
+    /* Ticks are scheduled at absolute times on a monotonic clock, so
+       wall clock changes don't affect them and scheduling errors don't
+       accumulate over time. */
+    qint64 next = monotonicTime();
+    qint64 previous = next;
 
-    sleepTime->tv_sec = 0;
-
-    /* This is the start time for the timer */
-    tod = gettimeofday(finish, NULL);
-    if (tod == -1)
-    {
-        qWarning() << Q_FUNC_INFO << "Unable to get the time accurately:"
-                   << strerror(errno) << "- Stopping MasterTimer";
-        m_running = false;
-    }
-    else
-    {
-        m_running = true;
-    }
+    s_timerThreads.ref();
 
     while (m_running == true)
     {
-        /* Increment the finish time for this loop */
-        finish->tv_sec += (finish->tv_usec + tickTime) / 1000000;
-        finish->tv_usec = (finish->tv_usec + tickTime) % 1000000;
+        /* Frequency may change on the fly, but only between function runs */
+        applyFrequency();
+        qint64 period = Q_INT64_C(1000000000) / frequency();
+        next += period;
 
-        tod = gettimeofday(current, NULL);
-        if (tod == -1)
-        {
-            qWarning() << Q_FUNC_INFO << "Unable to get the current time:"
-                       << strerror(errno);
-            m_running = false;
-            break;
-        }
+        QLCClock::sleepUntil(next);
 
-        /* Do a rough sleep using the kernel to return control.
-           We know that this will never be seconds as we are dealing
-           with jumps of under a second every time. */
-        sleepTime->tv_nsec =
-            ((finish->tv_usec - current->tv_usec) * 1000) +
-            ((finish->tv_sec - current->tv_sec) * 1000000000) - 1000;
-        if (sleepTime->tv_nsec > 0)
-        {
-            tod = nanosleep(sleepTime, remainingTime);
-            while (tod == -1 && sleepTime->tv_nsec > 100) {
-                sleepTime->tv_nsec = remainingTime->tv_nsec;
-                tod = nanosleep(sleepTime, remainingTime);
-            }
-        }
+        qint64 now = monotonicTime();
+        recordTick(now - next, now - previous, period);
+        previous = now;
 
-        /* Now take full CPU for precision (only a few nanoseconds,
-           at maximum 1000 nanoseconds) */
-        while (finish->tv_usec - current->tv_usec +
-                (finish->tv_sec - current->tv_sec) * 1000000 > 5)
-        {
-            tod = gettimeofday(current, NULL);
-            if (tod == -1)
-            {
-                qWarning() << Q_FUNC_INFO << "Unable to get the current time:"
-                           << strerror(errno);
-                m_running = false;
-                break;
-            }
-        }
+        /* If the timer has fallen behind more than a second (e.g. the system
+           has been suspended), don't try to catch up all the missed ticks
+           in a burst. Just continue from the current time. */
+        if (now - next > Q_INT64_C(1000000000))
+            next = now;
 
         /* Execute the next timer event */
         timerTick();
     }
 
-    free(finish);
-    free(current);
-    free(sleepTime);
-    free(remainingTime);
+    /* A frequency change that was waiting for functions can now be done */
+    if (s_timerThreads.deref() == false)
+        s_frequency.fetchAndStoreOrdered(int(s_requestedFrequency));
 }
-#else /* WIN32 */
-void MasterTimer::run()
-{
-    /* This timer implementation requires 64bit support from compiler.
-       (Not 64bit processor architecture, though.) */
-    LARGE_INTEGER freq;
-    LARGE_INTEGER start;
-    LARGE_INTEGER lap;
-    LONGLONG target;
-
-    /* Calculate the target time that should be waited before each event */
-    QueryPerformanceFrequency(&freq);
-    target = freq.QuadPart / frequency();
 
-    while (m_running == true)
+void MasterTimer::timerTick()
+{
+    /* Profiling state changes are taken into use only between ticks */
+    m_tickProfiling = m_profiling;
+    if (m_profileReset.testAndSetOrdered(1, 0) == true)
     {
-        /* Reset the timer and make the first check */
-        QueryPerformanceCounter(&start);
-        QueryPerformanceCounter(&lap);
-
-        /* Loop here until $target ticks have passed */
-        while ((lap.QuadPart - start.QuadPart) < target)
-        {
-            /* Relinquish this thread's time slot, but don't sleep
-               because that would skew the timer at least 30ms. */
-            Sleep(0);
+        /* Running functions keep their slots */
+        m_profile.reset();
+        m_functionCosts.fill(TickProfile::Cost());
+    }
 
-            /* Check how many ticks have passed */
-            QueryPerformanceCounter(&lap);
-        }
+    qint64 tickStart = profileTime();
 
-        /* Execute the next timer event */
-        timerTick();
+    /* Inputs that have been delivered before this tick get written out by
+       it. If the lock is taken, they are just measured on the next tick. */
+    qint64 inputTimestamp = 0;
+    if (m_tickProfiling == true && m_inputMutex.tryLock() == true)
+    {
+        inputTimestamp = m_inputTimestamp;
+        m_inputTimestamp = 0;
+        m_inputMutex.unlock();
     }
-}
-#endif
 
-void MasterTimer::timerTick()
-{
     UniverseArray* universes = m_outputMap->claimUniverses();
+
+    qint64 intensityStart = profileTime();
     universes->zeroIntensityChannels();
 
+    qint64 functionsStart = profileTime();
     runFunctions(universes);
+
+    qint64 sourcesStart = profileTime();
     runDMXSources(universes);
 
     m_outputMap->releaseUniverses();
+
+    qint64 dumpStart = profileTime();
     m_outputMap->dumpUniverses();
+
+    if (m_tickProfiling == true)
+    {
+        qint64 tickEnd = monotonicTime();
+
+        m_profile.ticks++;
+        m_profile.spans[TickProfile::TickSpan].add(tickEnd - tickStart);
+        m_profile.spans[TickProfile::IntensitySpan].add(functionsStart - intensityStart);
+        m_profile.spans[TickProfile::FunctionsSpan].add(sourcesStart - functionsStart);
+        m_profile.spans[TickProfile::DMXSourcesSpan].add(dumpStart - sourcesStart);
+        m_profile.spans[TickProfile::DumpSpan].add(tickEnd - dumpStart);
+        if (inputTimestamp != 0)
+            m_profile.inputLatency.add(tickEnd - inputTimestamp);
+
+        publishProfile(tickEnd);
+    }
 }
 
 void MasterTimer::runFunctions(UniverseArray* universes)
 {
-    /* Lock before accessing the running functions list. */
-    m_functionListMutex.lock();
+    /* Functions that can be written in parallel are collected into a batch
+       that is written just before the next function that must be handled
+       in this thread, or after the whole list has been gone thru. Since
+       batched functions don't read universes, the result is the same as
+       if they had been written one by one in the list order. */
+    bool parallel = (renderThreads() > 1);
+    int batched = 0;
+
+    /* Take functions started and stopped by other threads into use */
+    runCommands(universes);
+
     for (int i = 0; i < m_functionList.size(); i++)
     {
         Function* function = m_functionList.at(i);
 
-        /* No need to access function list on this round anymore */
-        m_functionListMutex.unlock();
-
-        if (function != NULL)
+        if (function != NULL && parallel == true &&
+            function->elapsed() != 0 && function->stopped() == false &&
+            function->canWriteInParallel() == true)
         {
+            if (batched < m_batch.size())
+                m_batch[batched] = function;
+            else
+                m_batch.append(function);
+            batched++;
+        }
+        else if (function != NULL)
+        {
+            /* Functions before this one must have been written by now */
+            writeBatch(universes, batched);
+            batched = 0;
+
             if (function->elapsed() == 0)
                 function->preRun(this);
 
             /* Check for pre-conditions before getting data */
-            if (function->stopped() == true ||
-                    m_stopAllFunctions == true)
+            if (function->stopped() == true)
             {
                 /* Function should be stopped instead */
-                m_functionListMutex.lock();
-                m_functionList.removeAt(i);
-                function->postRun(this, universes);
-                m_functionListMutex.unlock();
+                removeFunctionAt(i, universes);
                 emit functionListChanged();
             }
             else
             {
                 /* Run normally: get function data */
+                qint64 start = profileTime();
                 function->write(this, universes);
+                if (m_tickProfiling == true)
+                    m_functionCosts[function->m_profileSlot].add(monotonicTime() - start);
             }
         }
-
-        /* Lock function list for the next round. */
-        m_functionListMutex.lock();
     }
 
-    /* No more functions. Get out and wait for next timer event. */
-    m_functionListMutex.unlock();
+    writeBatch(universes, batched);
+
+    /* Commands taken on this tick have now taken effect */
+    finishTick();
 }
 
 void MasterTimer::runDMXSources(UniverseArray* universes)
@@ -336,7 +705,10 @@ void MasterTimer::runDMXSources(UniverseArray* universes)
         m_dmxSourceListMutex.unlock();
 
         /* Get DMX data from the source */
+        qint64 start = profileTime();
         source->writeDMX(this, universes);
+        if (m_tickProfiling == true)
+            m_profile.dmxSources[source].add(monotonicTime() - start);
 
         /* Lock for the next round. */
         m_dmxSourceListMutex.lock();
@@ -352,5 +724,366 @@ void MasterTimer::stop()
 
     m_running = false;
     wait();
+
+    /* Let waitForCommand() callers know that no more ticks are coming */
+    m_tickMutex.lock();
+    m_tickFinished.wakeAll();
+    m_tickMutex.unlock();
+
+    stopRenderWorkers();
+}
+
+/****************************************************************************
+ * Parallel rendering
+ ****************************************************************************/
+
+void MasterTimer::setRenderThreads(int threads)
+{
+    m_renderThreads = CLAMP(threads, 1, KMaxRenderThreads);
+}
+
+int MasterTimer::renderThreads() const
+{
+    return m_renderThreads;
+}
+
+int MasterTimer::defaultRenderThreads()
+{
+    return CLAMP(QThread::idealThreadCount(), 1, KMaxRenderThreads);
+}
+
+int MasterTimer::maxRenderThreads()
+{
+    return KMaxRenderThreads;
+}
+
+void MasterTimer::writeBatch(UniverseArray* universes, int count)
+{
+    Q_ASSERT(universes != NULL);
+
+    if (count == 0)
+        return;
+
+    /* Layers are kept from one tick to the next, so that they don't need
+       to be allocated again and again. */
+    while (m_layers.size() < count)
+    {
+        m_layers.append(new UniverseLayer);
+        m_batchCosts.append(0);
+    }
+
+    /* No point in waking up more helpers than there are functions */
+    int helpers = MIN(renderThreads(), count) - 1;
+    while (m_renderWorkers.size() < helpers)
+        m_renderWorkers.append(new RenderWorker(this));
+
+    /* Layers' views read the real universes, which may have been grown */
+    for (int i = 0; i < count; i++)
+        m_layers.at(i)->attach(universes);
+
+    m_batchSize = count;
+    m_nextBatched = 0;
+
+    for (int i = 0; i < helpers; i++)
+        m_renderWorkers.at(i)->render();
+    renderBatch();
+    for (int i = 0; i < helpers; i++)
+        m_renderWorkers.at(i)->waitRendered();
+
+    /* Merge in the list order for deterministic HTP & LTP results */
+    for (int i = 0; i < count; i++)
+        universes->merge(m_layers.at(i));
+
+    if (m_tickProfiling == true)
+    {
+        for (int i = 0; i < count; i++)
+            m_functionCosts[m_batch.at(i)->m_profileSlot].add(m_batchCosts.at(i));
+    }
+}
+
+void MasterTimer::renderBatch()
+{
+    int i;
+    while ((i = m_nextBatched.fetchAndAddOrdered(1)) < m_batchSize)
+    {
+        UniverseLayer* layer = m_layers.at(i);
+        layer->clear();
+
+        /* Each thread touches only its own functions' costs */
+        qint64 start = profileTime();
+        m_batch.at(i)->write(this, layer->universes());
+        if (m_tickProfiling == true)
+            m_batchCosts[i] = monotonicTime() - start;
+    }
+}
+
+void MasterTimer::stopRenderWorkers()
+{
+    while (m_renderWorkers.isEmpty() == false)
+        delete m_renderWorkers.takeLast();
+}
+
+/****************************************************************************
+ * Timing statistics
+ ****************************************************************************/
+
+int MasterTimer::histogramSize()
+{
+    return KHistogramSize;
+}
+
+quint32 MasterTimer::histogramBinWidth()
+{
+    return KHistogramBinWidth;
+}
+
+quint64 MasterTimer::ticks() const
+{
+    quint64 ticks;
+    int sequence;
+    do
+    {
+        sequence = beginStatisticsRead();
+        ticks = m_ticks;
+    } while (endStatisticsRead(sequence) == false);
+
+    return ticks;
+}
+
+quint64 MasterTimer::overruns() const
+{
+    quint64 overruns;
+    int sequence;
+    do
+    {
+        sequence = beginStatisticsRead();
+        overruns = m_overruns;
+    } while (endStatisticsRead(sequence) == false);
+
+    return overruns;
+}
+
+quint32 MasterTimer::maxLateness() const
+{
+    quint32 maxLateness;
+    int sequence;
+    do
+    {
+        sequence = beginStatisticsRead();
+        maxLateness = m_maxLateness;
+    } while (endStatisticsRead(sequence) == false);
+
+    return maxLateness;
+}
+
+/**
+ * Make a deep copy of a histogram. Returning a shallow copy would make the
+ * timer thread detach (allocate) its histogram when recording the next tick.
+ */
+static void copyHistogram(const QVector <quint32>& histogram,
+                          QVector <quint32>& copy)
+{
+    for (int i = 0; i < histogram.size(); i++)
+        copy[i] = histogram.at(i);
+}
+
+QVector <quint32> MasterTimer::latenessHistogram() const
+{
+    QVector <quint32> copy(m_latenessHistogram.size());
+    int sequence;
+    do
+    {
+        sequence = beginStatisticsRead();
+        copyHistogram(m_latenessHistogram, copy);
+    } while (endStatisticsRead(sequence) == false);
+
+    return copy;
+}
+
+QVector <quint32> MasterTimer::jitterHistogram() const
+{
+    QVector <quint32> copy(m_jitterHistogram.size());
+    int sequence;
+    do
+    {
+        sequence = beginStatisticsRead();
+        copyHistogram(m_jitterHistogram, copy);
+    } while (endStatisticsRead(sequence) == false);
+
+    return copy;
+}
+
+void MasterTimer::resetStatistics()
+{
+    if (isRunning() == true)
+        m_statisticsReset.fetchAndStoreOrdered(1);
+    else
+        clearStatistics();
+}
+
+void MasterTimer::clearStatistics()
+{
+    m_statisticsSequence.ref();
+    m_ticks = 0;
+    m_overruns = 0;
+    m_maxLateness = 0;
+    m_latenessHistogram.fill(0);
+    m_jitterHistogram.fill(0);
+    m_statisticsSequence.ref();
+}
+
+int MasterTimer::beginStatisticsRead() const
+{
+    int sequence;
+    while ((sequence = m_statisticsSequence.fetchAndAddOrdered(0)) % 2 != 0)
+        QThread::yieldCurrentThread();
+    return sequence;
+}
+
+bool MasterTimer::endStatisticsRead(int sequence) const
+{
+    return (m_statisticsSequence.fetchAndAddOrdered(0) == sequence);
+}
+
+void MasterTimer::recordTick(qint64 lateness, qint64 interval, qint64 period)
+{
+    /* Convert to microseconds; sleeping can't end before its deadline, but
+       let's not trust that blindly. */
+    quint32 late = quint32(qMax(lateness, Q_INT64_C(0)) / 1000);
+    quint32 jitter = quint32(qAbs(interval - period) / 1000);
+
+    int lateBin = qMin(int(late / KHistogramBinWidth), KHistogramSize - 1);
+    int jitterBin = qMin(int(jitter / KHistogramBinWidth), KHistogramSize - 1);
+
+    if (m_statisticsReset.testAndSetOrdered(1, 0) == true)
+        clearStatistics();
+
+    /* No locking: this thread is the only writer */
+    m_statisticsSequence.ref();
+
+    m_ticks++;
+    if (lateness >= period)
+        m_overruns++;
+    if (late > m_maxLateness)
+        m_maxLateness = late;
+
+    m_latenessHistogram[lateBin]++;
+    m_jitterHistogram[jitterBin]++;
+
+    m_statisticsSequence.ref();
+}
+
+/****************************************************************************
+ * Profiling
+ ****************************************************************************/
+
+void MasterTimer::setProfiling(bool enable)
+{
+    m_profiling = enable;
+}
+
+bool MasterTimer::isProfiling() const
+{
+    return m_profiling;
+}
+
+TickProfile MasterTimer::profile() const
+{
+    QMutexLocker locker(&m_profileMutex);
+    return m_publishedProfile;
+}
+
+void MasterTimer::resetProfile()
+{
+    /* The timer thread's own profile is reset by the timer thread */
+    m_profileReset.fetchAndStoreOrdered(1);
+
+    QMutexLocker locker(&m_profileMutex);
+    m_publishedProfile.reset();
+}
+
+void MasterTimer::slotInputDelivered(qint64 timestamp)
+{
+    if (m_profiling == false)
+        return;
+
+    QMutexLocker locker(&m_inputMutex);
+    if (m_inputTimestamp == 0 || timestamp < m_inputTimestamp)
+        m_inputTimestamp = timestamp;
+}
+
+qint64 MasterTimer::profileTime() const
+{
+    if (m_tickProfiling == true)
+        return monotonicTime();
+    else
+        return 0;
+}
+
+void MasterTimer::publishProfile(qint64 now)
+{
+    if (now - m_profilePublished < KProfilePublishInterval)
+        return;
+
+    /* Forget unregistered sources, so that their pointers can't be
+       mixed up with new sources that happen to get the same address. */
+    m_dmxSourceListMutex.lock();
+    QMutableHashIterator <DMXSource*,TickProfile::Cost> it(m_profile.dmxSources);
+    while (it.hasNext() == true)
+    {
+        it.next();
+        if (m_dmxSourceList.contains(it.key()) == false)
+            it.remove();
+    }
+    m_dmxSourceListMutex.unlock();
+
+    /* Gather functions' costs by their IDs for readers */
+    m_profile.functions.clear();
+    QHashIterator <t_function_id,int> fit(m_functionCostSlots);
+    while (fit.hasNext() == true)
+    {
+        fit.next();
+        const TickProfile::Cost& cost(m_functionCosts.at(fit.value()));
+        if (cost.count > 0)
+            m_profile.functions.insert(fit.key(), cost);
+    }
+
+    /* Never wait for readers. If one is busy copying the previous profile,
+       just try again on the next tick. The copy is shallow; the profile is
+       copied for real only when the timer thread next modifies it. */
+    if (m_profileMutex.tryLock() == true)
+    {
+        m_publishedProfile = m_profile;
+        m_profileMutex.unlock();
+        m_profilePublished = now;
+    }
+}
+
+/****************************************************************************
+ * Defaults
+ ****************************************************************************/
+
+void MasterTimer::loadDefaults()
+{
+    QSettings settings;
+    QVariant value = settings.value(SETTINGS_FREQUENCY);
+    if (value.isValid() == true)
+        setFrequency(value.toUInt());
+
+    value = settings.value(SETTINGS_RENDERTHREADS);
+    if (value.isValid() == true)
+        setRenderThreads(value.toInt());
+
+    value = settings.value(SETTINGS_PROFILING);
+    if (value.isValid() == true)
+        setProfiling(value.toBool());
+}
+
+void MasterTimer::saveDefaults()
+{
+    QSettings settings;
+    settings.setValue(SETTINGS_FREQUENCY, frequency());
+    settings.setValue(SETTINGS_RENDERTHREADS, renderThreads());
+    settings.setValue(SETTINGS_PROFILING, isProfiling());
 }
 
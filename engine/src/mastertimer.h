@@ -22,20 +22,58 @@
 #ifndef MASTERTIMER_H
 #define MASTERTIMER_H
 
+#include <QWaitCondition>
+#include <QAtomicPointer>
+#include <QAtomicInt>
+#include <QVector>
 #include <QThread>
 #include <QMutex>
+#include <QHash>
 #include <QList>
 
+#include "tickprofile.h"
+
+class UniverseLayer;
 class UniverseArray;
+class RenderWorker;
 class OutputMap;
 class DMXSource;
+class MasterTimer;
 class Function;
 
+/**
+ * TimerFuture tells when a command given to MasterTimer has taken effect,
+ * i.e. when the tick that carried it out has run its functions.
+ */
+class TimerFuture
+{
+public:
+    /** Create a future for a command, or an already finished one */
+    TimerFuture(MasterTimer* timer = NULL, int command = 0);
+
+    /** Check, whether the command has taken effect */
+    bool isFinished() const;
+
+    /**
+     * Block the calling thread until the command has taken effect
+     *
+     * @param msecs Maximum time to wait, or -1 to wait as long as it takes
+     * @return true if the command has taken effect, otherwise false
+     */
+    bool waitForFinished(int msecs = -1) const;
+
+private:
+    MasterTimer* m_timer;
+    int m_command;
+};
+
 class MasterTimer : public QThread
 {
     Q_OBJECT
     Q_DISABLE_COPY(MasterTimer)
 
+    friend class RenderWorker;
+
     /*************************************************************************
      * Initialization
      *************************************************************************/
@@ -55,13 +93,47 @@ public:
     /** Get the timer tick frequency in Hertz */
     static quint32 frequency();
 
+    /**
+     * Set the timer tick frequency in Hertz. The frequency is clamped
+     * between minFrequency() and maxFrequency() and it can be changed also
+     * while the timer is running. Functions count their elapsed time in
+     * ticks, so a running timer takes the new rate into use only when no
+     * functions are running; otherwise fades would jump. Bus values are
+     * stored in real time units, so fade and hold times stay the same
+     * regardless of the frequency.
+     *
+     * @param hz The new tick frequency in Hertz
+     */
+    static void setFrequency(quint32 hz);
+
+    /** Get the default (and historical) timer tick frequency in Hertz */
+    static quint32 defaultFrequency();
+
+    /** Get the lowest accepted timer tick frequency in Hertz */
+    static quint32 minFrequency();
+
+    /** Get the highest accepted timer tick frequency in Hertz */
+    static quint32 maxFrequency();
+
     /** Get the output map object that MasterTimer uses for DMX output */
     OutputMap* outputMap() const;
 
 protected:
     /** An OutputMap instance that routes all values to correct plugins. */
     OutputMap* m_outputMap;
-    static const quint32 s_frequency;
+
+    /** Take the requested frequency into use, if no functions are running.
+        Called by the timer thread at the beginning of each tick. */
+    void applyFrequency();
+
+    /** The frequency in use */
+    static QAtomicInt s_frequency;
+
+    /** The frequency given to setFrequency() */
+    static QAtomicInt s_requestedFrequency;
+
+    /** The number of running timer threads */
+    static QAtomicInt s_timerThreads;
 
     /*********************************************************************
      * Functions
@@ -70,10 +142,49 @@ public:
     /** Get the number of currently running functions */
     int runningFunctions();
 
-    /** Start running the given function */
+    /**
+     * Start running the given function. The function is counted as running
+     * right away, but it's taken into the list of running functions by the
+     * timer thread at the beginning of the next tick. When called from the
+     * timer thread itself (i.e. from Function::write()), the function is
+     * appended to the list directly and written already on this tick.
+     */
     virtual void startFunction(Function* function, bool initiatedByOtherFunction);
 
-    /** Stop all functions. Doesn't affect registered DMX sources. */
+    /**
+     * Start running all of the given functions at once, appending them to
+     * the list of running functions in the given order. Functions that are
+     * already running are skipped. functionListChanged() is emitted just
+     * once for the whole batch.
+     *
+     * @param functions The functions to start
+     * @param initiatedByOtherFunction true if started by another function
+     */
+    virtual void startFunctions(const QList <Function*>& functions,
+                                bool initiatedByOtherFunction);
+
+    /**
+     * Stop the given function. The function is removed from the list of
+     * running functions and stopped at the beginning of the next tick.
+     *
+     * @param function The function to stop
+     * @return A future that finishes when the function has been stopped
+     */
+    TimerFuture stopFunction(Function* function);
+
+    /**
+     * Flash or unflash the given function (see Function::flash()) in the
+     * timer thread at the beginning of the next tick.
+     *
+     * @param function The function to flash
+     * @param flash true to flash the function, false to unflash it
+     */
+    void flashFunction(Function* function, bool flash);
+
+    /**
+     * Stop all functions and wait until they have been stopped, which takes
+     * one tick. Doesn't affect registered DMX sources.
+     */
     void stopAllFunctions();
 
 signals:
@@ -81,14 +192,175 @@ signals:
     void functionListChanged();
 
 protected:
-    /** List of currently running functions */
+    /**
+     * Claim the given function for running, unless it's running already.
+     * Function membership is a flag in the function itself, so the check
+     * doesn't depend on the number of running functions.
+     *
+     * @return true if the function was claimed, otherwise false
+     */
+    bool claimFunction(Function* function, bool initiatedByOtherFunction);
+
+    /** Release a function claimed with claimFunction() */
+    void releaseFunction(Function* function);
+
+    /** Append a claimed function to the list of running functions. Called
+        only in the timer thread (or when the timer isn't running). */
+    void appendFunction(Function* function);
+
+protected:
+    /** List of currently running functions, accessed only in the timer
+        thread (or when the timer isn't running) */
     QList <Function*> m_functionList;
 
-    /** Mutex that guards access to m_functionList */
-    QMutex m_functionListMutex;
+    /** Number of claimed functions */
+    QAtomicInt m_runningFunctions;
+
+    /*************************************************************************
+     * Commands
+     *************************************************************************/
+public:
+    /**
+     * Check, whether the given number of commands have been carried out and
+     * the tick that did it has run its functions. Commands are counted from
+     * the timer's creation and the count may wrap around.
+     */
+    bool isCommandFinished(int command) const;
+
+    /**
+     * Wait until the given number of commands have been carried out, or
+     * until the timer is stopped.
+     *
+     * @param command The command count to wait for
+     * @param msecs Maximum time to wait, or -1 to wait as long as it takes
+     * @return true if the commands have been carried out, otherwise false
+     */
+    bool waitForCommand(int command, int msecs = -1);
+
+protected:
+    /** A request from another thread, carried out by the timer thread */
+    struct Command
+    {
+        enum Type { Start, Stop, StopAll, Flash, UnFlash };
+
+        /** The queue position that the slot is free for (position) or
+            ready to be run at (position + 1); see postCommand() */
+        QAtomicInt sequence;
+        Type type;
+        Function* function;
+    };
+
+    /**
+     * Queue a command for the timer thread. Commands go to a preallocated
+     * ring of slots, so posting doesn't allocate or lock anything. If the
+     * ring is full, the caller waits for the timer thread to make room,
+     * unless the timer isn't running, in which case the command is dropped.
+     *
+     * @param type The command to carry out
+     * @param function The function to carry out the command on
+     * @param command If not NULL, set to the count of commands that must be
+     *                finished for this one to have taken effect
+     * @return true if the command was queued, false if it was dropped
+     */
+    bool postCommand(Command::Type type, Function* function, int* command = NULL);
+
+    /**
+     * Carry out all queued commands in the order they were posted. Called
+     * at the beginning of each tick.
+     *
+     * @param universes Universes for the functions that get stopped
+     */
+    void runCommands(UniverseArray* universes);
+
+    /** Remove a function from the list of running functions and stop it */
+    void removeFunctionAt(int index, UniverseArray* universes);
+
+    /** Tell waitForCommand() callers that the current tick has finished */
+    void finishTick();
+
+protected:
+    /** Command slots, allocated once. Producers reserve a position with
+        compare-and-swap on m_commandHead and publish the slot by bumping
+        its sequence; the timer thread alone consumes them in order. */
+    Command* m_commandRing;
+
+    /** The next queue position to reserve */
+    QAtomicInt m_commandHead;
+
+    /** The next queue position to run, used only by the timer thread */
+    int m_commandTail;
+
+    /** The number of commands that have been run by finished ticks */
+    QAtomicInt m_finishedCommands;
+
+    /** Number of threads in waitForCommand(); the timer thread touches the
+        mutex below only when there are some */
+    QAtomicInt m_tickWaiters;
+    QMutex m_tickMutex;
+    QWaitCondition m_tickFinished;
+
+    /*************************************************************************
+     * Parallel rendering
+     *************************************************************************/
+public:
+    /**
+     * Set the number of threads used for writing functions, including
+     * MasterTimer's own thread. With more than one thread, functions whose
+     * Function::canWriteInParallel() returns true are written in parallel
+     * into layers of their own, which are then merged into universes in
+     * the order of the running functions list. The result is exactly the
+     * same as with a single thread. The number is clamped between 1 and
+     * maxRenderThreads() and it can be changed while the timer is running.
+     *
+     * @param threads The number of threads to use
+     */
+    void setRenderThreads(int threads);
+
+    /** Get the number of threads used for writing functions */
+    int renderThreads() const;
+
+    /** Get the default number of render threads (one per CPU core) */
+    static int defaultRenderThreads();
+
+    /** Get the highest accepted number of render threads */
+    static int maxRenderThreads();
 
-    /** Flag for stopping all functions */
-    bool m_stopAllFunctions;
+protected:
+    /**
+     * Write the first $count functions of the current batch into their
+     * layers, using all render threads, and merge the layers to universes.
+     */
+    void writeBatch(UniverseArray* universes, int count);
+
+    /**
+     * Write functions from the current batch into their layers until the
+     * batch has been exhausted. Called simultaneously from each render
+     * thread, including MasterTimer's own thread.
+     */
+    void renderBatch();
+
+    /** Stop and destroy all render workers */
+    void stopRenderWorkers();
+
+protected:
+    /** Requested number of render threads */
+    QAtomicInt m_renderThreads;
+
+    /** Helper threads; one less than the number of render threads */
+    QList <RenderWorker*> m_renderWorkers;
+
+    /** Functions to write in parallel and a layer for each of them */
+    QVector <Function*> m_batch;
+    QVector <UniverseLayer*> m_layers;
+
+    /** Number of functions in the current batch */
+    int m_batchSize;
+
+    /** Index of the next batched function that needs to be written */
+    QAtomicInt m_nextBatched;
+
+    /** Time spent in write() by each batched function, when profiling */
+    QVector <qint64> m_batchCosts;
 
     /*************************************************************************
      * DMX Sources
@@ -111,6 +383,9 @@ public:
      */
     virtual void unregisterDMXSource(DMXSource* source);
 
+    /** Get a list of currently registered DMX sources */
+    QList <DMXSource*> dmxSources();
+
 protected:
     /** List of currently running functions */
     QList <DMXSource*> m_dmxSourceList;
@@ -128,6 +403,15 @@ public:
     /** Stop this altogether. Functions cannot be run after this. */
     void stop();
 
+    /**
+     * Get the current time of the monotonic clock that ticks are scheduled
+     * and measured with. This is the same clock (QLCClock) that plugins use
+     * for timestamping input values.
+     *
+     * @return Current time in nanoseconds since an arbitrary starting point
+     */
+    static qint64 monotonicTime();
+
 protected:
     /** The main thread function */
     virtual void run();
@@ -144,6 +428,177 @@ protected:
 protected:
     /** Running status, telling, whether the MasterTimer has been started */
     bool m_running;
+
+    /*************************************************************************
+     * Timing statistics
+     *************************************************************************/
+public:
+    /** Get the number of bins in lateness and jitter histograms */
+    static int histogramSize();
+
+    /**
+     * Get the width of one histogram bin in microseconds. The last bin
+     * collects everything that doesn't fit into the other bins.
+     */
+    static quint32 histogramBinWidth();
+
+    /** Get the number of ticks run since start() or resetStatistics() */
+    quint64 ticks() const;
+
+    /**
+     * Get the number of overrun ticks since start() or resetStatistics().
+     * A tick overruns when it begins more than one tick period late, i.e.
+     * when the previous tick took longer than a tick period to complete.
+     */
+    quint64 overruns() const;
+
+    /** Get the largest observed tick lateness in microseconds */
+    quint32 maxLateness() const;
+
+    /**
+     * Get a histogram of tick lateness, i.e. how many microseconds after
+     * their scheduled time the ticks actually started.
+     */
+    QVector <quint32> latenessHistogram() const;
+
+    /**
+     * Get a histogram of tick jitter, i.e. how many microseconds the time
+     * between two consecutive ticks differed from the nominal tick period.
+     */
+    QVector <quint32> jitterHistogram() const;
+
+    /**
+     * Reset all timing statistics. While the timer is running, the timer
+     * thread resets them at the beginning of its next tick.
+     */
+    void resetStatistics();
+
+protected:
+    /**
+     * Record timing information for one tick
+     *
+     * @param lateness Nanoseconds between scheduled and actual tick start
+     * @param interval Nanoseconds since the previous tick started
+     * @param period Nominal tick period in nanoseconds
+     */
+    void recordTick(qint64 lateness, qint64 interval, qint64 period);
+
+    /** Clear all timing statistics; only by their writer */
+    void clearStatistics();
+
+    /** Wait for the timer thread to finish updating statistics and get the
+        sequence number to check with endStatisticsRead() */
+    int beginStatisticsRead() const;
+
+    /** Check, whether statistics stayed intact since beginStatisticsRead() */
+    bool endStatisticsRead(int sequence) const;
+
+protected:
+    quint64 m_ticks;
+    quint64 m_overruns;
+    quint32 m_maxLateness;
+    QVector <quint32> m_latenessHistogram;
+    QVector <quint32> m_jitterHistogram;
+
+    /** Statistics are written only by the timer thread, which makes the
+        sequence odd for the duration of each update. Readers retry until
+        they get a copy that wasn't updated in the meantime. */
+    mutable QAtomicInt m_statisticsSequence;
+
+    /** Non-zero when resetStatistics() has been called */
+    QAtomicInt m_statisticsReset;
+
+    /*************************************************************************
+     * Profiling
+     *************************************************************************/
+public:
+    /**
+     * Enable or disable tick profiling. When enabled, MasterTimer measures
+     * the time spent in each stage of every tick, as well as in each
+     * function and DMX source, and accumulates it into a TickProfile.
+     * Recording never waits for locks, and when profiling is disabled, it
+     * costs just a flag check per measurement.
+     *
+     * @param enable true to enable profiling, false to disable
+     */
+    void setProfiling(bool enable);
+
+    /** Check, whether tick profiling is enabled */
+    bool isProfiling() const;
+
+    /**
+     * Get the accumulated tick profile. The profile is published by the
+     * timer thread a few times per second, so it may lag a bit behind.
+     * DMXSource pointers in the profile may belong to sources that have
+     * since been unregistered; check them against dmxSources() before use.
+     */
+    TickProfile profile() const;
+
+    /** Clear the accumulated tick profile */
+    void resetProfile();
+
+public slots:
+    /**
+     * Tell that input values have been delivered to their listeners (see
+     * InputMap::inputDelivered()). When profiling, the time from receiving
+     * the oldest of them until the next tick has dumped its universes is
+     * added to the profile's input latency.
+     *
+     * @param timestamp The time when the oldest value was received, in
+     *                  monotonicTime() nanoseconds
+     */
+    void slotInputDelivered(qint64 timestamp);
+
+protected:
+    /** Get the current time if this tick is being profiled, otherwise 0 */
+    qint64 profileTime() const;
+
+    /** Make the timer thread's profile available to profile() */
+    void publishProfile(qint64 now);
+
+protected:
+    /** Requested profiling state */
+    volatile bool m_profiling;
+
+    /** Profiling state for the current tick */
+    bool m_tickProfiling;
+
+    /** Set to 1 by resetProfile(), cleared by the timer thread */
+    QAtomicInt m_profileReset;
+
+    /** The timer thread's own profile that all measurements go to, except
+        for functions' costs, which are gathered into it on publishing */
+    TickProfile m_profile;
+
+    /** Functions' costs, indexed by Function::m_profileSlot so that ticks
+        don't need to look anything up. Used only by the timer thread. */
+    QVector <TickProfile::Cost> m_functionCosts;
+
+    /** Function ID -> index in m_functionCosts, used when functions are
+        taken into the list and when the profile is published */
+    QHash <t_function_id,int> m_functionCostSlots;
+
+    /** The latest published profile; guarded by m_profileMutex */
+    TickProfile m_publishedProfile;
+    mutable QMutex m_profileMutex;
+
+    /** The time when m_profile was last published */
+    qint64 m_profilePublished;
+
+    /** The oldest delivered input that no tick has written out yet, or 0 if
+        there is none. Guarded by m_inputMutex. */
+    qint64 m_inputTimestamp;
+    QMutex m_inputMutex;
+
+    /*************************************************************************
+     * Defaults
+     *************************************************************************/
+public:
+    /** Load timer settings from QLC global settings */
+    void loadDefaults();
+
+    /** Save timer settings into QLC global settings */
+    void saveDefaults();
 };
 
 #endif
@@ -19,6 +19,8 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <string.h>
+
 #include <QCoreApplication>
 #include <QPluginLoader>
 #include <QByteArray>
@@ -36,9 +38,13 @@
 #include "qlcfile.h"
 
 #include "universearray.h"
+#include "outputworker.h"
 #include "outputpatch.h"
 #include "outputmap.h"
 
+#define KDefaultKeepAliveInterval 1000
+#define SETTINGS_KEEPALIVE "/outputmap/keepalive"
+
 /*****************************************************************************
  * Initialization
  *****************************************************************************/
@@ -48,23 +54,35 @@ OutputMap::OutputMap(QObject* parent, quint32 universes) : QObject(parent)
     m_universes = universes;
     m_blackout = false;
     m_universeChanged = false;
+    m_keepAliveInterval = KDefaultKeepAliveInterval;
+    m_keepAliveTime.start();
 
     m_universeArray = new UniverseArray(512 * universes);
+    for (quint32 i = 0; i < universes; i++)
+    {
+        m_dumpedUniverses << QByteArray(512, char(0));
+        m_dumpTimes << 0;
+    }
 
     initPatch();
 }
 
 OutputMap::~OutputMap()
 {
-    delete m_universeArray;
-    m_universeArray = NULL;
-
+    /* Patches detach themselves from their workers */
     for (quint32 i = 0; i < m_universes; i++)
     {
         delete m_patch[i];
         m_patch[i] = NULL;
     }
 
+    /* Stop workers before their plugins disappear */
+    while (m_workers.isEmpty() == false)
+        delete m_workers.takeFirst();
+
+    delete m_universeArray;
+    m_universeArray = NULL;
+
     while (m_plugins.isEmpty() == false)
         delete m_plugins.takeFirst();
 }
@@ -134,17 +152,23 @@ void OutputMap::setBlackout(bool blackout)
         return;
     m_blackout = blackout;
 
+    /* Universes are posted only while holding m_universeMutex */
+    m_universeMutex.lock();
     if (blackout == true)
     {
         QByteArray zeros(512, 0);
         for (quint32 i = 0; i < m_universes; i++)
-            m_patch[i]->dump(zeros);
+            m_patch[i]->post(zeros);
     }
     else
     {
         /* Force writing of values back to the plugins */
         m_universeChanged = true;
     }
+    m_universeMutex.unlock();
+
+    if (blackout == true)
+        wakeOutputWorkers();
 
     emit blackoutChanged(m_blackout);
 }
@@ -166,22 +190,73 @@ UniverseArray* OutputMap::claimUniverses()
 
 void OutputMap::releaseUniverses()
 {
-    m_universeChanged = true;
+    /* UniverseArray keeps track of changed universes by itself */
     m_universeMutex.unlock();
 }
 
 void OutputMap::dumpUniverses()
 {
+    bool posted = false;
+
     m_universeMutex.lock();
-    if (m_universeChanged == true && m_blackout == false)
+    if (m_blackout == false)
     {
-        QByteArray postGM(m_universeArray->postGMValues());
+        int now = m_keepAliveTime.elapsed();
+
         for (quint32 i = 0; i < m_universes; i++)
-            m_patch[i]->dump(postGM.mid(i * 512, 512));
+        {
+            /* Universe views point directly to UniverseArray's buffer, so
+               the only copies made are the ones into each patch's buffer
+               and m_dumpedUniverses. */
+            const QByteArray& universe(m_universeArray->postGMUniverse(i));
+            QByteArray& dumped(m_dumpedUniverses[i]);
+            bool dump = m_universeChanged;
+
+            /* A universe that has been written to might still contain the
+               same values that were dumped last time (e.g. intensities
+               zeroed and then written back by functions on each tick). */
+            if (m_universeArray->isUniverseDirty(i) == true)
+            {
+                m_universeArray->setUniverseDirty(i, false);
+                if (memcmp(universe.constData(), dumped.constData(),
+                           universe.size()) != 0)
+                {
+                    dump = true;
+                }
+            }
+
+            /* Refresh unchanged universes periodically. QTime wraps around
+               at midnight, making "now" smaller than the dump time. */
+            if (dump == false && m_keepAliveInterval > 0)
+            {
+                int elapsed = now - m_dumpTimes[i];
+                if (elapsed < 0 || quint32(elapsed) >= m_keepAliveInterval)
+                    dump = true;
+            }
+
+            if (dump == true)
+            {
+                /* Plugins are written to by workers, never by the caller */
+                memcpy(dumped.data(), universe.constData(), universe.size());
+                m_dumpTimes[i] = now;
+                m_patch[i]->post(universe);
+                posted = true;
+            }
+        }
 
         m_universeChanged = false;
     }
     m_universeMutex.unlock();
+
+    if (posted == true)
+        wakeOutputWorkers();
+}
+
+void OutputMap::flushUniverses()
+{
+    QListIterator <OutputWorker*> it(m_workers);
+    while (it.hasNext() == true)
+        it.next()->flush();
 }
 
 const UniverseArray* OutputMap::peekUniverses() const
@@ -196,6 +271,25 @@ void OutputMap::resetUniverses()
     releaseUniverses();
 }
 
+/*****************************************************************************
+ * Keep-alive
+ *****************************************************************************/
+
+void OutputMap::setKeepAliveInterval(quint32 msecs)
+{
+    m_keepAliveInterval = msecs;
+}
+
+quint32 OutputMap::keepAliveInterval() const
+{
+    return m_keepAliveInterval;
+}
+
+quint32 OutputMap::defaultKeepAliveInterval()
+{
+    return KDefaultKeepAliveInterval;
+}
+
 /*****************************************************************************
  * Patch
  *****************************************************************************/
@@ -216,6 +310,35 @@ quint32 OutputMap::universes() const
     return m_universes;
 }
 
+void OutputMap::setUniverses(quint32 universes)
+{
+    universes = MIN(universes, KUniverseCountMax);
+    if (universes == m_universes)
+        return;
+
+    /* MasterTimer must not be dumping while the universes move around */
+    m_universeMutex.lock();
+    m_universeArray->setUniverses(universes);
+    for (quint32 i = m_universes; i < universes; i++)
+    {
+        m_patch.append(new OutputPatch(this));
+        m_dumpedUniverses << QByteArray(512, char(0));
+        m_dumpTimes << 0;
+    }
+
+    /* Dropped patches close their outputs and detach from their workers */
+    for (quint32 i = universes; i < m_universes; i++)
+    {
+        delete m_patch.takeLast();
+        m_dumpedUniverses.removeLast();
+        m_dumpTimes.removeLast();
+    }
+    m_universes = universes;
+    m_universeMutex.unlock();
+
+    emit universesChanged(universes);
+}
+
 bool OutputMap::setPatch(quint32 universe, const QString& pluginName,
                          quint32 output)
 {
@@ -227,12 +350,17 @@ bool OutputMap::setPatch(quint32 universe, const QString& pluginName,
 
     m_patch[universe]->set(plugin(pluginName), output);
 
+    /* Newly-patched outputs need the current values, changed or not */
+    m_universeMutex.lock();
+    m_universeChanged = true;
+    m_universeMutex.unlock();
+
     return true;
 }
 
 OutputPatch* OutputMap::patch(quint32 universe) const
 {
-    if (universe < KUniverseCount)
+    if (universe < m_universes)
         return m_patch[universe];
     else
         return NULL;
@@ -241,7 +369,7 @@ OutputPatch* OutputMap::patch(quint32 universe) const
 QStringList OutputMap::universeNames() const
 {
     QStringList list;
-    for (quint32 i = 0; i < KUniverseCount; i++)
+    for (quint32 i = 0; i < m_universes; i++)
     {
         OutputPatch* p(patch(i));
         Q_ASSERT(p != NULL);
@@ -334,6 +462,7 @@ bool OutputMap::appendPlugin(QLCOutPlugin* outputPlugin)
     if (plugin(outputPlugin->name()) == NULL)
     {
         m_plugins.append(outputPlugin);
+        m_workers.append(new OutputWorker(this, outputPlugin));
         connect(outputPlugin, SIGNAL(configurationChanged()),
                 this, SLOT(slotConfigurationChanged()));
         emit pluginAdded(outputPlugin->name());
@@ -364,8 +493,27 @@ QLCOutPlugin* OutputMap::plugin(const QString& name)
 void OutputMap::slotConfigurationChanged()
 {
     QLCOutPlugin* plugin = qobject_cast<QLCOutPlugin*> (QObject::sender());
-    if (plugin != NULL)
-        emit pluginConfigurationChanged(plugin->name());
+    if (plugin == NULL)
+        return;
+
+    /* The plugin's lines may have been re-created, so close and reopen the
+       patched ones. Lines that are gone are unpatched. */
+    quint32 outputs = plugin->outputs().size();
+    for (quint32 i = 0; i < m_universes; i++)
+    {
+        OutputPatch* op = m_patch[i];
+        Q_ASSERT(op != NULL);
+
+        if (op->plugin() != plugin)
+            continue;
+
+        if (op->output() < outputs)
+            op->set(plugin, op->output());
+        else
+            op->set(plugin, KOutputInvalid);
+    }
+
+    emit pluginConfigurationChanged(plugin->name());
 }
 
 QDir OutputMap::systemPluginDirectory()
@@ -384,65 +532,125 @@ QDir OutputMap::systemPluginDirectory()
     return dir;
 }
 
+/*****************************************************************************
+ * Output workers
+ *****************************************************************************/
+
+OutputWorker* OutputMap::outputWorker(QLCOutPlugin* plugin) const
+{
+    QListIterator <OutputWorker*> it(m_workers);
+    while (it.hasNext() == true)
+    {
+        OutputWorker* worker = it.next();
+        if (worker->plugin() == plugin)
+            return worker;
+    }
+
+    return NULL;
+}
+
+void OutputMap::wakeOutputWorkers()
+{
+    QListIterator <OutputWorker*> it(m_workers);
+    while (it.hasNext() == true)
+        it.next()->wake();
+}
+
 /*****************************************************************************
  * Defaults
  *****************************************************************************/
 
 void OutputMap::loadDefaults()
+{
+    QSettings settings;
+
+    QVariant keepAlive = settings.value(SETTINGS_KEEPALIVE);
+    if (keepAlive.isValid() == true)
+        setKeepAliveInterval(keepAlive.toUInt());
+
+    for (quint32 i = 0; i < m_universes; i++)
+        loadDefaults(i);
+}
+
+void OutputMap::loadDefaults(quint32 universe)
 {
     QSettings settings;
     QString plugin;
     QString output;
     QString key;
 
-    for (quint32 i = 0; i < KUniverseCount; i++)
-    {
-        /* Zero-based addressing */
-        key = QString("/outputmap/universe%1/dmxzerobased").arg(i);
-        QVariant value = settings.value(key);
-        if (value.isValid() == true)
-            m_patch[i]->setDMXZeroBased(value.toBool());
+    if (universe >= m_universes)
+        return;
 
-        /* Plugin name */
-        key = QString("/outputmap/universe%2/plugin/").arg(i);
-        plugin = settings.value(key).toString();
+    /* Zero-based addressing */
+    key = QString("/outputmap/universe%1/dmxzerobased").arg(universe);
+    QVariant value = settings.value(key);
+    if (value.isValid() == true)
+        m_patch[universe]->setDMXZeroBased(value.toBool());
 
-        /* Plugin output */
-        key = QString("/outputmap/universe%2/output/").arg(i);
-        output = settings.value(key).toString();
+    /* Refresh rate & interpolation */
+    key = QString("/outputmap/universe%1/refreshrate").arg(universe);
+    value = settings.value(key);
+    if (value.isValid() == true)
+        m_patch[universe]->setRefreshRate(value.toUInt());
 
-        if (plugin.length() > 0 && output.length() > 0)
-        {
-            /* Check that the same plugin & output are not mapped
-               to more than one universe at a time. */
-            quint32 m = mapping(plugin, output.toInt());
-            if (m == QLCChannel::invalid() || m == i)
-                setPatch(i, plugin, output.toInt());
-        }
+    key = QString("/outputmap/universe%1/interpolation").arg(universe);
+    value = settings.value(key);
+    if (value.isValid() == true)
+        m_patch[universe]->setInterpolation(value.toBool());
+
+    /* Plugin name */
+    key = QString("/outputmap/universe%2/plugin/").arg(universe);
+    plugin = settings.value(key).toString();
+
+    /* Plugin output */
+    key = QString("/outputmap/universe%2/output/").arg(universe);
+    output = settings.value(key).toString();
+
+    if (plugin.length() > 0 && output.length() > 0)
+    {
+        /* Check that the same plugin & output are not mapped
+           to more than one universe at a time. */
+        quint32 m = mapping(plugin, output.toInt());
+        if (m == QLCChannel::invalid() || m == universe)
+            setPatch(universe, plugin, output.toInt());
     }
 }
 
 void OutputMap::saveDefaults()
+{
+    QSettings settings;
+    settings.setValue(SETTINGS_KEEPALIVE, keepAliveInterval());
+
+    for (quint32 i = 0; i < m_universes; i++)
+        saveDefaults(i);
+}
+
+void OutputMap::saveDefaults(quint32 universe)
 {
     QSettings settings;
     QString key;
     QString str;
 
-    for (quint32 i = 0; i < KUniverseCount; i++)
-    {
-        OutputPatch* outputPatch = patch(i);
-        Q_ASSERT(outputPatch != NULL);
+    OutputPatch* outputPatch = patch(universe);
+    if (outputPatch == NULL)
+        return;
 
-        /* Zero-based DMX addressing */
-        key = QString("/outputmap/universe%1/dmxzerobased").arg(i);
-        settings.setValue(key, outputPatch->isDMXZeroBased());
+    /* Zero-based DMX addressing */
+    key = QString("/outputmap/universe%1/dmxzerobased").arg(universe);
+    settings.setValue(key, outputPatch->isDMXZeroBased());
 
-        /* Plugin name */
-        key = QString("/outputmap/universe%2/plugin/").arg(i);
-        settings.setValue(key, outputPatch->pluginName());
+    /* Refresh rate & interpolation */
+    key = QString("/outputmap/universe%1/refreshrate").arg(universe);
+    settings.setValue(key, outputPatch->refreshRate());
+    key = QString("/outputmap/universe%1/interpolation").arg(universe);
+    settings.setValue(key, outputPatch->interpolation());
 
-        /* Plugin output */
-        key = QString("/outputmap/universe%2/output/").arg(i);
-        settings.setValue(key, str.setNum(outputPatch->output()));
-    }
+    /* Plugin name */
+    key = QString("/outputmap/universe%2/plugin/").arg(universe);
+    settings.setValue(key, outputPatch->pluginName());
+
+    /* Plugin output */
+    key = QString("/outputmap/universe%2/output/").arg(universe);
+    settings.setValue(key, str.setNum(outputPatch->output()));
 }
@@ -27,6 +27,7 @@
 #include <QMutex>
 #include <QList>
 #include <QHash>
+#include <QTime>
 #include <QDir>
 
 #include "qlctypes.h"
@@ -41,6 +42,7 @@ class QLCOutPlugin;
 class UniverseArray;
 class OutputMapEditor;
 class OutputPatchEditor;
+class OutputWorker;
 
 #define KOutputNone QObject::tr("None")
 #define KXMLQLCOutputMap "OutputMap"
@@ -132,10 +134,20 @@ public:
 
     /**
      * Write current universe array data to plugins, each universe within
-     * the array to its assigned plugin.
+     * the array to its assigned plugin. The universes are posted to
+     * each plugin's OutputWorker so this never waits for the plugins.
+     *
+     * Only universes whose values have changed since they were last
+     * dumped are written, plus those whose keep-alive interval is due.
      */
     void dumpUniverses();
 
+    /**
+     * Make sure that everything dumped so far has been written to plugins.
+     * Blocks until the plugins have been written to.
+     */
+    void flushUniverses();
+
     /**
      * Get a read-only pointer to OutputMap's UniverseArray. You're not supposed
      * to write anything to the returned universes.
@@ -153,9 +165,43 @@ protected:
     /** The values of all universes */
     UniverseArray* m_universeArray;
 
-    /** When true, universes are dumped. Otherwise not. */
+    /** When true, all universes are dumped on the next dumpUniverses(),
+        whether their values have changed or not. */
     bool m_universeChanged;
 
+    /** Universe contents as they were last dumped, for change detection */
+    QVector <QByteArray> m_dumpedUniverses;
+
+    /** Times (msecs since m_keepAliveTime start) of each universe's
+        latest dump */
+    QVector <int> m_dumpTimes;
+
+    /*********************************************************************
+     * Keep-alive
+     *********************************************************************/
+public:
+    /**
+     * Set the keep-alive interval. Universes whose values don't change
+     * are re-dumped once per interval for devices that need periodic
+     * frames. Zero disables keep-alive refreshes altogether.
+     *
+     * @param msecs Keep-alive interval in milliseconds
+     */
+    void setKeepAliveInterval(quint32 msecs);
+
+    /** Get the keep-alive interval in milliseconds (0 == disabled) */
+    quint32 keepAliveInterval() const;
+
+    /** Get the default keep-alive interval in milliseconds */
+    static quint32 defaultKeepAliveInterval();
+
+protected:
+    /** Keep-alive interval in milliseconds */
+    quint32 m_keepAliveInterval;
+
+    /** Clock for universe dump times */
+    QTime m_keepAliveTime;
+
     /** Mutex guarding m_universeArray */
     QMutex m_universeMutex;
 
@@ -181,6 +227,23 @@ public:
      */
     quint32 universes() const;
 
+public slots:
+    /**
+     * Grow or shrink the number of universes. Remaining universes, their
+     * values and patches are kept as they are; dropped universes close
+     * their outputs. The number can't exceed KUniverseCountMax. Patches
+     * aren't saved or restored here; use saveDefaults(quint32) and
+     * loadDefaults(quint32) for that.
+     *
+     * @param universes The new number of universes
+     */
+    void setUniverses(quint32 universes);
+
+signals:
+    /** Signal that the number of universes has changed */
+    void universesChanged(quint32 universes);
+
+public:
     /**
      * Patch the given universe to go thru the given plugin
      *
@@ -304,6 +367,28 @@ protected:
     /** List containing all available plugins */
     QList <QLCOutPlugin*> m_plugins;
 
+    /*********************************************************************
+     * Output workers
+     *********************************************************************/
+public:
+    /**
+     * Get the OutputWorker that writes DMX data to the given plugin.
+     * Each plugin gets a worker thread of its own when appended to
+     * OutputMap; the thread starts when the first patch is attached.
+     *
+     * @param plugin The plugin whose worker to get
+     * @return The plugin's worker or NULL if the plugin is unknown
+     */
+    OutputWorker* outputWorker(QLCOutPlugin* plugin) const;
+
+protected:
+    /** Wake up all workers to write newly-posted universes */
+    void wakeOutputWorkers();
+
+protected:
+    /** One worker for each plugin in m_plugins */
+    QList <OutputWorker*> m_workers;
+
     /*********************************************************************
      * Defaults
      *********************************************************************/
@@ -313,10 +398,24 @@ public:
      */
     void loadDefaults();
 
+    /**
+     * Load the default patch of one universe from QLC global settings
+     *
+     * @param universe The universe to load
+     */
+    void loadDefaults(quint32 universe);
+
     /**
      * Save default settings for output mapper into QLC global settings
      */
     void saveDefaults();
+
+    /**
+     * Save the patch of one universe into QLC global settings
+     *
+     * @param universe The universe to save
+     */
+    void saveDefaults(quint32 universe);
 };
 
 #endif
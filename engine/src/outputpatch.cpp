@@ -20,29 +20,53 @@
 */
 
 #include <algorithm>
+#include <string.h>
 #include <QObject>
 #include <QtXml>
 
 #include "qlcoutplugin.h"
 #include "qlctypes.h"
+#include "outputworker.h"
 #include "outputpatch.h"
+#include "mastertimer.h"
 #include "outputmap.h"
 
+/** Refresh rates are kept with the worker's 1ms wake-up granularity */
+#define KOutputPatchMaxRefreshRate 1000
+
+/** A change bigger than this within one tick is a snap, not a fade */
+#define KOutputPatchSnapThreshold 128
+
 /*****************************************************************************
  * Initialization
  *****************************************************************************/
 
-OutputPatch::OutputPatch(QObject* parent) : QObject(parent)
+OutputPatch::OutputPatch(QObject* parent)
+    : QObject(parent)
+    , m_posted(512)
+    , m_refreshRate(0)
+    , m_interpolation(false)
+    , m_previous(512, char(0))
+    , m_current(512, char(0))
+    , m_currentTime(0)
+    , m_universesTaken(0)
+    , m_interpolated(512, char(0))
+    , m_pairedChannels(512, false)
+    , m_nextDump(0)
 {
     Q_ASSERT(parent != NULL);
 
     m_plugin = NULL;
     m_output = KOutputInvalid;
     m_dmxZeroBased = false;
+    m_worker = NULL;
 }
 
 OutputPatch::~OutputPatch()
 {
+    if (m_worker != NULL)
+        m_worker->detach(this);
+
     if (m_plugin != NULL)
         m_plugin->close(m_output);
 }
@@ -53,6 +77,13 @@ OutputPatch::~OutputPatch()
 
 void OutputPatch::set(QLCOutPlugin* plugin, quint32 output)
 {
+    /* Make sure that the worker isn't writing while outputs are changed */
+    if (m_worker != NULL)
+    {
+        m_worker->detach(this);
+        m_worker = NULL;
+    }
+
     if (m_plugin != NULL && m_output != KOutputInvalid)
         m_plugin->close(m_output);
 
@@ -60,7 +91,17 @@ void OutputPatch::set(QLCOutPlugin* plugin, quint32 output)
     m_output = output;
 
     if (m_plugin != NULL && m_output != KOutputInvalid)
+    {
         m_plugin->open(m_output);
+
+        OutputMap* outputMap = qobject_cast<OutputMap*> (parent());
+        if (outputMap != NULL)
+        {
+            m_worker = outputMap->outputWorker(m_plugin);
+            if (m_worker != NULL)
+                m_worker->attach(this);
+        }
+    }
 }
 
 QString OutputPatch::pluginName() const
@@ -117,3 +158,208 @@ void OutputPatch::dump(const QByteArray& universe)
     if (m_plugin != NULL && m_output != KOutputInvalid)
         m_plugin->outputDMX(m_output, universe);
 }
+
+void OutputPatch::post(const QByteArray& universe)
+{
+    /* If the worker hasn't written the previous universe yet, it's dropped
+       here. Nobody needs stale values when newer ones are available. */
+    m_posted.write(universe);
+}
+
+bool OutputPatch::dumpPosted(qint64 now, bool flush)
+{
+    bool posted = m_posted.read();
+
+    /* Without a refresh rate, write each posted universe once */
+    if (m_refreshRate == 0)
+    {
+        if (posted == true)
+            dump(m_posted.front());
+        return posted;
+    }
+
+    if (posted == true)
+        pushUniverse(m_posted.front(), now);
+
+    if (flush == true && posted == true)
+    {
+        dump(m_current);
+        return true;
+    }
+
+    if (m_universesTaken == 0 || now < m_nextDump)
+        return false;
+
+    /* Keep to the schedule, unless writing has fallen more than a whole
+       period behind it. Then there's no point in catching up. */
+    qint64 period = Q_INT64_C(1000000000) / m_refreshRate;
+    m_nextDump += period;
+    if (m_nextDump <= now)
+        m_nextDump = now + period;
+
+    if (m_interpolation == true && m_universesTaken > 1)
+        dump(interpolate(now));
+    else
+        dump(m_current);
+
+    return true;
+}
+
+qint64 OutputPatch::nextDumpTime() const
+{
+    if (m_refreshRate == 0 || m_universesTaken == 0)
+        return 0;
+    else
+        return m_nextDump;
+}
+
+/*****************************************************************************
+ * Refresh rate
+ *****************************************************************************/
+
+void OutputPatch::setRefreshRate(quint32 hz)
+{
+    hz = qMin(hz, maxRefreshRate());
+
+    /* Make sure that the worker isn't writing while the rate is changed */
+    if (m_worker != NULL)
+        m_worker->detach(this);
+
+    m_refreshRate = hz;
+    m_nextDump = 0;
+
+    /* Wake up the worker to take the new schedule into use */
+    if (m_worker != NULL)
+        m_worker->attach(this);
+}
+
+quint32 OutputPatch::refreshRate() const
+{
+    return m_refreshRate;
+}
+
+quint32 OutputPatch::maxRefreshRate()
+{
+    return KOutputPatchMaxRefreshRate;
+}
+
+void OutputPatch::setInterpolation(bool enable)
+{
+    if (m_worker != NULL)
+        m_worker->detach(this);
+
+    m_interpolation = enable;
+
+    if (m_worker != NULL)
+        m_worker->attach(this);
+}
+
+bool OutputPatch::interpolation() const
+{
+    return m_interpolation;
+}
+
+void OutputPatch::setFineChannels(const QList <QPair <int,int> >& pairs)
+{
+    if (pairs == m_finePairs)
+        return;
+
+    if (m_worker != NULL)
+        m_worker->detach(this);
+
+    m_finePairs.clear();
+    m_pairedChannels.fill(false);
+
+    QListIterator <QPair <int,int> > it(pairs);
+    while (it.hasNext() == true)
+    {
+        QPair <int,int> pair(it.next());
+        if (pair.first < 0 || pair.first >= m_pairedChannels.size() ||
+            pair.second < 0 || pair.second >= m_pairedChannels.size() ||
+            pair.first == pair.second)
+        {
+            continue;
+        }
+
+        m_finePairs << pair;
+        m_pairedChannels[pair.first] = true;
+        m_pairedChannels[pair.second] = true;
+    }
+
+    if (m_worker != NULL)
+        m_worker->attach(this);
+}
+
+QList <QPair <int,int> > OutputPatch::fineChannels() const
+{
+    return m_finePairs;
+}
+
+void OutputPatch::pushUniverse(const QByteArray& universe, qint64 now)
+{
+    /* Both buffers are reused, so that no memory is allocated per tick */
+    qSwap(m_previous, m_current);
+    if (m_current.size() != universe.size())
+        m_current.resize(universe.size());
+    memcpy(m_current.data(), universe.constData(), universe.size());
+
+    m_currentTime = now;
+    m_universesTaken = qMin(m_universesTaken + 1, 2);
+}
+
+const QByteArray& OutputPatch::interpolate(qint64 now)
+{
+    /* Fade from the previous universe to the newest one over one tick.
+       Universes are posted only when they change, so the time between
+       the last two of them says nothing about the fade's speed. */
+    qint64 period = Q_INT64_C(1000000000) / MasterTimer::frequency();
+    qint64 elapsed = now - m_currentTime;
+    if (elapsed >= period || m_previous.size() != m_current.size())
+        return m_current;
+
+    int fraction = int((qMax(elapsed, Q_INT64_C(0)) * 256) / period);
+
+    if (m_interpolated.size() != m_current.size())
+        m_interpolated.resize(m_current.size());
+
+    const uchar* previous = reinterpret_cast<const uchar*> (m_previous.constData());
+    const uchar* current = reinterpret_cast<const uchar*> (m_current.constData());
+    uchar* interpolated = reinterpret_cast<uchar*> (m_interpolated.data());
+
+    const bool* paired = m_pairedChannels.constData();
+    int pairable = qMin(m_current.size(), m_pairedChannels.size());
+
+    for (int i = 0; i < m_current.size(); i++)
+    {
+        /* 16-bit pairs are done below */
+        if (i < pairable && paired[i] == true)
+            continue;
+
+        int delta = int(current[i]) - int(previous[i]);
+        if (qAbs(delta) > KOutputPatchSnapThreshold)
+            interpolated[i] = current[i];
+        else
+            interpolated[i] = uchar(int(previous[i]) + ((delta * fraction) / 256));
+    }
+
+    /* Coarse & fine channels make one value, with the same snap rule */
+    for (int i = 0; i < m_finePairs.size(); i++)
+    {
+        int coarse = m_finePairs.at(i).first;
+        int fine = m_finePairs.at(i).second;
+        if (coarse >= m_current.size() || fine >= m_current.size())
+            continue;
+
+        int from = (int(previous[coarse]) << 8) | int(previous[fine]);
+        int to = (int(current[coarse]) << 8) | int(current[fine]);
+        int delta = to - from;
+        int value = to;
+        if (qAbs(delta) <= (KOutputPatchSnapThreshold << 8))
+            value = from + ((delta * fraction) / 256);
+
+        interpolated[coarse] = uchar(value >> 8);
+        interpolated[fine] = uchar(value & 0xFF);
+    }
+
+    return m_interpolated;
+}
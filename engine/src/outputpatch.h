@@ -23,13 +23,18 @@
 #define OUTPUTPATCH_H
 
 #include <QObject>
+#include <QVector>
+#include <QPair>
+#include <QList>
 
+#include "qlctriplebuffer.h"
 #include "qlctypes.h"
 
 class QDomDocument;
 class QDomElement;
 
 class QLCOutPlugin;
+class OutputWorker;
 class OutputMap;
 
 #define KXMLQLCOutputPatch "Patch"
@@ -69,13 +74,105 @@ protected:
     quint32 m_output;
     bool m_dmxZeroBased;
 
+    /** The worker that writes posted universes to m_plugin. Patches
+        owned by an OutputMap get one from it, others don't have any. */
+    OutputWorker* m_worker;
+
     /********************************************************************
      * Value dump
      ********************************************************************/
 public:
-    /** Write the contents of a 512 channel value buffer to the plugin.
-      * Called periodically by OutputMap. No need to call manually. */
+    /** Write the contents of a 512 channel value buffer to the plugin
+      * immediately, in the calling thread. */
     void dump(const QByteArray& universe);
+
+    /** Post the contents of a 512 channel value buffer to be written to
+      * the plugin by the patch's OutputWorker. Never blocks. Called
+      * periodically by OutputMap. No need to call manually. */
+    void post(const QByteArray& universe);
+
+    /** Write posted universes to the plugin. Without a refresh rate, the
+      * newest posted universe is written unless it has already been
+      * written. With a refresh rate, a universe is written whenever one is
+      * due, whether or not anything new has been posted. Called by
+      * OutputWorker.
+      *
+      * @param now The current time in QLCClock::monotonicTime() nanoseconds
+      * @param flush If true, a newly-posted universe is written right away
+      *              even if the patch has a refresh rate
+      * @return true if a universe was written, otherwise false */
+    bool dumpPosted(qint64 now, bool flush = false);
+
+    /** Get the time when dumpPosted() next writes a universe even though
+      * nothing new has been posted, or 0 if it writes only posted ones.
+      * Called by OutputWorker. */
+    qint64 nextDumpTime() const;
+
+protected:
+    /** Universes posted by MasterTimer, waiting to be written */
+    QLCTripleBuffer m_posted;
+
+    /********************************************************************
+     * Refresh rate
+     ********************************************************************/
+public:
+    /** Set the rate at which universes are written to the plugin,
+      * independent of MasterTimer's frequency. The newest universe is
+      * written again for outputs faster than MasterTimer and posted
+      * universes are skipped for slower ones. 0 (the default) writes each
+      * changed universe as soon as it's posted. Clamped to
+      * maxRefreshRate(). */
+    void setRefreshRate(quint32 hz);
+    quint32 refreshRate() const;
+
+    /** Get the highest accepted refresh rate in Hertz */
+    static quint32 maxRefreshRate();
+
+    /** Enable or disable interpolation between the last two posted
+      * universes. With a refresh rate faster than MasterTimer, the values
+      * written between two ticks are then faded from the previous universe
+      * towards the newest one over one tick period, instead of repeating
+      * the newest one. Interpolated output lags one tick behind. Channels
+      * that change by more than half their range in one tick are taken to
+      * be snaps (gobos, colour wheels etc.) and are never interpolated. */
+    void setInterpolation(bool enable);
+    bool interpolation() const;
+
+    /** Set the channels that hold 16-bit values (e.g. pan & tilt) as
+      * (coarse, fine) pairs of channel indices within the universe.
+      * Interpolation fades and snaps each pair as one value, so that a
+      * fine channel wrapping around doesn't make the output jump back. */
+    void setFineChannels(const QList <QPair <int,int> >& pairs);
+    QList <QPair <int,int> > fineChannels() const;
+
+protected:
+    /** Take $universe into use as the newest one, received at $now */
+    void pushUniverse(const QByteArray& universe, qint64 now);
+
+    /** Get the interpolated universe for the given time */
+    const QByteArray& interpolate(qint64 now);
+
+protected:
+    quint32 m_refreshRate;
+    bool m_interpolation;
+
+    /** The two newest posted universes and the time when the newest one
+        was taken in. Accessed only by the worker thread. */
+    QByteArray m_previous;
+    QByteArray m_current;
+    qint64 m_currentTime;
+    int m_universesTaken;
+
+    /** Buffer for interpolated values */
+    QByteArray m_interpolated;
+
+    /** 16-bit (coarse, fine) channel pairs and a flag for each channel that
+        belongs to one of them; read by the worker thread */
+    QList <QPair <int,int> > m_finePairs;
+    QVector <bool> m_pairedChannels;
+
+    /** The time when the next universe is due, with a refresh rate */
+    qint64 m_nextDump;
 };
 
 #endif
@@ -0,0 +1,184 @@
+/*
+  Q Light Controller
+  outputworker.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QMutexLocker>
+
+#include "qlcoutplugin.h"
+#include "qlcclock.h"
+#include "outputworker.h"
+#include "outputpatch.h"
+
+/****************************************************************************
+ * Initialization
+ ****************************************************************************/
+
+OutputWorker::OutputWorker(QObject* parent, QLCOutPlugin* plugin)
+    : QThread(parent)
+    , m_plugin(plugin)
+    , m_pending(0)
+    , m_running(false)
+{
+    Q_ASSERT(plugin != NULL);
+}
+
+OutputWorker::~OutputWorker()
+{
+    stop();
+}
+
+QLCOutPlugin* OutputWorker::plugin() const
+{
+    return m_plugin;
+}
+
+/****************************************************************************
+ * Patches
+ ****************************************************************************/
+
+void OutputWorker::attach(OutputPatch* patch)
+{
+    Q_ASSERT(patch != NULL);
+
+    m_patchMutex.lock();
+    if (m_patches.contains(patch) == false)
+        m_patches.append(patch);
+    m_patchMutex.unlock();
+
+    if (isRunning() == false)
+    {
+        m_running = true;
+        start();
+    }
+    else
+    {
+        /* The patch may need writing sooner than the worker would wake up */
+        wake();
+    }
+}
+
+void OutputWorker::detach(OutputPatch* patch)
+{
+    /* Waits until the worker has finished writing, if it's doing that */
+    QMutexLocker locker(&m_patchMutex);
+    m_patches.removeAll(patch);
+}
+
+int OutputWorker::patches() const
+{
+    QMutexLocker locker(&m_patchMutex);
+    return m_patches.size();
+}
+
+/****************************************************************************
+ * Writing
+ ****************************************************************************/
+
+void OutputWorker::wake()
+{
+    /* One pending wake-up is enough for the worker to write the newest
+       universes, no matter how many times it's woken up meanwhile. */
+    if (m_pending.testAndSetOrdered(0, 1) == true)
+        m_wakeup.release();
+}
+
+void OutputWorker::flush()
+{
+    QMutexLocker locker(&m_patchMutex);
+    writePatches(QLCClock::monotonicTime(), true);
+}
+
+void OutputWorker::stop()
+{
+    if (isRunning() == true)
+    {
+        m_running = false;
+        m_wakeup.release();
+        wait();
+    }
+}
+
+void OutputWorker::writePatches(qint64 now, bool flush)
+{
+    bool written = false;
+
+    QListIterator <OutputPatch*> it(m_patches);
+    while (it.hasNext() == true)
+    {
+        if (it.next()->dumpPosted(now, flush) == true)
+            written = true;
+    }
+
+    /* Let the plugin send everything it got in one go */
+    if (written == true)
+        m_plugin->flushDMX();
+}
+
+qint64 OutputWorker::nextDumpTime() const
+{
+    qint64 next = 0;
+
+    QListIterator <OutputPatch*> it(m_patches);
+    while (it.hasNext() == true)
+    {
+        qint64 time = it.next()->nextDumpTime();
+        if (time != 0 && (next == 0 || time < next))
+            next = time;
+    }
+
+    return next;
+}
+
+void OutputWorker::run()
+{
+    while (true)
+    {
+        m_patchMutex.lock();
+        qint64 next = nextDumpTime();
+        m_patchMutex.unlock();
+
+        /* Patches with a refresh rate of their own are written on time
+           also when nothing new has been posted */
+        bool woken = true;
+        if (next == 0)
+        {
+            m_wakeup.acquire();
+        }
+        else
+        {
+            qint64 wait = next - QLCClock::monotonicTime();
+            int msecs = 0;
+            if (wait > 0)
+                msecs = int((wait + Q_INT64_C(999999)) / Q_INT64_C(1000000));
+            woken = m_wakeup.tryAcquire(1, msecs);
+        }
+
+        if (m_running == false)
+            break;
+
+        /* Anything posted after this point needs another wake-up */
+        if (woken == true)
+            m_pending.fetchAndStoreOrdered(0);
+
+        m_patchMutex.lock();
+        writePatches(QLCClock::monotonicTime(), false);
+        m_patchMutex.unlock();
+    }
+}
@@ -0,0 +1,139 @@
+/*
+  Q Light Controller
+  outputworker.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef OUTPUTWORKER_H
+#define OUTPUTWORKER_H
+
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QThread>
+#include <QMutex>
+#include <QList>
+
+class QLCOutPlugin;
+class OutputPatch;
+
+/**
+ * OutputWorker writes DMX data to one output plugin in a thread of its own,
+ * so that slow devices can't hold back MasterTimer. MasterTimer posts
+ * universes to OutputPatches and wakes up the workers. Each worker then
+ * writes the newest posted universe of each of its patches to the plugin.
+ * Patches that have a refresh rate of their own are written on their own
+ * schedule instead, so the worker also wakes up whenever one of them is due.
+ */
+class OutputWorker : public QThread
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(OutputWorker)
+
+    /*********************************************************************
+     * Initialization
+     *********************************************************************/
+public:
+    /**
+     * Create a new OutputWorker for the given plugin. The thread is not
+     * started until the first patch is attached to the worker.
+     *
+     * @param parent The parent object that owns the worker
+     * @param plugin The plugin to write to
+     */
+    OutputWorker(QObject* parent, QLCOutPlugin* plugin);
+
+    /** Stop and destroy an OutputWorker */
+    ~OutputWorker();
+
+    /** Get the plugin that this worker writes to */
+    QLCOutPlugin* plugin() const;
+
+protected:
+    QLCOutPlugin* m_plugin;
+
+    /*********************************************************************
+     * Patches
+     *********************************************************************/
+public:
+    /**
+     * Start writing posted universes of the given patch to the plugin.
+     * Starts the worker thread if it's not yet running.
+     */
+    void attach(OutputPatch* patch);
+
+    /**
+     * Stop writing posted universes of the given patch. When this function
+     * returns, the worker is guaranteed not to touch the patch anymore.
+     */
+    void detach(OutputPatch* patch);
+
+    /** Get the number of attached patches */
+    int patches() const;
+
+protected:
+    /** Patches whose universes are written by this worker */
+    QList <OutputPatch*> m_patches;
+
+    /** Held while the patch list is changed or patches are being written */
+    mutable QMutex m_patchMutex;
+
+    /*********************************************************************
+     * Writing
+     *********************************************************************/
+public:
+    /**
+     * Wake up the worker to write newly-posted universes. Never blocks,
+     * no matter how slow the plugin is.
+     */
+    void wake();
+
+    /**
+     * Write the newest posted universes to the plugin in the calling thread
+     * unless the worker has already written them. When this function
+     * returns, everything posted before the call has reached the plugin.
+     */
+    void flush();
+
+    /** Stop the worker thread */
+    void stop();
+
+protected:
+    /** Write posted universes from each patch and flush the plugin if
+        anything was written. m_patchMutex must be held.
+        See OutputPatch::dumpPosted() for parameters. */
+    void writePatches(qint64 now, bool flush);
+
+    /** Get the earliest time when a patch is due to be written without
+        anything new posted, or 0 if none is. m_patchMutex must be held. */
+    qint64 nextDumpTime() const;
+
+    /** @reimp */
+    void run();
+
+protected:
+    /** Semaphore that the worker sleeps on until it's woken up */
+    QSemaphore m_wakeup;
+
+    /** Non-zero when a wake-up is pending, keeps m_wakeup from counting up */
+    QAtomicInt m_pending;
+
+    /** When false, the worker thread exits */
+    volatile bool m_running;
+};
+
+#endif
@@ -19,10 +19,11 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QXmlStreamReader>
 #include <QCoreApplication>
+#include <QMutexLocker>
 #include <QList>
 #include <QDebug>
-#include <QSet>
 
 #ifdef WIN32
 #   include <windows.h>
@@ -45,51 +46,48 @@ QLCFixtureDefCache::~QLCFixtureDefCache()
 const QLCFixtureDef* QLCFixtureDefCache::fixtureDef(
     const QString& manufacturer, const QString& model) const
 {
-    QListIterator <QLCFixtureDef*> it(m_defs);
-    while (it.hasNext() == true)
+    QMutexLocker locker(&m_mutex);
+
+    QLCFixtureDef* def = m_models.value(manufacturer).value(model, NULL);
+    if (def == NULL)
+        return NULL;
+
+    if (m_unloaded.contains(def) == true)
     {
-        const QLCFixtureDef* def = it.next();
-        if (def->manufacturer() == manufacturer && def->model() == model)
-            return def;
+        /* First use; load channels & modes on top of the header */
+        QString path = m_unloaded.take(def);
+        QFile::FileError error = def->loadXML(path);
+        if (error != QFile::NoError)
+        {
+            qWarning() << Q_FUNC_INFO << "Fixture definition loading from"
+                       << path << "failed:" << QLCFile::errorString(error);
+
+            /* A def with only a header (or half of its body) is useless, so
+               forget about it altogether, as if its header had failed too */
+            QHash <QString, QLCFixtureDef*>& defs(m_models[manufacturer]);
+            defs.remove(model);
+            if (defs.isEmpty() == true)
+                m_models.remove(manufacturer);
+            m_defs.removeAll(def);
+            delete def;
+
+            return NULL;
+        }
     }
 
-    return NULL;
+    return def;
 }
 
 QStringList QLCFixtureDefCache::manufacturers() const
 {
-    QSet <QString> makers;
-
-    // Gather a list of manufacturers
-    QListIterator <QLCFixtureDef*> it(m_defs);
-    while (it.hasNext() == true)
-        makers << it.next()->manufacturer();
-
-    // Bounce the QSet into a QStringList
-    QStringList list;
-    foreach (QString manuf, makers)
-        list << manuf;
-
-    return list;
+    QMutexLocker locker(&m_mutex);
+    return m_models.keys();
 }
 
 QStringList QLCFixtureDefCache::models(const QString& manufacturer) const
 {
-    QSet <QString> models;
-    QListIterator <QLCFixtureDef*> it(m_defs);
-    while (it.hasNext() == true)
-    {
-        QLCFixtureDef* def = it.next();
-        if (def->manufacturer() == manufacturer)
-            models << def->model();
-    }
-
-    // Bounce the QSet into a QStringList
-    QStringList list;
-    foreach (QString manuf, models)
-        list << manuf;
-
-    return list;
+    QMutexLocker locker(&m_mutex);
+    return m_models.value(manufacturer).keys();
 }
 
 bool QLCFixtureDefCache::addFixtureDef(QLCFixtureDef* fixtureDef)
@@ -97,8 +95,12 @@ bool QLCFixtureDefCache::addFixtureDef(QLCFixtureDef* fixtureDef)
     if (fixtureDef == NULL)
         return false;
 
-    if (models(fixtureDef->manufacturer()).contains(fixtureDef->model()) == false)
+    QMutexLocker locker(&m_mutex);
+
+    QHash <QString, QLCFixtureDef*>& defs(m_models[fixtureDef->manufacturer()]);
+    if (defs.contains(fixtureDef->model()) == false)
     {
+        defs[fixtureDef->model()] = fixtureDef;
         m_defs << fixtureDef;
         return true;
     }
@@ -119,36 +121,117 @@ bool QLCFixtureDefCache::load(const QDir& dir)
     QStringListIterator it(dir.entryList());
     while (it.hasNext() == true)
     {
-        QLCFixtureDef* fxi;
-        QString path;
-
-        path = dir.absoluteFilePath(it.next());
-
-        fxi = new QLCFixtureDef();
-        Q_ASSERT(fxi != NULL);
+        QString path(dir.absoluteFilePath(it.next()));
 
-        QFile::FileError error = fxi->loadXML(path);
-        if (error == QFile::NoError)
+        /* Only the header is read now, the rest when the def is used */
+        QLCFixtureDef* fxi = loadHeader(path);
+        if (fxi == NULL)
         {
-            /* Delete the def if it's a duplicate. */
-            if (addFixtureDef(fxi) == false)
-                delete fxi;
-            fxi = NULL;
+            qWarning() << Q_FUNC_INFO << "Fixture definition loading from"
+                       << path << "failed";
+        }
+        else if (addFixtureDef(fxi) == true)
+        {
+            QMutexLocker locker(&m_mutex);
+            m_unloaded[fxi] = path;
         }
         else
         {
-            qWarning() << Q_FUNC_INFO << "Fixture definition loading from"
-                       << path << "failed:" << QLCFile::errorString(error);
+            /* Delete the def if it's a duplicate. */
             delete fxi;
-            fxi = NULL;
         }
     }
 
     return true;
 }
 
+QLCFixtureDef* QLCFixtureDefCache::loadHeader(const QString& path)
+{
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly) == false)
+        return NULL;
+
+    QString manufacturer;
+    QString model;
+    QString type;
+    bool doctype = false;
+    bool root = false;
+
+    /* Stop reading as soon as the header has been passed, i.e. at the
+       first channel or at the end of the root element. */
+    QXmlStreamReader xml(&file);
+    while (xml.atEnd() == false)
+    {
+        xml.readNext();
+        if (xml.isDTD() == true)
+        {
+            doctype = (xml.dtdName().toString() == KXMLQLCFixtureDefDocument);
+        }
+        else if (xml.isStartElement() == true)
+        {
+            QString tag(xml.name().toString());
+            if (root == false)
+            {
+                if (tag != KXMLQLCFixtureDef)
+                    break;
+                root = true;
+            }
+            else if (tag == KXMLQLCFixtureDefManufacturer)
+            {
+                manufacturer = xml.readElementText();
+            }
+            else if (tag == KXMLQLCFixtureDefModel)
+            {
+                model = xml.readElementText();
+            }
+            else if (tag == KXMLQLCFixtureDefType)
+            {
+                type = xml.readElementText();
+            }
+            else if (tag == KXMLQLCCreator)
+            {
+                /* Skip everything inside the creator element */
+                while (xml.atEnd() == false &&
+                       (xml.isEndElement() == false ||
+                        xml.name().toString() != KXMLQLCCreator))
+                {
+                    xml.readNext();
+                }
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    if (xml.hasError() == true)
+    {
+        qWarning() << Q_FUNC_INFO << "Error loading file" << path << ":"
+                   << xml.errorString() << ", line:" << xml.lineNumber()
+                   << ", col:" << xml.columnNumber();
+        return NULL;
+    }
+
+    if (doctype == false || root == false)
+    {
+        qWarning() << Q_FUNC_INFO << path << "is not a fixture definition file";
+        return NULL;
+    }
+
+    QLCFixtureDef* fxi = new QLCFixtureDef();
+    fxi->setManufacturer(manufacturer);
+    fxi->setModel(model);
+    fxi->setType(type);
+    return fxi;
+}
+
 void QLCFixtureDefCache::clear()
 {
+    QMutexLocker locker(&m_mutex);
+    m_unloaded.clear();
+    m_models.clear();
+
     while (m_defs.isEmpty() == false)
         delete m_defs.takeFirst();
 }
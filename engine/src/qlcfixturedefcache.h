@@ -24,7 +24,8 @@
 
 #include <QStringList>
 #include <QString>
-#include <QMap>
+#include <QMutex>
+#include <QHash>
 #include <QDir>
 
 #include "qlctypes.h"
@@ -37,14 +38,19 @@ class QLCFixtureDef;
  * manufacturer names with QLCFixturedefCache::manufacturers() and subsequently
  * all models for a particular manufacturer with QLCFixtureDefCache::models().
  *
- * The internal structure is a two-tier map (m_models), with the first tier
- * containing manufacturer names as the keys for the first map. The value of
- * each key is another map (the second-tier) whose keys are model names. The
- * value for each model name entry in the second-tier map is the actual
+ * The internal structure is a two-tier hash (m_models), with the first tier
+ * containing manufacturer names as the keys for the first hash. The value of
+ * each key is another hash (the second-tier) whose keys are model names. The
+ * value for each model name entry in the second-tier hash is the actual
  * QLCFixtureDef instance.
  *
  * Multiple manufacturer & model combinations are discarded.
  *
+ * Definitions are loaded lazily: load() reads only the manufacturer, model
+ * and type from each file, which is enough for listing them. The channels
+ * and modes of a definition are loaded when the definition is first asked
+ * for with fixtureDef().
+ *
  * Because this component is meant to be used only on the application side,
  * the returned fixture definitions are const, preventing any modifications to
  * the definitions. Modifying the definitions would also screw up the mapping
@@ -67,10 +73,12 @@ public:
     /**
      * Get a fixture definition by its manufacturer and model. Only
      * const methods can be accessed for returned fixture definitions.
+     * If the definition hasn't been used yet, it's fully loaded first. If
+     * that fails, the definition is removed from the cache altogether.
      *
      * @param manufacturer The fixture definition's manufacturer
      * @param model The fixture definition's model
-     * @return A matching fixture definition or NULL if not found
+     * @return A matching fixture definition or NULL if not found or broken
      */
     const QLCFixtureDef* fixtureDef(const QString& manufacturer,
                                     const QString& model) const;
@@ -128,7 +136,29 @@ public:
     static QDir userDefinitionDirectory();
 
 protected:
-    QList <QLCFixtureDef*> m_defs;
+    /**
+     * Create a fixture definition that contains only the manufacturer,
+     * model and type read from the given file.
+     *
+     * @param path The file to read
+     * @return A new fixture definition or NULL if the file is not valid
+     */
+    static QLCFixtureDef* loadHeader(const QString& path);
+
+protected:
+    /** All definitions, including those that haven't been fully loaded.
+        Definitions that fail to load are removed by fixtureDef(). */
+    mutable QList <QLCFixtureDef*> m_defs;
+
+    /** Manufacturer -> model -> definition */
+    mutable QHash <QString, QHash <QString, QLCFixtureDef*> > m_models;
+
+    /** Files of the definitions that haven't been fully loaded yet */
+    mutable QHash <QLCFixtureDef*, QString> m_unloaded;
+
+    /** Guards all of the above, since fixtureDef() loads definitions on
+        demand and removes the ones that can't be loaded */
+    mutable QMutex m_mutex;
 };
 
 #endif
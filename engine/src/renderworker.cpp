@@ -0,0 +1,83 @@
+/*
+  Q Light Controller
+  renderworker.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "renderworker.h"
+#include "mastertimer.h"
+
+/****************************************************************************
+ * Initialization
+ ****************************************************************************/
+
+RenderWorker::RenderWorker(MasterTimer* timer)
+    : QThread(timer)
+    , m_timer(timer)
+    , m_running(false)
+{
+    Q_ASSERT(timer != NULL);
+}
+
+RenderWorker::~RenderWorker()
+{
+    stop();
+}
+
+/****************************************************************************
+ * Rendering
+ ****************************************************************************/
+
+void RenderWorker::render()
+{
+    if (isRunning() == false)
+    {
+        m_running = true;
+        start();
+    }
+
+    m_wakeup.release();
+}
+
+void RenderWorker::waitRendered()
+{
+    m_rendered.acquire();
+}
+
+void RenderWorker::stop()
+{
+    if (isRunning() == true)
+    {
+        m_running = false;
+        m_wakeup.release();
+        wait();
+    }
+}
+
+void RenderWorker::run()
+{
+    while (true)
+    {
+        m_wakeup.acquire();
+        if (m_running == false)
+            break;
+
+        m_timer->renderBatch();
+        m_rendered.release();
+    }
+}
@@ -0,0 +1,75 @@
+/*
+  Q Light Controller
+  renderworker.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef RENDERWORKER_H
+#define RENDERWORKER_H
+
+#include <QSemaphore>
+#include <QThread>
+
+class MasterTimer;
+
+/**
+ * RenderWorker is a helper thread that MasterTimer uses for writing
+ * functions in parallel. When woken up, the worker takes functions one by
+ * one from MasterTimer's current batch and writes each one into its own
+ * UniverseLayer, until the batch has been exhausted. MasterTimer's own
+ * thread does the same, so the workers that get done early just end up
+ * taking more functions than the others.
+ */
+class RenderWorker : public QThread
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(RenderWorker)
+
+public:
+    /**
+     * Create a new RenderWorker for the given MasterTimer. The thread is
+     * not started until the worker is needed for the first time.
+     *
+     * @param timer The MasterTimer that owns the worker
+     */
+    RenderWorker(MasterTimer* timer);
+
+    /** Stop and destroy a RenderWorker */
+    ~RenderWorker();
+
+    /** Start writing functions from MasterTimer's current batch */
+    void render();
+
+    /** Wait until the worker has finished with the current batch */
+    void waitRendered();
+
+    /** Stop the worker thread */
+    void stop();
+
+protected:
+    /** The worker thread function */
+    void run();
+
+protected:
+    MasterTimer* m_timer;
+    QSemaphore m_wakeup;
+    QSemaphore m_rendered;
+    volatile bool m_running;
+};
+
+#endif
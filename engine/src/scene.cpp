@@ -296,35 +296,49 @@ void Scene::arm()
     Doc* doc = qobject_cast <Doc*> (parent());
     Q_ASSERT(doc != NULL);
 
-    m_armedChannels.clear();
+    m_fadePlan.clear();
+
+    /* Values of the same fixture are usually next to each other, so look
+       each fixture up only once per run of its values */
+    quint32 fxi_id = Fixture::invalidId();
+    Fixture* fxi = NULL;
 
     /* Fixate exact DMX addresses */
     QMutableListIterator <SceneValue> it(m_values);
     while (it.hasNext() == true)
     {
-        SceneValue value(it.next());
+        const SceneValue& value(it.next());
+
+        if (value.fxi != fxi_id)
+        {
+            fxi_id = value.fxi;
+            fxi = doc->fixture(fxi_id);
+        }
 
-        Fixture* fxi = doc->fixture(value.fxi);
-        if (fxi == NULL || fxi->channel(value.channel) == NULL)
+        const QLCChannel* channel = NULL;
+        if (fxi != NULL)
+            channel = fxi->channel(value.channel);
+
+        if (channel == NULL)
         {
             // Remove such fixtures and channels that don't exist
             it.remove();
             continue;
         }
 
-        FadeChannel fc;
-        fc.setAddress(fxi->universeAddress() + value.channel);
-        fc.setGroup(fxi->channel(value.channel)->group());
-        fc.setTarget(value.value);
-        m_armedChannels << fc;
+        m_fadePlan.append(value.fxi, fxi->universeAddress() + value.channel,
+                          channel->group(), value.value);
     }
 
+    /* Sorted by address, the plan is written to universes sequentially */
+    m_fadePlan.sort();
+
     resetElapsed();
 }
 
 void Scene::disarm()
 {
-    m_armedChannels.clear();
+    m_fadePlan.clear();
 }
 
 void Scene::write(MasterTimer* timer, UniverseArray* universes)
@@ -333,79 +347,25 @@ void Scene::write(MasterTimer* timer, UniverseArray* universes)
     Q_ASSERT(universes != NULL);
 
     /* Count ready channels so that the scene can be stopped */
-    quint32 ready = m_armedChannels.count();
-
-    /* Iterator for all scene channels */
-    QMutableListIterator <FadeChannel> it(m_armedChannels);
+    quint32 ready = m_fadePlan.size();
 
     /* Get starting values for each channel on the first pass */
     if (elapsed() == 0)
-    {
-        while (it.hasNext() == true)
-        {
-            FadeChannel& fc(it.next());
-
-            /* Get the starting value from universes. Important
-               to cast to uchar, since UniverseArray handles signed
-               char, whereas uchar is unsigned. Without cast,
-               this will result in negative values when x > 127 */
-            fc.setStart(uchar(universes->preGMValues()[fc.address()]));
-            fc.setCurrent(fc.start());
-
-            // Don't touch the value at all if it's already on target
-            if (fc.start() == fc.target())
-            {
-                fc.setReady(true);
-                if (fc.group() != QLCChannel::Intensity)
-                    ready--;
-            }
-            else
-            {
-                fc.setReady(false);
-            }
-        }
-
-        /* Reel back to start of list */
-        it.toFront();
-    }
+        ready -= m_fadePlan.begin(universes);
 
     // Grab current fade bus value
     quint32 fadeTime = Bus::instance()->value(m_busID);
 
-    while (it.hasNext() == true)
+    if (elapsed() >= fadeTime)
     {
-        FadeChannel& fc(it.next());
-        if (elapsed() >= fadeTime)
-        {
-            if (fc.group() == QLCChannel::Intensity)
-            {
-                // Don't do "ready--" for intensity channels to keep the
-                // scene on as long as its manually stopped.
-                fc.setReady(true);
-                universes->write(fc.address(), fc.target(), fc.group());
-            }
-            else if (fc.isReady() == false)
-            {
-                // If an LTP channel has not been marked ready (i.e. we've just
-                // consumed all time) mark it ready so that its value will not
-                // be written anymore (otherwise it would not be LTP anymore).
-                ready--;
-                fc.setReady(true);
-                universes->write(fc.address(), fc.target(), fc.group());
-            }
-            else
-            {
-                // Once an LTP-channel (non-intensity) has been marked ready,
-                // it's value is no longer touched by scene.
-            }
-        }
-        else
-        {
-            /* Write the next value to the universe buffer */
-            universes->write(fc.address(),
-                             fc.calculateCurrent(fadeTime, elapsed()),
-                             fc.group());
-        }
+        // Intensity channels are kept up for as long as the scene runs.
+        // LTP channels are written only once after the fade is complete.
+        ready -= m_fadePlan.finish(universes);
+    }
+    else
+    {
+        /* Write the next values to the universe buffer */
+        m_fadePlan.fade(universes, fadeTime, elapsed());
     }
 
     /* Next time unit */
@@ -418,24 +378,42 @@ void Scene::write(MasterTimer* timer, UniverseArray* universes)
         stop();
 }
 
+bool Scene::canWriteInParallel() const
+{
+    return true;
+}
+
 void Scene::writeValues(UniverseArray* universes, quint32 fxi_id,
                         QLCChannel::Group grp)
 {
     Q_ASSERT(universes != NULL);
 
-    for (int i = 0; i < m_armedChannels.size() && i < m_values.size(); i++)
+    /* EFXs may call this from several render threads at the same time, so
+       the plan is only read here. */
+    for (int i = 0; i < m_fadePlan.size(); i++)
     {
-        if (fxi_id == Fixture::invalidId() || m_values[i].fxi == fxi_id)
+        if (fxi_id != Fixture::invalidId() && m_fadePlan.fixture(i) != fxi_id)
+            continue;
+
+        if (grp == QLCChannel::NoGroup || m_fadePlan.group(i) == grp)
         {
-            const FadeChannel& fc(m_armedChannels[i]);
-            if (grp == QLCChannel::NoGroup || fc.group() == grp)
-                universes->write(fc.address(), fc.target(), fc.group());
+            universes->write(m_fadePlan.address(i), m_fadePlan.target(i),
+                             m_fadePlan.group(i));
         }
     }
 }
 
 QList <FadeChannel> Scene::armedChannels() const
 {
-    return m_armedChannels;
-}
+    QList <FadeChannel> list;
+    for (int i = 0; i < m_fadePlan.size(); i++)
+    {
+        FadeChannel fc(m_fadePlan.address(i), m_fadePlan.group(i),
+                       m_fadePlan.start(i), m_fadePlan.target(i),
+                       m_fadePlan.current(i));
+        fc.setReady(m_fadePlan.isReady(i));
+        list << fc;
+    }
 
+    return list;
+}
@@ -27,6 +27,7 @@
 
 #include "fadechannel.h"
 #include "scenevalue.h"
+#include "fadeplan.h"
 #include "dmxsource.h"
 #include "qlctypes.h"
 #include "function.h"
@@ -160,6 +161,12 @@ public:
     /** @reimpl */
     void write(MasterTimer* timer, UniverseArray* universes);
 
+    /**
+     * Scenes read universes only on their first pass, to get the starting
+     * values for fading. After that, they can be written in parallel.
+     */
+    bool canWriteInParallel() const;
+
     /**
      * Write the scene values to OutputMap. If fxi_id is given, writes
      * values only for the specified fixture.
@@ -175,11 +182,15 @@ public:
                              quint32 fxi_id = Fixture::invalidId(),
                              QLCChannel::Group grp = QLCChannel::NoGroup);
 
-    /** Get a list of channels that have been armed for running */
+    /**
+     * Get a list of channels that have been armed for running, sorted by
+     * their absolute DMX address.
+     */
     QList <FadeChannel> armedChannels() const;
 
 protected:
-    QList <FadeChannel> m_armedChannels;
+    /** Channels armed for running, sorted by address */
+    FadePlan m_fadePlan;
 };
 
 #endif
@@ -12,6 +12,9 @@ QTPLUGIN =
 
 INCLUDEPATH += ../../plugins/interfaces
 
+# MasterTimer uses clock_nanosleep() from librt
+unix:!macx:LIBS += -lrt
+
 #############################################################################
 # Installation
 #############################################################################
@@ -50,18 +53,24 @@ HEADERS += bus.h \
            efx.h \
            efxfixture.h \
            fadechannel.h \
+           fadeplan.h \
            fixture.h \
            function.h \
+           inputlistener.h \
            inputmap.h \
            inputpatch.h \
            intensitygenerator.h \
            mastertimer.h \
            universearray.h \
+           universelayer.h \
            outputmap.h \
            outputpatch.h \
+           outputworker.h \
            palettegenerator.h \
+           renderworker.h \
            scene.h \
-           scenevalue.h
+           scenevalue.h \
+           tickprofile.h
 
 # Fixture metadata
 SOURCES += qlccapability.cpp \
@@ -84,6 +93,7 @@ SOURCES += bus.cpp \
            efx.cpp \
            efxfixture.cpp \
            fadechannel.cpp \
+           fadeplan.cpp \
            fixture.cpp \
            function.cpp \
            inputmap.cpp \
@@ -91,15 +101,20 @@ SOURCES += bus.cpp \
            intensitygenerator.cpp \
            mastertimer.cpp \
            universearray.cpp \
+           universelayer.cpp \
            outputmap.cpp \
            outputpatch.cpp \
+           outputworker.cpp \
            palettegenerator.cpp \
+           renderworker.cpp \
            scene.cpp \
-           scenevalue.cpp
+           scenevalue.cpp \
+           tickprofile.cpp
 
 # Interfaces
 HEADERS += ../../plugins/interfaces/qlcinplugin.h \
-           ../../plugins/interfaces/qlcoutplugin.h
+           ../../plugins/interfaces/qlcoutplugin.h \
+           ../../plugins/interfaces/qlctriplebuffer.h
 
 #############################################################################
 # qlcconfig.h generation
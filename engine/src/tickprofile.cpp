@@ -0,0 +1,87 @@
+/*
+  Q Light Controller
+  tickprofile.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "tickprofile.h"
+
+/****************************************************************************
+ * Cost
+ ****************************************************************************/
+
+TickProfile::Cost::Cost()
+    : count(0)
+    , total(0)
+    , max(0)
+{
+}
+
+void TickProfile::Cost::add(qint64 nsecs)
+{
+    count++;
+    total += nsecs;
+    if (nsecs > max)
+        max = nsecs;
+}
+
+qint64 TickProfile::Cost::average() const
+{
+    if (count == 0)
+        return 0;
+    else
+        return total / qint64(count);
+}
+
+/****************************************************************************
+ * TickProfile
+ ****************************************************************************/
+
+TickProfile::TickProfile()
+    : ticks(0)
+{
+}
+
+void TickProfile::reset()
+{
+    ticks = 0;
+    for (int i = 0; i < SpanCount; i++)
+        spans[i] = Cost();
+    functions.clear();
+    dmxSources.clear();
+    inputLatency = Cost();
+}
+
+QString TickProfile::spanToString(Span span)
+{
+    switch (span)
+    {
+    case TickSpan:
+        return QString("Tick");
+    case IntensitySpan:
+        return QString("Intensity reset");
+    case FunctionsSpan:
+        return QString("Functions");
+    case DMXSourcesSpan:
+        return QString("DMX sources");
+    case DumpSpan:
+        return QString("Output dump");
+    default:
+        return QString();
+    }
+}
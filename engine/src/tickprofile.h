@@ -0,0 +1,96 @@
+/*
+  Q Light Controller
+  tickprofile.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef TICKPROFILE_H
+#define TICKPROFILE_H
+
+#include <QString>
+#include <QHash>
+
+#include "qlctypes.h"
+
+class DMXSource;
+
+/**
+ * TickProfile holds accumulated timing information about MasterTimer ticks:
+ * how long each stage of a tick has taken and how much time each function
+ * and DMX source has spent writing their values. MasterTimer records the
+ * information when profiling is enabled and hands out copies of it thru
+ * MasterTimer::profile(). All times are in nanoseconds.
+ */
+class TickProfile
+{
+public:
+    /** Stages of a MasterTimer tick */
+    enum Span
+    {
+        TickSpan = 0,      /** The whole tick */
+        IntensitySpan,     /** Zeroing intensity channels */
+        FunctionsSpan,     /** Writing running functions */
+        DMXSourcesSpan,    /** Writing registered DMX sources */
+        DumpSpan,          /** Dumping universes to output */
+        SpanCount
+    };
+
+    /** Get a human-readable name for a tick stage */
+    static QString spanToString(Span span);
+
+    /** Accumulated cost of one span, function or DMX source */
+    class Cost
+    {
+    public:
+        Cost();
+
+        /** Add one measurement of $nsecs nanoseconds */
+        void add(qint64 nsecs);
+
+        /** Get the average time of one measurement */
+        qint64 average() const;
+
+        quint64 count;
+        qint64 total;
+        qint64 max;
+    };
+
+public:
+    TickProfile();
+
+    /** Clear all accumulated information */
+    void reset();
+
+    /** Number of profiled ticks */
+    quint64 ticks;
+
+    /** Cost of each tick stage */
+    Cost spans[SpanCount];
+
+    /** Cost of each function's write() calls, by function ID */
+    QHash <t_function_id,Cost> functions;
+
+    /** Cost of each DMX source's writeDMX() calls */
+    QHash <DMXSource*,Cost> dmxSources;
+
+    /** Time from receiving input values in input plugins until the tick
+        that writes them out has dumped its universes */
+    Cost inputLatency;
+};
+
+#endif
@@ -19,7 +19,9 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <string.h>
 #include <math.h>
+
 #include "universearray.h"
 #include "qlctypes.h"
 
@@ -28,25 +30,93 @@
 #define KXMLQLCGMChannelModeAllChannels "All"
 #define KXMLQLCGMChannelModeIntensity "Intensity"
 
+/** Returned by postGMUniverse() for nonexistent universes */
+static const QByteArray KEmptyUniverse;
+
 /****************************************************************************
  * Initialization
  ****************************************************************************/
 
 UniverseArray::UniverseArray(int size)
-    : m_size(size)
+    : m_layer(NULL)
+    , m_size(size)
     , m_preGMValues(new QByteArray(size, char(0)))
     , m_postGMValues(new QByteArray(size, char(0)))
+    , m_gMChannels(new uchar[size])
+{
+    m_gMChannelMode = GMIntensity;
+    m_gMValueMode = GMReduce;
+    m_gMValue = 255;
+    m_gMFraction = 1.0;
+    memset(m_gMChannels, GMFlagNone, size);
+    updateGMTable();
+
+    /* Detach once here and never again: all writes are done in place */
+    m_preGMData = reinterpret_cast<uchar*> (m_preGMValues->data());
+    m_postGMData = reinterpret_cast<uchar*> (m_postGMValues->data());
+
+    m_dirtyUniverses = NULL;
+    m_intensityUniverses = NULL;
+    initUniverses();
+}
+
+UniverseArray::UniverseArray(UniverseLayer* layer)
+    : m_layer(layer)
+    , m_size(0)
+    , m_preGMValues(NULL)
+    , m_postGMValues(NULL)
+    , m_gMChannels(NULL)
 {
+    Q_ASSERT(layer != NULL);
+
     m_gMChannelMode = GMIntensity;
     m_gMValueMode = GMReduce;
     m_gMValue = 255;
     m_gMFraction = 1.0;
+    updateGMTable();
+
+    m_preGMData = NULL;
+    m_postGMData = NULL;
+    m_dirtyUniverses = NULL;
+    m_intensityUniverses = NULL;
+}
+
+void UniverseArray::attach(const UniverseArray* source)
+{
+    Q_ASSERT(m_layer != NULL);
+    Q_ASSERT(source != NULL);
+    Q_ASSERT(source->m_layer == NULL);
+
+    /* Nothing is copied but the GM state; the buffers are the source's own.
+       Assigning the implicitly shared list of views doesn't allocate. */
+    m_size = source->m_size;
+    m_gMValueMode = source->m_gMValueMode;
+    m_gMChannelMode = source->m_gMChannelMode;
+    m_gMValue = source->m_gMValue;
+    m_gMFraction = source->m_gMFraction;
+    memcpy(m_gMTable, source->m_gMTable, sizeof(m_gMTable));
+
+    m_preGMValues = source->m_preGMValues;
+    m_postGMValues = source->m_postGMValues;
+    m_preGMData = source->m_preGMData;
+    m_postGMData = source->m_postGMData;
+    m_postGMUniverses = source->m_postGMUniverses;
+    m_gMChannels = source->m_gMChannels;
+    m_dirtyUniverses = source->m_dirtyUniverses;
+    m_intensityUniverses = source->m_intensityUniverses;
 }
 
 UniverseArray::~UniverseArray()
 {
+    /* Views don't own the buffers they read */
+    if (m_layer != NULL)
+        return;
+
     delete m_preGMValues;
     delete m_postGMValues;
+    delete [] m_gMChannels;
+    delete [] m_dirtyUniverses;
+    delete [] m_intensityUniverses;
 }
 
 int UniverseArray::size() const
@@ -54,22 +124,96 @@ int UniverseArray::size() const
     return m_size;
 }
 
+void UniverseArray::setUniverses(int universes)
+{
+    Q_ASSERT(m_layer == NULL);
+
+    int size = MAX(universes, 0) * 512;
+    if (size == m_size)
+        return;
+
+    /* QByteArray keeps the old contents (or what fits) when resized */
+    m_preGMValues->resize(size);
+    m_postGMValues->resize(size);
+    m_preGMData = reinterpret_cast<uchar*> (m_preGMValues->data());
+    m_postGMData = reinterpret_cast<uchar*> (m_postGMValues->data());
+
+    uchar* gMChannels = new uchar[size];
+    memcpy(gMChannels, m_gMChannels, MIN(size, m_size));
+    if (size > m_size)
+    {
+        memset(m_preGMData + m_size, 0, size - m_size);
+        memset(m_postGMData + m_size, 0, size - m_size);
+        memset(gMChannels + m_size, GMFlagNone, size - m_size);
+    }
+    delete [] m_gMChannels;
+    m_gMChannels = gMChannels;
+
+    m_size = size;
+    initUniverses();
+}
+
+void UniverseArray::initUniverses()
+{
+    int oldCount = m_postGMUniverses.size();
+
+    /* Raw views to each universe don't copy anything; they just point to
+       the corresponding 512-channel range in m_postGMValues. */
+    m_postGMUniverses.clear();
+    for (int i = 0; i < m_size; i += 512)
+    {
+        const char* data = reinterpret_cast<const char*> (m_postGMData + i);
+        m_postGMUniverses << QByteArray::fromRawData(data, MIN(512, m_size - i));
+    }
+
+    /* Keep the flags of existing universes. New ones are dirty so that
+       they get dumped, but they can't contain any intensities yet. */
+    int count = m_postGMUniverses.size();
+    bool* dirty = new bool[count];
+    bool* intensity = new bool[count];
+    for (int i = 0; i < count; i++)
+    {
+        if (i < oldCount)
+        {
+            dirty[i] = m_dirtyUniverses[i];
+            intensity[i] = m_intensityUniverses[i];
+        }
+        else
+        {
+            dirty[i] = true;
+            intensity[i] = false;
+        }
+    }
+
+    delete [] m_dirtyUniverses;
+    m_dirtyUniverses = dirty;
+    delete [] m_intensityUniverses;
+    m_intensityUniverses = intensity;
+}
+
 void UniverseArray::reset()
 {
-    m_preGMValues->fill(0);
-    m_postGMValues->fill(0);
-    m_gMIntensityChannels.clear();
-    m_gMNonIntensityChannels.clear();
+    Q_ASSERT(m_layer == NULL);
+
+    memset(m_preGMData, 0, m_size);
+    memset(m_postGMData, 0, m_size);
+    memset(m_gMChannels, GMFlagNone, m_size);
+    setAllUniversesDirty();
+
+    for (int i = 0; i < m_postGMUniverses.size(); i++)
+        m_intensityUniverses[i] = false;
 }
 
 void UniverseArray::reset(int address, int range)
 {
+    Q_ASSERT(m_layer == NULL);
+
     for (int i = address; i < address + range && i < size(); i++)
     {
-        m_preGMValues->data()[i] = 0;
-        m_postGMValues->data()[i] = 0;
-        m_gMIntensityChannels.remove(i);
-        m_gMNonIntensityChannels.remove(i);
+        m_preGMData[i] = 0;
+        m_postGMData[i] = 0;
+        m_gMChannels[i] = GMFlagNone;
+        m_dirtyUniverses[i >> 9] = true;
     }
 }
 
@@ -79,26 +223,28 @@ void UniverseArray::reset(int address, int range)
 
 void UniverseArray::zeroIntensityChannels()
 {
-    QSetIterator <int> it(m_gMIntensityChannels);
-    while (it.hasNext() == true)
-    {
-        int channel(it.next());
-        m_preGMValues->data()[channel] = 0;
-        m_postGMValues->data()[channel] = 0;
-    }
-}
+    Q_ASSERT(m_layer == NULL);
 
-bool UniverseArray::checkHTP(int channel, uchar value, QLCChannel::Group group) const
-{
-    if (group == QLCChannel::Intensity && value < uchar(preGMValues()[channel]))
+    /* A straight pass thru the flags is cheaper than any lookup structure
+       and compilers are able to vectorize it. Channel flags are left as
+       they are, just like the values' owners would expect. Universes that
+       have never had any intensity channels are skipped altogether. */
+    for (int universe = 0; universe < m_postGMUniverses.size(); universe++)
     {
-        /* Current value is higher than new value and HTP applies: reject. */
-        return false;
-    }
-    else
-    {
-        /* Current value is below new value or HTP does not apply: accept. */
-        return true;
+        if (m_intensityUniverses[universe] == false)
+            continue;
+
+        int end = MIN((universe + 1) * 512, m_size);
+        for (int i = universe * 512; i < end; i++)
+        {
+            if ((m_gMChannels[i] & GMFlagIntensity) != 0)
+            {
+                if (m_postGMData[i] != 0)
+                    m_dirtyUniverses[universe] = true;
+                m_preGMData[i] = 0;
+                m_postGMData[i] = 0;
+            }
+        }
     }
 }
 
@@ -151,7 +297,8 @@ void UniverseArray::setGMValueMode(UniverseArray::GMValueMode mode)
     if (m_gMValueMode != mode)
     {
         m_gMValueMode = mode;
-        setGMValue(gMValue());
+        updateGMTable();
+        applyGMToAll();
     }
 }
 
@@ -165,18 +312,7 @@ void UniverseArray::setGMChannelMode(UniverseArray::GMChannelMode mode)
     if (m_gMChannelMode != mode)
     {
         m_gMChannelMode = mode;
-        setGMValue(gMValue());
-    }
-
-    if (gMChannelMode() == GMIntensity)
-    {
-        QSetIterator <int> it(m_gMNonIntensityChannels);
-        while (it.hasNext() == true)
-        {
-            int channel(it.next());
-            char chValue(m_preGMValues->data()[channel]);
-            write(channel, chValue, QLCChannel::NoGroup);
-        }
+        applyGMToAll();
     }
 }
 
@@ -190,24 +326,8 @@ void UniverseArray::setGMValue(uchar value)
     m_gMValue = value;
     m_gMFraction = CLAMP(double(value) / double(UCHAR_MAX), 0.0, 1.0);
 
-    QSetIterator <int> it(m_gMIntensityChannels);
-    while (it.hasNext() == true)
-    {
-        int channel(it.next());
-        char chValue(m_preGMValues->data()[channel]);
-        write(channel, chValue, QLCChannel::Intensity);
-    }
-
-    if (gMChannelMode() == GMAllChannels)
-    {
-        QSetIterator <int> it(m_gMNonIntensityChannels);
-        while (it.hasNext() == true)
-        {
-            int channel(it.next());
-            char chValue(m_preGMValues->data()[channel]);
-            write(channel, chValue, QLCChannel::NoGroup);
-        }
-    }
+    updateGMTable();
+    applyGMToAll();
 }
 
 uchar UniverseArray::gMValue() const
@@ -220,59 +340,156 @@ double UniverseArray::gMFraction() const
     return m_gMFraction;
 }
 
-const QByteArray UniverseArray::postGMValues() const
+QByteArray UniverseArray::postGMValues() const
+{
+    /* Deep copy: a shallow one would share the buffer written in place */
+    return QByteArray(m_postGMValues->constData(), m_size);
+}
+
+QByteArray UniverseArray::preGMValues() const
+{
+    return QByteArray(m_preGMValues->constData(), m_size);
+}
+
+const uchar* UniverseArray::postGMData() const
+{
+    return m_postGMData;
+}
+
+const uchar* UniverseArray::preGMData() const
+{
+    return m_preGMData;
+}
+
+uchar UniverseArray::preGMValue(int channel) const
+{
+    if (channel >= 0 && channel < m_size)
+        return m_preGMData[channel];
+    else
+        return 0;
+}
+
+const QByteArray& UniverseArray::postGMUniverse(int universe) const
 {
-    return *m_postGMValues;
+    if (universe >= 0 && universe < m_postGMUniverses.size())
+        return m_postGMUniverses.at(universe);
+    else
+        return KEmptyUniverse;
 }
 
-const QByteArray UniverseArray::preGMValues() const
+int UniverseArray::universes() const
 {
-    return *m_preGMValues;
+    return m_postGMUniverses.size();
 }
 
 uchar UniverseArray::applyGM(int channel, uchar value, QLCChannel::Group group)
 {
+    uchar flag;
+    if (group == QLCChannel::Intensity)
+        flag = GMFlagIntensity;
+    else
+        flag = GMFlagNonIntensity;
+
     if (value == 0)
     {
-        if (group == QLCChannel::Intensity)
-            m_gMIntensityChannels.remove(channel);
-        else
-            m_gMNonIntensityChannels.remove(channel);
+        m_gMChannels[channel] &= ~flag;
         return value;
     }
 
+    m_gMChannels[channel] |= flag;
+    if (flag == GMFlagIntensity)
+        m_intensityUniverses[channel >> 9] = true;
+
     if ((gMChannelMode() == GMIntensity && group == QLCChannel::Intensity) ||
         (gMChannelMode() == GMAllChannels))
+    {
+        value = m_gMTable[value];
+    }
+
+    return value;
+}
+
+void UniverseArray::applyGMToAll()
+{
+    Q_ASSERT(m_layer == NULL);
+
+    /* Channels that GM applies to get their values from the lookup table,
+       all others get their pre-GM values as such. This is done without
+       branching so that the loop stays tight even for lots of universes. */
+    uchar gMFlags = GMFlagIntensity;
+    if (gMChannelMode() == GMAllChannels)
+        gMFlags |= GMFlagNonIntensity;
+
+    for (int i = 0; i < m_size; i++)
+    {
+        uchar pre = m_preGMData[i];
+        uchar mask = uchar(0) - uchar((m_gMChannels[i] & gMFlags) != 0);
+        m_postGMData[i] = (m_gMTable[pre] & mask) | (pre & ~mask);
+    }
+
+    setAllUniversesDirty();
+}
+
+void UniverseArray::updateGMTable()
+{
+    for (int i = 0; i < 256; i++)
     {
         if (gMValueMode() == GMLimit)
-            value = MIN(value, gMValue());
+            m_gMTable[i] = MIN(uchar(i), gMValue());
         else
-            value = char(floor((double(value) * gMFraction()) + 0.5));
+            m_gMTable[i] = uchar(floor((double(i) * gMFraction()) + 0.5));
     }
+}
 
-    if (group == QLCChannel::Intensity)
-        m_gMIntensityChannels << channel;
+/****************************************************************************
+ * Change tracking
+ ****************************************************************************/
+
+bool UniverseArray::isUniverseDirty(int universe) const
+{
+    if (universe >= 0 && universe < m_postGMUniverses.size())
+        return m_dirtyUniverses[universe];
     else
-        m_gMNonIntensityChannels << channel;
+        return false;
+}
 
-    return value;
+void UniverseArray::setUniverseDirty(int universe, bool dirty)
+{
+    Q_ASSERT(m_layer == NULL);
+
+    if (universe >= 0 && universe < m_postGMUniverses.size())
+        m_dirtyUniverses[universe] = dirty;
+}
+
+void UniverseArray::setAllUniversesDirty()
+{
+    for (int i = 0; i < m_postGMUniverses.size(); i++)
+        m_dirtyUniverses[i] = true;
 }
 
 /****************************************************************************
  * Writing
  ****************************************************************************/
 
-bool UniverseArray::write(int channel, uchar value, QLCChannel::Group group)
+void UniverseArray::writeBlock(const int* channels, const uchar* values,
+                               const QLCChannel::Group* groups, int count)
 {
-    if (channel >= size())
-        return false;
+    /* Views hand the whole block over to their layer in one go */
+    if (m_layer != NULL)
+    {
+        m_layer->writeBlock(channels, values, groups, count);
+        return;
+    }
 
-    if (checkHTP(channel, value, group) == false)
-        return false;
+    for (int i = 0; i < count; i++)
+        write(channels[i], values[i], groups[i]);
+}
 
-    m_preGMValues->data()[channel] = char(value);
-    value = applyGM(channel, value, group);
-    m_postGMValues->data()[channel] = char(value);
+void UniverseArray::merge(const UniverseLayer* layer)
+{
+    Q_ASSERT(layer != NULL);
 
-    return true;
+    const UniverseLayer::Value* values = layer->values();
+    for (int i = 0; i < layer->count(); i++)
+        write(values[i].channel, values[i].value, values[i].group);
 }
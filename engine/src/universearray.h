@@ -23,19 +23,48 @@
 #define UNIVERSEARRAY_H
 
 #include <QByteArray>
-#include <QSet>
+#include <QList>
 
+#include "universelayer.h"
 #include "qlcchannel.h"
 
 class UniverseArray
 {
+    friend class UniverseLayer;
+
 public:
     /** Construct a new UniverseArray of given size */
     UniverseArray(int size);
 
     /** Destructor */
-    virtual ~UniverseArray();
+    ~UniverseArray();
+
+private:
+    Q_DISABLE_COPY(UniverseArray)
+
+protected:
+    /**
+     * Construct a view that records all write() and writeBlock() calls to
+     * the given layer instead of applying them. Use attach() to let the
+     * view read the values of a real array.
+     *
+     * @param layer The layer to record writes to
+     */
+    UniverseArray(UniverseLayer* layer);
+
+    /**
+     * Make this view read the values of the given array. The view shares
+     * the array's buffers, so it must not be used after the array has been
+     * grown or destroyed, until attached again.
+     *
+     * @param source The array, whose values to read
+     */
+    void attach(const UniverseArray* source);
 
+    /** The layer that this view records to, or NULL for real arrays */
+    UniverseLayer* m_layer;
+
+public:
     /** Get the size of the UniverseArray */
     int size() const;
 
@@ -52,8 +81,24 @@ public:
      */
     void reset(int address, int range);
 
+    /**
+     * Grow or shrink the array to hold the given number of 512-channel
+     * universes. Values and Grand Master state of the universes that remain
+     * are kept as they are, new channels start from zero.
+     *
+     * Resizing moves the value buffers, so any raw pointers and universe
+     * views obtained before this call become invalid.
+     *
+     * @param universes The new number of universes
+     */
+    void setUniverses(int universes);
+
+protected:
+    /** (Re)create per-universe views and flags for the current size */
+    void initUniverses();
+
 protected:
-    const int m_size;
+    int m_size;
 
     /************************************************************************
      * Highest Takes Precedence
@@ -63,7 +108,8 @@ public:
     void zeroIntensityChannels();
 
     /** Check if new $value for $channel & $group pass HTP criteria. */
-    bool checkHTP(int channel, uchar value, QLCChannel::Group group) const;
+    inline bool checkHTP(int channel, uchar value,
+                         QLCChannel::Group group) const;
 
     /************************************************************************
      * Grand Master
@@ -140,24 +186,67 @@ public:
     double gMFraction() const;
 
     /**
-     * Get the current post-Grand-Master values (to be written to output HW)
-     * Don't write to the returned array to prevent copying. Not that it would
-     * do anything to UniverseArray's internal values, but it would be just
-     * pointless waste of CPU time.
+     * Get a snapshot of the current post-Grand-Master values (to be written
+     * to output HW). The buffer is written in place by the timer thread, so
+     * the returned array is a deep copy that stays intact no matter what is
+     * written afterwards. Since this allocates, it's not for the timer
+     * thread; use postGMData() or postGMUniverse() there instead.
+     *
+     * @return A copy of the current values
+     */
+    QByteArray postGMValues() const;
+
+    /**
+     * Get a snapshot of the current pre-Grand-Master values (used by
+     * functions and everyone else INSIDE QLC). Like postGMValues(), the
+     * returned array is a deep copy.
+     *
+     * @return A copy of the current values
+     */
+    QByteArray preGMValues() const;
+
+    /**
+     * Get a read-only pointer to the raw post-Grand-Master values. The
+     * pointer stays valid until the array is resized with setUniverses(), but
+     * the values behind it change whenever the array is written to.
+     *
+     * @return Pointer to size() post-GM channel values
+     */
+    const uchar* postGMData() const;
+
+    /**
+     * Get a read-only pointer to the raw pre-Grand-Master values. The same
+     * lifetime rules apply as with postGMData().
+     *
+     * @return Pointer to size() pre-GM channel values
+     */
+    const uchar* preGMData() const;
+
+    /**
+     * Get the pre-Grand-Master value of a single channel. This is the
+     * cheapest way for functions to read a channel's current value.
      *
-     * @return The current values
+     * @param channel The channel, whose value to get
+     * @return The channel's pre-GM value or 0 if channel is out of bounds
      */
-    const QByteArray postGMValues() const;
+    uchar preGMValue(int channel) const;
 
     /**
-     * Get the current pre-Grand-Master values (used by functions and everyone
-     * else INSIDE QLC). Don't write to the returned array to prevent copying.
-     * Not that it would do anything to UniverseArray's internal values, but it
-     * would be just pointless waste of CPU time.
+     * Get the post-Grand-Master values of one 512-channel universe. The
+     * returned array is a raw view to UniverseArray's internal buffer,
+     * created once at construction, so getting it doesn't copy or allocate
+     * anything. The view always contains the latest values.
      *
-     * @return The current values
+     * @param universe The universe (0-based), whose values to get
+     * @return A read-only view to the universe's post-GM values or an empty
+     *         array if the universe is out of bounds.
+     */
+    const QByteArray& postGMUniverse(int universe) const;
+
+    /**
+     * Get the number of 512-channel universes (slices) in the array.
      */
-    const QByteArray preGMValues() const;
+    int universes() const;
 
 protected:
     /**
@@ -170,31 +259,161 @@ protected:
      */
     uchar applyGM(int channel, uchar value, QLCChannel::Group group);
 
+    /**
+     * Re-apply Grand Master to all channels in one pass. Used whenever GM
+     * value or mode changes. Instead of looking up individual channels, the
+     * whole post-GM buffer is recalculated from the pre-GM buffer, using
+     * the per-channel group flags and the GM lookup table.
+     */
+    void applyGMToAll();
+
+    /** Recalculate m_gMTable after GM value or value mode has changed */
+    void updateGMTable();
+
+    /** Per-channel flags telling which GM group(s) a channel belongs to */
+    enum GMChannelFlag
+    {
+        GMFlagNone         = 0,
+        GMFlagIntensity    = 1 << 0,
+        GMFlagNonIntensity = 1 << 1
+    };
+
 protected:
     GMValueMode m_gMValueMode;
     GMChannelMode m_gMChannelMode;
     uchar m_gMValue;
     double m_gMFraction;
-    QSet <int> m_gMIntensityChannels;
-    QSet <int> m_gMNonIntensityChannels;
     QByteArray* m_preGMValues;
     QByteArray* m_postGMValues;
 
+    /** Raw pointers to the above arrays' data. All writes go through these. */
+    uchar* m_preGMData;
+    uchar* m_postGMData;
+
+    /** Per-universe raw views to m_postGMValues */
+    QList <QByteArray> m_postGMUniverses;
+
+    /** GMChannelFlags for each channel, one byte per channel */
+    uchar* m_gMChannels;
+
+    /** Pre-calculated post-GM value for each possible pre-GM value */
+    uchar m_gMTable[256];
+
+    /************************************************************************
+     * Change tracking
+     ************************************************************************/
+public:
+    /**
+     * Check, whether any post-GM value in the given universe has changed
+     * since the universe was last marked clean. Values that are changed
+     * and then changed back also count as changes, so a dirty universe
+     * doesn't necessarily have different contents. A clean one does not.
+     *
+     * @param universe The universe (0-based) to check
+     * @return true if the universe is dirty, false if clean or out of bounds
+     */
+    bool isUniverseDirty(int universe) const;
+
+    /**
+     * Mark the given universe dirty or clean.
+     *
+     * @param universe The universe (0-based) to mark
+     * @param dirty true to mark the universe dirty, false to mark it clean
+     */
+    void setUniverseDirty(int universe, bool dirty);
+
+protected:
+    /** Mark all universes dirty */
+    void setAllUniversesDirty();
+
+protected:
+    /** Dirty flag for each universe */
+    bool* m_dirtyUniverses;
+
+    /** For each universe, true if it may contain channels flagged with
+        GMFlagIntensity. Lets zeroIntensityChannels() skip idle universes. */
+    bool* m_intensityUniverses;
+
     /************************************************************************
      * Writing
      ************************************************************************/
 public:
     /**
      * Write a value to a DMX channel, taking Grand Master and HTP into
-     * account, if applicable.
+     * account, if applicable. Views of a UniverseLayer just record the write.
      *
      * @param channel The channel number to write to
      * @param value The value to write
      * @param group The channel's channel group
      * @return true if successful, otherwise false
      */
-    bool write(int channel, uchar value,
-               QLCChannel::Group group = QLCChannel::NoGroup);
+    inline bool write(int channel, uchar value,
+                      QLCChannel::Group group = QLCChannel::NoGroup);
+
+    /**
+     * Write a block of values, exactly as if write() was called for each of
+     * them in order.
+     *
+     * @param channels The channel numbers to write to
+     * @param values The values to write
+     * @param groups The channels' channel groups
+     * @param count The number of items in each of the above arrays
+     */
+    void writeBlock(const int* channels, const uchar* values,
+                    const QLCChannel::Group* groups, int count);
+
+    /**
+     * Write all values recorded in the given layer, in the order they were
+     * recorded, exactly as if they had been written here with write().
+     *
+     * @param layer The layer, whose values to write
+     */
+    void merge(const UniverseLayer* layer);
 };
 
+/****************************************************************************
+ * Inline implementations
+ ****************************************************************************/
+
+inline bool UniverseArray::checkHTP(int channel, uchar value,
+                                    QLCChannel::Group group) const
+{
+    if (group == QLCChannel::Intensity && value < m_preGMData[channel])
+    {
+        /* Current value is higher than new value and HTP applies: reject. */
+        return false;
+    }
+    else
+    {
+        /* Current value is below new value or HTP does not apply: accept. */
+        return true;
+    }
+}
+
+inline bool UniverseArray::write(int channel, uchar value,
+                                 QLCChannel::Group group)
+{
+    if (m_layer != NULL)
+    {
+        m_layer->write(channel, value, group);
+        return true;
+    }
+
+    if (channel >= m_size)
+        return false;
+
+    if (checkHTP(channel, value, group) == false)
+        return false;
+
+    m_preGMData[channel] = value;
+    value = applyGM(channel, value, group);
+    if (m_postGMData[channel] != value)
+    {
+        m_postGMData[channel] = value;
+        m_dirtyUniverses[channel >> 9] = true;
+    }
+
+    return true;
+}
+
 #endif
@@ -0,0 +1,89 @@
+/*
+  Q Light Controller
+  universelayer.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "universelayer.h"
+#include "universearray.h"
+
+/****************************************************************************
+ * Initialization
+ ****************************************************************************/
+
+UniverseLayer::UniverseLayer()
+    : m_universes(new UniverseArray(this))
+{
+    /* A reserved QVector keeps its capacity when it's shrunk, so once
+       the layer has grown big enough, recording doesn't allocate. */
+    m_values.reserve(512);
+}
+
+UniverseLayer::~UniverseLayer()
+{
+    delete m_universes;
+}
+
+/****************************************************************************
+ * Universes
+ ****************************************************************************/
+
+void UniverseLayer::attach(const UniverseArray* source)
+{
+    Q_ASSERT(source != NULL);
+    m_universes->attach(source);
+}
+
+UniverseArray* UniverseLayer::universes() const
+{
+    return m_universes;
+}
+
+/****************************************************************************
+ * Recording
+ ****************************************************************************/
+
+void UniverseLayer::writeBlock(const int* channels, const uchar* values,
+                               const QLCChannel::Group* groups, int count)
+{
+    int first = m_values.size();
+    m_values.resize(first + count);
+
+    Value* v = m_values.data() + first;
+    for (int i = 0; i < count; i++)
+    {
+        v[i].channel = channels[i];
+        v[i].value = values[i];
+        v[i].group = groups[i];
+    }
+}
+
+void UniverseLayer::clear()
+{
+    m_values.resize(0);
+}
+
+int UniverseLayer::count() const
+{
+    return m_values.size();
+}
+
+const UniverseLayer::Value* UniverseLayer::values() const
+{
+    return m_values.constData();
+}
@@ -0,0 +1,122 @@
+/*
+  Q Light Controller
+  universelayer.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef UNIVERSELAYER_H
+#define UNIVERSELAYER_H
+
+#include <QVector>
+
+#include "qlcchannel.h"
+
+class UniverseArray;
+
+/**
+ * UniverseLayer is a scratch buffer that a single function can write to
+ * in a render thread of its own. Instead of applying HTP and Grand Master
+ * right away, the layer just records the writes in the order they were
+ * made. UniverseArray::merge() then replays them to the real universes,
+ * so the end result is exactly the same as if the function had written
+ * to the universes directly.
+ *
+ * Functions write to the layer thru universes(), a UniverseArray view that
+ * records its write() and writeBlock() calls here. The view reads the values
+ * of the array that the layer has been attached to.
+ */
+class UniverseLayer
+{
+public:
+    /** Construct a new, empty UniverseLayer */
+    UniverseLayer();
+
+    /** Destructor */
+    ~UniverseLayer();
+
+private:
+    Q_DISABLE_COPY(UniverseLayer)
+
+    /*********************************************************************
+     * Universes
+     *********************************************************************/
+public:
+    /**
+     * Let the layer's view read the values of the given array. Must be done
+     * again if the array is grown with UniverseArray::setUniverses().
+     *
+     * @param source The array to read values from
+     */
+    void attach(const UniverseArray* source);
+
+    /** Get the view that records its writes to this layer */
+    UniverseArray* universes() const;
+
+protected:
+    UniverseArray* m_universes;
+
+    /*********************************************************************
+     * Recording
+     *********************************************************************/
+public:
+    /** One recorded write */
+    struct Value
+    {
+        int channel;
+        uchar value;
+        QLCChannel::Group group;
+    };
+
+    /**
+     * Record a write to a DMX channel. The value is not checked against
+     * HTP or Grand Master until it is merged.
+     *
+     * @param channel The channel number to write to
+     * @param value The value to write
+     * @param group The channel's channel group
+     */
+    void write(int channel, uchar value,
+               QLCChannel::Group group = QLCChannel::NoGroup)
+    {
+        Value v;
+        v.channel = channel;
+        v.value = value;
+        v.group = group;
+        m_values.append(v);
+    }
+
+    /** Record a block of writes. See write() above. */
+    void writeBlock(const int* channels, const uchar* values,
+                    const QLCChannel::Group* groups, int count);
+
+    /** Forget all recorded writes, keeping the allocated memory */
+    void clear();
+
+    /** Get the number of recorded writes */
+    int count() const;
+
+    /** Get the recorded writes, count() of them, in the order made */
+    const Value* values() const;
+
+protected:
+    QVector <Value> m_values;
+};
+
+Q_DECLARE_TYPEINFO(UniverseLayer::Value, Q_PRIMITIVE_TYPE);
+
+#endif
@@ -23,6 +23,7 @@
 #include <QtXml>
 
 #include "bus_test.h"
+#include "mastertimer.h"
 #include "bus.h"
 
 void Bus_Test::initTestCase()
@@ -76,6 +77,32 @@ void Bus_Test::value()
     QVERIFY(spy.at(2).at(1).toUInt() == UINT_MAX);
 }
 
+void Bus_Test::frequency()
+{
+    QVERIFY(MasterTimer::frequency() == MasterTimer::defaultFrequency());
+
+    /* One second at the default frequency */
+    Bus::instance()->setValue(0, MasterTimer::defaultFrequency());
+
+    /* Bus values are times, so they must keep their real-time meaning
+       even when the timer frequency changes. */
+    MasterTimer::setFrequency(250);
+    QVERIFY(Bus::instance()->value(0) == 250);
+
+    MasterTimer::setFrequency(100);
+    QVERIFY(Bus::instance()->value(0) == 100);
+
+    /* Values set at another frequency come back intact */
+    Bus::instance()->setValue(0, 13);
+    QVERIFY(Bus::instance()->value(0) == 13);
+
+    MasterTimer::setFrequency(MasterTimer::defaultFrequency());
+    QVERIFY(Bus::instance()->value(0) == 7);
+
+    Bus::instance()->setValue(0, 15);
+    QVERIFY(Bus::instance()->value(0) == 15);
+}
+
 void Bus_Test::name()
 {
     QSignalSpy spy(Bus::instance(), SIGNAL(nameChanged(quint32,QString)));
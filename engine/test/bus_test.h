@@ -33,6 +33,7 @@ private slots:
 
     void defaults();
     void value();
+    void frequency();
     void name();
     void idName();
     void tap();
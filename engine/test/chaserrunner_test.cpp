@@ -39,6 +39,28 @@
 
 #define INTERNAL_FIXTUREDIR "../../fixtures/"
 
+/** Find the index of the runner's fade channel for $address, or -1 */
+static int fadeChannelIndex(const ChaserRunner& cr, quint32 address)
+{
+    for (int i = 0; i < cr.m_channels.size(); i++)
+    {
+        if (cr.m_channels.at(i).address() == address)
+            return i;
+    }
+
+    return -1;
+}
+
+/** Get a copy of the runner's fade channel for $address */
+static FadeChannel fadeChannel(const ChaserRunner& cr, quint32 address)
+{
+    int index = fadeChannelIndex(cr, address);
+    if (index == -1)
+        return FadeChannel();
+    else
+        return cr.m_channels.at(index);
+}
+
 void ChaserRunner_Test::initTestCase()
 {
     Bus::init(this);
@@ -102,7 +124,7 @@ void ChaserRunner_Test::initial()
     QCOMPARE(cr.m_direction, Function::Forward);
     QCOMPARE(cr.m_originalDirection, Function::Forward);
     QCOMPARE(cr.m_runOrder, Function::SingleShot);
-    QVERIFY(cr.m_channelMap.isEmpty() == true);
+    QVERIFY(cr.m_channels.isEmpty() == true);
     QCOMPARE(cr.m_elapsed, quint32(0));
     QCOMPARE(cr.m_next, false);
     QCOMPARE(cr.m_currentStep, 0);
@@ -116,7 +138,7 @@ void ChaserRunner_Test::initial()
     QCOMPARE(cr2.m_direction, Function::Backward);
     QCOMPARE(cr2.m_originalDirection, Function::Backward);
     QCOMPARE(cr2.m_runOrder, Function::Loop);
-    QVERIFY(cr2.m_channelMap.isEmpty() == true);
+    QVERIFY(cr2.m_channels.isEmpty() == true);
     QCOMPARE(cr2.m_elapsed, quint32(0));
     QCOMPARE(cr2.m_next, false);
     QCOMPARE(cr2.m_currentStep, 2);
@@ -397,103 +419,89 @@ void ChaserRunner_Test::createFadeChannels()
     ChaserRunner cr(m_doc, steps, Bus::defaultHold(), Function::Forward,
                     Function::Loop);
     UniverseArray ua(512);
-    QMap <quint32,FadeChannel> map;
     FadeChannel ch;
 
     // No handover
     QCOMPARE(cr.currentStep(), 0);
-    map = cr.createFadeChannels(&ua);
+    cr.createFadeChannels(&ua);
 
-    QVERIFY(map.contains(0) == true);
-    ch = map[0];
+    ch = fadeChannel(cr, 0);
     QCOMPARE(ch.address(), quint32(0));
     QCOMPARE(ch.start(), uchar(0));
     QCOMPARE(ch.target(), uchar(255));
     QCOMPARE(ch.current(), uchar(0));
 
-    QVERIFY(map.contains(1) == true);
-    ch = map[1];
+    ch = fadeChannel(cr, 1);
     QCOMPARE(ch.address(), quint32(1));
     QCOMPARE(ch.start(), uchar(0));
     QCOMPARE(ch.target(), uchar(254));
     QCOMPARE(ch.current(), uchar(0));
 
-    QVERIFY(map.contains(2) == true);
-    ch = map[2];
+    ch = fadeChannel(cr, 2);
     QCOMPARE(ch.address(), quint32(2));
     QCOMPARE(ch.start(), uchar(0));
     QCOMPARE(ch.target(), uchar(253));
     QCOMPARE(ch.current(), uchar(0));
 
-    QVERIFY(map.contains(3) == true);
-    ch = map[3];
+    ch = fadeChannel(cr, 3);
     QCOMPARE(ch.address(), quint32(3));
     QCOMPARE(ch.start(), uchar(0));
     QCOMPARE(ch.target(), uchar(252));
     QCOMPARE(ch.current(), uchar(0));
 
-    QVERIFY(map.contains(4) == true);
-    ch = map[4];
+    ch = fadeChannel(cr, 4);
     QCOMPARE(ch.address(), quint32(4));
     QCOMPARE(ch.start(), uchar(0));
     QCOMPARE(ch.target(), uchar(251));
     QCOMPARE(ch.current(), uchar(0));
 
-    QVERIFY(map.contains(5) == true);
-    ch = map[5];
+    ch = fadeChannel(cr, 5);
     QCOMPARE(ch.address(), quint32(5));
     QCOMPARE(ch.start(), uchar(0));
     QCOMPARE(ch.target(), uchar(250));
     QCOMPARE(ch.current(), uchar(0));
 
     // Handover with previous values
-    map[0].setCurrent(map[0].target());
-    map[1].setCurrent(map[1].target());
-    map[2].setCurrent(map[2].target());
-    map[3].setCurrent(map[3].target());
-    map[4].setCurrent(map[4].target());
-    map[5].setCurrent(map[5].target());
-    cr.m_channelMap = map;
+    cr.m_channels[0].setCurrent(cr.m_channels[0].target());
+    cr.m_channels[1].setCurrent(cr.m_channels[1].target());
+    cr.m_channels[2].setCurrent(cr.m_channels[2].target());
+    cr.m_channels[3].setCurrent(cr.m_channels[3].target());
+    cr.m_channels[4].setCurrent(cr.m_channels[4].target());
+    cr.m_channels[5].setCurrent(cr.m_channels[5].target());
     cr.m_currentStep = 1;
-    map = cr.createFadeChannels(&ua);
+    cr.createFadeChannels(&ua);
 
-    QVERIFY(map.contains(0) == true);
-    ch = map[0];
+    ch = fadeChannel(cr, 0);
     QCOMPARE(ch.address(), quint32(0));
     QCOMPARE(ch.start(), uchar(255));
     QCOMPARE(ch.target(), uchar(127));
     QCOMPARE(ch.current(), uchar(255));
 
-    QVERIFY(map.contains(1) == true);
-    ch = map[1];
+    ch = fadeChannel(cr, 1);
     QCOMPARE(ch.address(), quint32(1));
     QCOMPARE(ch.start(), uchar(254));
     QCOMPARE(ch.target(), uchar(126));
     QCOMPARE(ch.current(), uchar(254));
 
-    QVERIFY(map.contains(2) == true);
-    ch = map[2];
+    ch = fadeChannel(cr, 2);
     QCOMPARE(ch.address(), quint32(2));
     QCOMPARE(ch.start(), uchar(253));
     QCOMPARE(ch.target(), uchar(125));
     QCOMPARE(ch.current(), uchar(253));
 
-    QVERIFY(map.contains(3) == true);
-    ch = map[3];
+    ch = fadeChannel(cr, 3);
     QCOMPARE(ch.address(), quint32(3));
     QCOMPARE(ch.start(), uchar(252));
     QCOMPARE(ch.target(), uchar(124));
     QCOMPARE(ch.current(), uchar(252));
 
-    QVERIFY(map.contains(4) == true);
-    ch = map[4];
+    ch = fadeChannel(cr, 4);
     QCOMPARE(ch.address(), quint32(4));
     QCOMPARE(ch.start(), uchar(251));
     QCOMPARE(ch.target(), uchar(123));
     QCOMPARE(ch.current(), uchar(251));
 
-    QVERIFY(map.contains(5) == true);
-    ch = map[5];
+    ch = fadeChannel(cr, 5);
     QCOMPARE(ch.address(), quint32(5));
     QCOMPARE(ch.start(), uchar(250));
     QCOMPARE(ch.target(), uchar(122));
@@ -506,59 +514,53 @@ void ChaserRunner_Test::createFadeChannels()
     ua.write(3, 4, QLCChannel::Intensity);
     ua.write(4, 5, QLCChannel::Intensity);
     ua.write(5, 6, QLCChannel::Intensity);
-    cr.m_channelMap.clear();
+    cr.m_channels.clear();
     cr.m_currentStep = 2;
-    map = cr.createFadeChannels(&ua);
+    cr.createFadeChannels(&ua);
 
-    QVERIFY(map.contains(0) == true);
-    ch = map[0];
+    ch = fadeChannel(cr, 0);
     QCOMPARE(ch.address(), quint32(0));
     QCOMPARE(ch.start(), uchar(1));
     QCOMPARE(ch.target(), uchar(0));
     QCOMPARE(ch.current(), uchar(1));
 
-    QVERIFY(map.contains(1) == true);
-    ch = map[1];
+    ch = fadeChannel(cr, 1);
     QCOMPARE(ch.address(), quint32(1));
     QCOMPARE(ch.start(), uchar(2));
     QCOMPARE(ch.target(), uchar(1));
     QCOMPARE(ch.current(), uchar(2));
 
-    QVERIFY(map.contains(2) == true);
-    ch = map[2];
+    ch = fadeChannel(cr, 2);
     QCOMPARE(ch.address(), quint32(2));
     QCOMPARE(ch.start(), uchar(3));
     QCOMPARE(ch.target(), uchar(2));
     QCOMPARE(ch.current(), uchar(3));
 
-    QVERIFY(map.contains(3) == true);
-    ch = map[3];
+    ch = fadeChannel(cr, 3);
     QCOMPARE(ch.address(), quint32(3));
     QCOMPARE(ch.start(), uchar(4));
     QCOMPARE(ch.target(), uchar(3));
     QCOMPARE(ch.current(), uchar(4));
 
-    QVERIFY(map.contains(4) == true);
-    ch = map[4];
+    ch = fadeChannel(cr, 4);
     QCOMPARE(ch.address(), quint32(4));
     QCOMPARE(ch.start(), uchar(5));
     QCOMPARE(ch.target(), uchar(4));
     QCOMPARE(ch.current(), uchar(5));
 
-    QVERIFY(map.contains(5) == true);
-    ch = map[5];
+    ch = fadeChannel(cr, 5);
     QCOMPARE(ch.address(), quint32(5));
     QCOMPARE(ch.start(), uchar(6));
     QCOMPARE(ch.target(), uchar(5));
     QCOMPARE(ch.current(), uchar(6));
 
     cr.m_currentStep = 3;
-    map = cr.createFadeChannels(&ua);
-    QVERIFY(map.isEmpty() == true);
+    cr.createFadeChannels(&ua);
+    QVERIFY(cr.m_channels.isEmpty() == true);
 
     cr.m_currentStep = -1;
-    map = cr.createFadeChannels(&ua);
-    QVERIFY(map.isEmpty() == true);
+    cr.createFadeChannels(&ua);
+    QVERIFY(cr.m_channels.isEmpty() == true);
 }
 
 void ChaserRunner_Test::createFadeChannelsAutoHTPZero()
@@ -585,36 +587,79 @@ void ChaserRunner_Test::createFadeChannelsAutoHTPZero()
     ChaserRunner cr(m_doc, steps, Bus::defaultHold(), Function::Forward,
                     Function::Loop);
     UniverseArray ua(512);
-    QMap <quint32,FadeChannel> map;
 
     // Normal first execution with step 0
     QCOMPARE(cr.currentStep(), 0);
-    map = cr.createFadeChannels(&ua);
+    cr.createFadeChannels(&ua);
 
-    QVERIFY(map.contains(15) == true);
-    FadeChannel& ch = map[15];
+    int index = fadeChannelIndex(cr, 15);
+    QVERIFY(index != -1);
+    FadeChannel ch = cr.m_channels[index];
     QCOMPARE(ch.address(), quint32(15));
     QCOMPARE(ch.start(), uchar(0));
     QCOMPARE(ch.target(), uchar(255));
     QCOMPARE(ch.current(), uchar(0));
-    ch.setCurrent(142); // Let's assume write() has been called several times
+    // Let's assume write() has been called several times
+    cr.m_channels[index].setCurrent(142);
 
     // Second execution with handover from step 0 to 1 and auto-zeroing of ch15:
     // m_scene2 at m_currentStep == 1 doesn't contain anything regarding ch15
     // (i.e. fixture2 @ DMX address 10 + 5) but since it was present in the last
     // step, it should be auto-faded to zero.
-    cr.m_channelMap = map;
     cr.m_currentStep = 1;
-    map = cr.createFadeChannels(&ua);
+    cr.createFadeChannels(&ua);
 
-    QVERIFY(map.contains(15) == true);
-    ch = map[15];
+    ch = fadeChannel(cr, 15);
     QCOMPARE(ch.address(), quint32(15));
     QCOMPARE(ch.start(), uchar(142));
     QCOMPARE(ch.target(), uchar(0));
     QCOMPARE(ch.current(), uchar(142));
 }
 
+void ChaserRunner_Test::compileSteps()
+{
+    const QLCFixtureDef* def = m_cache.fixtureDef("Futurelight", "DJScan250");
+    QVERIFY(def != NULL);
+    const QLCFixtureMode* mode = def->mode("Mode 1");
+    QVERIFY(mode != NULL);
+
+    /* Overlaps the first fixture's channels 3-5 */
+    Fixture* fxi = new Fixture(m_doc);
+    QVERIFY(fxi != NULL);
+    fxi->setFixtureDefinition(def, mode);
+    fxi->setName("Test Fixture 2");
+    fxi->setAddress(3);
+    fxi->setUniverse(0);
+    m_doc->addFixture(fxi);
+
+    m_scene1->setValue(fxi->id(), 0, 7);
+    m_scene1->setValue(500, 0, 255);
+
+    QList <Function*> steps;
+    steps << m_scene1 << m_scene2;
+    ChaserRunner cr(m_doc, steps, Bus::defaultHold(), Function::Forward,
+                    Function::Loop);
+
+    QCOMPARE(cr.m_compiledSteps.size(), 2);
+    QVERIFY(cr.m_compiledSteps[0].scene == true);
+    QCOMPARE(cr.m_compiledSteps[0].fadeBusId, m_scene1->busID());
+
+    /* Sorted, one channel per address, missing fixture left out */
+    const QVector <ChaserRunner::StepChannel>& channels(cr.m_compiledSteps[0].channels);
+    QCOMPARE(channels.size(), int(fxi->channels()));
+    for (int i = 0; i < channels.size(); i++)
+        QCOMPARE(channels[i].address, quint32(i));
+
+    /* The later one of the overlapping values counts */
+    QCOMPARE(channels[2].value, uchar(253));
+    QCOMPARE(channels[3].value, uchar(7));
+    QCOMPARE(channels[4].value, uchar(251));
+
+    /* Room for all fade channels has been reserved in advance */
+    QVERIFY(cr.m_channels.capacity() >= channels.size());
+    QVERIFY(cr.m_nextChannels.capacity() >= channels.size());
+}
+
 void ChaserRunner_Test::writeNoSteps()
 {
     QList <Function*> steps;
@@ -654,7 +699,7 @@ void ChaserRunner_Test::writeHoldZero()
 
     QVERIFY(cr.write(&ua) == true);
     QCOMPARE(cr.m_elapsed, quint32(1));
-    QVERIFY(cr.m_channelMap.isEmpty() == false);
+    QVERIFY(cr.m_channels.isEmpty() == false);
     QCOMPARE(cr.currentStep(), 0);
     QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
     QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -667,7 +712,7 @@ void ChaserRunner_Test::writeHoldZero()
 
     QVERIFY(cr.write(&ua) == true);
     QCOMPARE(cr.m_elapsed, quint32(1));
-    QVERIFY(cr.m_channelMap.isEmpty() == false);
+    QVERIFY(cr.m_channels.isEmpty() == false);
     QCOMPARE(cr.currentStep(), 1);
     QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(127));
     QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(126));
@@ -680,7 +725,7 @@ void ChaserRunner_Test::writeHoldZero()
 
     QVERIFY(cr.write(&ua) == true);
     QCOMPARE(cr.m_elapsed, quint32(1));
-    QVERIFY(cr.m_channelMap.isEmpty() == false);
+    QVERIFY(cr.m_channels.isEmpty() == false);
     QCOMPARE(cr.currentStep(), 2);
     QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(0));
     QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(1));
@@ -693,7 +738,7 @@ void ChaserRunner_Test::writeHoldZero()
 
     QVERIFY(cr.write(&ua) == true);
     QCOMPARE(cr.m_elapsed, quint32(1));
-    QVERIFY(cr.m_channelMap.isEmpty() == false);
+    QVERIFY(cr.m_channels.isEmpty() == false);
     QCOMPARE(cr.currentStep(), 0);
     QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
     QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -726,7 +771,7 @@ void ChaserRunner_Test::writeForwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 0);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -742,7 +787,7 @@ void ChaserRunner_Test::writeForwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 2);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(0));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(1));
@@ -764,7 +809,7 @@ void ChaserRunner_Test::writeForwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 0);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -780,7 +825,7 @@ void ChaserRunner_Test::writeForwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 1);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(127));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(126));
@@ -796,7 +841,7 @@ void ChaserRunner_Test::writeForwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 2);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(0));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(1));
@@ -812,7 +857,7 @@ void ChaserRunner_Test::writeForwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 0);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -846,7 +891,7 @@ void ChaserRunner_Test::writeBackwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 2);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(0));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(1));
@@ -862,7 +907,7 @@ void ChaserRunner_Test::writeBackwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 0);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -884,7 +929,7 @@ void ChaserRunner_Test::writeBackwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 2);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(0));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(1));
@@ -900,7 +945,7 @@ void ChaserRunner_Test::writeBackwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 1);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(127));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(126));
@@ -916,7 +961,7 @@ void ChaserRunner_Test::writeBackwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 0);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -932,7 +977,7 @@ void ChaserRunner_Test::writeBackwardLoopHoldFiveNextPrevious()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 2);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(0));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(1));
@@ -960,7 +1005,7 @@ void ChaserRunner_Test::writeForwardSingleShotHoldFive()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 0);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -976,7 +1021,7 @@ void ChaserRunner_Test::writeForwardSingleShotHoldFive()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 1);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(127));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(126));
@@ -992,7 +1037,7 @@ void ChaserRunner_Test::writeForwardSingleShotHoldFive()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 2);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(0));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(1));
@@ -1024,7 +1069,7 @@ void ChaserRunner_Test::writeNoAutoStepHoldFive()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 0);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -1042,7 +1087,7 @@ void ChaserRunner_Test::writeNoAutoStepHoldFive()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 2);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(0));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(1));
@@ -1060,7 +1105,7 @@ void ChaserRunner_Test::writeNoAutoStepHoldFive()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 0);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -1078,7 +1123,7 @@ void ChaserRunner_Test::writeNoAutoStepHoldFive()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 1);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(127));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(126));
@@ -1107,7 +1152,7 @@ void ChaserRunner_Test::writeNoAutoSetCurrentStep()
 
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 0);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -1145,7 +1190,7 @@ void ChaserRunner_Test::writeNoAutoSetCurrentStep()
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_newCurrent, -1);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 2);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(0));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(1));
@@ -1165,7 +1210,7 @@ void ChaserRunner_Test::writeNoAutoSetCurrentStep()
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_newCurrent, -1);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 0);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(255));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(254));
@@ -1185,7 +1230,7 @@ void ChaserRunner_Test::writeNoAutoSetCurrentStep()
         QVERIFY(cr.write(&ua) == true);
         QCOMPARE(cr.m_newCurrent, -1);
         QCOMPARE(cr.m_elapsed, quint32(i + 1));
-        QVERIFY(cr.m_channelMap.isEmpty() == false);
+        QVERIFY(cr.m_channels.isEmpty() == false);
         QCOMPARE(cr.currentStep(), 1);
         QCOMPARE(uchar(ua.preGMValues().data()[0]), uchar(127));
         QCOMPARE(uchar(ua.preGMValues().data()[1]), uchar(126));
@@ -48,6 +48,7 @@ private slots:
     void roundCheckPingPongBackward();
     void createFadeChannels();
     void createFadeChannelsAutoHTPZero();
+    void compileSteps();
 
     void writeNoSteps();
     void writeMissingFixture();
@@ -431,6 +431,18 @@ void Collection_Test::armMissingFunction()
     QVERIFY(c->functions().size() == 4);
     c->arm();
     QVERIFY(c->functions().size() == 2); // Nonexistent functions are removed
+    QVERIFY(c->m_armedFunctions.size() == 2);
+    QVERIFY(c->m_armedFunctions.at(0) == s1);
+    QVERIFY(c->m_armedFunctions.at(1) == s2);
+
+    /* Destroyed members are dropped also from the resolved functions */
+    doc->deleteFunction(s1->id());
+    QVERIFY(c->functions().size() == 1);
+    QVERIFY(c->m_armedFunctions.size() == 1);
+    QVERIFY(c->m_armedFunctions.at(0) == s2);
+
+    c->disarm();
+    QVERIFY(c->m_armedFunctions.isEmpty() == true);
 
     delete doc;
 }
@@ -576,8 +588,8 @@ void Collection_Test::stopNotOwnChildren()
     QVERIFY(s2->stopped() == false);
 
     // Collection controls s1 & s2
-    QVERIFY(c->m_runningChildren.contains(s1->id()) == true);
-    QVERIFY(c->m_runningChildren.contains(s2->id()) == true);
+    QVERIFY(c->isRunningChild(s1) == true);
+    QVERIFY(c->isRunningChild(s2) == true);
 
     // Manually stop and re-start s1
     s1->stop();
@@ -587,8 +599,8 @@ void Collection_Test::stopNotOwnChildren()
     QVERIFY(s1->stopped() == false);
 
     // Collection should no longer be controlling s1
-    QVERIFY(c->m_runningChildren.contains(s1->id()) == false);
-    QVERIFY(c->m_runningChildren.contains(s2->id()) == true);
+    QVERIFY(c->isRunningChild(s1) == false);
+    QVERIFY(c->isRunningChild(s2) == true);
 
     c->stop();
     c->write(mts, &uni);
@@ -32,6 +32,7 @@
 #include "qlcphysical.h"
 #include "qlcfixturemode.h"
 #include "qlcfixturedef.h"
+#include "qlctypes.h"
 
 #include "doc_test.h"
 #define protected public
@@ -61,6 +62,45 @@ void Doc_Test::defaults()
     QVERIFY(doc.m_fixtures.size() == 0);
     QVERIFY(doc.m_functionAllocation == 0);
     QVERIFY(doc.m_functionArray != NULL);
+    QVERIFY(doc.m_universes == KUniverseCount);
+}
+
+void Doc_Test::universes()
+{
+    Doc doc(this, m_fixtureDefCache);
+    QSignalSpy spy(&doc, SIGNAL(universesChanged(quint32)));
+
+    /* Never shrink */
+    doc.setUniverses(1);
+    QVERIFY(doc.universes() == KUniverseCount);
+    QVERIFY(spy.size() == 0);
+    QVERIFY(doc.isModified() == false);
+
+    doc.setUniverses(KUniverseCount + 2);
+    QVERIFY(doc.universes() == KUniverseCount + 2);
+    QVERIFY(spy.size() == 1);
+    QVERIFY(spy.at(0).at(0) == KUniverseCount + 2);
+    QVERIFY(doc.isModified() == true);
+
+    /* Never exceed the maximum */
+    doc.setUniverses(KUniverseCountMax + 1);
+    QVERIFY(doc.universes() == KUniverseCountMax);
+    QVERIFY(spy.size() == 2);
+
+    /* Adding a fixture beyond the current count grows it */
+    Doc doc2(this, m_fixtureDefCache);
+    Fixture* fxi = new Fixture(&doc2);
+    fxi->setChannels(5);
+    fxi->setUniverse(KUniverseCount + 5);
+    QVERIFY(doc2.addFixture(fxi) == true);
+    QVERIFY(doc2.universes() == KUniverseCount + 6);
+
+    /* So does moving one there */
+    fxi->setUniverse(KUniverseCount + 9);
+    QVERIFY(doc2.universes() == KUniverseCount + 10);
+
+    /* Free space is searched from the new universes, too */
+    QVERIFY(doc2.findAddress(512) == 0);
 }
 
 void Doc_Test::createFixtureId()
@@ -512,10 +552,12 @@ void Doc_Test::load()
     root.appendChild(createBusNode(document, 31, 500));
 
     root.appendChild(document.createElement("ExtraTag"));
+    root.setAttribute("Universes", KUniverseCount + 3);
 
     QVERIFY(doc.fixtures().size() == 0);
     QVERIFY(doc.functions() == 0);
     QVERIFY(doc.loadXML(&root) == true);
+    QVERIFY(doc.universes() == KUniverseCount + 3);
     QVERIFY(doc.fixtures().size() == 3);
     QVERIFY(doc.functions() == 4);
     QVERIFY(Bus::instance()->value(0) == 1);
@@ -599,6 +641,7 @@ void Doc_Test::save()
     unsigned int fixtures = 0, functions = 0, buses = 0;
     QDomNode node = root.firstChild();
     QVERIFY(node.toElement().tagName() == "Engine");
+    QVERIFY(node.toElement().attribute("Universes").toUInt() == KUniverseCount);
 
     node = node.firstChild();
     while (node.isNull() == false)
@@ -35,6 +35,7 @@ private slots:
     void initTestCase();
 
     void defaults();
+    void universes();
 
     void createFixtureId();
     void addFixture();
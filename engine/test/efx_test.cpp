@@ -1530,6 +1530,40 @@ void EFX_Test::rotateAndScale()
     QVERIFY(floor(y + 0.5) == 127);
 }
 
+void EFX_Test::calculatePoints()
+{
+    EFX efx(m_doc);
+    efx.setRotation(33);
+    efx.setXFrequency(3);
+    efx.setYPhase(45);
+
+    /* Include negative and multiple-cycle iterators */
+    QVector <qreal> iterators;
+    for (int i = -200; i < 1000; i++)
+        iterators << qreal(i) * 0.0137;
+
+    QVector <qreal> x(iterators.size());
+    QVector <qreal> y(iterators.size());
+
+    QStringList algos(EFX::algorithmList());
+    for (int a = 0; a < algos.size(); a++)
+    {
+        efx.setAlgorithm(EFX::stringToAlgorithm(algos.at(a)));
+        efx.calculatePoints(iterators.constData(), x.data(), y.data(),
+                            iterators.size());
+
+        for (int i = 0; i < iterators.size(); i++)
+        {
+            qreal refX, refY;
+            efx.calculatePoint(iterators.at(i), &refX, &refY);
+
+            /* Much less than one 16-bit step (1/256) */
+            QVERIFY(qAbs(x.at(i) - refX) < 0.001);
+            QVERIFY(qAbs(y.at(i) - refY) < 0.001);
+        }
+    }
+}
+
 void EFX_Test::copyFrom()
 {
     EFX e1(m_doc);
@@ -59,6 +59,7 @@ private slots:
     void previewLissajous();
 
     void rotateAndScale();
+    void calculatePoints();
     void widthHeightOffset();
 
     void copyFrom();
@@ -487,6 +487,14 @@ void EFXFixture_Test::setPoint16bit()
     QVERIFY(array.preGMValues()[3] == (char) 127); /* 255 * 0.5 */
 }
 
+void EFXFixture_Test::fineValue()
+{
+    QCOMPARE(EFXFixture::fineValue(5.0), uchar(0));
+    QCOMPARE(EFXFixture::fineValue(5.4), uchar(102)); /* 255 * 0.4 */
+    QCOMPARE(EFXFixture::fineValue(1.5), uchar(127)); /* 255 * 0.5 */
+    QCOMPARE(EFXFixture::fineValue(254.999), uchar(254));
+}
+
 void EFXFixture_Test::nextStepLoop()
 {
     UniverseArray array(512 * 4);
@@ -51,6 +51,7 @@ private slots:
     void startStop();
     void setPoint8bit();
     void setPoint16bit();
+    void fineValue();
     void nextStepLoop();
     void nextStepSingleShot();
 
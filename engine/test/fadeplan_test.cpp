@@ -0,0 +1,241 @@
+/*
+  Q Light Controller - Unit test
+  fadeplan_test.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtTest>
+
+#include "fadeplan_test.h"
+#include "universelayer.h"
+#include "universearray.h"
+#include "fadechannel.h"
+#include "qlcchannel.h"
+
+#define protected public
+#include "fadeplan.h"
+#undef protected
+
+void FadePlan_Test::initial()
+{
+    FadePlan plan;
+    QVERIFY(plan.size() == 0);
+    QVERIFY(plan.m_finishCached == false);
+}
+
+void FadePlan_Test::appendSort()
+{
+    FadePlan plan;
+    plan.append(1, 20, QLCChannel::Intensity, 100);
+    plan.append(2, 5, QLCChannel::Colour, 50);
+    plan.append(3, 20, QLCChannel::Pan, 200);
+    plan.append(4, 10, QLCChannel::Tilt, 25);
+    QVERIFY(plan.size() == 4);
+
+    /* Appended order until sorted */
+    QVERIFY(plan.address(0) == 20);
+    QVERIFY(plan.address(1) == 5);
+
+    plan.sort();
+    QVERIFY(plan.size() == 4);
+
+    QVERIFY(plan.address(0) == 5);
+    QVERIFY(plan.fixture(0) == 2);
+    QVERIFY(plan.group(0) == QLCChannel::Colour);
+    QVERIFY(plan.target(0) == 50);
+
+    QVERIFY(plan.address(1) == 10);
+    QVERIFY(plan.fixture(1) == 4);
+    QVERIFY(plan.group(1) == QLCChannel::Tilt);
+    QVERIFY(plan.target(1) == 25);
+
+    /* Equal addresses keep their order */
+    QVERIFY(plan.address(2) == 20);
+    QVERIFY(plan.fixture(2) == 1);
+    QVERIFY(plan.group(2) == QLCChannel::Intensity);
+    QVERIFY(plan.target(2) == 100);
+
+    QVERIFY(plan.address(3) == 20);
+    QVERIFY(plan.fixture(3) == 3);
+    QVERIFY(plan.group(3) == QLCChannel::Pan);
+    QVERIFY(plan.target(3) == 200);
+
+    for (int i = 0; i < plan.size(); i++)
+    {
+        QVERIFY(plan.start(i) == 0);
+        QVERIFY(plan.current(i) == 0);
+        QVERIFY(plan.isReady(i) == false);
+    }
+}
+
+void FadePlan_Test::clear()
+{
+    FadePlan plan;
+    plan.append(1, 20, QLCChannel::Intensity, 100);
+    plan.append(2, 5, QLCChannel::Colour, 50);
+    plan.sort();
+    QVERIFY(plan.size() == 2);
+
+    plan.clear();
+    QVERIFY(plan.size() == 0);
+    QVERIFY(plan.m_finishCached == false);
+}
+
+void FadePlan_Test::begin()
+{
+    UniverseArray ua(512);
+    ua.write(0, 100, QLCChannel::Intensity);
+    ua.write(1, 50, QLCChannel::Colour);
+    ua.write(2, 10, QLCChannel::Colour);
+
+    FadePlan plan;
+    plan.append(1, 0, QLCChannel::Intensity, 100); // On target, HTP
+    plan.append(1, 1, QLCChannel::Colour, 50);     // On target, LTP
+    plan.append(1, 2, QLCChannel::Colour, 20);
+    plan.append(1, 3, QLCChannel::Pan, 30);
+    plan.sort();
+
+    /* Only LTP channels that are already on target count as ready */
+    QVERIFY(plan.begin(&ua) == 1);
+
+    QVERIFY(plan.start(0) == 100);
+    QVERIFY(plan.current(0) == 100);
+    QVERIFY(plan.isReady(0) == true);
+
+    QVERIFY(plan.start(1) == 50);
+    QVERIFY(plan.current(1) == 50);
+    QVERIFY(plan.isReady(1) == true);
+
+    QVERIFY(plan.start(2) == 10);
+    QVERIFY(plan.current(2) == 10);
+    QVERIFY(plan.isReady(2) == false);
+
+    QVERIFY(plan.start(3) == 0);
+    QVERIFY(plan.current(3) == 0);
+    QVERIFY(plan.isReady(3) == false);
+}
+
+void FadePlan_Test::fade()
+{
+    UniverseArray ua(512);
+    ua.write(1, 200, QLCChannel::Colour);
+    ua.write(2, 77, QLCChannel::Pan);
+
+    FadePlan plan;
+    plan.append(1, 0, QLCChannel::Intensity, 255);
+    plan.append(1, 1, QLCChannel::Colour, 0);
+    plan.append(1, 2, QLCChannel::Pan, 77);
+    plan.append(1, 3, QLCChannel::Tilt, 13);
+    plan.sort();
+    plan.begin(&ua);
+
+    /* Each step must match what FadeChannel would calculate */
+    QList <FadeChannel> channels;
+    for (int i = 0; i < plan.size(); i++)
+    {
+        FadeChannel fc(plan.address(i), plan.group(i), plan.start(i),
+                       plan.target(i), plan.current(i));
+        fc.setReady(plan.isReady(i));
+        channels << fc;
+    }
+
+    const quint32 fadeTime = 17;
+    for (quint32 elapsed = 0; elapsed < fadeTime; elapsed++)
+    {
+        plan.fade(&ua, fadeTime, elapsed);
+        for (int i = 0; i < plan.size(); i++)
+        {
+            uchar value = channels[i].calculateCurrent(fadeTime, elapsed);
+            QCOMPARE(plan.current(i), value);
+            QCOMPARE(uchar(ua.preGMValues()[plan.address(i)]), value);
+        }
+    }
+}
+
+void FadePlan_Test::finish()
+{
+    UniverseArray ua(512);
+    ua.write(2, 77, QLCChannel::Pan);
+
+    FadePlan plan;
+    plan.append(1, 0, QLCChannel::Intensity, 255);
+    plan.append(1, 1, QLCChannel::Colour, 100);
+    plan.append(1, 2, QLCChannel::Pan, 77); // Ready from the start
+    plan.sort();
+    QVERIFY(plan.begin(&ua) == 1);
+
+    /* The first call writes HTP and the not-yet-ready LTP channel */
+    QVERIFY(plan.finish(&ua) == 1);
+    QVERIFY(plan.m_finishCached == false);
+    QVERIFY(plan.m_finishAddresses.size() == 2);
+    QVERIFY(uchar(ua.preGMValues()[0]) == 255);
+    QVERIFY(uchar(ua.preGMValues()[1]) == 100);
+    QVERIFY(uchar(ua.preGMValues()[2]) == 77);
+    for (int i = 0; i < plan.size(); i++)
+    {
+        QVERIFY(plan.isReady(i) == true);
+        QVERIFY(plan.current(i) == plan.target(i));
+    }
+
+    /* LTP channels are no longer touched */
+    ua.reset();
+    QVERIFY(plan.finish(&ua) == 0);
+    QVERIFY(plan.m_finishCached == true);
+    QVERIFY(plan.m_finishAddresses.size() == 1);
+    QVERIFY(uchar(ua.preGMValues()[0]) == 255);
+    QVERIFY(uchar(ua.preGMValues()[1]) == 0);
+    QVERIFY(uchar(ua.preGMValues()[2]) == 0);
+
+    /* Cached block stays the same */
+    ua.reset();
+    QVERIFY(plan.finish(&ua) == 0);
+    QVERIFY(plan.m_finishCached == true);
+    QVERIFY(uchar(ua.preGMValues()[0]) == 255);
+    QVERIFY(uchar(ua.preGMValues()[1]) == 0);
+
+    /* A new run gathers the block again */
+    plan.begin(&ua);
+    QVERIFY(plan.m_finishCached == false);
+}
+
+void FadePlan_Test::finishLayer()
+{
+    UniverseArray ua(512);
+    UniverseLayer layer;
+    layer.attach(&ua);
+
+    FadePlan plan;
+    plan.append(1, 4, QLCChannel::Colour, 100);
+    plan.append(1, 3, QLCChannel::Intensity, 255);
+    plan.sort();
+    plan.begin(&ua);
+
+    /* A layer records the block in address order */
+    QVERIFY(plan.finish(layer.universes()) == 1);
+    QVERIFY(layer.count() == 2);
+    QVERIFY(layer.values()[0].channel == 3);
+    QVERIFY(layer.values()[0].value == 255);
+    QVERIFY(layer.values()[0].group == QLCChannel::Intensity);
+    QVERIFY(layer.values()[1].channel == 4);
+    QVERIFY(layer.values()[1].value == 100);
+    QVERIFY(layer.values()[1].group == QLCChannel::Colour);
+
+    ua.merge(&layer);
+    QVERIFY(uchar(ua.preGMValues()[3]) == 255);
+    QVERIFY(uchar(ua.preGMValues()[4]) == 100);
+}
@@ -280,6 +280,80 @@ void Fixture_Test::channels()
     QCOMPARE(fxi.channels("brown", Qt::CaseInsensitive, QLCChannel::Intensity), chs);
 }
 
+void Fixture_Test::fineChannels()
+{
+    Fixture fxi(this);
+
+    /* Generic dimmers have no 16-bit channels */
+    fxi.setChannels(4);
+    QVERIFY(fxi.fineChannels().isEmpty() == true);
+
+    QLCFixtureDef def;
+    def.setManufacturer("Yoyodyne");
+    def.setModel("Mover");
+
+    QLCChannel* pan = new QLCChannel();
+    pan->setName("Pan");
+    pan->setGroup(QLCChannel::Pan);
+    def.addChannel(pan);
+
+    QLCChannel* tilt = new QLCChannel();
+    tilt->setName("Tilt");
+    tilt->setGroup(QLCChannel::Tilt);
+    def.addChannel(tilt);
+
+    QLCChannel* panFine = new QLCChannel();
+    panFine->setName("Pan fine");
+    panFine->setGroup(QLCChannel::Pan);
+    panFine->setControlByte(QLCChannel::LSB);
+    def.addChannel(panFine);
+
+    QLCChannel* tiltFine = new QLCChannel();
+    tiltFine->setName("Tilt fine");
+    tiltFine->setGroup(QLCChannel::Tilt);
+    tiltFine->setControlByte(QLCChannel::LSB);
+    def.addChannel(tiltFine);
+
+    QLCChannel* dimmer = new QLCChannel();
+    dimmer->setName("Dimmer");
+    dimmer->setGroup(QLCChannel::Intensity);
+    def.addChannel(dimmer);
+
+    QLCFixtureMode* full = new QLCFixtureMode(&def);
+    full->setName("16bit");
+    full->insertChannel(dimmer, 0);
+    full->insertChannel(pan, 1);
+    full->insertChannel(tilt, 2);
+    full->insertChannel(panFine, 3);
+    full->insertChannel(tiltFine, 4);
+    def.addMode(full);
+
+    QLCFixtureMode* panOnly = new QLCFixtureMode(&def);
+    panOnly->setName("16bit pan");
+    panOnly->insertChannel(pan, 0);
+    panOnly->insertChannel(panFine, 1);
+    panOnly->insertChannel(tilt, 2);
+    def.addMode(panOnly);
+
+    /* Pairs are (MSB, LSB), pan first */
+    fxi.setFixtureDefinition(&def, full);
+    QList <QPair <quint32,quint32> > pairs(fxi.fineChannels());
+    QCOMPARE(pairs.size(), 2);
+    QCOMPARE(pairs.at(0).first, quint32(1));
+    QCOMPARE(pairs.at(0).second, quint32(3));
+    QCOMPARE(pairs.at(1).first, quint32(2));
+    QCOMPARE(pairs.at(1).second, quint32(4));
+
+    /* An 8-bit tilt doesn't make a pair */
+    fxi.setFixtureDefinition(&def, panOnly);
+    pairs = fxi.fineChannels();
+    QCOMPARE(pairs.size(), 1);
+    QCOMPARE(pairs.at(0).first, quint32(0));
+    QCOMPARE(pairs.at(0).second, quint32(1));
+
+    fxi.setFixtureDefinition(NULL, NULL);
+}
+
 void Fixture_Test::loadWrongRoot()
 {
     QDomDocument doc;
@@ -39,6 +39,7 @@ private slots:
     void dimmer();
     void fixtureDef();
     void channels();
+    void fineChannels();
     void loadWrongRoot();
     void loadFixtureDef();
     void loadFixtureDefWrongChannels();
@@ -19,6 +19,9 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <math.h>
+
+#include "universearray.h"
 #include "doc.h"
 #include "fixture.h"
 #include "function_stub.h"
@@ -30,6 +33,11 @@ Function_Stub::Function_Stub(Doc* doc) : Function(doc)
     m_postRunCalls = 0;
     m_slotFixtureRemovedId = Fixture::invalidId();
     m_type = Function::Type(0xDEADBEEF);
+    m_channel = -1;
+    m_value = 0;
+    m_group = QLCChannel::NoGroup;
+    m_workload = 0;
+    m_canWriteInParallel = false;
 }
 
 Function_Stub::~Function_Stub()
@@ -79,12 +87,25 @@ void Function_Stub::preRun(MasterTimer* timer)
 void Function_Stub::write(MasterTimer* timer, UniverseArray* universes)
 {
     Q_UNUSED(timer);
-    Q_UNUSED(universes);
+
+    if (m_channel >= 0)
+    {
+        volatile double waste = 0;
+        for (int i = 0; i < m_workload; i++)
+            waste += sin(double(i));
+
+        universes->write(m_channel, uchar(m_value + elapsed()), m_group);
+    }
 
     incrementElapsed();
     m_writeCalls++;
 }
 
+bool Function_Stub::canWriteInParallel() const
+{
+    return m_canWriteInParallel;
+}
+
 void Function_Stub::postRun(MasterTimer* timer, UniverseArray* universes)
 {
     Q_UNUSED(timer);
@@ -23,6 +23,7 @@
 #define FUNCTION_STUB_H
 
 #include "function.h"
+#include "qlcchannel.h"
 
 class Doc;
 
@@ -46,6 +47,7 @@ public:
 
     void preRun(MasterTimer* timer);
     void write(MasterTimer* timer, UniverseArray* universes);
+    bool canWriteInParallel() const;
     void postRun(MasterTimer* timer, UniverseArray* universes);
 
 public slots:
@@ -58,6 +60,14 @@ public:
 
     quint32 m_slotFixtureRemovedId;
     Function::Type m_type;
+
+    /* If m_channel >= 0, write() writes (m_value + elapsed) to m_channel,
+       after wasting CPU for m_workload rounds */
+    int m_channel;
+    uchar m_value;
+    QLCChannel::Group m_group;
+    int m_workload;
+    bool m_canWriteInParallel;
 };
 
 #endif
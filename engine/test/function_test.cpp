@@ -130,33 +130,6 @@ void Function_Test::preRunPostRun()
     // @todo Check the contents of the signal in spyStopped
 }
 
-void Function_Test::stopAndWait()
-{
-    QLCFixtureDefCache cache;
-    Doc doc(this, cache);
-
-    Function_Stub* stub = new Function_Stub(&doc);
-    stub->preRun(NULL);
-    stub->incrementElapsed();
-
-    // @todo Make stopAndWait() return before the 2s watchdog timer
-    //QSignalSpy spyStopped(stub, SIGNAL(stopped(t_function_id)));
-    //QVERIFY(stub->stopAndWait() == true);
-}
-
-void Function_Test::stopAndWaitFail()
-{
-    QLCFixtureDefCache cache;
-    Doc doc(this, cache);
-
-    Function_Stub* stub = new Function_Stub(&doc);
-    stub->preRun(NULL);
-    stub->incrementElapsed();
-
-    QSignalSpy spyStopped(stub, SIGNAL(stopped(t_function_id)));
-    QVERIFY(stub->stopAndWait() == false);
-}
-
 void Function_Test::slotFixtureRemoved()
 {
     QLCFixtureDefCache cache;
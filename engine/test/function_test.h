@@ -35,8 +35,6 @@ private slots:
     void flashUnflash();
     void elapsed();
     void preRunPostRun();
-    void stopAndWait();
-    void stopAndWaitFail();
     void slotFixtureRemoved();
     void invalidId();
     void typeString();
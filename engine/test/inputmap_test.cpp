@@ -25,9 +25,11 @@
 #include "inputpluginstub.h"
 #include "inputmap_test.h"
 #include "qlcconfig.h"
+#include "qlcclock.h"
 #include "qlcfile.h"
 
 #define protected public
+#include "inputlistener.h"
 #include "inputpatch.h"
 #include "inputmap.h"
 #undef protected
@@ -74,6 +76,28 @@ void InputMap_Test::editorUniverse()
     QVERIFY(im.editorUniverse() == 2);
 }
 
+void InputMap_Test::setUniverses()
+{
+    InputMap im(this);
+    QSignalSpy spy(&im, SIGNAL(universesChanged(quint32)));
+
+    /* Never shrink */
+    im.setUniverses(1);
+    QVERIFY(im.universes() == KInputUniverseCount);
+    QVERIFY(spy.size() == 0);
+
+    im.setUniverses(KInputUniverseCount + 3);
+    QVERIFY(im.universes() == KInputUniverseCount + 3);
+    QVERIFY(im.m_patch.size() == int(KInputUniverseCount + 3));
+    QVERIFY(im.patch(KInputUniverseCount + 2) != NULL);
+    QVERIFY(spy.size() == 1);
+    QVERIFY(spy.at(0).at(0) == KInputUniverseCount + 3);
+
+    /* The editor universe can be any existing universe */
+    im.setEditorUniverse(KInputUniverseCount + 2);
+    QVERIFY(im.editorUniverse() == KInputUniverseCount + 2);
+}
+
 void InputMap_Test::appendPlugin()
 {
     InputMap im(this);
@@ -414,6 +438,158 @@ void InputMap_Test::slotValueChanged()
     QVERIFY(spy.at(1).at(2) == 127);
 }
 
+/* Records all values that it receives */
+class InputListenerStub : public InputListener
+{
+public:
+    void receiveInput(quint32 universe, quint32 channel, uchar value)
+    {
+        m_universes << universe;
+        m_channels << channel;
+        m_values << value;
+    }
+
+    QList <quint32> m_universes;
+    QList <quint32> m_channels;
+    QList <uchar> m_values;
+};
+
+void InputMap_Test::routing()
+{
+    InputMap im(this);
+
+    im.loadPlugins(testPluginDir());
+    QVERIFY(im.m_plugins.size() > 0);
+    InputPluginStub* stub = static_cast<InputPluginStub*> (im.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    QVERIFY(im.setPatch(0, stub->name(), 0, false) == true);
+    QVERIFY(im.setPatch(1, stub->name(), 1, false) == true);
+
+    InputListenerStub l1, l2;
+
+    /* Invalid sources are ignored */
+    im.addListener(InputMap::invalidUniverse(), 15, &l1);
+    im.addListener(0, KInputChannelInvalid, &l1);
+    QVERIFY(im.m_routes.isEmpty() == true);
+
+    im.addListener(0, 15, &l1);
+    im.addListener(0, 15, &l1);
+    im.addListener(1, 15, &l2);
+    QCOMPARE(im.listeners(0, 15).size(), 1);
+    QCOMPARE(im.listeners(1, 15).size(), 1);
+    QCOMPARE(im.listeners(0, 5).size(), 0);
+
+    /* Values are delivered from the event loop, only to their listeners */
+    stub->emitValueChanged(0, 15, UCHAR_MAX);
+    stub->emitValueChanged(0, 5, 127);
+    QCOMPARE(l1.m_values.size(), 0);
+    QCoreApplication::processEvents();
+    QCOMPARE(l1.m_values.size(), 1);
+    QCOMPARE(l1.m_universes.at(0), quint32(0));
+    QCOMPARE(l1.m_channels.at(0), quint32(15));
+    QCOMPARE(l1.m_values.at(0), uchar(UCHAR_MAX));
+    QCOMPARE(l2.m_values.size(), 0);
+
+    stub->emitValueChanged(1, 15, 42);
+    QCoreApplication::processEvents();
+    QCOMPARE(l1.m_values.size(), 1);
+    QCOMPARE(l2.m_values.size(), 1);
+    QCOMPARE(l2.m_universes.at(0), quint32(1));
+    QCOMPARE(l2.m_values.at(0), uchar(42));
+
+    /* Both listeners on the same channel */
+    im.addListener(1, 15, &l1);
+    stub->emitValueChanged(1, 15, 43);
+    QCoreApplication::processEvents();
+    QCOMPARE(l1.m_values.size(), 2);
+    QCOMPARE(l1.m_values.at(1), uchar(43));
+    QCOMPARE(l2.m_values.size(), 2);
+    QCOMPARE(l2.m_values.at(1), uchar(43));
+
+    im.removeListener(1, 15, &l2);
+    QCOMPARE(im.listeners(1, 15).size(), 1);
+    stub->emitValueChanged(1, 15, 44);
+    QCoreApplication::processEvents();
+    QCOMPARE(l1.m_values.size(), 3);
+    QCOMPARE(l2.m_values.size(), 2);
+
+    /* Remove from all channels */
+    im.removeListener(&l1);
+    QVERIFY(im.m_routes.isEmpty() == true);
+    stub->emitValueChanged(0, 15, 1);
+    stub->emitValueChanged(1, 15, 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(l1.m_values.size(), 3);
+    QCOMPARE(l2.m_values.size(), 2);
+}
+
+void InputMap_Test::routingBatch()
+{
+    InputMap im(this);
+
+    im.loadPlugins(testPluginDir());
+    QVERIFY(im.m_plugins.size() > 0);
+    InputPluginStub* stub = static_cast<InputPluginStub*> (im.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+    QVERIFY(im.setPatch(0, stub->name(), 0, false) == true);
+
+    InputListenerStub l1, l2;
+    im.addListener(0, 1, &l1);
+    im.addListener(0, 2, &l2);
+
+    /* A sweep delivers only the latest value of each channel */
+    QSignalSpy spy(&im, SIGNAL(inputValueChanged(quint32, quint32, uchar)));
+    QSignalSpy deliveredSpy(&im, SIGNAL(inputDelivered(qint64)));
+    qint64 before = QLCClock::monotonicTime();
+    qint64 first = 0;
+    for (int i = 1; i <= 100; i++)
+    {
+        stub->emitValueChanged(0, 1, i);
+        stub->emitValueChanged(0, 2, 200 - i);
+        if (i == 1)
+        {
+            first = QLCClock::monotonicTime();
+            QTest::qSleep(5);
+        }
+    }
+    QCOMPARE(spy.size(), 200);
+    QCoreApplication::processEvents();
+    QCOMPARE(l1.m_values.size(), 1);
+    QCOMPARE(l1.m_values.at(0), uchar(100));
+    QCOMPARE(l2.m_values.size(), 1);
+    QCOMPARE(l2.m_values.at(0), uchar(100));
+
+    /* One batch, stamped when the first of the merged values arrived */
+    QCOMPARE(deliveredSpy.size(), 1);
+    qint64 timestamp = deliveredSpy.at(0).at(0).toLongLong();
+    QVERIFY(timestamp >= before);
+    QVERIFY(timestamp <= first);
+
+    /* Presses and releases are never merged */
+    l1.m_values.clear();
+    stub->emitValueChanged(0, 1, 0);
+    stub->emitValueChanged(0, 1, 127);
+    stub->emitValueChanged(0, 1, UCHAR_MAX);
+    stub->emitValueChanged(0, 1, 0);
+    stub->emitValueChanged(0, 1, 0);
+    stub->emitValueChanged(0, 1, 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(l1.m_values.size(), 5);
+    QCOMPARE(l1.m_values.at(0), uchar(0));
+    QCOMPARE(l1.m_values.at(1), uchar(UCHAR_MAX));
+    QCOMPARE(l1.m_values.at(2), uchar(0));
+    QCOMPARE(l1.m_values.at(3), uchar(0));
+    QCOMPARE(l1.m_values.at(4), uchar(1));
+
+    /* A removed listener gets nothing from an already queued batch */
+    l1.m_values.clear();
+    stub->emitValueChanged(0, 1, 10);
+    im.removeListener(0, 1, &l1);
+    QCoreApplication::processEvents();
+    QCOMPARE(l1.m_values.size(), 0);
+}
+
 void InputMap_Test::slotConfigurationChanged()
 {
     InputMap im(this);
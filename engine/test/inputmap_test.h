@@ -31,6 +31,7 @@ class InputMap_Test : public QObject
 private slots:
     void initial();
     void editorUniverse();
+    void setUniverses();
     void appendPlugin();
     void notInputPlugin();
     void pluginNames();
@@ -41,6 +42,8 @@ private slots:
     void setPatch();
     void feedBack();
     void slotValueChanged();
+    void routing();
+    void routingBatch();
     void slotConfigurationChanged();
     void loadInputProfiles();
     void inputSourceNames();
@@ -38,10 +38,14 @@
 // Engine
 #include "palettegenerator_test.h"
 #include "universearray_test.h"
+#include "universelayer_test.h"
+#include "triplebuffer_test.h"
+#include "tickprofile_test.h"
 #include "chaserrunner_test.h"
 #include "mastertimer_test.h"
 #include "outputpatch_test.h"
 #include "fadechannel_test.h"
+#include "fadeplan_test.h"
 #include "inputpatch_test.h"
 #include "scenevalue_test.h"
 #include "collection_test.h"
@@ -131,6 +135,21 @@ int main(int argc, char** argv)
     if (r != 0)
         return r;
 
+    UniverseLayer_Test universelayer;
+    r = QTest::qExec(&universelayer, argc, argv);
+    if (r != 0)
+        return r;
+
+    TripleBuffer_Test triplebuffer;
+    r = QTest::qExec(&triplebuffer, argc, argv);
+    if (r != 0)
+        return r;
+
+    TickProfile_Test tickprofile;
+    r = QTest::qExec(&tickprofile, argc, argv);
+    if (r != 0)
+        return r;
+
     OutputPatch_Test outputpatch;
     r = QTest::qExec(&outputpatch, argc, argv);
     if (r != 0)
@@ -171,6 +190,11 @@ int main(int argc, char** argv)
     if (r != 0)
         return r;
 
+    FadePlan_Test fadeplan;
+    r = QTest::qExec(&fadeplan, argc, argv);
+    if (r != 0)
+        return r;
+
     SceneValue_Test scenevalue;
     r = QTest::qExec(&scenevalue, argc, argv);
     if (r != 0)
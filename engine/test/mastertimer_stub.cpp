@@ -44,6 +44,14 @@ void MasterTimerStub::startFunction(Function* function, bool initiatedByOtherFun
     function->preRun(this);
 }
 
+void MasterTimerStub::startFunctions(const QList <Function*>& functions,
+                                     bool initiatedByOtherFunction)
+{
+    QListIterator <Function*> it(functions);
+    while (it.hasNext() == true)
+        startFunction(it.next(), initiatedByOtherFunction);
+}
+
 void MasterTimerStub::stopFunction(Function* function)
 {
     m_functionList.removeAll(function);
@@ -42,6 +42,8 @@ public:
     ~MasterTimerStub();
 
     void startFunction(Function* function, bool initiatedByOtherFunction);
+    void startFunctions(const QList <Function*>& functions,
+                        bool initiatedByOtherFunction);
     void stopFunction(Function* function);
     QList <Function*> m_functionList;
 
@@ -70,8 +70,6 @@ void MasterTimer_Test::initial()
 
     QVERIFY(mt.runningFunctions() == 0);
     QVERIFY(mt.m_functionList.size() == 0);
-    QVERIFY(mt.m_functionListMutex.tryLock() == true);
-    mt.m_functionListMutex.unlock();
 
     QVERIFY(mt.m_dmxSourceList.size() == 0);
     QVERIFY(mt.m_dmxSourceListMutex.tryLock() == true);
@@ -80,7 +78,6 @@ void MasterTimer_Test::initial()
     QVERIFY(mt.outputMap() == m_oms);
     QVERIFY(mt.m_outputMap == m_oms);
     QVERIFY(mt.m_running == false);
-    QVERIFY(mt.m_stopAllFunctions == false);
 }
 
 void MasterTimer_Test::startStop()
@@ -99,7 +96,6 @@ void MasterTimer_Test::startStop()
     QVERIFY(mt.outputMap() == m_oms);
     QVERIFY(mt.m_outputMap == m_oms);
     QVERIFY(mt.m_running == true);
-    QVERIFY(mt.m_stopAllFunctions == false);
 
     mt.stop();
 #ifdef WIN32
@@ -113,7 +109,6 @@ void MasterTimer_Test::startStop()
     QVERIFY(mt.outputMap() == m_oms);
     QVERIFY(mt.m_outputMap == m_oms);
     QVERIFY(mt.m_running == false);
-    QVERIFY(mt.m_stopAllFunctions == false);
 }
 
 void MasterTimer_Test::startStopFunction()
@@ -151,6 +146,173 @@ void MasterTimer_Test::startStopFunction()
     QVERIFY(mt.runningFunctions() == 0);
 }
 
+void MasterTimer_Test::startFunctions()
+{
+    MasterTimer mt(this, m_oms);
+    UniverseArray ua(512);
+
+    Function_Stub fs1(m_doc);
+    Function_Stub fs2(m_doc);
+    Function_Stub fs3(m_doc);
+
+    mt.startFunction(&fs2, false);
+    QVERIFY(mt.runningFunctions() == 1);
+
+    /* Already running functions are skipped, the rest go in order */
+    QList <Function*> list;
+    list << &fs1 << &fs2 << NULL << &fs3 << &fs1;
+    mt.startFunctions(list, true);
+    QVERIFY(mt.runningFunctions() == 3);
+    QVERIFY(fs1.initiatedByOtherFunction() == true);
+    QVERIFY(fs2.initiatedByOtherFunction() == false);
+    QVERIFY(fs3.initiatedByOtherFunction() == true);
+
+    /* Functions are taken into the list on the next tick */
+    QVERIFY(mt.m_functionList.size() == 0);
+    mt.runFunctions(&ua);
+    QVERIFY(mt.m_functionList.size() == 3);
+    QVERIFY(mt.m_functionList.at(0) == &fs2);
+    QVERIFY(mt.m_functionList.at(1) == &fs1);
+    QVERIFY(mt.m_functionList.at(2) == &fs3);
+    QVERIFY(fs1.m_writeCalls == 1);
+
+    quint32 stopCount = fs1.stopCount();
+    fs1.stop();
+    mt.runFunctions(&ua);
+    QVERIFY(mt.runningFunctions() == 2);
+    QVERIFY(mt.m_functionList.size() == 2);
+    QVERIFY(fs1.stopCount() == stopCount + 1);
+
+    /* A stopped function can be started again */
+    mt.startFunctions(list, false);
+    QVERIFY(mt.runningFunctions() == 3);
+    QVERIFY(fs1.initiatedByOtherFunction() == false);
+    mt.runFunctions(&ua);
+    QVERIFY(mt.m_functionList.size() == 3);
+    QVERIFY(mt.m_functionList.at(2) == &fs1);
+
+    /* Without the timer thread, stopping runs the commands right away */
+    mt.stopAllFunctions();
+    QVERIFY(mt.runningFunctions() == 0);
+    QVERIFY(mt.m_functionList.size() == 0);
+}
+
+void MasterTimer_Test::commands()
+{
+    MasterTimer mt(this, m_oms);
+    UniverseArray ua(512);
+
+    Function_Stub fs1(m_doc);
+    Function_Stub fs2(m_doc);
+    mt.startFunction(&fs1, false);
+    mt.startFunction(&fs2, false);
+
+    /* Commands take effect on the next tick */
+    TimerFuture future(mt.stopFunction(&fs1));
+    QVERIFY(future.isFinished() == false);
+    QVERIFY(mt.runningFunctions() == 2);
+    mt.runFunctions(&ua);
+    QVERIFY(future.isFinished() == true);
+    QVERIFY(future.waitForFinished(0) == true);
+    QVERIFY(mt.runningFunctions() == 1);
+    QVERIFY(fs1.m_writeCalls == 0);
+    QVERIFY(fs1.m_postRunCalls == 1);
+    QVERIFY(fs2.m_writeCalls == 1);
+
+    /* Stopping doesn't wait for a tick to finish, if there's none coming */
+    future = mt.stopFunction(&fs2);
+    QVERIFY(future.waitForFinished(10) == false);
+    mt.runFunctions(&ua);
+    QVERIFY(future.isFinished() == true);
+    QVERIFY(mt.runningFunctions() == 0);
+
+    /* Commands run in the order they were posted */
+    mt.flashFunction(&fs1, true);
+    mt.flashFunction(&fs1, false);
+    mt.flashFunction(&fs2, true);
+    QVERIFY(fs1.flashing() == false);
+    QVERIFY(fs2.flashing() == false);
+    mt.runFunctions(&ua);
+    QVERIFY(fs1.flashing() == false);
+    QVERIFY(fs2.flashing() == true);
+
+    /* A default future is always finished */
+    QVERIFY(TimerFuture().isFinished() == true);
+    QVERIFY(TimerFuture().waitForFinished() == true);
+}
+
+void MasterTimer_Test::commandRing()
+{
+    MasterTimer mt(this, m_oms);
+    UniverseArray ua(512);
+    Function_Stub fs(m_doc);
+
+    /* Slots are reused round after round */
+    for (int round = 0; round < 5; round++)
+    {
+        for (int i = 0; i < 1000; i++)
+            QVERIFY(mt.postCommand(MasterTimer::Command::Flash, &fs) == true);
+        QVERIFY(mt.postCommand(MasterTimer::Command::UnFlash, &fs) == true);
+        mt.runFunctions(&ua);
+        QVERIFY(fs.flashing() == false);
+        QVERIFY(mt.m_commandTail == (round + 1) * 1001);
+    }
+
+    /* With nobody to empty a full ring, new commands are dropped */
+    int command = 0;
+    for (int i = 0; i < 1024; i++)
+        QVERIFY(mt.postCommand(MasterTimer::Command::UnFlash, &fs) == true);
+    QVERIFY(mt.postCommand(MasterTimer::Command::Flash, &fs, &command) == false);
+    mt.startFunction(&fs, false);
+    QVERIFY(mt.runningFunctions() == 0);
+
+    /* ...until the ring has been emptied */
+    mt.runFunctions(&ua);
+    QVERIFY(fs.flashing() == false);
+    QVERIFY(mt.postCommand(MasterTimer::Command::Flash, &fs, &command) == true);
+    QVERIFY(mt.isCommandFinished(command) == false);
+    mt.runFunctions(&ua);
+    QVERIFY(mt.isCommandFinished(command) == true);
+    QVERIFY(fs.flashing() == true);
+}
+
+void MasterTimer_Test::stopAllWithinTick()
+{
+    MasterTimer mt(this, m_oms);
+    mt.start();
+
+    Function_Stub fs1(m_doc);
+    Function_Stub fs2(m_doc);
+    Function_Stub fs3(m_doc);
+    mt.startFunction(&fs1, false);
+    mt.startFunction(&fs2, false);
+    mt.startFunction(&fs3, false);
+
+    /* Let the functions run for a while */
+#ifdef WIN32
+    Sleep(100);
+#else
+    usleep(100000);
+#endif
+
+    /* All functions are stopped on the next tick, all at once */
+    mt.stopAllFunctions();
+    QVERIFY(mt.runningFunctions() == 0);
+    QVERIFY(fs1.m_postRunCalls == 1);
+    QVERIFY(fs2.m_postRunCalls == 1);
+    QVERIFY(fs3.m_postRunCalls == 1);
+
+    int writeCalls = fs1.m_writeCalls;
+#ifdef WIN32
+    Sleep(100);
+#else
+    usleep(100000);
+#endif
+    QVERIFY(fs1.m_writeCalls == writeCalls);
+
+    mt.stop();
+}
+
 void MasterTimer_Test::registerUnregisterDMXSource()
 {
     MasterTimer mt(this, m_oms);
@@ -243,6 +405,416 @@ void MasterTimer_Test::interval()
     QVERIFY(mt.m_dmxSourceList.size() == 0);
 }
 
+void MasterTimer_Test::frequency()
+{
+    QVERIFY(MasterTimer::frequency() == MasterTimer::defaultFrequency());
+    QVERIFY(MasterTimer::defaultFrequency() == 50);
+
+    MasterTimer::setFrequency(250);
+    QVERIFY(MasterTimer::frequency() == 250);
+
+    MasterTimer::setFrequency(0);
+    QVERIFY(MasterTimer::frequency() == MasterTimer::minFrequency());
+
+    MasterTimer::setFrequency(MasterTimer::minFrequency() - 1);
+    QVERIFY(MasterTimer::frequency() == MasterTimer::minFrequency());
+
+    MasterTimer::setFrequency(MasterTimer::maxFrequency() + 1);
+    QVERIFY(MasterTimer::frequency() == MasterTimer::maxFrequency());
+
+    MasterTimer::setFrequency(MasterTimer::maxFrequency());
+    QVERIFY(MasterTimer::frequency() == MasterTimer::maxFrequency());
+
+    MasterTimer::setFrequency(MasterTimer::defaultFrequency());
+    QVERIFY(MasterTimer::frequency() == MasterTimer::defaultFrequency());
+}
+
+void MasterTimer_Test::frequencyBetweenRuns()
+{
+    MasterTimer mt(this, m_oms);
+    UniverseArray ua(512);
+    Function_Stub fs(m_doc);
+
+    /* Pretend that there's a timer thread running */
+    MasterTimer::s_timerThreads.ref();
+
+    mt.startFunction(&fs, false);
+    mt.runFunctions(&ua);
+
+    /* Running functions keep the old frequency */
+    MasterTimer::setFrequency(100);
+    QVERIFY(MasterTimer::frequency() == MasterTimer::defaultFrequency());
+    mt.applyFrequency();
+    QVERIFY(MasterTimer::frequency() == MasterTimer::defaultFrequency());
+
+    /* ...until they have all stopped */
+    mt.stopFunction(&fs);
+    mt.runFunctions(&ua);
+    QVERIFY(mt.runningFunctions() == 0);
+    mt.applyFrequency();
+    QVERIFY(MasterTimer::frequency() == 100);
+
+    MasterTimer::s_timerThreads.deref();
+
+    /* Without timer threads the frequency changes right away */
+    MasterTimer::setFrequency(MasterTimer::defaultFrequency());
+    QVERIFY(MasterTimer::frequency() == MasterTimer::defaultFrequency());
+}
+
+void MasterTimer_Test::highFrequencyInterval()
+{
+    MasterTimer::setFrequency(250);
+
+    MasterTimer mt(this, m_oms);
+    DMXSource_Stub dss;
+
+    mt.start();
+    mt.registerDMXSource(&dss);
+    QVERIFY(mt.m_dmxSourceList.size() == 1);
+
+    /* Let the timer settle */
+#ifdef WIN32
+    Sleep(100);
+#else
+    usleep(100000);
+#endif
+
+    quint64 ticks = mt.ticks();
+    qint64 start = MasterTimer::monotonicTime();
+#ifdef WIN32
+    Sleep(2000);
+#else
+    usleep(2000000);
+#endif
+    ticks = mt.ticks() - ticks;
+    qint64 elapsed = MasterTimer::monotonicTime() - start;
+
+    /* Single ticks may come late on a busy machine, but ticks are scheduled
+       against absolute deadlines, so over some 500 ticks the mean period
+       must stay close to 4ms. */
+    QVERIFY(ticks > 0);
+    qint64 mean = elapsed / qint64(ticks);
+    QVERIFY(mean >= 3200000 && mean <= 4800000);
+    QVERIFY(dss.m_writeCalls > 0);
+
+    mt.unregisterDMXSource(&dss);
+    QVERIFY(mt.m_dmxSourceList.size() == 0);
+
+    mt.stop();
+    MasterTimer::setFrequency(MasterTimer::defaultFrequency());
+}
+
+void MasterTimer_Test::statistics()
+{
+    MasterTimer mt(this, m_oms);
+    QVERIFY(mt.ticks() == 0);
+    QVERIFY(mt.overruns() == 0);
+    QVERIFY(mt.maxLateness() == 0);
+    QVERIFY(mt.latenessHistogram().size() == MasterTimer::histogramSize());
+    QVERIFY(mt.jitterHistogram().size() == MasterTimer::histogramSize());
+    QVERIFY(MasterTimer::histogramBinWidth() > 0);
+
+    mt.start();
+#ifdef WIN32
+    Sleep(500);
+#else
+    usleep(500000);
+#endif
+    mt.stop();
+
+    quint64 ticks = mt.ticks();
+    QVERIFY(ticks >= 20 && ticks <= 30);
+    QVERIFY(mt.overruns() <= ticks);
+
+    /* Each tick lands in exactly one lateness bin */
+    quint64 sum = 0;
+    QVector <quint32> lateness(mt.latenessHistogram());
+    QVERIFY(lateness.size() == MasterTimer::histogramSize());
+    for (int i = 0; i < lateness.size(); i++)
+        sum += lateness[i];
+    QVERIFY(sum == ticks);
+
+    /* The first interval is measured from start(), so every tick counts */
+    sum = 0;
+    QVector <quint32> jitter(mt.jitterHistogram());
+    QVERIFY(jitter.size() == MasterTimer::histogramSize());
+    for (int i = 0; i < jitter.size(); i++)
+        sum += jitter[i];
+    QVERIFY(sum == ticks);
+
+    /* Statistics stay put after stop() but can be reset */
+    QVERIFY(mt.ticks() == ticks);
+    mt.resetStatistics();
+    QVERIFY(mt.ticks() == 0);
+    QVERIFY(mt.overruns() == 0);
+    QVERIFY(mt.maxLateness() == 0);
+    for (int i = 0; i < MasterTimer::histogramSize(); i++)
+    {
+        QVERIFY(mt.latenessHistogram()[i] == 0);
+        QVERIFY(mt.jitterHistogram()[i] == 0);
+    }
+}
+
+void MasterTimer_Test::renderThreads()
+{
+    MasterTimer mt(this, m_oms);
+    QVERIFY(mt.renderThreads() == MasterTimer::defaultRenderThreads());
+    QVERIFY(MasterTimer::defaultRenderThreads() >= 1);
+    QVERIFY(MasterTimer::defaultRenderThreads() <= MasterTimer::maxRenderThreads());
+    QVERIFY(mt.m_renderWorkers.size() == 0);
+
+    mt.setRenderThreads(0);
+    QVERIFY(mt.renderThreads() == 1);
+    mt.setRenderThreads(4);
+    QVERIFY(mt.renderThreads() == 4);
+    mt.setRenderThreads(MasterTimer::maxRenderThreads() + 1);
+    QVERIFY(mt.renderThreads() == MasterTimer::maxRenderThreads());
+}
+
+void MasterTimer_Test::parallelWrite()
+{
+    MasterTimer serial(this, m_oms);
+    serial.setRenderThreads(1);
+    UniverseArray serialUa(4 * 512);
+    QList <Function_Stub*> serialFunctions;
+
+    MasterTimer parallel(this, m_oms);
+    parallel.setRenderThreads(4);
+    UniverseArray parallelUa(4 * 512);
+    QList <Function_Stub*> parallelFunctions;
+
+    /* Two identical sets of functions that write to overlapping HTP & LTP
+       channels. Every seventh function can't be written in parallel. */
+    for (int i = 0; i < 40; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            Function_Stub* fs = new Function_Stub(m_doc);
+            fs->m_channel = (i % 5) * 200;
+            fs->m_value = uchar(i * 37);
+            fs->m_group = (i % 3 == 0) ? QLCChannel::Intensity : QLCChannel::Pan;
+            fs->m_workload = (i % 4) * 100;
+            fs->m_canWriteInParallel = (i % 7 != 3);
+
+            if (j == 0)
+            {
+                serialFunctions << fs;
+                serial.startFunction(fs, false);
+            }
+            else
+            {
+                parallelFunctions << fs;
+                parallel.startFunction(fs, false);
+            }
+        }
+    }
+
+    for (int tick = 0; tick < 10; tick++)
+    {
+        serialUa.zeroIntensityChannels();
+        serial.runFunctions(&serialUa);
+
+        parallelUa.zeroIntensityChannels();
+        parallel.runFunctions(&parallelUa);
+
+        QVERIFY(parallelUa.preGMValues() == serialUa.preGMValues());
+        QVERIFY(parallelUa.postGMValues() == serialUa.postGMValues());
+    }
+
+    /* Everything was written in a single thread in the serial timer */
+    QVERIFY(serial.m_renderWorkers.size() == 0);
+    QVERIFY(parallel.m_renderWorkers.size() == 3);
+    for (int i = 0; i < serialFunctions.size(); i++)
+    {
+        QVERIFY(serialFunctions.at(i)->m_writeCalls == 10);
+        QVERIFY(parallelFunctions.at(i)->m_writeCalls == 10);
+    }
+
+    serial.m_functionList.clear();
+    parallel.m_functionList.clear();
+    while (serialFunctions.isEmpty() == false)
+        delete serialFunctions.takeFirst();
+    while (parallelFunctions.isEmpty() == false)
+        delete parallelFunctions.takeFirst();
+}
+
+void MasterTimer_Test::parallelWriteBenchmark_data()
+{
+    QTest::addColumn <int> ("threads");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+}
+
+void MasterTimer_Test::parallelWriteBenchmark()
+{
+    QFETCH(int, threads);
+
+    MasterTimer mt(this, m_oms);
+    mt.setRenderThreads(threads);
+    UniverseArray ua(4 * 512);
+    QList <Function_Stub*> functions;
+
+    /* Lots of functions with roughly the cost of a big EFX each */
+    for (int i = 0; i < 200; i++)
+    {
+        Function_Stub* fs = new Function_Stub(m_doc);
+        fs->m_channel = i;
+        fs->m_group = QLCChannel::Pan;
+        fs->m_workload = 2000;
+        fs->m_canWriteInParallel = true;
+        functions << fs;
+        mt.startFunction(fs, false);
+    }
+
+    /* First pass is always written serially */
+    mt.runFunctions(&ua);
+
+    QBENCHMARK
+    {
+        ua.zeroIntensityChannels();
+        mt.runFunctions(&ua);
+    }
+
+    mt.m_functionList.clear();
+    while (functions.isEmpty() == false)
+        delete functions.takeFirst();
+}
+
+void MasterTimer_Test::profiling()
+{
+    MasterTimer mt(this, m_oms);
+    mt.setRenderThreads(2);
+    QVERIFY(mt.isProfiling() == false);
+
+    Function_Stub fs1(m_doc);
+    fs1.setID(1);
+    fs1.m_channel = 1;
+    mt.startFunction(&fs1, false);
+
+    Function_Stub fs2(m_doc);
+    fs2.setID(2);
+    fs2.m_channel = 2;
+    fs2.m_canWriteInParallel = true;
+    mt.startFunction(&fs2, false);
+
+    Function_Stub fs3(m_doc);
+    fs3.setID(3);
+    fs3.m_channel = 3;
+    fs3.m_canWriteInParallel = true;
+    mt.startFunction(&fs3, false);
+
+    DMXSource_Stub source;
+    mt.registerDMXSource(&source);
+
+    /* Nothing is recorded while profiling is off */
+    mt.timerTick();
+    QVERIFY(mt.m_profile.ticks == 0);
+    QVERIFY(mt.m_profile.functions.size() == 0);
+    QVERIFY(mt.profile().ticks == 0);
+
+    /* Functions got their profile slots when they were taken into use */
+    QVERIFY(mt.m_functionCosts.size() == 3);
+    QVERIFY(mt.m_functionCostSlots.size() == 3);
+    QVERIFY(fs1.m_profileSlot != fs2.m_profileSlot);
+    QVERIFY(fs2.m_profileSlot != fs3.m_profileSlot);
+    QVERIFY(mt.m_functionCostSlots[fs1.id()] == fs1.m_profileSlot);
+    for (int i = 0; i < mt.m_functionCosts.size(); i++)
+        QVERIFY(mt.m_functionCosts.at(i).count == 0);
+
+    mt.setProfiling(true);
+    QVERIFY(mt.isProfiling() == true);
+    for (int i = 0; i < 5; i++)
+        mt.timerTick();
+
+    /* Serially and parallel written functions alike */
+    QVERIFY(mt.m_profile.ticks == 5);
+    QVERIFY(mt.m_functionCosts.size() == 3);
+    QVERIFY(mt.m_functionCosts.at(fs1.m_profileSlot).count == 5);
+    QVERIFY(mt.m_functionCosts.at(fs2.m_profileSlot).count == 5);
+    QVERIFY(mt.m_functionCosts.at(fs3.m_profileSlot).count == 5);
+    QVERIFY(mt.m_profile.dmxSources.size() == 1);
+    QVERIFY(mt.m_profile.dmxSources[&source].count == 5);
+
+    const TickProfile::Cost& tick(mt.m_profile.spans[TickProfile::TickSpan]);
+    QVERIFY(tick.count == 5);
+    QVERIFY(tick.total > 0);
+    QVERIFY(tick.max >= tick.average());
+    for (int i = 1; i < TickProfile::SpanCount; i++)
+    {
+        QVERIFY(mt.m_profile.spans[i].count == 5);
+        QVERIFY(mt.m_profile.spans[i].total <= tick.total);
+    }
+
+    /* The first profiled tick is published right away */
+    TickProfile profile(mt.profile());
+    QVERIFY(profile.ticks >= 1);
+    QVERIFY(profile.functions.size() == 3);
+    QVERIFY(profile.functions[fs1.id()].count >= 1);
+
+    /* Turning profiling off keeps what has been recorded */
+    mt.setProfiling(false);
+    mt.timerTick();
+    QVERIFY(mt.m_profile.ticks == 5);
+
+    /* Reset takes effect in the timer thread on the next tick */
+    mt.resetProfile();
+    QVERIFY(mt.profile().ticks == 0);
+    mt.setProfiling(true);
+    mt.timerTick();
+    QVERIFY(mt.m_profile.ticks == 1);
+    QVERIFY(mt.m_functionCosts.at(fs1.m_profileSlot).count == 1);
+
+    /* A restarted function gets the same slot back */
+    int slot = fs1.m_profileSlot;
+    mt.stopFunction(&fs1);
+    mt.timerTick();
+    mt.startFunction(&fs1, false);
+    mt.timerTick();
+    QVERIFY(fs1.m_profileSlot == slot);
+    QVERIFY(mt.m_functionCosts.size() == 3);
+    QVERIFY(mt.m_functionCosts.at(slot).count == 2);
+
+    /* Unregistered sources are dropped when the profile is published */
+    mt.unregisterDMXSource(&source);
+    mt.m_profilePublished = 0;
+    mt.timerTick();
+    QVERIFY(mt.m_profile.dmxSources.size() == 0);
+    QVERIFY(mt.profile().dmxSources.size() == 0);
+
+    mt.m_functionList.clear();
+}
+
+void MasterTimer_Test::inputLatency()
+{
+    MasterTimer mt(this, m_oms);
+
+    /* Inputs are ignored while profiling is off */
+    mt.slotInputDelivered(MasterTimer::monotonicTime());
+    QVERIFY(mt.m_inputTimestamp == 0);
+
+    mt.setProfiling(true);
+    mt.timerTick();
+    QVERIFY(mt.m_profile.inputLatency.count == 0);
+
+    /* The oldest input of those delivered before a tick is measured */
+    qint64 oldest = MasterTimer::monotonicTime() - 5000000;
+    mt.slotInputDelivered(oldest + 1000000);
+    mt.slotInputDelivered(oldest);
+    mt.slotInputDelivered(oldest + 2000000);
+    QVERIFY(mt.m_inputTimestamp == oldest);
+
+    mt.timerTick();
+    QVERIFY(mt.m_inputTimestamp == 0);
+    QVERIFY(mt.m_profile.inputLatency.count == 1);
+    QVERIFY(mt.m_profile.inputLatency.max >= 5000000);
+
+    /* Nothing more without new inputs */
+    mt.timerTick();
+    QVERIFY(mt.m_profile.inputLatency.count == 1);
+}
+
 void MasterTimer_Test::functionInitiatedStop()
 {
     MasterTimer mt(this, m_oms);
@@ -383,22 +955,16 @@ void MasterTimer_Test::restart()
     mt.stop();
     QVERIFY(mt.runningFunctions() == 0);
     QVERIFY(mt.m_functionList.size() == 0);
-    QVERIFY(mt.m_functionListMutex.tryLock() == true);
-    mt.m_functionListMutex.unlock();
     QVERIFY(mt.outputMap() == m_oms);
     QVERIFY(mt.m_outputMap == m_oms);
     QVERIFY(mt.m_running == false);
-    QVERIFY(mt.m_stopAllFunctions == false);
 
     mt.start();
     QVERIFY(mt.runningFunctions() == 0);
     QVERIFY(mt.m_functionList.size() == 0);
-    QVERIFY(mt.m_functionListMutex.tryLock() == true);
-    mt.m_functionListMutex.unlock();
     QVERIFY(mt.outputMap() == m_oms);
     QVERIFY(mt.m_outputMap == m_oms);
     QVERIFY(mt.m_running == true);
-    QVERIFY(mt.m_stopAllFunctions == false);
 
     mt.startFunction(&fs1, false);
     mt.startFunction(&fs2, false);
@@ -41,8 +41,22 @@ private slots:
     void initial();
     void startStop();
     void startStopFunction();
+    void startFunctions();
+    void commands();
+    void commandRing();
+    void stopAllWithinTick();
     void registerUnregisterDMXSource();
     void interval();
+    void frequency();
+    void frequencyBetweenRuns();
+    void highFrequencyInterval();
+    void statistics();
+    void renderThreads();
+    void parallelWrite();
+    void parallelWriteBenchmark_data();
+    void parallelWriteBenchmark();
+    void profiling();
+    void inputLatency();
     void functionInitiatedStop();
     void runMultipleFunctions();
     void stopAllFunctions();
@@ -33,6 +33,8 @@
 #include "outputmap.h"
 #undef protected
 
+#include "outputworker.h"
+
 #define TESTPLUGINDIR "../outputpluginstub"
 #define INPUT_TESTPLUGINDIR "../inputpluginstub"
 #define ENGINEDIR "../src"
@@ -114,7 +116,7 @@ void OutputMap_Test::setPatch()
     QVERIFY(om.patch(0)->output() == KOutputInvalid);
     QVERIFY(om.patch(1)->plugin() == NULL);
     QVERIFY(om.patch(1)->output() == KOutputInvalid);
-    QVERIFY(om.patch(2)->plugin() == NULL);
+    QVERIFY(om.patch(1)->output() == 2);
     QVERIFY(om.patch(2)->output() == KOutputInvalid);
     QVERIFY(om.patch(3)->plugin() == NULL);
     QVERIFY(om.patch(3)->output() == KOutputInvalid);
@@ -124,7 +126,7 @@ void OutputMap_Test::setPatch()
     QVERIFY(om.patch(0)->output() == KOutputInvalid);
     QVERIFY(om.patch(1)->plugin() == NULL);
     QVERIFY(om.patch(1)->output() == KOutputInvalid);
-    QVERIFY(om.patch(2)->plugin() == NULL);
+    QVERIFY(om.patch(1)->output() == 2);
     QVERIFY(om.patch(2)->output() == KOutputInvalid);
     QVERIFY(om.patch(3)->plugin() == NULL);
     QVERIFY(om.patch(3)->output() == KOutputInvalid);
@@ -134,7 +136,7 @@ void OutputMap_Test::setPatch()
     QVERIFY(om.patch(0)->output() == KOutputInvalid);
     QVERIFY(om.patch(1)->plugin() == NULL);
     QVERIFY(om.patch(1)->output() == KOutputInvalid);
-    QVERIFY(om.patch(2)->plugin() == NULL);
+    QVERIFY(om.patch(1)->output() == 2);
     QVERIFY(om.patch(2)->output() == KOutputInvalid);
     QVERIFY(om.patch(3)->plugin() == NULL);
     QVERIFY(om.patch(3)->output() == KOutputInvalid);
@@ -156,6 +158,78 @@ void OutputMap_Test::setPatch()
     QVERIFY(om.patch(0)->output() == 3);
 }
 
+void OutputMap_Test::setUniverses()
+{
+    OutputMap om(this);
+    QSignalSpy spy(&om, SIGNAL(universesChanged(quint32)));
+
+    om.loadPlugins(testPluginDir());
+    QVERIFY(om.m_plugins.size() >= 1);
+    OutputPluginStub* stub = static_cast<OutputPluginStub*> (om.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    /* Same count, no change */
+    om.setUniverses(KUniverseCount);
+    QVERIFY(spy.size() == 0);
+
+    om.setUniverses(KUniverseCount + 2);
+    QVERIFY(om.universes() == KUniverseCount + 2);
+    QVERIFY(om.m_patch.size() == int(KUniverseCount + 2));
+    QVERIFY(om.m_dumpedUniverses.size() == int(KUniverseCount + 2));
+    QVERIFY(om.m_dumpTimes.size() == int(KUniverseCount + 2));
+    QVERIFY(om.peekUniverses()->universes() == int(KUniverseCount + 2));
+    QVERIFY(om.universeNames().size() == int(KUniverseCount + 2));
+    QVERIFY(spy.size() == 1);
+    QVERIFY(spy.at(0).at(0) == KUniverseCount + 2);
+
+    /* New universes can be patched and written to */
+    QVERIFY(om.setPatch(KUniverseCount + 1, stub->name(), 0) == true);
+    QVERIFY(om.patch(KUniverseCount + 1)->plugin() == stub);
+    UniverseArray* ua = om.claimUniverses();
+    QVERIFY(ua->write((KUniverseCount + 1) * 512 + 5, 42) == true);
+    om.releaseUniverses();
+    om.dumpUniverses();
+    om.flushUniverses();
+    QVERIFY(stub->m_array.data()[5] == char(42));
+
+    /* Never exceed the maximum */
+    om.setUniverses(KUniverseCountMax + 1);
+    QVERIFY(om.universes() == KUniverseCountMax);
+    QVERIFY(om.patch(KUniverseCountMax - 1) != NULL);
+    QVERIFY(om.patch(KUniverseCountMax) == NULL);
+    QVERIFY(spy.size() == 2);
+
+    /* Shrinking closes the dropped outputs and keeps the rest */
+    QVERIFY(om.setPatch(0, stub->name(), 1) == true);
+    QVERIFY(stub->m_openLines.contains(quint32(0)) == true);
+    QVERIFY(stub->m_openLines.contains(quint32(1)) == true);
+    om.setUniverses(2);
+    QVERIFY(om.universes() == 2);
+    QVERIFY(om.m_patch.size() == 2);
+    QVERIFY(om.m_dumpedUniverses.size() == 2);
+    QVERIFY(om.m_dumpTimes.size() == 2);
+    QVERIFY(om.peekUniverses()->universes() == 2);
+    QVERIFY(om.universeNames().size() == 2);
+    QVERIFY(om.patch(2) == NULL);
+    QVERIFY(om.patch(0)->plugin() == stub);
+    QVERIFY(stub->m_openLines.contains(quint32(0)) == false);
+    QVERIFY(stub->m_openLines.contains(quint32(1)) == true);
+    QVERIFY(spy.size() == 3);
+    QVERIFY(spy.at(2).at(0) == 2);
+
+    /* Dropped universes can't be written to or patched */
+    ua = om.claimUniverses();
+    QVERIFY(ua->write(2 * 512, 42) == false);
+    QVERIFY(ua->write(5, 43) == true);
+    om.releaseUniverses();
+    QVERIFY(om.setPatch(2, stub->name(), 2) == false);
+
+    /* The remaining universes are dumped as usual */
+    om.dumpUniverses();
+    om.flushUniverses();
+    QVERIFY(stub->m_array.data()[512 + 5] == char(43));
+}
+
 void OutputMap_Test::claimReleaseDumpReset()
 {
     OutputMap om(this);
@@ -182,6 +256,7 @@ void OutputMap_Test::claimReleaseDumpReset()
     om.releaseUniverses();
 
     om.dumpUniverses();
+    om.flushUniverses();
 
     for (int i = 0; i < 512; i++)
         QCOMPARE(stub->m_array.data()[i], 'a');
@@ -225,10 +300,12 @@ void OutputMap_Test::blackout()
         unis->write(i, 'd', QLCChannel::Intensity);
     om.releaseUniverses();
     om.dumpUniverses();
+    om.flushUniverses();
 
     om.setBlackout(true);
     QVERIFY(om.blackout() == true);
     om.dumpUniverses();
+    om.flushUniverses();
 
     for (int i = 0; i < 2048; i++)
         QVERIFY(stub->m_array[i] == (char) 0);
@@ -236,6 +313,7 @@ void OutputMap_Test::blackout()
     om.setBlackout(true);
     QVERIFY(om.blackout() == true);
     om.dumpUniverses();
+    om.flushUniverses();
 
     for (int i = 0; i < 2048; i++)
         QVERIFY(stub->m_array[i] == (char) 0);
@@ -243,6 +321,7 @@ void OutputMap_Test::blackout()
     om.toggleBlackout();
     QVERIFY(om.blackout() == false);
     om.dumpUniverses();
+    om.flushUniverses();
 
     for (int i = 0; i < 512; i++)
         QVERIFY(stub->m_array[i] == 'a');
@@ -256,6 +335,7 @@ void OutputMap_Test::blackout()
     om.setBlackout(false);
     QVERIFY(om.blackout() == false);
     om.dumpUniverses();
+    om.flushUniverses();
 
     for (int i = 0; i < 512; i++)
         QVERIFY(stub->m_array[i] == 'a');
@@ -269,11 +349,216 @@ void OutputMap_Test::blackout()
     om.toggleBlackout();
     QVERIFY(om.blackout() == true);
     om.dumpUniverses();
+    om.flushUniverses();
 
     for (int i = 0; i < 2048; i++)
         QVERIFY(stub->m_array[i] == (char) 0);
 }
 
+void OutputMap_Test::dumpChangedOnly()
+{
+    OutputMap om(this);
+    om.setKeepAliveInterval(0);
+
+    om.loadPlugins(testPluginDir());
+    QVERIFY(om.m_plugins.size() >= 1);
+    OutputPluginStub* stub = static_cast<OutputPluginStub*> (om.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    om.setPatch(0, stub->name(), 0);
+    om.setPatch(1, stub->name(), 1);
+
+    /* Patching forces the next dump even without changes */
+    QVERIFY(om.m_universeChanged == true);
+    om.dumpUniverses();
+    om.flushUniverses();
+    QVERIFY(om.m_universeChanged == false);
+
+    /* Mark the plugin's buffer so that any writes to it are visible */
+    stub->m_array.fill('z');
+
+    /* Claiming & releasing without writing anything doesn't dump */
+    om.claimUniverses();
+    om.releaseUniverses();
+    om.dumpUniverses();
+    om.flushUniverses();
+    QVERIFY(stub->m_array.at(0) == 'z');
+    QVERIFY(stub->m_array.at(512) == 'z');
+
+    /* Only the changed universe is dumped */
+    UniverseArray* unis = om.claimUniverses();
+    unis->write(513, 'a', QLCChannel::Intensity);
+    om.releaseUniverses();
+    om.dumpUniverses();
+    om.flushUniverses();
+    QVERIFY(stub->m_array.at(0) == 'z');
+    QVERIFY(stub->m_array.at(512) == char(0));
+    QVERIFY(stub->m_array.at(513) == 'a');
+
+    /* Values zeroed and written back on the same tick are no change */
+    stub->m_array.fill('z');
+    unis = om.claimUniverses();
+    unis->zeroIntensityChannels();
+    unis->write(513, 'a', QLCChannel::Intensity);
+    om.releaseUniverses();
+    om.dumpUniverses();
+    om.flushUniverses();
+    QVERIFY(stub->m_array.at(513) == 'z');
+
+    /* Nothing is dumped during blackout, everything right after it */
+    om.setBlackout(true);
+    om.flushUniverses();
+    QVERIFY(stub->m_array.at(513) == char(0));
+    om.setBlackout(false);
+    om.dumpUniverses();
+    om.flushUniverses();
+    QVERIFY(stub->m_array.at(513) == 'a');
+}
+
+void OutputMap_Test::keepAlive()
+{
+    OutputMap om(this);
+    QVERIFY(om.keepAliveInterval() == OutputMap::defaultKeepAliveInterval());
+    QVERIFY(om.keepAliveInterval() > 0);
+
+    om.setKeepAliveInterval(100);
+    QVERIFY(om.keepAliveInterval() == 100);
+
+    om.loadPlugins(testPluginDir());
+    QVERIFY(om.m_plugins.size() >= 1);
+    OutputPluginStub* stub = static_cast<OutputPluginStub*> (om.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    om.setPatch(0, stub->name(), 0);
+    om.dumpUniverses();
+    om.flushUniverses();
+
+    /* Unchanged values are not dumped before the interval has passed */
+    stub->m_array.fill('z');
+    om.dumpUniverses();
+    om.flushUniverses();
+    QVERIFY(stub->m_array.at(0) == 'z');
+
+    /* ...but they are after it */
+    QTest::qWait(150);
+    om.dumpUniverses();
+    om.flushUniverses();
+    QVERIFY(stub->m_array.at(0) == char(0));
+
+    /* Disabled keep-alive doesn't refresh anything */
+    om.setKeepAliveInterval(0);
+    stub->m_array.fill('z');
+    QTest::qWait(150);
+    om.dumpUniverses();
+    om.flushUniverses();
+    QVERIFY(stub->m_array.at(0) == 'z');
+}
+
+void OutputMap_Test::dumpEfficiency()
+{
+    OutputMap om(this);
+
+    om.loadPlugins(testPluginDir());
+    QVERIFY(om.m_plugins.size() >= 1);
+    OutputPluginStub* stub = static_cast<OutputPluginStub*> (om.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    for (quint32 i = 0; i < om.universes(); i++)
+        om.setPatch(i, stub->name(), i);
+
+    UniverseArray* unis = om.claimUniverses();
+    const uchar* data = unis->postGMData();
+    for (quint32 i = 0; i < 512 * om.universes(); i++)
+        unis->write(i, 'x', QLCChannel::Intensity);
+    om.releaseUniverses();
+
+    /* Dumping hands out views to UniverseArray's own buffer, so the buffer
+       must stay exactly where it was, no matter how many times it's dumped. */
+    QBENCHMARK
+    {
+        om.claimUniverses();
+        om.releaseUniverses();
+        om.dumpUniverses();
+    }
+
+    om.flushUniverses();
+
+    QVERIFY(om.peekUniverses()->postGMData() == data);
+    for (quint32 i = 0; i < om.universes(); i++)
+    {
+        QVERIFY(om.peekUniverses()->postGMUniverse(i).constData() ==
+                reinterpret_cast<const char*> (data + (i * 512)));
+    }
+
+    for (quint32 i = 0; i < 512 * om.universes(); i++)
+        QCOMPARE(stub->m_array.data()[i], 'x');
+}
+
+void OutputMap_Test::outputWorkers()
+{
+    OutputMap om(this);
+    QVERIFY(om.m_workers.size() == 0);
+
+    om.loadPlugins(testPluginDir());
+    QVERIFY(om.m_plugins.size() >= 1);
+    QVERIFY(om.m_workers.size() == om.m_plugins.size());
+    OutputPluginStub* stub = static_cast<OutputPluginStub*> (om.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    /* Workers don't run until something is patched to their plugins */
+    OutputWorker* worker = om.outputWorker(stub);
+    QVERIFY(worker != NULL);
+    QVERIFY(worker->plugin() == stub);
+    QVERIFY(worker->isRunning() == false);
+    QVERIFY(worker->patches() == 0);
+    QVERIFY(om.outputWorker(NULL) == NULL);
+
+    om.setPatch(0, stub->name(), 0);
+    QVERIFY(worker->isRunning() == true);
+    QVERIFY(worker->patches() == 1);
+    QVERIFY(om.patch(0)->m_worker == worker);
+
+    om.setPatch(1, stub->name(), 1);
+    QVERIFY(worker->patches() == 2);
+    QVERIFY(om.patch(1)->m_worker == worker);
+
+    /* Re-patching the same universe doesn't attach it twice */
+    om.setPatch(1, stub->name(), 2);
+    QVERIFY(worker->patches() == 2);
+
+    om.setPatch(0, KOutputNone, 0);
+    QVERIFY(worker->patches() == 1);
+    QVERIFY(om.patch(0)->m_worker == NULL);
+
+    /* Worker writes posted universes on its own, without flushUniverses().
+       Stopping the worker makes sure it's done before checking the values. */
+    UniverseArray* unis = om.claimUniverses();
+    for (int i = 512; i < 1024; i++)
+        unis->write(i, 'e', QLCChannel::Intensity);
+    om.releaseUniverses();
+    om.dumpUniverses();
+    QTest::qWait(100);
+
+    worker->stop();
+    QVERIFY(worker->isRunning() == false);
+    for (int i = 2 * 512; i < 3 * 512; i++)
+        QCOMPARE(stub->m_array.data()[i], 'e');
+    int flushes = stub->m_flushCalled;
+    QVERIFY(flushes > 0);
+
+    /* Plugin is flushed only when something has been written to it */
+    om.flushUniverses();
+    QVERIFY(stub->m_flushCalled == flushes);
+
+    unis = om.claimUniverses();
+    unis->write(512, 'f', QLCChannel::Intensity);
+    om.releaseUniverses();
+    om.dumpUniverses();
+    om.flushUniverses();
+    QCOMPARE(stub->m_array.data()[2 * 512], 'f');
+    QVERIFY(stub->m_flushCalled == flushes + 1);
+}
+
 void OutputMap_Test::pluginNames()
 {
     OutputMap om(this);
@@ -368,6 +653,18 @@ void OutputMap_Test::slotConfigurationChanged()
     QCOMPARE(spy.size(), 1);
     QCOMPARE(spy.at(0).size(), 1);
     QCOMPARE(spy.at(0).at(0).toString(), QString(stub->name()));
+
+    /* Patched lines are reopened after the plugin has closed them */
+    QVERIFY(om.setPatch(0, stub->name(), 1) == true);
+    QVERIFY(om.setPatch(1, stub->name(), 2) == true);
+    stub->m_openLines.clear();
+    stub->configure();
+    QCOMPARE(spy.size(), 2);
+    QVERIFY(stub->m_openLines.contains(quint32(1)) == true);
+    QVERIFY(stub->m_openLines.contains(quint32(2)) == true);
+    QVERIFY(om.patch(0)->plugin() == stub);
+    QVERIFY(om.patch(0)->output() == 1);
+    QVERIFY(om.patch(1)->output() == 2);
 }
 
 void OutputMap_Test::mapping()
@@ -33,8 +33,13 @@ private slots:
     void appendPlugin();
     void notOutputPlugin();
     void setPatch();
+    void setUniverses();
     void claimReleaseDumpReset();
     void blackout();
+    void dumpChangedOnly();
+    void keepAlive();
+    void dumpEfficiency();
+    void outputWorkers();
     void pluginNames();
     void pluginOutputs();
     void universeNames();
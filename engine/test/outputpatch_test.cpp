@@ -29,6 +29,7 @@
 /* Expose protected members to unit test */
 #define protected public
 #include "outputpatch.h"
+#include "mastertimer.h"
 #include "outputmap.h"
 #undef protected
 
@@ -50,6 +51,9 @@ void OutputPatch_Test::defaults()
     QVERIFY(op.pluginName() == KOutputNone);
     QVERIFY(op.outputName() == KOutputNone);
     QVERIFY(op.isDMXZeroBased() == false);
+    QVERIFY(op.refreshRate() == 0);
+    QVERIFY(op.interpolation() == false);
+    QVERIFY(op.nextDumpTime() == 0);
 }
 
 void OutputPatch_Test::patch()
@@ -125,3 +129,246 @@ void OutputPatch_Test::dump()
 
     delete op;
 }
+
+void OutputPatch_Test::postDumpPosted()
+{
+    QByteArray uni1(512, char(0));
+    uni1[0] = 100;
+    QByteArray uni2(512, char(0));
+    uni2[0] = 50;
+
+    OutputMap om(this);
+    OutputPatch* op = new OutputPatch(this);
+
+    om.loadPlugins(testPluginDir());
+    QVERIFY(om.m_plugins.size() >= 1);
+    OutputPluginStub* stub = static_cast<OutputPluginStub*> (om.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    /* Not owned by an OutputMap, so there's no worker */
+    op->set(stub, 0);
+    QVERIFY(op->m_worker == NULL);
+
+    /* Nothing posted yet */
+    QVERIFY(op->dumpPosted(0) == false);
+    QVERIFY(stub->m_array[0] == (char) 0);
+
+    /* Posting alone doesn't write anything */
+    op->post(uni1);
+    QVERIFY(stub->m_array[0] == (char) 0);
+    QVERIFY(op->dumpPosted(0) == true);
+    QVERIFY(stub->m_array[0] == (char) 100);
+    QVERIFY(op->dumpPosted(0) == false);
+
+    /* Only the newest one of unwritten universes gets written */
+    op->post(uni2);
+    op->post(uni1);
+    op->post(uni2);
+    QVERIFY(op->dumpPosted(0) == true);
+    QVERIFY(stub->m_array[0] == (char) 50);
+    QVERIFY(op->dumpPosted(0) == false);
+
+    delete op;
+}
+
+void OutputPatch_Test::refreshRate()
+{
+    OutputPatch op(this);
+
+    op.setRefreshRate(44);
+    QVERIFY(op.refreshRate() == 44);
+    op.setRefreshRate(OutputPatch::maxRefreshRate() + 1);
+    QVERIFY(op.refreshRate() == OutputPatch::maxRefreshRate());
+    op.setRefreshRate(0);
+    QVERIFY(op.refreshRate() == 0);
+
+    op.setInterpolation(true);
+    QVERIFY(op.interpolation() == true);
+    op.setInterpolation(false);
+    QVERIFY(op.interpolation() == false);
+}
+
+void OutputPatch_Test::decimate()
+{
+    /* 100Hz, i.e. 10ms between universes */
+    const qint64 ms = Q_INT64_C(1000000);
+    QByteArray uni(512, char(0));
+
+    OutputMap om(this);
+    OutputPatch* op = new OutputPatch(this);
+
+    om.loadPlugins(testPluginDir());
+    QVERIFY(om.m_plugins.size() >= 1);
+    OutputPluginStub* stub = static_cast<OutputPluginStub*> (om.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    op->set(stub, 0);
+    op->setRefreshRate(100);
+
+    /* Nothing is written until something has been posted */
+    QVERIFY(op->dumpPosted(0) == false);
+    QVERIFY(op->nextDumpTime() == 0);
+
+    /* The first universe is written immediately */
+    uni[0] = 10;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(1000 * ms) == true);
+    QVERIFY(stub->m_array[0] == (char) 10);
+    QVERIFY(op->nextDumpTime() == 1010 * ms);
+
+    /* Universes posted before the next one is due are skipped */
+    uni[0] = 20;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(1004 * ms) == false);
+    QVERIFY(stub->m_array[0] == (char) 10);
+    uni[0] = 30;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(1008 * ms) == false);
+    QVERIFY(stub->m_array[0] == (char) 10);
+    QVERIFY(op->dumpPosted(1010 * ms) == true);
+    QVERIFY(stub->m_array[0] == (char) 30);
+    QVERIFY(op->nextDumpTime() == 1020 * ms);
+
+    /* The newest universe is written again when nothing new is posted */
+    stub->m_array[0] = 0;
+    QVERIFY(op->dumpPosted(1021 * ms) == true);
+    QVERIFY(stub->m_array[0] == (char) 30);
+    QVERIFY(op->nextDumpTime() == 1030 * ms);
+
+    /* Falling more than a period behind restarts the schedule */
+    QVERIFY(op->dumpPosted(1055 * ms) == true);
+    QVERIFY(op->nextDumpTime() == 1065 * ms);
+
+    /* Flushing writes a posted universe right away */
+    uni[0] = 40;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(1056 * ms, true) == true);
+    QVERIFY(stub->m_array[0] == (char) 40);
+    QVERIFY(op->dumpPosted(1057 * ms, true) == false);
+
+    delete op;
+}
+
+void OutputPatch_Test::interpolate()
+{
+    const qint64 period = Q_INT64_C(1000000000) / MasterTimer::frequency();
+    QByteArray uni(512, char(0));
+
+    OutputMap om(this);
+    OutputPatch* op = new OutputPatch(this);
+
+    om.loadPlugins(testPluginDir());
+    QVERIFY(om.m_plugins.size() >= 1);
+    OutputPluginStub* stub = static_cast<OutputPluginStub*> (om.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    op->set(stub, 0);
+    op->setRefreshRate(OutputPatch::maxRefreshRate());
+    op->setInterpolation(true);
+
+    uni[0] = 0;
+    uni[1] = 0;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(0) == true);
+
+    /* Channel 0 fades, channel 1 snaps */
+    uni[0] = 100;
+    uni[1] = (char) 200;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(period) == true);
+    QVERIFY(stub->m_array[0] == (char) 0);
+    QVERIFY(stub->m_array[1] == (char) 200);
+
+    QVERIFY(op->dumpPosted(period + period / 2) == true);
+    QVERIFY(stub->m_array[0] == (char) 50);
+    QVERIFY(stub->m_array[1] == (char) 200);
+
+    /* After one tick, the newest universe is written as such */
+    QVERIFY(op->dumpPosted(2 * period) == true);
+    QVERIFY(stub->m_array[0] == (char) 100);
+    QVERIFY(op->dumpPosted(3 * period) == true);
+    QVERIFY(stub->m_array[0] == (char) 100);
+
+    /* Fades downwards work the same way */
+    uni[0] = 20;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(4 * period) == true);
+    QVERIFY(stub->m_array[0] == (char) 100);
+    QVERIFY(op->dumpPosted(4 * period + period / 4) == true);
+    QVERIFY(stub->m_array[0] == (char) 80);
+
+    /* Without interpolation, the newest universe is always written */
+    op->setInterpolation(false);
+    uni[0] = 60;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(6 * period) == true);
+    QVERIFY(stub->m_array[0] == (char) 60);
+
+    delete op;
+}
+
+void OutputPatch_Test::interpolateFine()
+{
+    const qint64 period = Q_INT64_C(1000000000) / MasterTimer::frequency();
+    QByteArray uni(512, char(0));
+
+    OutputMap om(this);
+    OutputPatch* op = new OutputPatch(this);
+
+    om.loadPlugins(testPluginDir());
+    QVERIFY(om.m_plugins.size() >= 1);
+    OutputPluginStub* stub = static_cast<OutputPluginStub*> (om.m_plugins.at(0));
+    QVERIFY(stub != NULL);
+
+    /* Invalid pairs are ignored */
+    QList <QPair <int,int> > pairs;
+    pairs << QPair <int,int> (0, 1) << QPair <int,int> (2, 2)
+          << QPair <int,int> (3, 512) << QPair <int,int> (-1, 4);
+    op->setFineChannels(pairs);
+    QCOMPARE(op->fineChannels().size(), 1);
+    QVERIFY(op->fineChannels().at(0) == QPair <int,int> (0, 1));
+
+    op->set(stub, 0);
+    op->setRefreshRate(OutputPatch::maxRefreshRate());
+    op->setInterpolation(true);
+
+    /* 0x10F0 on the paired channels, the same bytes on unpaired 2 & 3 */
+    uni[0] = (char) 0x10;
+    uni[1] = (char) 0xF0;
+    uni[2] = (char) 0x10;
+    uni[3] = (char) 0xF0;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(0) == true);
+
+    /* 0x1110: the fine channel wraps around while the value goes up */
+    uni[0] = (char) 0x11;
+    uni[1] = (char) 0x10;
+    uni[2] = (char) 0x11;
+    uni[3] = (char) 0x10;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(period) == true);
+    QVERIFY(stub->m_array[0] == (char) 0x10);
+    QVERIFY(stub->m_array[1] == (char) 0xF0);
+
+    /* Halfway, the pair is at 0x1100 and never goes back below 0x10F0.
+       Bytes of their own would have given 0x1010 instead. */
+    QVERIFY(op->dumpPosted(period + period / 2) == true);
+    QVERIFY(stub->m_array[0] == (char) 0x11);
+    QVERIFY(stub->m_array[1] == (char) 0x00);
+    QVERIFY(stub->m_array[2] == (char) 0x10);
+    QVERIFY(stub->m_array[3] == (char) 0x10);
+
+    QVERIFY(op->dumpPosted(2 * period) == true);
+    QVERIFY(stub->m_array[0] == (char) 0x11);
+    QVERIFY(stub->m_array[1] == (char) 0x10);
+
+    /* More than half of the 16-bit range in one tick is a snap */
+    uni[0] = (char) 0xF0;
+    uni[1] = (char) 0x00;
+    op->post(uni);
+    QVERIFY(op->dumpPosted(3 * period) == true);
+    QVERIFY(stub->m_array[0] == (char) 0xF0);
+    QVERIFY(stub->m_array[1] == (char) 0x00);
+
+    delete op;
+}
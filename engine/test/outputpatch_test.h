@@ -33,6 +33,11 @@ private slots:
     void patch();
     void dmxZeroBased();
     void dump();
+    void postDumpPosted();
+    void refreshRate();
+    void decimate();
+    void interpolate();
+    void interpolateFine();
 };
 
 #endif
@@ -180,6 +180,87 @@ void QLCFixtureDefCache_Test::load()
     QVERIFY(cache.manufacturers().contains("SGM") == true);
 }
 
+void QLCFixtureDefCache_Test::lazyLoad()
+{
+    /* Only headers have been read so far */
+    QVERIFY(cache.m_defs.size() > 0);
+    QCOMPARE(cache.m_unloaded.size(), cache.m_defs.size());
+
+    QString model = cache.models("Martin").first();
+    QLCFixtureDef* header = cache.m_models["Martin"][model];
+    QVERIFY(header != NULL);
+    QVERIFY(header->manufacturer() == "Martin");
+    QVERIFY(header->model() == model);
+    QVERIFY(header->type().isEmpty() == false);
+    QVERIFY(header->channels().size() == 0);
+    QVERIFY(header->modes().size() == 0);
+
+    /* The rest is loaded on first use, into the same def */
+    const QLCFixtureDef* def = cache.fixtureDef("Martin", model);
+    QVERIFY(def == header);
+    QVERIFY(def->channels().size() > 0);
+    QVERIFY(def->modes().size() > 0);
+    QCOMPARE(cache.m_unloaded.size(), cache.m_defs.size() - 1);
+    QVERIFY(cache.m_unloaded.contains(header) == false);
+
+    /* Loaded only once */
+    int channels = def->channels().size();
+    QVERIFY(cache.fixtureDef("Martin", model) == def);
+    QCOMPARE(def->channels().size(), channels);
+
+    /* Not a fixture definition */
+    QVERIFY(QLCFixtureDefCache::loadHeader("qlcfixturedefcache_test.cpp") == NULL);
+    QVERIFY(QLCFixtureDefCache::loadHeader("nonexistent.qxf") == NULL);
+}
+
+void QLCFixtureDefCache_Test::lazyLoadFailure()
+{
+    cache.clear();
+
+    /* A valid header followed by a truncated body */
+    QDir dir(QDir::temp());
+    QString subdir = QString("qlcfixturedefcache_test_%1")
+                        .arg(QCoreApplication::applicationPid());
+    QVERIFY(dir.mkdir(subdir) == true);
+    QVERIFY(dir.cd(subdir) == true);
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters(QStringList() << QString("*%1").arg(KExtFixture));
+
+    QFile file(dir.absoluteFilePath(QString("Truncated%1").arg(KExtFixture)));
+    QVERIFY(file.open(QIODevice::WriteOnly) == true);
+    QTextStream stream(&file);
+    stream << "<!DOCTYPE FixtureDefinition>\n"
+           << "<FixtureDefinition>\n"
+           << " <Manufacturer>Yoyodyne</Manufacturer>\n"
+           << " <Model>Truncated</Model>\n"
+           << " <Type>Moving Head</Type>\n"
+           << " <Channel Name=\"Pan\">\n"
+           << "  <Group Byte=\"0\">Pan";
+    stream.flush();
+    file.close();
+
+    /* The header is fine, so the def gets listed */
+    QVERIFY(cache.load(dir) == true);
+    QCOMPARE(cache.m_defs.size(), 1);
+    QVERIFY(cache.manufacturers().contains("Yoyodyne") == true);
+    QVERIFY(cache.models("Yoyodyne").contains("Truncated") == true);
+
+    /* The body isn't, so the def is dropped on first use */
+    QVERIFY(cache.fixtureDef("Yoyodyne", "Truncated") == NULL);
+    QCOMPARE(cache.m_defs.size(), 0);
+    QCOMPARE(cache.m_unloaded.size(), 0);
+    QVERIFY(cache.m_models.contains("Yoyodyne") == false);
+    QVERIFY(cache.manufacturers().contains("Yoyodyne") == false);
+    QVERIFY(cache.models("Yoyodyne").isEmpty() == true);
+
+    /* ...and stays dropped */
+    QVERIFY(cache.fixtureDef("Yoyodyne", "Truncated") == NULL);
+
+    QVERIFY(file.remove() == true);
+    QVERIFY(dir.cdUp() == true);
+    QVERIFY(dir.rmdir(subdir) == true);
+}
+
 void QLCFixtureDefCache_Test::defDirectories()
 {
     QDir dir = QLCFixtureDefCache::systemDefinitionDirectory();
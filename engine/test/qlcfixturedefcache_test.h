@@ -37,6 +37,8 @@ private slots:
     void add();
     void fixtureDef();
 	void load();
+    void lazyLoad();
+    void lazyLoadFailure();
     void defDirectories();
 
 private:
@@ -397,6 +397,7 @@ void Scene_Test::arm()
     s1->arm();
     QVERIFY(s1->armedChannels().size() == 3);
 
+    /* Armed channels are sorted by address */
     FadeChannel ch;
     ch = s1->armedChannels().at(0);
     QVERIFY(ch.address() == fxi->universeAddress());
@@ -405,16 +406,16 @@ void Scene_Test::arm()
     QVERIFY(ch.target() == 123);
 
     ch = s1->armedChannels().at(1);
-    QVERIFY(ch.address() == fxi->universeAddress() + 7);
+    QVERIFY(ch.address() == fxi->universeAddress() + 3);
     QVERIFY(ch.start() == 0);
     QVERIFY(ch.current() == 0);
-    QVERIFY(ch.target() == 45);
+    QVERIFY(ch.target() == 67);
 
     ch = s1->armedChannels().at(2);
-    QVERIFY(ch.address() == fxi->universeAddress() + 3);
+    QVERIFY(ch.address() == fxi->universeAddress() + 7);
     QVERIFY(ch.start() == 0);
     QVERIFY(ch.current() == 0);
-    QVERIFY(ch.target() == 67);
+    QVERIFY(ch.target() == 45);
 
     s1->disarm();
     QVERIFY(s1->armedChannels().size() == 0);
@@ -449,16 +450,16 @@ void Scene_Test::armMissingFixture()
 
     FadeChannel ch;
     ch = s1->armedChannels().at(0);
-    QVERIFY(ch.address() == fxi->universeAddress() + 7);
+    QVERIFY(ch.address() == fxi->universeAddress() + 3);
     QVERIFY(ch.start() == 0);
     QVERIFY(ch.current() == 0);
-    QVERIFY(ch.target() == 45);
+    QVERIFY(ch.target() == 67);
 
     ch = s1->armedChannels().at(1);
-    QVERIFY(ch.address() == fxi->universeAddress() + 3);
+    QVERIFY(ch.address() == fxi->universeAddress() + 7);
     QVERIFY(ch.start() == 0);
     QVERIFY(ch.current() == 0);
-    QVERIFY(ch.target() == 67);
+    QVERIFY(ch.target() == 45);
 
     s1->disarm();
     QVERIFY(s1->armedChannels().size() == 0);
@@ -493,16 +494,16 @@ void Scene_Test::armTooManyChannels()
 
     FadeChannel ch;
     ch = s1->armedChannels().at(0);
-    QVERIFY(ch.address() == fxi->universeAddress() + 7);
+    QVERIFY(ch.address() == fxi->universeAddress() + 3);
     QVERIFY(ch.start() == 0);
     QVERIFY(ch.current() == 0);
-    QVERIFY(ch.target() == 45);
+    QVERIFY(ch.target() == 67);
 
     ch = s1->armedChannels().at(1);
-    QVERIFY(ch.address() == fxi->universeAddress() + 3);
+    QVERIFY(ch.address() == fxi->universeAddress() + 7);
     QVERIFY(ch.start() == 0);
     QVERIFY(ch.current() == 0);
-    QVERIFY(ch.target() == 67);
+    QVERIFY(ch.target() == 45);
 
     s1->disarm();
     QVERIFY(s1->armedChannels().size() == 0);
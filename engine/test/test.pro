@@ -12,6 +12,7 @@ INCLUDEPATH += ../src
 DEPENDPATH  += ../src
 INCLUDEPATH += ../../plugins/interfaces
 INCLUDEPATH += ../inputpluginstub ../outputpluginstub
+INCLUDEPATH += ../benchmark
 QMAKE_LIBDIR += ../src
 LIBS   += -lqlcengine
 
@@ -32,6 +33,7 @@ HEADERS += qlcphysical_test.h \
 HEADERS += bus_test.h \
            chaserrunner_test.h \
            fadechannel_test.h \
+           fadeplan_test.h \
            fixture_test.h \
            function_test.h \
            scene_test.h \
@@ -41,6 +43,9 @@ HEADERS += bus_test.h \
            efx_test.h \
            efxfixture_test.h \
            universearray_test.h \
+           universelayer_test.h \
+           triplebuffer_test.h \
+           tickprofile_test.h \
            outputpatch_test.h \
            inputpatch_test.h \
            outputmap_test.h \
@@ -59,6 +64,9 @@ HEADERS += mastertimer_stub.h \
            outputmap_stub.h \
            function_stub.h
 
+# Allocation counting
+HEADERS += ../benchmark/allocationcounter.h
+
 # Fixture metadata
 SOURCES += qlcphysical_test.cpp \
            qlcfixturemode_test.cpp \
@@ -76,6 +84,7 @@ SOURCES += qlcphysical_test.cpp \
 SOURCES += bus_test.cpp \
            chaserrunner_test.cpp \
            fadechannel_test.cpp \
+           fadeplan_test.cpp \
            fixture_test.cpp \
            function_test.cpp \
            scene_test.cpp \
@@ -85,6 +94,9 @@ SOURCES += bus_test.cpp \
            efx_test.cpp \
            efxfixture_test.cpp \
            universearray_test.cpp \
+           universelayer_test.cpp \
+           triplebuffer_test.cpp \
+           tickprofile_test.cpp \
            outputpatch_test.cpp \
            inputpatch_test.cpp \
            outputmap_test.cpp \
@@ -100,5 +112,8 @@ SOURCES += mastertimer_stub.cpp \
            outputmap_stub.cpp \
            function_stub.cpp
 
+# Allocation counting
+SOURCES += ../benchmark/allocationcounter.cpp
+
 # Test main
 SOURCES += main.cpp
@@ -0,0 +1,92 @@
+/*
+  Q Light Controller - Unit test
+  tickprofile_test.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtTest>
+
+#include "tickprofile_test.h"
+#include "dmxsource_stub.h"
+#include "tickprofile.h"
+
+void TickProfile_Test::cost()
+{
+    TickProfile::Cost cost;
+    QVERIFY(cost.count == 0);
+    QVERIFY(cost.total == 0);
+    QVERIFY(cost.max == 0);
+    QVERIFY(cost.average() == 0);
+
+    cost.add(100);
+    cost.add(300);
+    cost.add(200);
+    QVERIFY(cost.count == 3);
+    QVERIFY(cost.total == 600);
+    QVERIFY(cost.max == 300);
+    QVERIFY(cost.average() == 200);
+}
+
+void TickProfile_Test::initial()
+{
+    TickProfile profile;
+    QVERIFY(profile.ticks == 0);
+    for (int i = 0; i < TickProfile::SpanCount; i++)
+        QVERIFY(profile.spans[i].count == 0);
+    QVERIFY(profile.functions.isEmpty() == true);
+    QVERIFY(profile.dmxSources.isEmpty() == true);
+    QVERIFY(profile.inputLatency.count == 0);
+}
+
+void TickProfile_Test::reset()
+{
+    DMXSource_Stub source;
+    TickProfile profile;
+
+    profile.ticks = 5;
+    profile.spans[TickProfile::DumpSpan].add(1000);
+    profile.functions[3].add(50);
+    profile.dmxSources[&source].add(60);
+    profile.inputLatency.add(70);
+
+    /* Copies are independent of each other */
+    TickProfile copy(profile);
+    profile.reset();
+
+    QVERIFY(profile.ticks == 0);
+    QVERIFY(profile.spans[TickProfile::DumpSpan].count == 0);
+    QVERIFY(profile.functions.isEmpty() == true);
+    QVERIFY(profile.dmxSources.isEmpty() == true);
+    QVERIFY(profile.inputLatency.count == 0);
+
+    QVERIFY(copy.ticks == 5);
+    QVERIFY(copy.spans[TickProfile::DumpSpan].total == 1000);
+    QVERIFY(copy.functions[3].total == 50);
+    QVERIFY(copy.dmxSources[&source].total == 60);
+    QVERIFY(copy.inputLatency.total == 70);
+}
+
+void TickProfile_Test::spanToString()
+{
+    QVERIFY(TickProfile::spanToString(TickProfile::TickSpan) == "Tick");
+    QVERIFY(TickProfile::spanToString(TickProfile::IntensitySpan) == "Intensity reset");
+    QVERIFY(TickProfile::spanToString(TickProfile::FunctionsSpan) == "Functions");
+    QVERIFY(TickProfile::spanToString(TickProfile::DMXSourcesSpan) == "DMX sources");
+    QVERIFY(TickProfile::spanToString(TickProfile::DumpSpan) == "Output dump");
+    QVERIFY(TickProfile::spanToString(TickProfile::SpanCount) == QString());
+}
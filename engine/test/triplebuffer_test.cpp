@@ -0,0 +1,151 @@
+/*
+  Q Light Controller - Unit test
+  triplebuffer_test.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtTest>
+#include <QThread>
+
+#include "triplebuffer_test.h"
+
+#define private public
+#include "qlctriplebuffer.h"
+#undef private
+
+#define KFrameCount 100000
+
+/** Writes KFrameCount frames, each filled with its sequence number */
+class TripleBufferProducer : public QThread
+{
+public:
+    TripleBufferProducer(QLCTripleBuffer* buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    void run()
+    {
+        QByteArray frame(512, char(0));
+        for (int i = 1; i <= KFrameCount; i++)
+        {
+            frame.fill(char(i % 256));
+            *reinterpret_cast<int*> (frame.data()) = i;
+            m_buffer->write(frame);
+        }
+    }
+
+    QLCTripleBuffer* m_buffer;
+};
+
+void TripleBuffer_Test::initial()
+{
+    QLCTripleBuffer tb(512);
+    QVERIFY(tb.m_back != tb.m_front);
+    QVERIFY(tb.m_back != (int(tb.m_middle) & 0x3));
+    QVERIFY(tb.m_front != (int(tb.m_middle) & 0x3));
+    QVERIFY(tb.front().size() == 512);
+    for (int i = 0; i < 3; i++)
+        QVERIFY(tb.m_buffers[i] == QByteArray(512, char(0)));
+
+    /* Nothing written yet */
+    QVERIFY(tb.read() == false);
+}
+
+void TripleBuffer_Test::writeRead()
+{
+    QLCTripleBuffer tb(512);
+    QByteArray frame(512, 'a');
+
+    QVERIFY(tb.write(frame) == true);
+    QVERIFY(tb.read() == true);
+    QVERIFY(tb.front() == frame);
+
+    /* Same frame can't be read twice */
+    QVERIFY(tb.read() == false);
+    QVERIFY(tb.front() == frame);
+
+    frame.fill('b');
+    QVERIFY(tb.write(frame) == true);
+    QVERIFY(tb.front() == QByteArray(512, 'a'));
+    QVERIFY(tb.read() == true);
+    QVERIFY(tb.front() == frame);
+
+    /* Frames of different size are taken as such */
+    QVERIFY(tb.write(QByteArray(10, 'c')) == true);
+    QVERIFY(tb.read() == true);
+    QVERIFY(tb.front() == QByteArray(10, 'c'));
+}
+
+void TripleBuffer_Test::dropStale()
+{
+    QLCTripleBuffer tb(512);
+
+    QVERIFY(tb.write(QByteArray(512, 'a')) == true);
+    QVERIFY(tb.write(QByteArray(512, 'b')) == false);
+    QVERIFY(tb.write(QByteArray(512, 'c')) == false);
+
+    /* Only the newest frame is read */
+    QVERIFY(tb.read() == true);
+    QVERIFY(tb.front() == QByteArray(512, 'c'));
+    QVERIFY(tb.read() == false);
+}
+
+void TripleBuffer_Test::shallowCopy()
+{
+    QLCTripleBuffer tb(512);
+
+    QVERIFY(tb.write(QByteArray(512, 'a')) == true);
+    QVERIFY(tb.read() == true);
+
+    /* A consumer keeping a shallow copy must not see it changing */
+    QByteArray copy(tb.front());
+    for (int i = 0; i < 10; i++)
+    {
+        tb.write(QByteArray(512, char('b' + i)));
+        tb.read();
+    }
+
+    QVERIFY(copy == QByteArray(512, 'a'));
+    QVERIFY(tb.front() == QByteArray(512, char('b' + 9)));
+}
+
+void TripleBuffer_Test::threaded()
+{
+    QLCTripleBuffer tb(512);
+    TripleBufferProducer producer(&tb);
+
+    /* Frames must come out whole and in order, with gaps allowed */
+    int previous = 0;
+    producer.start();
+    while (previous < KFrameCount)
+    {
+        if (tb.read() == false)
+            continue;
+
+        const QByteArray& frame = tb.front();
+        int sequence = *reinterpret_cast<const int*> (frame.constData());
+        QVERIFY(sequence > previous);
+        for (int i = sizeof(int); i < frame.size(); i++)
+            QCOMPARE(frame.at(i), char(sequence % 256));
+
+        previous = sequence;
+    }
+
+    QVERIFY(producer.wait(1000) == true);
+}
@@ -21,8 +21,10 @@
 
 #include <QtTest>
 #include <sys/time.h>
+#include <math.h>
 
 #include "universearray_test.h"
+#include "allocationcounter.h"
 
 #define protected public
 #include "universearray.h"
@@ -153,8 +155,7 @@ void UniverseArray_Test::applyGM()
 {
     UniverseArray ua(1);
 
-    QCOMPARE(ua.m_gMIntensityChannels.size(), 0);
-    QCOMPARE(ua.m_gMNonIntensityChannels.size(), 0);
+    QCOMPARE(ua.m_gMChannels[0], uchar(UniverseArray::GMFlagNone));
     QCOMPARE(ua.applyGM(0, 50, QLCChannel::Intensity), uchar(50));
     QCOMPARE(ua.applyGM(0, 200, QLCChannel::Colour), uchar(200));
 
@@ -178,8 +179,57 @@ void UniverseArray_Test::applyGM()
     QCOMPARE(ua.applyGM(0, 200, QLCChannel::Intensity), uchar(100));
     QCOMPARE(ua.applyGM(0, 255, QLCChannel::Colour), uchar(127));
 
-    QCOMPARE(ua.m_gMIntensityChannels.size(), 1);
-    QCOMPARE(ua.m_gMNonIntensityChannels.size(), 1);
+    QCOMPARE(ua.m_gMChannels[0], uchar(UniverseArray::GMFlagIntensity |
+                                        UniverseArray::GMFlagNonIntensity));
+
+    QCOMPARE(ua.applyGM(0, 0, QLCChannel::Intensity), uchar(0));
+    QCOMPARE(ua.m_gMChannels[0], uchar(UniverseArray::GMFlagNonIntensity));
+    QCOMPARE(ua.applyGM(0, 0, QLCChannel::Colour), uchar(0));
+    QCOMPARE(ua.m_gMChannels[0], uchar(UniverseArray::GMFlagNone));
+}
+
+void UniverseArray_Test::gMTable()
+{
+    UniverseArray ua(1);
+
+    for (int gm = 0; gm <= UCHAR_MAX; gm++)
+    {
+        ua.setGMValueMode(UniverseArray::GMReduce);
+        ua.setGMValue(uchar(gm));
+        for (int i = 0; i <= UCHAR_MAX; i++)
+        {
+            uchar expected = uchar(floor((double(i) * ua.gMFraction()) + 0.5));
+            QCOMPARE(ua.m_gMTable[i], expected);
+        }
+
+        ua.setGMValueMode(UniverseArray::GMLimit);
+        for (int i = 0; i <= UCHAR_MAX; i++)
+            QCOMPARE(ua.m_gMTable[i], uchar(MIN(i, gm)));
+    }
+}
+
+void UniverseArray_Test::zeroIntensityChannels()
+{
+    UniverseArray ua(4);
+
+    ua.write(0, 10, QLCChannel::Intensity);
+    ua.write(1, 20, QLCChannel::Pan);
+    ua.write(2, 30, QLCChannel::Intensity);
+    ua.write(3, 40, QLCChannel::Colour);
+
+    ua.zeroIntensityChannels();
+    QCOMPARE(ua.preGMValue(0), uchar(0));
+    QCOMPARE(ua.preGMValue(1), uchar(20));
+    QCOMPARE(ua.preGMValue(2), uchar(0));
+    QCOMPARE(ua.preGMValue(3), uchar(40));
+    QCOMPARE(ua.postGMData()[0], uchar(0));
+    QCOMPARE(ua.postGMData()[1], uchar(20));
+    QCOMPARE(ua.postGMData()[2], uchar(0));
+    QCOMPARE(ua.postGMData()[3], uchar(40));
+
+    /* HTP channels are still known to be intensity channels after zeroing */
+    QCOMPARE(ua.m_gMChannels[0], uchar(UniverseArray::GMFlagIntensity));
+    QCOMPARE(ua.m_gMChannels[2], uchar(UniverseArray::GMFlagIntensity));
 }
 
 void UniverseArray_Test::write()
@@ -212,6 +262,30 @@ void UniverseArray_Test::write()
     QCOMPARE(ua.postGMValues().data()[0], char(127));
 }
 
+void UniverseArray_Test::writeBlock()
+{
+    UniverseArray ua(10);
+    ua.write(3, 100, QLCChannel::Intensity);
+
+    int channels[] = { 0, 3, 5, 5, 10 };
+    uchar values[] = { 50, 20, 30, 40, 255 };
+    QLCChannel::Group groups[] = { QLCChannel::Intensity, QLCChannel::Intensity,
+                                   QLCChannel::Pan, QLCChannel::Pan,
+                                   QLCChannel::Intensity };
+
+    /* Same as writing one by one: HTP, LTP in order, bounds */
+    ua.writeBlock(channels, values, groups, 5);
+    QCOMPARE(ua.preGMValues().data()[0], char(50));
+    QCOMPARE(ua.preGMValues().data()[3], char(100));
+    QCOMPARE(ua.preGMValues().data()[5], char(40));
+    QCOMPARE(ua.preGMValues().data()[9], char(0));
+
+    ua.setGMValue(127);
+    ua.writeBlock(channels, values, groups, 1);
+    QCOMPARE(ua.postGMValues().data()[0], char(25));
+    QCOMPARE(ua.postGMValues().data()[5], char(40));
+}
+
 void UniverseArray_Test::reset()
 {
     UniverseArray ua(128);
@@ -236,6 +310,282 @@ void UniverseArray_Test::reset()
         QCOMPARE(ua.postGMValues().data()[i], char(0));
 }
 
+void UniverseArray_Test::rawAccess()
+{
+    UniverseArray ua(10);
+    const uchar* pre = ua.preGMData();
+    const uchar* post = ua.postGMData();
+
+    /* Snapshots are deep copies that never share the written buffers */
+    QByteArray preCopy(ua.preGMValues());
+    QByteArray postCopy(ua.postGMValues());
+    QVERIFY(preCopy.constData() != reinterpret_cast<const char*> (pre));
+    QVERIFY(postCopy.constData() != reinterpret_cast<const char*> (post));
+    QCOMPARE(preCopy.size(), 10);
+    QCOMPARE(postCopy.size(), 10);
+
+    ua.setGMValue(127);
+    QVERIFY(ua.write(9, 200, QLCChannel::Intensity) == true);
+    QVERIFY(ua.write(0, 100, QLCChannel::Pan) == true);
+    QCOMPARE(ua.preGMValue(9), uchar(200));
+    QCOMPARE(ua.preGMValue(0), uchar(100));
+    QCOMPARE(ua.preGMValue(5), uchar(0));
+    QCOMPARE(ua.preGMValue(10), uchar(0));
+    QCOMPARE(ua.preGMValue(-1), uchar(0));
+    QCOMPARE(ua.preGMData()[9], uchar(200));
+    QCOMPARE(ua.postGMData()[9], uchar(100));
+    QCOMPARE(ua.postGMData()[0], uchar(100));
+
+    /* Earlier snapshots are left intact, new ones get the new values */
+    QCOMPARE(preCopy.at(9), char(0));
+    QCOMPARE(postCopy.at(9), char(0));
+    QCOMPARE(ua.preGMValues().at(9), char(200));
+    QCOMPARE(ua.postGMValues().at(9), char(100));
+
+    ua.reset();
+    QCOMPARE(ua.preGMValue(9), uchar(0));
+    QCOMPARE(ua.postGMData()[9], uchar(0));
+
+    /* Writing never moves the buffers */
+    QVERIFY(ua.preGMData() == pre);
+    QVERIFY(ua.postGMData() == post);
+}
+
+void UniverseArray_Test::tickAllocations()
+{
+    UniverseArray ua(512 * 4);
+    ua.setGMValue(127);
+
+    int channels[16];
+    uchar values[16];
+    QLCChannel::Group groups[16];
+    for (int i = 0; i < 16; i++)
+    {
+        channels[i] = i * 100;
+        values[i] = uchar(i * 10);
+        groups[i] = (i % 2 == 0) ? QLCChannel::Intensity : QLCChannel::Tilt;
+    }
+
+    /* Everything that the timer thread does with the array on each tick:
+       zero intensities, write values and read them out for dumping. */
+    quint32 bytes = AllocationCounter::bytes();
+    quint32 allocations = AllocationCounter::count();
+    int sum = 0;
+    for (int tick = 0; tick < 100; tick++)
+    {
+        ua.zeroIntensityChannels();
+        for (int i = 0; i < 512; i++)
+            ua.write(i * 4, uchar(tick), QLCChannel::Intensity);
+        ua.writeBlock(channels, values, groups, 16);
+
+        for (int i = 0; i < ua.universes(); i++)
+        {
+            if (ua.isUniverseDirty(i) == true)
+            {
+                ua.setUniverseDirty(i, false);
+                sum += ua.postGMUniverse(i).at(0);
+            }
+        }
+        sum += ua.postGMData()[100];
+    }
+    bytes = AllocationCounter::bytes() - bytes;
+    allocations = AllocationCounter::count() - allocations;
+
+    QVERIFY(sum != 0);
+    QCOMPARE(bytes, quint32(0));
+    QCOMPARE(allocations, quint32(0));
+}
+
+void UniverseArray_Test::postGMUniverse()
+{
+    UniverseArray ua(512 * 2 + 10);
+    QCOMPARE(ua.universes(), 3);
+    QCOMPARE(ua.postGMUniverse(0).size(), 512);
+    QCOMPARE(ua.postGMUniverse(1).size(), 512);
+    QCOMPARE(ua.postGMUniverse(2).size(), 10);
+    QCOMPARE(ua.postGMUniverse(3).size(), 0);
+    QCOMPARE(ua.postGMUniverse(-1).size(), 0);
+
+    QVERIFY(ua.postGMUniverse(0).constData() ==
+            reinterpret_cast<const char*> (ua.postGMData()));
+    QVERIFY(ua.postGMUniverse(1).constData() ==
+            reinterpret_cast<const char*> (ua.postGMData() + 512));
+    QVERIFY(ua.postGMUniverse(2).constData() ==
+            reinterpret_cast<const char*> (ua.postGMData() + 1024));
+
+    /* Views always reflect the latest values */
+    ua.write(3, 42, QLCChannel::Intensity);
+    ua.write(512 + 7, 43, QLCChannel::Intensity);
+    ua.write(1024 + 9, 44, QLCChannel::Intensity);
+    QCOMPARE(ua.postGMUniverse(0).at(3), char(42));
+    QCOMPARE(ua.postGMUniverse(1).at(7), char(43));
+    QCOMPARE(ua.postGMUniverse(2).at(9), char(44));
+}
+
+void UniverseArray_Test::dirtyUniverses()
+{
+    UniverseArray ua(512 * 4);
+    QVERIFY(ua.universes() == 4);
+
+    /* Everything is dirty in the beginning */
+    for (int i = 0; i < 4; i++)
+    {
+        QVERIFY(ua.isUniverseDirty(i) == true);
+        ua.setUniverseDirty(i, false);
+        QVERIFY(ua.isUniverseDirty(i) == false);
+    }
+
+    QVERIFY(ua.isUniverseDirty(-1) == false);
+    QVERIFY(ua.isUniverseDirty(4) == false);
+    ua.setUniverseDirty(4, true);
+    QVERIFY(ua.isUniverseDirty(4) == false);
+
+    /* Writing the same value doesn't make a universe dirty */
+    QVERIFY(ua.write(600, 0, QLCChannel::Intensity) == true);
+    QVERIFY(ua.isUniverseDirty(1) == false);
+
+    QVERIFY(ua.write(600, 100, QLCChannel::Intensity) == true);
+    QVERIFY(ua.isUniverseDirty(0) == false);
+    QVERIFY(ua.isUniverseDirty(1) == true);
+    QVERIFY(ua.isUniverseDirty(2) == false);
+    QVERIFY(ua.isUniverseDirty(3) == false);
+    ua.setUniverseDirty(1, false);
+
+    QVERIFY(ua.write(600, 100, QLCChannel::Intensity) == true);
+    QVERIFY(ua.isUniverseDirty(1) == false);
+
+    /* Rejected HTP writes don't make anything dirty */
+    QVERIFY(ua.write(600, 50, QLCChannel::Intensity) == false);
+    QVERIFY(ua.isUniverseDirty(1) == false);
+
+    /* Zeroing intensities makes dirty only those that had some */
+    ua.zeroIntensityChannels();
+    QVERIFY(ua.isUniverseDirty(0) == false);
+    QVERIFY(ua.isUniverseDirty(1) == true);
+    QVERIFY(ua.isUniverseDirty(2) == false);
+    QVERIFY(ua.isUniverseDirty(3) == false);
+    ua.setUniverseDirty(1, false);
+
+    ua.reset(1536, 10);
+    QVERIFY(ua.isUniverseDirty(0) == false);
+    QVERIFY(ua.isUniverseDirty(1) == false);
+    QVERIFY(ua.isUniverseDirty(2) == false);
+    QVERIFY(ua.isUniverseDirty(3) == true);
+    ua.setUniverseDirty(3, false);
+
+    /* GM changes and full resets touch everything */
+    ua.setGMValue(127);
+    for (int i = 0; i < 4; i++)
+    {
+        QVERIFY(ua.isUniverseDirty(i) == true);
+        ua.setUniverseDirty(i, false);
+    }
+
+    ua.reset();
+    for (int i = 0; i < 4; i++)
+        QVERIFY(ua.isUniverseDirty(i) == true);
+}
+
+void UniverseArray_Test::setUniverses()
+{
+    UniverseArray ua(512 * 2);
+    QVERIFY(ua.universes() == 2);
+    QVERIFY(ua.size() == 1024);
+
+    ua.setGMValue(127);
+    QVERIFY(ua.write(0, 200, QLCChannel::Intensity) == true);
+    QVERIFY(ua.write(1023, 100, QLCChannel::Pan) == true);
+    QVERIFY(ua.write(1024, 100, QLCChannel::Pan) == false);
+    for (int i = 0; i < 2; i++)
+        ua.setUniverseDirty(i, false);
+
+    ua.setUniverses(32);
+    QVERIFY(ua.universes() == 32);
+    QVERIFY(ua.size() == 32 * 512);
+    QVERIFY(ua.preGMValues().size() == 32 * 512);
+    QVERIFY(ua.postGMValues().size() == 32 * 512);
+
+    /* Old values, GM & flags are kept */
+    QCOMPARE(ua.preGMValue(0), uchar(200));
+    QCOMPARE(ua.postGMData()[0], uchar(100));
+    QCOMPARE(ua.preGMValue(1023), uchar(100));
+    QCOMPARE(ua.m_gMChannels[0], uchar(UniverseArray::GMFlagIntensity));
+    QVERIFY(ua.gMValue() == 127);
+    QVERIFY(ua.isUniverseDirty(0) == false);
+    QVERIFY(ua.isUniverseDirty(1) == false);
+
+    /* New channels are zero and dirty */
+    for (int i = 1024; i < ua.size(); i++)
+    {
+        QCOMPARE(ua.preGMData()[i], uchar(0));
+        QCOMPARE(ua.postGMData()[i], uchar(0));
+        QCOMPARE(ua.m_gMChannels[i], uchar(UniverseArray::GMFlagNone));
+    }
+
+    for (int i = 2; i < 32; i++)
+    {
+        QVERIFY(ua.isUniverseDirty(i) == true);
+        QVERIFY(ua.postGMUniverse(i).size() == 512);
+        QVERIFY(ua.postGMUniverse(i).constData() ==
+                reinterpret_cast<const char*> (ua.postGMData() + (i * 512)));
+    }
+
+    /* New channels are writable with GM */
+    QVERIFY(ua.write(31 * 512, 200, QLCChannel::Intensity) == true);
+    QCOMPARE(ua.postGMData()[31 * 512], uchar(100));
+    QVERIFY(ua.postGMUniverse(31).at(0) == char(100));
+
+    /* Shrinking drops the last universes and keeps the rest */
+    ua.setUniverseDirty(0, false);
+    ua.setUniverses(1);
+    QVERIFY(ua.universes() == 1);
+    QVERIFY(ua.size() == 512);
+    QVERIFY(ua.preGMValues().size() == 512);
+    QVERIFY(ua.postGMValues().size() == 512);
+    QCOMPARE(ua.preGMValue(0), uchar(200));
+    QCOMPARE(ua.postGMData()[0], uchar(100));
+    QCOMPARE(ua.m_gMChannels[0], uchar(UniverseArray::GMFlagIntensity));
+    QVERIFY(ua.m_intensityUniverses[0] == true);
+    QVERIFY(ua.isUniverseDirty(0) == false);
+    QVERIFY(ua.postGMUniverse(0).constData() ==
+            reinterpret_cast<const char*> (ua.postGMData()));
+    QVERIFY(ua.write(511, 100, QLCChannel::Pan) == true);
+    QVERIFY(ua.write(512, 100, QLCChannel::Pan) == false);
+
+    /* Growing back doesn't bring the old values back */
+    ua.setUniverses(2);
+    QVERIFY(ua.universes() == 2);
+    QCOMPARE(ua.preGMValue(1023), uchar(0));
+    QCOMPARE(ua.m_gMChannels[1023], uchar(UniverseArray::GMFlagNone));
+    QVERIFY(ua.isUniverseDirty(1) == true);
+}
+
+void UniverseArray_Test::intensityUniverses()
+{
+    UniverseArray ua(512 * 4);
+    for (int i = 0; i < 4; i++)
+        QVERIFY(ua.m_intensityUniverses[i] == false);
+
+    ua.write(600, 10, QLCChannel::Pan);
+    QVERIFY(ua.m_intensityUniverses[1] == false);
+
+    ua.write(1600, 10, QLCChannel::Intensity);
+    QVERIFY(ua.m_intensityUniverses[0] == false);
+    QVERIFY(ua.m_intensityUniverses[1] == false);
+    QVERIFY(ua.m_intensityUniverses[2] == false);
+    QVERIFY(ua.m_intensityUniverses[3] == true);
+
+    /* Zeroing skips universes without intensities and keeps the flags */
+    ua.zeroIntensityChannels();
+    QCOMPARE(ua.preGMValue(600), uchar(10));
+    QCOMPARE(ua.preGMValue(1600), uchar(0));
+    QVERIFY(ua.m_intensityUniverses[3] == true);
+
+    ua.reset();
+    for (int i = 0; i < 4; i++)
+        QVERIFY(ua.m_intensityUniverses[i] == false);
+}
+
 void UniverseArray_Test::setGMValueEfficiency()
 {
     UniverseArray* ua = new UniverseArray(512 * KUniverseCount);
@@ -252,13 +602,12 @@ void UniverseArray_Test::setGMValueEfficiency()
        less than 1ms so there's a full 22ms to spare after GM. */
     QBENCHMARK
     {
-        // This is slower than plain write() because UA has to dig out each
-        // Intensity-enabled channel from its internal QSet.
+        // This is a single pass over all channels' group flags
         ua->setGMValue(127);
     }
 
     for (i = 0; i < int(512 * KUniverseCount); i++)
-        QCOMPARE(ua->postGMValues().data()[i], char(100));
+        QCOMPARE(ua->postGMData()[i], uchar(100));
 }
 
 void UniverseArray_Test::writeEfficiency()
@@ -280,5 +629,27 @@ void UniverseArray_Test::writeEfficiency()
     }
 
     for (i = 0; i < int(512 * KUniverseCount); i++)
-        QCOMPARE(ua->postGMValues().data()[i], char(100));
+        QCOMPARE(ua->postGMData()[i], uchar(100));
+}
+
+void UniverseArray_Test::readEfficiency()
+{
+    UniverseArray* ua = new UniverseArray(512 * KUniverseCount);
+    for (int i = 0; i < int(512 * KUniverseCount); i++)
+        ua->write(i, 200, QLCChannel::Intensity);
+
+    /* Reading every channel once is what Scene and ChaserRunner do when
+       they start fading. This must not copy or allocate anything. */
+    const uchar* pre = ua->preGMData();
+    quint32 sum = 0;
+    QBENCHMARK
+    {
+        sum = 0;
+        for (int i = 0; i < int(512 * KUniverseCount); i++)
+            sum += ua->preGMValue(i);
+    }
+
+    QCOMPARE(sum, quint32(200 * 512 * KUniverseCount));
+    QVERIFY(ua->preGMData() == pre);
+    delete ua;
 }
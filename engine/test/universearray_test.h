@@ -35,10 +35,20 @@ private slots:
     void gMValue();
     void applyGM();
     void setGMValue();
+    void gMTable();
+    void zeroIntensityChannels();
     void write();
+    void writeBlock();
     void reset();
+    void rawAccess();
+    void tickAllocations();
+    void postGMUniverse();
+    void dirtyUniverses();
+    void setUniverses();
+    void intensityUniverses();
     void setGMValueEfficiency();
     void writeEfficiency();
+    void readEfficiency();
 };
 
 #endif
@@ -0,0 +1,181 @@
+/*
+  Q Light Controller - Unit test
+  universelayer_test.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtTest>
+
+#include "universelayer_test.h"
+
+#define protected public
+#include "universelayer.h"
+#include "universearray.h"
+#undef protected
+
+void UniverseLayer_Test::initial()
+{
+    UniverseLayer layer;
+    QVERIFY(layer.count() == 0);
+    QVERIFY(layer.m_values.capacity() >= 512);
+    QVERIFY(layer.universes() != NULL);
+    QVERIFY(layer.universes()->m_layer == &layer);
+}
+
+void UniverseLayer_Test::write()
+{
+    UniverseLayer layer;
+    UniverseArray* ua = layer.universes();
+
+    /* Writes thru the view must end up in the layer */
+    QVERIFY(ua->write(10, 100, QLCChannel::Intensity) == true);
+    QVERIFY(ua->write(600, 200, QLCChannel::Pan) == true);
+    QVERIFY(ua->write(10, 50, QLCChannel::Intensity) == true);
+    QVERIFY(layer.count() == 3);
+
+    const UniverseLayer::Value* values = layer.values();
+    QVERIFY(values[0].channel == 10);
+    QVERIFY(values[0].value == 100);
+    QVERIFY(values[0].group == QLCChannel::Intensity);
+    QVERIFY(values[1].channel == 600);
+    QVERIFY(values[1].value == 200);
+    QVERIFY(values[1].group == QLCChannel::Pan);
+    QVERIFY(values[2].channel == 10);
+    QVERIFY(values[2].value == 50);
+    QVERIFY(values[2].group == QLCChannel::Intensity);
+
+    /* An unattached view has no values to read */
+    QVERIFY(ua->preGMValue(10) == 0);
+}
+
+void UniverseLayer_Test::writeBlock()
+{
+    UniverseLayer layer;
+    UniverseArray* ua = layer.universes();
+
+    int channels[] = { 10, 600 };
+    uchar values[] = { 100, 200 };
+    QLCChannel::Group groups[] = { QLCChannel::Intensity, QLCChannel::Pan };
+
+    QVERIFY(ua->write(5, 1, QLCChannel::Tilt) == true);
+    ua->writeBlock(channels, values, groups, 2);
+    QVERIFY(layer.count() == 3);
+
+    const UniverseLayer::Value* v = layer.values();
+    QVERIFY(v[0].channel == 5);
+    QVERIFY(v[0].value == 1);
+    QVERIFY(v[0].group == QLCChannel::Tilt);
+    QVERIFY(v[1].channel == 10);
+    QVERIFY(v[1].value == 100);
+    QVERIFY(v[1].group == QLCChannel::Intensity);
+    QVERIFY(v[2].channel == 600);
+    QVERIFY(v[2].value == 200);
+    QVERIFY(v[2].group == QLCChannel::Pan);
+}
+
+void UniverseLayer_Test::attach()
+{
+    UniverseArray real(1024);
+    real.setGMValue(127);
+    real.write(10, 200, QLCChannel::Intensity);
+    real.write(600, 42, QLCChannel::Pan);
+
+    UniverseLayer layer;
+    layer.attach(&real);
+    UniverseArray* ua = layer.universes();
+
+    /* The view reads the real values without copying them */
+    QVERIFY(ua->size() == 1024);
+    QVERIFY(ua->universes() == 2);
+    QVERIFY(ua->preGMData() == real.preGMData());
+    QVERIFY(ua->preGMValue(10) == 200);
+    QVERIFY(ua->preGMValue(600) == 42);
+    QVERIFY(ua->postGMData()[10] == 100);
+    QVERIFY(ua->gMValue() == 127);
+
+    /* ...but only records writes */
+    QVERIFY(ua->write(10, 255, QLCChannel::Intensity) == true);
+    QVERIFY(ua->write(600, 1, QLCChannel::Pan) == true);
+    QVERIFY(layer.count() == 2);
+    QVERIFY(real.preGMValue(10) == 200);
+    QVERIFY(real.preGMValue(600) == 42);
+
+    /* Growing the real array takes effect when attached again */
+    real.setUniverses(4);
+    layer.attach(&real);
+    QVERIFY(ua->size() == 4 * 512);
+    QVERIFY(ua->preGMData() == real.preGMData());
+    QVERIFY(ua->preGMValue(10) == 200);
+}
+
+void UniverseLayer_Test::clear()
+{
+    UniverseLayer layer;
+    for (int i = 0; i < 2000; i++)
+        layer.write(i % 512, uchar(i), QLCChannel::Pan);
+    QVERIFY(layer.count() == 2000);
+
+    const UniverseLayer::Value* values = layer.values();
+    layer.clear();
+    QVERIFY(layer.count() == 0);
+
+    /* Memory is kept for the next round */
+    QVERIFY(layer.m_values.capacity() >= 2000);
+    layer.write(1, 2, QLCChannel::Pan);
+    QVERIFY(layer.values() == values);
+}
+
+void UniverseLayer_Test::merge()
+{
+    UniverseArray direct(1024);
+    UniverseArray merged(1024);
+    direct.setGMValue(127);
+    merged.setGMValue(127);
+
+    UniverseLayer layer1;
+    UniverseLayer layer2;
+
+    /* Same writes, directly and thru two layers merged in order */
+    direct.write(5, 200, QLCChannel::Intensity);
+    layer1.write(5, 200, QLCChannel::Intensity);
+    direct.write(6, 10, QLCChannel::Pan);
+    layer1.write(6, 10, QLCChannel::Pan);
+    direct.write(700, 30, QLCChannel::Tilt);
+    layer1.write(700, 30, QLCChannel::Tilt);
+
+    direct.write(5, 100, QLCChannel::Intensity); // HTP: rejected
+    layer2.write(5, 100, QLCChannel::Intensity);
+    direct.write(6, 20, QLCChannel::Pan); // LTP: accepted
+    layer2.write(6, 20, QLCChannel::Pan);
+    direct.write(2000, 1, QLCChannel::Pan); // Out of bounds
+    layer2.write(2000, 1, QLCChannel::Pan);
+
+    merged.merge(&layer1);
+    merged.merge(&layer2);
+
+    QVERIFY(merged.preGMValues() == direct.preGMValues());
+    QVERIFY(merged.postGMValues() == direct.postGMValues());
+    QVERIFY(merged.preGMValue(5) == 200);
+    QVERIFY(merged.preGMValue(6) == 20);
+    QVERIFY(merged.postGMValues()[5] == char(100));
+    QVERIFY(merged.isUniverseDirty(1) == true);
+
+    /* Merging doesn't consume the layer */
+    QVERIFY(layer1.count() == 3);
+    QVERIFY(layer2.count() == 3);
+}
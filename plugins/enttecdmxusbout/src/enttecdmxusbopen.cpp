@@ -22,11 +22,11 @@
 
 #include <QSettings>
 #include <QDebug>
-#include <math.h>
-#include <QTime>
+#include <string.h>
 
 #include "enttecdmxusbopen.h"
 #include "qlctypes.h"
+#include "qlcclock.h"
 #include "qlcftdi.h"
 
 #define DMX_MAB 16
@@ -43,13 +43,14 @@ EnttecDMXUSBOpen::EnttecDMXUSBOpen(const QString& serial, const QString& name,
     : QThread(parent)
     , EnttecDMXUSBWidget(serial, name, id)
     , m_running(false)
-    , m_universe(QByteArray(513, 0))
     , m_frequency(30)
-    , m_granularity(Unknown)
+    , m_frames(DMX_CHANNELS)
+    , m_universe(QByteArray(DMX_CHANNELS + 1, 0))
+    , m_measuredFrequency(0)
 {
     QSettings settings;
     QVariant var = settings.value(SETTINGS_FREQUENCY);
-    if (var.isValid() == true)
+    if (var.isValid() == true && var.toDouble() > 0)
         m_frequency = var.toDouble();
 }
 
@@ -92,19 +93,22 @@ bool EnttecDMXUSBOpen::close()
 QString EnttecDMXUSBOpen::additionalInfo() const
 {
     QString info;
-    QString gran;
+    QString measured;
 
     info += QString("<P>");
     info += QString("<B>%1:</B> %2Hz").arg(tr("DMX Frame Frequency"))
                                       .arg(m_frequency);
     info += QString("<BR>");
-    if (m_granularity == Bad)
-        gran = QString("<FONT COLOR=\"#aa0000\">%1</FONT>").arg(tr("Bad"));
-    else if (m_granularity == Good)
-        gran = QString("<FONT COLOR=\"#00aa00\">%1</FONT>").arg(tr("Good"));
+    if (isRunning() == false)
+        measured = tr("Patch this widget to a universe to find out.");
+    else if (measuredFrequency() < m_frequency * 0.95)
+        measured = QString("<FONT COLOR=\"#aa0000\">%1Hz</FONT>")
+                        .arg(measuredFrequency(), 0, 'f', 1);
     else
-        gran = tr("Patch this widget to a universe to find out.");
-    info += QString("<B>%1:</B> %2").arg(tr("System Timer Accuracy")).arg(gran);
+        measured = QString("<FONT COLOR=\"#00aa00\">%1Hz</FONT>")
+                        .arg(measuredFrequency(), 0, 'f', 1);
+    info += QString("<B>%1:</B> %2").arg(tr("Measured Frame Frequency"))
+                                    .arg(measured);
     info += QString("</P>");
 
     return info;
@@ -116,10 +120,15 @@ QString EnttecDMXUSBOpen::additionalInfo() const
 
 bool EnttecDMXUSBOpen::sendDMX(const QByteArray& universe)
 {
-    m_universe.replace(1, MIN(universe.size(), m_universe.size()), universe);
+    m_frames.write(universe);
     return true;
 }
 
+double EnttecDMXUSBOpen::measuredFrequency() const
+{
+    return double(int(m_measuredFrequency)) / 100.0;
+}
+
 void EnttecDMXUSBOpen::stop()
 {
     if (isRunning() == true)
@@ -127,49 +136,65 @@ void EnttecDMXUSBOpen::stop()
         m_running = false;
         wait();
     }
+
+    m_measuredFrequency = 0;
 }
 
 void EnttecDMXUSBOpen::run()
 {
     // One "official" DMX frame can take (1s/44Hz) = 23ms
-    int frameTime = (int) floor(((double)1000 / m_frequency) + (double)0.5);
+    const qint64 period = qint64(1000000000.0 / m_frequency);
 
     // Wait for device to settle in case the device was opened just recently
-    // Also measure, whether timer granularity is OK
-    QTime time;
-    time.start();
-    usleep(1000);
-    if (time.elapsed() > 3)
-        m_granularity = Bad;
-    else
-        m_granularity = Good;
+    qint64 next = QLCClock::monotonicTime() + 1000000;
+    QLCClock::sleepUntil(next);
+
+    qint64 measureStart = next;
+    int frames = 0;
 
     m_running = true;
     while (m_running == true)
     {
-        // Measure how much time passes during these calls
-        time.restart();
+        // Pick up the latest complete frame, if there is a new one
+        if (m_frames.read() == true)
+        {
+            const QByteArray& frame(m_frames.front());
+            memcpy(m_universe.data() + 1, frame.constData(),
+                   MIN(frame.size(), DMX_CHANNELS));
+        }
 
         if (m_ftdi->setBreak(true) == false)
             goto framesleep;
 
-        if (m_granularity == Good)
-            usleep(DMX_BREAK);
+        QLCClock::sleepUntil(QLCClock::monotonicTime() + DMX_BREAK * 1000);
 
         if (m_ftdi->setBreak(false) == false)
             goto framesleep;
 
-        if (m_granularity == Good)
-            usleep(DMX_MAB);
+        QLCClock::sleepUntil(QLCClock::monotonicTime() + DMX_MAB * 1000);
 
         if (m_ftdi->write(m_universe) == false)
             goto framesleep;
 
+        frames++;
+
 framesleep:
-        // Sleep for the remainder of the DMX frame time
-        if (m_granularity == Good)
-            while (time.elapsed() < frameTime) { usleep(1000); }
+        // Sleep until the next frame is due. If the device has stalled for
+        // a long time, start a new schedule instead of bursting to catch up.
+        next += period;
+        qint64 now = QLCClock::monotonicTime();
+        if (now - next > Q_INT64_C(1000000000))
+            next = now;
         else
-            while (time.elapsed() < frameTime) { /* Busy sleep */ }
+            QLCClock::sleepUntil(next);
+
+        // Publish the measured frame rate once per second
+        if (next - measureStart >= Q_INT64_C(1000000000))
+        {
+            m_measuredFrequency = int((qint64(frames) * Q_INT64_C(100000000000))
+                                      / (next - measureStart));
+            measureStart = next;
+            frames = 0;
+        }
     }
 }
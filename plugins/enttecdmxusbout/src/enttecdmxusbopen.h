@@ -23,11 +23,12 @@
 #ifndef ENTTECDMXUSBOPEN_H
 #define ENTTECDMXUSBOPEN_H
 
+#include <QAtomicInt>
 #include <QByteArray>
 #include <QThread>
-#include <QMutex>
 
 #include "enttecdmxusbwidget.h"
+#include "qlctriplebuffer.h"
 
 class QLCFTDI;
 
@@ -78,23 +79,46 @@ public:
      * Thread
      ************************************************************************/
 public:
-    /** @reimp */
+    /**
+     * Hand a new frame over to the writer thread. The frame is copied
+     * into a lock-free triple buffer, so this never blocks and the writer
+     * thread always sends complete frames, never a mix of two.
+     *
+     * @reimp
+     */
     bool sendDMX(const QByteArray& universe);
 
-protected:
-    enum TimerGranularity { Unknown, Good, Bad };
+    /**
+     * Get the frame rate that the writer thread has actually achieved
+     * during the last second.
+     *
+     * @return Measured frames per second, 0 if the thread is not running
+     */
+    double measuredFrequency() const;
 
+protected:
     /** Stop the writer thread */
     void stop();
 
-    /** DMX writer thread worker method */
+    /**
+     * DMX writer thread worker method. Frames are scheduled at absolute
+     * deadlines on the monotonic clock, so the frame rate doesn't drift
+     * with the time spent in the FTDI calls.
+     */
     void run();
 
 protected:
-    bool m_running;
-    QByteArray m_universe;
+    volatile bool m_running;
     double m_frequency;
-    TimerGranularity m_granularity;
+
+    /** Frames from sendDMX(), picked up by the writer thread */
+    QLCTripleBuffer m_frames;
+
+    /** The frame being sent, with start code. Used only by the thread. */
+    QByteArray m_universe;
+
+    /** Measured frame rate in hundredths of Hertz */
+    QAtomicInt m_measuredFrequency;
 };
 
 #endif
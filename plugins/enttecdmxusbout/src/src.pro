@@ -7,6 +7,7 @@ TARGET   = enttecdmxusbout
 CONFIG      += plugin
 QT          += gui core
 INCLUDEPATH += ../../interfaces
+unix:!macx:LIBS += -lrt
 
 # FTD2XX is a proprietary interface by FTDI Ltd. and would therefore taint the
 # 100% FLOSS codebase of QLC if distributed along with QLC sources. Download
@@ -26,7 +27,9 @@ win32 {
     PKGCONFIG   += libftdi libusb
 }
 
-HEADERS += ../../interfaces/qlcoutplugin.h
+HEADERS += ../../interfaces/qlcoutplugin.h \
+           ../../interfaces/qlctriplebuffer.h \
+           ../../interfaces/qlcclock.h
 HEADERS += enttecdmxusbwidget.h \
            qlcftdi.h \
            enttecdmxusbout.h \
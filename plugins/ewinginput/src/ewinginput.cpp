@@ -39,6 +39,12 @@ void EWingInput::init()
        any local address. */
     m_socket = new QUdpSocket(this);
     reBindSocket();
+
+    /* Values from all the datagrams that arrive in a burst are emitted in
+       one go, so that wing sliders don't flood the event loop. */
+    m_inputQueue = new QLCInputQueue(this);
+    m_valueTimestamp = 0;
+
     connect(m_socket, SIGNAL(readyRead()), this, SLOT(slotReadSocket()));
 }
 
@@ -46,6 +52,8 @@ EWingInput::~EWingInput()
 {
     while (m_devices.isEmpty() == false)
         delete m_devices.takeFirst();
+
+    delete m_inputQueue;
 }
 
 QString EWingInput::name()
@@ -145,6 +153,34 @@ QString EWingInput::infoText(quint32 input)
     return str;
 }
 
+qint64 EWingInput::valueTimestamp()
+{
+    return m_valueTimestamp;
+}
+
+void EWingInput::customEvent(QEvent* event)
+{
+    if (event->type() == QLCInputQueue::eventType())
+    {
+        QVector <QLCInputQueue::Event> events(m_inputQueue->take());
+        for (int i = 0; i < events.size(); i++)
+        {
+            const QLCInputQueue::Event& e = events.at(i);
+
+            /* The wing may have been removed since its value was queued */
+            int index = m_devices.indexOf(static_cast<EWing*> (e.device));
+            if (index != -1)
+            {
+                m_valueTimestamp = e.timestamp;
+                emit valueChanged(quint32(index), e.channel, e.value);
+            }
+        }
+
+        m_valueTimestamp = 0;
+        event->accept();
+    }
+}
+
 /*****************************************************************************
  * Devices
  *****************************************************************************/
@@ -266,7 +302,7 @@ void EWingInput::slotReadSocket()
 void EWingInput::slotValueChanged(quint32 channel, uchar value)
 {
     EWing* wing = qobject_cast<EWing*> (QObject::sender());
-    emit valueChanged(m_devices.indexOf(wing), channel, value);
+    m_inputQueue->enqueue(wing, channel, value);
 }
 
 /*****************************************************************************
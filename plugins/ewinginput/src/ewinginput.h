@@ -26,6 +26,7 @@
 #include <QStringList>
 #include <QList>
 
+#include "qlcinputqueue.h"
 #include "qlcinplugin.h"
 #include "ewing.h"
 
@@ -72,6 +73,20 @@ public:
     /** @reimp */
     QString infoText(quint32 input = KInputInvalid);
 
+    /** @reimp */
+    qint64 valueTimestamp();
+
+protected:
+    /** Emit values that have been queued from the wings */
+    void customEvent(QEvent* event);
+
+protected:
+    /** Values parsed from datagrams, waiting to be emitted */
+    QLCInputQueue* m_inputQueue;
+
+    /** Timestamp of the value that is being emitted */
+    qint64 m_valueTimestamp;
+
 signals:
     /** @reimp */
     void valueChanged(quint32 line, quint32 channel, uchar value);
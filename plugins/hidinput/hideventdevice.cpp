@@ -278,13 +278,10 @@ bool HIDEventDevice::readEvent()
                 val = 0;
         }
 
-        /* Post the event to the global event loop so
-           that we can switch context away from the
-           poller thread and into the main application
-           thread. This is caught in
-           HIDInput::customEvent(). */
-        e = new HIDInputEvent(this, m_line, ev.code, val, true);
-        QApplication::postEvent(parent(), e);
+        /* Queue the value for the main application thread. The
+           plugin is notified thru the global event loop, which
+           is caught in HIDInput::customEvent(). */
+        static_cast<HIDInput*> (parent())->enqueueValue(this, ev.code, val);
 
         return true;
     }
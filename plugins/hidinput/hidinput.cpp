@@ -58,6 +58,8 @@ HIDInputEvent::~HIDInputEvent()
 
 void HIDInput::init()
 {
+    m_inputQueue = new QLCInputQueue(this);
+    m_valueTimestamp = 0;
     m_poller = new HIDPoller(this);
     rescanDevices();
 }
@@ -69,6 +71,8 @@ HIDInput::~HIDInput()
 
     m_poller->stop();
     delete m_poller;
+
+    delete m_inputQueue;
 }
 
 QString HIDInput::name()
@@ -109,10 +113,23 @@ void HIDInput::close(quint32 input)
         qDebug() << name() << "has no input number:" << input;
 }
 
+qint64 HIDInput::valueTimestamp()
+{
+    return m_valueTimestamp;
+}
+
 void HIDInput::customEvent(QEvent* event)
 {
-    if (event->type() == _HIDInputEventType)
+    if (event->type() == QLCInputQueue::eventType())
+    {
+        emitQueuedValues();
+        event->accept();
+    }
+    else if (event->type() == _HIDInputEventType)
     {
+        /* Emit everything that was read before this event first */
+        emitQueuedValues();
+
         HIDInputEvent* e = static_cast<HIDInputEvent*> (event);
         if (e != NULL && e->m_alive == true)
             emit valueChanged(e->m_input, e->m_channel, e->m_value);
@@ -123,6 +140,25 @@ void HIDInput::customEvent(QEvent* event)
     }
 }
 
+void HIDInput::emitQueuedValues()
+{
+    QVector <QLCInputQueue::Event> events(m_inputQueue->take());
+    for (int i = 0; i < events.size(); i++)
+    {
+        const QLCInputQueue::Event& e = events.at(i);
+
+        /* The device may have been removed since its value was queued */
+        HIDDevice* dev = static_cast<HIDDevice*> (e.device);
+        if (m_devices.contains(dev) == true)
+        {
+            m_valueTimestamp = e.timestamp;
+            emit valueChanged(dev->line(), e.channel, e.value);
+        }
+    }
+
+    m_valueTimestamp = 0;
+}
+
 QString HIDInput::infoText(quint32 input)
 {
     QString str;
@@ -298,6 +334,11 @@ void HIDInput::removePollDevice(HIDDevice* device)
     m_poller->removeDevice(device);
 }
 
+void HIDInput::enqueueValue(HIDDevice* device, quint32 channel, uchar value)
+{
+    m_inputQueue->enqueue(device, channel, value);
+}
+
 /*****************************************************************************
  * Plugin export
  ****************************************************************************/
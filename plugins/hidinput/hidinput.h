@@ -25,6 +25,7 @@
 #include <QEvent>
 #include <QList>
 
+#include "qlcinputqueue.h"
 #include "qlcinplugin.h"
 
 #include "hiddevice.h"
@@ -89,6 +90,9 @@ public:
     /** @reimp */
     QString infoText(quint32 input = KInputInvalid);
 
+    /** @reimp */
+    qint64 valueTimestamp();
+
 signals:
     /** @reimp */
     void valueChanged(quint32 line, quint32 channel, uchar value);
@@ -96,6 +100,16 @@ signals:
 protected:
     void customEvent(QEvent* event);
 
+    /** Emit values that the devices have queued */
+    void emitQueuedValues();
+
+protected:
+    /** Values from the poller thread, waiting to be emitted */
+    QLCInputQueue* m_inputQueue;
+
+    /** Timestamp of the value that is being emitted */
+    qint64 m_valueTimestamp;
+
     /*********************************************************************
      * Configuration
      *********************************************************************/
@@ -144,6 +158,10 @@ public:
     void addPollDevice(HIDDevice* device);
     void removePollDevice(HIDDevice* device);
 
+    /** Queue a value from a device for emitting in the main thread. Called
+        by the devices in the poller thread. */
+    void enqueueValue(HIDDevice* device, quint32 channel, uchar value);
+
 protected:
     HIDPoller* m_poller;
 };
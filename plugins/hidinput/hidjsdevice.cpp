@@ -142,9 +142,8 @@ bool HIDJsDevice::readEvent()
             /* Map button channels to start after axes */
             ch = quint32(m_axes + ev.number);
 
-            /* Generate and post an event */
-            e = new HIDInputEvent(this, m_line, ch, val, true);
-            QApplication::postEvent(parent(), e);
+            /* Queue the value for the main application thread */
+            static_cast<HIDInput*> (parent())->enqueueValue(this, ch, val);
         }
         else if ((ev.type & ~JS_EVENT_INIT) == JS_EVENT_AXIS)
         {
@@ -152,8 +151,7 @@ bool HIDJsDevice::readEvent()
                         double(0), double(UCHAR_MAX));
             ch = quint32(ev.number);
 
-            e = new HIDInputEvent(this, m_line, ch, val, true);
-            QApplication::postEvent(parent(), e);
+            static_cast<HIDInput*> (parent())->enqueueValue(this, ch, val);
         }
         else
         {
@@ -0,0 +1,119 @@
+/*
+  Q Light Controller
+  qlcclock.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef QLCCLOCK_H
+#define QLCCLOCK_H
+
+#include <QtGlobal>
+#include <QDebug>
+
+#if defined(WIN32)
+#   include <windows.h>
+#elif defined(__APPLE__)
+#   include <mach/mach_time.h>
+#else
+#   include <string.h>
+#   include <errno.h>
+#   include <time.h>
+#endif
+
+/**
+ * QLCClock provides the monotonic clock that QLC uses for scheduling timer
+ * ticks and DMX frames, and for timestamping input events. Since the clock
+ * is the same for the engine and all plugins, timestamps taken in a plugin
+ * can be compared with those taken by MasterTimer.
+ */
+class QLCClock
+{
+public:
+    /**
+     * Get the current time of the monotonic clock. The clock is not
+     * affected by wall clock changes.
+     *
+     * @return Current time in nanoseconds since an arbitrary starting point
+     */
+    static qint64 monotonicTime()
+    {
+#if defined(WIN32)
+        static LARGE_INTEGER freq = { { 0, 0 } };
+        if (freq.QuadPart == 0)
+            QueryPerformanceFrequency(&freq);
+
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        return qint64((double(now.QuadPart) / double(freq.QuadPart)) * 1e9);
+#elif defined(__APPLE__)
+        static mach_timebase_info_data_t timebase = { 0, 0 };
+        if (timebase.denom == 0)
+            mach_timebase_info(&timebase);
+
+        return qint64(mach_absolute_time() * timebase.numer / timebase.denom);
+#else
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return qint64(now.tv_sec) * Q_INT64_C(1000000000) + qint64(now.tv_nsec);
+#endif
+    }
+
+    /**
+     * Sleep until the monotonic clock reaches the given time. Sleeping to
+     * absolute deadlines keeps periodic schedules from drifting, since
+     * the time spent between two sleeps doesn't add up.
+     *
+     * @param deadline The time to wake up at, in monotonicTime() nanoseconds
+     */
+    static void sleepUntil(qint64 deadline)
+    {
+#if defined(WIN32)
+        /* Sleep() is not accurate enough for the last millisecond, so
+           relinquish the time slot until the deadline has passed. */
+        qint64 remaining = deadline - monotonicTime();
+        if (remaining > 2000000)
+            Sleep(DWORD((remaining / 1000000) - 1));
+        while (monotonicTime() < deadline)
+            Sleep(0);
+#elif defined(__APPLE__)
+        static mach_timebase_info_data_t timebase = { 0, 0 };
+        if (timebase.denom == 0)
+            mach_timebase_info(&timebase);
+
+        mach_wait_until(uint64_t(deadline) * timebase.denom / timebase.numer);
+#else
+        timespec ts;
+        ts.tv_sec = time_t(deadline / Q_INT64_C(1000000000));
+        ts.tv_nsec = long(deadline % Q_INT64_C(1000000000));
+
+        /* clock_nanosleep() returns the error number instead of setting
+           errno. Absolute deadlines can be retried as such after signal
+           interruptions. */
+        int ret;
+        do
+        {
+            ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        } while (ret == EINTR);
+
+        if (ret != 0)
+            qWarning() << Q_FUNC_INFO << "Unable to sleep:" << strerror(ret);
+#endif
+    }
+};
+
+#endif
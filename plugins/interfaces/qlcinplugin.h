@@ -172,6 +172,18 @@ signals:
      */
     void valueChanged(quint32 input, quint32 channel, uchar value);
 
+public:
+    /**
+     * Get the time when the value that is being emitted with valueChanged()
+     * was received from its device, as QLCClock::monotonicTime() nanoseconds.
+     * This is meaningful only in slots that are directly connected to
+     * valueChanged(), while the signal is being emitted.
+     *
+     * The default implementation returns 0, which means that the time is
+     * not known.
+     */
+    virtual qint64 valueTimestamp() { return 0; }
+
     /*************************************************************************
      * Configuration
      *************************************************************************/
@@ -223,6 +235,8 @@ public:
     virtual void feedBack(quint32 input, quint32 channel, uchar value) = 0;
 };
 
-Q_DECLARE_INTERFACE(QLCInPlugin, "QLCInPlugin")
+/* Bump the version whenever the virtual methods change, so that plugins
+   built against an older interface are rejected instead of loaded. */
+Q_DECLARE_INTERFACE(QLCInPlugin, "QLCInPlugin/2")
 
 #endif
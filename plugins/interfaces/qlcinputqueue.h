@@ -0,0 +1,165 @@
+/*
+  Q Light Controller
+  qlcinputqueue.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef QLCINPUTQUEUE_H
+#define QLCINPUTQUEUE_H
+
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QVector>
+#include <QObject>
+#include <QMutex>
+#include <QEvent>
+#include <QHash>
+#include <QPair>
+
+#include "qlcclock.h"
+
+/**
+ * QLCInputQueue carries input values from an input plugin's reader thread
+ * (or socket handler) to the plugin's main thread side, where they are
+ * emitted with QLCInPlugin::valueChanged().
+ *
+ * Each value is timestamped with QLCClock when it is queued. Instead of
+ * posting an event for each value, the queue posts a single event of
+ * eventType() to its receiver when the first value is queued. Until the
+ * receiver takes the values with take(), new values for a channel replace
+ * the channel's queued value, so a fader sweep doesn't flood the event
+ * loop with intermediate values. A replaced value keeps the timestamp of
+ * the value that was queued first, so latency is measured from the oldest
+ * input that the event stands for. Changes to or from zero are never
+ * merged, so button presses and releases are kept.
+ *
+ * All methods are thread-safe.
+ */
+class QLCInputQueue
+{
+public:
+    /** A queued input value */
+    struct Event
+    {
+        /** The plugin's device that the value came from */
+        QObject* device;
+
+        /** The channel that the value came from */
+        quint32 channel;
+
+        /** The latest value of the channel */
+        uchar value;
+
+        /** QLCClock::monotonicTime() when the oldest of the values merged
+            into this one was queued */
+        qint64 timestamp;
+    };
+
+public:
+    /**
+     * Create a new input queue
+     *
+     * @param receiver The object that receives an event of eventType()
+     *                 when values have been queued (usually the plugin)
+     */
+    QLCInputQueue(QObject* receiver)
+    {
+        Q_ASSERT(receiver != NULL);
+        m_receiver = receiver;
+    }
+
+    /** Get the type of the events that are posted to the receiver */
+    static QEvent::Type eventType()
+    {
+        static QEvent::Type type =
+            static_cast<QEvent::Type> (QEvent::registerEventType());
+        return type;
+    }
+
+    /**
+     * Queue a value, replacing the channel's queued value if possible.
+     *
+     * @param device The plugin's device that the value came from
+     * @param channel The channel that the value came from
+     * @param value The new value
+     */
+    void enqueue(QObject* device, quint32 channel, uchar value)
+    {
+        qint64 timestamp = QLCClock::monotonicTime();
+        QPair <QObject*, quint32> key(device, channel);
+
+        QMutexLocker locker(&m_mutex);
+
+        QHash <QPair <QObject*, quint32>, int>::const_iterator it =
+            m_index.find(key);
+        if (it != m_index.end())
+        {
+            Event& queued = m_events[it.value()];
+            if (queued.value != 0 && value != 0)
+            {
+                /* Keep the oldest timestamp */
+                queued.value = value;
+                return;
+            }
+        }
+
+        /* The receiver takes everything that has been queued until then */
+        if (m_events.isEmpty() == true)
+            QCoreApplication::postEvent(m_receiver, new QEvent(eventType()));
+
+        Event event;
+        event.device = device;
+        event.channel = channel;
+        event.value = value;
+        event.timestamp = timestamp;
+
+        m_index[key] = m_events.size();
+        m_events.append(event);
+    }
+
+    /**
+     * Take all queued values in the order that they were queued.
+     *
+     * @return The queued values
+     */
+    QVector <Event> take()
+    {
+        QMutexLocker locker(&m_mutex);
+
+        QVector <Event> events(m_events);
+        m_events.clear();
+        m_index.clear();
+
+        return events;
+    }
+
+private:
+    Q_DISABLE_COPY(QLCInputQueue)
+
+    QObject* m_receiver;
+
+    /** Queued values, in the order they were queued */
+    QVector <Event> m_events;
+
+    /** Index of each device & channel's latest value in m_events */
+    QHash <QPair <QObject*, quint32>, int> m_index;
+
+    QMutex m_mutex;
+};
+
+#endif
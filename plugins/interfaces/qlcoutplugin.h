@@ -66,9 +66,9 @@
  * should provide information concerning ONLY that particular output line.
  * This info is displayed to the user as-is.
  *
- * DMX data is written by QLC to plugins with writeData(). Complete 512-channel
- * universes are written at a time. Traffic from output plugins towards QLC is
- * not possible.
+ * DMX data is written by QLC to plugins with outputDMX(). Complete 512-channel
+ * universes are written at a time, after which flushDMX() is called once.
+ * Traffic from output plugins towards QLC is not possible.
  */
 class QLCOutPlugin : public QObject
 {
@@ -147,6 +147,15 @@ public:
      */
     virtual void outputDMX(quint32 output, const QByteArray& universe) = 0;
 
+    /**
+     * Tell that all universes that had new values at this time have now
+     * been written with outputDMX(). Plugins that can send several universes
+     * at once may collect universes in outputDMX() and send them here in
+     * one go. outputDMX() and flushDMX() are never called concurrently.
+     * The default implementation does nothing.
+     */
+    virtual void flushDMX() { /* NOP */ }
+
     /**
      * Provide an information text to be displayed in the output manager.
      * If @output is KOutputInvalid, the info text contains info regarding
@@ -193,6 +202,8 @@ signals:
     void configurationChanged();
 };
 
-Q_DECLARE_INTERFACE(QLCOutPlugin, "QLCOutPlugin")
+/* Bump the version whenever the virtual methods change, so that plugins
+   built against an older interface are rejected instead of loaded. */
+Q_DECLARE_INTERFACE(QLCOutPlugin, "QLCOutPlugin/2")
 
 #endif
@@ -0,0 +1,236 @@
+/*
+  Q Light Controller
+  qlcoutputwriter.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef QLCOUTPUTWRITER_H
+#define QLCOUTPUTWRITER_H
+
+#include <QMutexLocker>
+#include <QByteArray>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QThread>
+#include <QMutex>
+
+#include "qlctriplebuffer.h"
+#include "qlcclock.h"
+
+/** Default size of the frames written with QLCOutputWriter */
+#define KOutputWriterFrameSize 512
+
+/**
+ * QLCOutputWriter takes blocking device transfers off the output path. An
+ * output plugin's device inherits QLCOutputWriter and implements transfer(),
+ * which is then called from a writer thread of the device's own. The
+ * plugin's outputDMX() just post()s the universe, which never waits for the
+ * device.
+ *
+ * Only one transfer is in flight at a time and at most one frame waits for
+ * it to finish. If a newer frame is posted while one is already waiting,
+ * the waiting frame is skipped, so a slow or stalled device always gets
+ * the newest values when it recovers, instead of a backlog of old ones.
+ *
+ * Transfer times, failures and skipped frames are counted, so that the
+ * device can report them in its info text.
+ */
+class QLCOutputWriter : public QThread
+{
+public:
+    /**
+     * Create a new output writer
+     *
+     * @param parent The owner of this object
+     * @param frameSize The usual size of the frames to write
+     */
+    QLCOutputWriter(QObject* parent, int frameSize = KOutputWriterFrameSize)
+        : QThread(parent)
+        , m_frames(frameSize)
+        , m_running(false)
+        , m_skipped(0)
+        , m_transfers(0)
+        , m_failures(0)
+        , m_failing(false)
+        , m_totalTime(0)
+        , m_maxTime(0)
+    {
+    }
+
+    /**
+     * Destructor. Inheriting classes must call stopWriter() in their own
+     * destructor at the latest, since transfer() can't be called anymore
+     * when this destructor runs.
+     */
+    virtual ~QLCOutputWriter()
+    {
+        Q_ASSERT(isRunning() == false);
+    }
+
+    /*********************************************************************
+     * Writer thread
+     *********************************************************************/
+public:
+    /** Start the writer thread, if it isn't running already */
+    void startWriter()
+    {
+        if (isRunning() == true)
+            return;
+
+        m_running = true;
+        start(QThread::TimeCriticalPriority);
+    }
+
+    /**
+     * Stop the writer thread and wait until the current transfer, if any,
+     * has finished. Frames that haven't been written yet are discarded.
+     */
+    void stopWriter()
+    {
+        if (isRunning() == false)
+            return;
+
+        m_running = false;
+        m_wakeup.release();
+        wait();
+    }
+
+    /**
+     * Post a frame to be written by the writer thread. Never blocks. Must
+     * be called from one thread only (the plugin's output thread).
+     *
+     * @param frame The frame to write
+     */
+    void post(const QByteArray& frame)
+    {
+        if (m_frames.write(frame) == false)
+            m_skipped.ref();
+        m_wakeup.release();
+    }
+
+protected:
+    /**
+     * Write one frame to the device. Called only from the writer thread, so
+     * it may block as long as the device needs.
+     *
+     * @param frame The frame to write
+     * @return true if the frame was written successfully, otherwise false
+     */
+    virtual bool transfer(const QByteArray& frame) = 0;
+
+    /** @reimp */
+    void run()
+    {
+        while (m_running == true)
+        {
+            /* Wake up for each posted frame. Posts that arrived during the
+               previous transfer are handled all at once, since only the
+               newest frame is kept anyway. */
+            if (m_wakeup.tryAcquire(1, 100) == false)
+                continue;
+            m_wakeup.tryAcquire(m_wakeup.available());
+
+            if (m_running == false || m_frames.read() == false)
+                continue;
+
+            qint64 start = QLCClock::monotonicTime();
+            bool ok = transfer(m_frames.front());
+            qint64 time = QLCClock::monotonicTime() - start;
+
+            QMutexLocker locker(&m_statisticsMutex);
+            m_transfers++;
+            m_totalTime += time;
+            m_maxTime = qMax(m_maxTime, time);
+            if (ok == false)
+                m_failures++;
+            m_failing = !ok;
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(QLCOutputWriter)
+
+    QLCTripleBuffer m_frames;
+    QSemaphore m_wakeup;
+    volatile bool m_running;
+
+    /*********************************************************************
+     * Statistics
+     *********************************************************************/
+public:
+    /** Get the number of frames skipped because the device was busy */
+    quint32 skippedFrames() const
+    {
+        return quint32(int(m_skipped));
+    }
+
+    /** Get the number of transfers attempted, including failed ones */
+    quint64 transfers() const
+    {
+        QMutexLocker locker(&m_statisticsMutex);
+        return m_transfers;
+    }
+
+    /** Get the number of failed transfers */
+    quint64 failures() const
+    {
+        QMutexLocker locker(&m_statisticsMutex);
+        return m_failures;
+    }
+
+    /**
+     * Check, whether the latest transfer failed. Can be used in transfer()
+     * to warn only about the first failure in a row.
+     */
+    bool isFailing() const
+    {
+        QMutexLocker locker(&m_statisticsMutex);
+        return m_failing;
+    }
+
+    /** Get the average transfer time in nanoseconds */
+    qint64 averageTransferTime() const
+    {
+        QMutexLocker locker(&m_statisticsMutex);
+        if (m_transfers == 0)
+            return 0;
+        else
+            return m_totalTime / qint64(m_transfers);
+    }
+
+    /** Get the longest transfer time in nanoseconds */
+    qint64 maxTransferTime() const
+    {
+        QMutexLocker locker(&m_statisticsMutex);
+        return m_maxTime;
+    }
+
+private:
+    QAtomicInt m_skipped;
+
+    quint64 m_transfers;
+    quint64 m_failures;
+    bool m_failing;
+    qint64 m_totalTime;
+    qint64 m_maxTime;
+
+    /** Guards all statistics except m_skipped */
+    mutable QMutex m_statisticsMutex;
+};
+
+#endif
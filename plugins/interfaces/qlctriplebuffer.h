@@ -0,0 +1,144 @@
+/*
+  Q Light Controller
+  qlctriplebuffer.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef QLCTRIPLEBUFFER_H
+#define QLCTRIPLEBUFFER_H
+
+#include <QByteArray>
+#include <QAtomicInt>
+
+#include <string.h>
+
+#define KTripleBufferIndexMask 0x3
+#define KTripleBufferFresh     0x4
+
+/**
+ * QLCTripleBuffer hands frames over from exactly one producer thread to
+ * exactly one consumer thread without locking. The producer always has a
+ * buffer of its own to write to and the consumer always has a buffer of its
+ * own to read from. The third buffer sits in the middle, holding the newest
+ * published frame until either side swaps it for their own.
+ *
+ * Neither side ever waits for the other. If the producer publishes faster
+ * than the consumer reads, older unread frames are simply overwritten.
+ *
+ * The class is header-only, so that both the engine and plugins can use it.
+ */
+class QLCTripleBuffer
+{
+public:
+    /** Create a new QLCTripleBuffer whose buffers are $size bytes each */
+    QLCTripleBuffer(int size)
+        : m_back(0)
+        , m_middle(1)
+        , m_front(2)
+    {
+        for (int i = 0; i < 3; i++)
+            m_buffers[i] = QByteArray(size, char(0));
+    }
+
+    /** Destructor */
+    ~QLCTripleBuffer()
+    {
+    }
+
+private:
+    Q_DISABLE_COPY(QLCTripleBuffer)
+
+    /************************************************************************
+     * Producer
+     ************************************************************************/
+public:
+    /**
+     * Copy $frame to the producer's buffer and publish it as the newest
+     * frame. Must be called only from the producer thread.
+     *
+     * @param frame The frame to publish
+     * @return false if an unread frame was dropped, otherwise true
+     */
+    bool write(const QByteArray& frame)
+    {
+        /* The back buffer belongs to the producer alone. If the consumer has
+           kept a shallow copy of it, data() detaches and the copy stays
+           intact. */
+        QByteArray& back = m_buffers[m_back];
+        if (back.size() != frame.size())
+            back.resize(frame.size());
+        memcpy(back.data(), frame.constData(), frame.size());
+
+        /* Publish the back buffer and take whatever was in the middle */
+        int previous = m_middle.fetchAndStoreOrdered(m_back |
+                                                     KTripleBufferFresh);
+        m_back = previous & KTripleBufferIndexMask;
+
+        return ((previous & KTripleBufferFresh) == 0);
+    }
+
+    /************************************************************************
+     * Consumer
+     ************************************************************************/
+public:
+    /**
+     * Take the newest published frame into the consumer's use, if there is
+     * one that hasn't been read yet. Must be called only from the consumer
+     * thread.
+     *
+     * @return true if a new frame is available thru front(), otherwise false
+     */
+    bool read()
+    {
+        /* Nothing new since the last read. Only the producer can set the
+           flag, so it's safe to check it without swapping. */
+        if ((int(m_middle) & KTripleBufferFresh) == 0)
+            return false;
+
+        /* Take the newest frame and hand the old front buffer back */
+        int previous = m_middle.fetchAndStoreOrdered(m_front);
+        m_front = previous & KTripleBufferIndexMask;
+
+        return true;
+    }
+
+    /**
+     * Get the frame most recently taken with read(). The returned buffer
+     * stays intact until the next call to read().
+     */
+    const QByteArray& front() const
+    {
+        return m_buffers[m_front];
+    }
+
+private:
+    /** The three buffers that change hands between producer and consumer */
+    QByteArray m_buffers[3];
+
+    /** Index of the producer's buffer */
+    int m_back;
+
+    /** Index of the middle buffer, with an additional "fresh" bit set when the
+        middle buffer contains a frame that hasn't been read yet */
+    QAtomicInt m_middle;
+
+    /** Index of the consumer's buffer */
+    int m_front;
+};
+
+#endif
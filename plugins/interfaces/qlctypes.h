@@ -106,10 +106,15 @@ const t_function_id KFunctionArraySize ( 4096 );
  *****************************************************************************/
 
 /**
- * Number of supported universes
+ * Default number of universes in a new workspace
  */
 const quint32 KUniverseCount ( 4 );
 
+/**
+ * Maximum number of universes that a workspace can grow to
+ */
+const quint32 KUniverseCountMax ( 64 );
+
 /*****************************************************************************
  * Output lines
  *****************************************************************************/
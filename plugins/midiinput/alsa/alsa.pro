@@ -16,7 +16,6 @@ FORMS += ../common/src/configuremidiinput.ui \
 
 HEADERS += ../common/src/configuremidiinput.h \
            ../common/src/configuremidiline.h \
-           ../common/src/midiinputevent.h \
            ../common/src/midiprotocol.h \
            mididevice.h \
            midiinput.h \
@@ -24,7 +23,6 @@ HEADERS += ../common/src/configuremidiinput.h \
 
 SOURCES += ../common/src/configuremidiinput.cpp \
            ../common/src/configuremidiline.cpp \
-           ../common/src/midiinputevent.cpp \
            ../common/src/midiprotocol.cpp \
            mididevice.cpp \
            midiinput.cpp \
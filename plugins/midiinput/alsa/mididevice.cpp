@@ -25,7 +25,6 @@
 #include <QDebug>
 #include <QFile>
 
-#include "midiinputevent.h"
 #include "midiprotocol.h"
 #include "mididevice.h"
 #include "midiinput.h"
@@ -28,7 +28,6 @@
 #include <QDir>
 
 #include "configuremidiinput.h"
-#include "midiinputevent.h"
 #include "mididevice.h"
 #include "midipoller.h"
 #include "midiinput.h"
@@ -42,6 +41,9 @@ MIDIInput::~MIDIInput()
     /* Delete the poller. Removes the devices also from the hash table. */
     delete m_poller;
 
+    /* Values that are still in the queue go nowhere */
+    delete m_inputQueue;
+
     /* Delete all MIDI devices. */
     while (m_devices.isEmpty() == false)
         delete m_devices.takeFirst();
@@ -57,7 +59,9 @@ void MIDIInput::init()
     m_alsa = NULL;
     m_address = NULL;
 
-    /* Create the poller thread */
+    /* Create the poller thread and a queue for the values it reads */
+    m_inputQueue = new QLCInputQueue(this);
+    m_valueTimestamp = 0;
     m_poller = new MIDIPoller(this);
 
     /* Initialize ALSA stuff */
@@ -345,20 +349,31 @@ void MIDIInput::removeDevice(MIDIDevice* device)
     emit configurationChanged();
 }
 
+qint64 MIDIInput::valueTimestamp()
+{
+    return m_valueTimestamp;
+}
+
 void MIDIInput::customEvent(QEvent* event)
 {
-    if (event->type() == MIDIInputEvent::eventType)
+    if (event->type() == QLCInputQueue::eventType())
     {
-        MIDIInputEvent* e = static_cast<MIDIInputEvent*> (event);
-        if (e == NULL)
-            return;
-
-        int index = m_devices.indexOf(e->m_device);
-        if (index != -1)
+        QVector <QLCInputQueue::Event> events(m_inputQueue->take());
+        for (int i = 0; i < events.size(); i++)
         {
-            emit valueChanged(quint32(index), e->m_channel, e->m_value);
-            event->accept();
+            const QLCInputQueue::Event& e = events.at(i);
+
+            /* The device may have been removed since its value was queued */
+            int index = m_devices.indexOf(static_cast<MIDIDevice*> (e.device));
+            if (index != -1)
+            {
+                m_valueTimestamp = e.timestamp;
+                emit valueChanged(quint32(index), e.channel, e.value);
+            }
         }
+
+        m_valueTimestamp = 0;
+        event->accept();
     }
 }
 
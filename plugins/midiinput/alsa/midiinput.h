@@ -29,11 +29,11 @@
 
 #include <alsa/asoundlib.h>
 
+#include "qlcinputqueue.h"
 #include "qlcinplugin.h"
 #include "qlctypes.h"
 
 class ConfigureMIDIInput;
-class MIDIInputEvent;
 class MIDIPoller;
 class MIDIDevice;
 class MIDIInput;
@@ -83,9 +83,20 @@ public:
     /** @reimp */
     QString infoText(quint32 input = KInputInvalid);
 
+    /** @reimp */
+    qint64 valueTimestamp();
+
 protected:
+    /** Emit values that the poller thread has queued */
     void customEvent(QEvent* event);
 
+protected:
+    /** Values from the poller thread, waiting to be emitted */
+    QLCInputQueue* m_inputQueue;
+
+    /** Timestamp of the value that is being emitted */
+    qint64 m_valueTimestamp;
+
     /*********************************************************************
      * Configuration
      *********************************************************************/
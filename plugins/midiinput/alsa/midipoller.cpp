@@ -19,12 +19,10 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
-#include <QApplication>
-#include <QEvent>
 #include <QDebug>
 #include <poll.h>
 
-#include "midiinputevent.h"
+#include "qlcinputqueue.h"
 #include "midiprotocol.h"
 #include "midipoller.h"
 #include "mididevice.h"
@@ -290,8 +288,9 @@ void MIDIPoller::readEvent(snd_seq_t* alsa)
         if (QLCMIDIProtocol::midiToInput(cmd, data1, data2, device->midiChannel(),
                                          &channel, &value) == true)
         {
-            MIDIInputEvent* event = new MIDIInputEvent(device, channel, value);
-            QApplication::postEvent(parent(), event);
+            /* Queue the value for the plugin in the main thread */
+            static_cast<MIDIInput*> (parent())->m_inputQueue->enqueue(
+                device, channel, value);
         }
     } while (snd_seq_event_input_pending(alsa, 0) > 0);
 
@@ -9,6 +9,7 @@ INCLUDEPATH += ../common
 INCLUDEPATH += ../../interfaces
 DEPENDPATH  += ../common
 CONFIG      += plugin link_pkgconfig
+LIBS        += -lrt
 PKGCONFIG   += alsa
 
 FORMS += ../common/configuremididevice.ui \
@@ -16,15 +17,19 @@ FORMS += ../common/configuremididevice.ui \
 
 HEADERS += ../common/configuremididevice.h \
            ../common/configuremidiout.h \
+           ../common/midischeduler.h \
            mididevice.h \
            midiout.h
 
 SOURCES += ../common/configuremididevice.cpp \
            ../common/configuremidiout.cpp \
+           ../common/midischeduler.cpp \
            mididevice.cpp \
            midiout.cpp
 
-HEADERS += ../../interfaces/qlcoutplugin.h
+HEADERS += ../../interfaces/qlcoutplugin.h \
+           ../../interfaces/qlctriplebuffer.h \
+           ../../interfaces/qlcclock.h
 
 PRO_FILE = alsa.pro
 TRANSLATIONS += MIDI_Output_fi_FI.ts
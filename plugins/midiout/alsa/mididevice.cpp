@@ -19,6 +19,7 @@
   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <QMutexLocker>
 #include <QSettings>
 #include <QObject>
 #include <QString>
@@ -29,18 +30,20 @@
 
 #include "midiprotocol.h"
 #include "mididevice.h"
+#include "qlcclock.h"
 #include "midiout.h"
 
 MIDIDevice::MIDIDevice(MIDIOut* parent, const snd_seq_addr_t* address)
-        : QObject(parent)
+        : QThread(parent)
+        , m_running(false)
+        , m_frames(512)
+        , m_scheduler(MAX_MIDI_DMX_CHANNELS)
 {
     Q_ASSERT(address != NULL);
     m_address = NULL;
     m_mode = ControlChange;
     m_midiChannel = 0;
 
-    std::fill(m_values, m_values + MAX_MIDI_DMX_CHANNELS, 0);
-
     setAddress(address);
     extractName();
     loadSettings();
@@ -48,6 +51,7 @@ MIDIDevice::MIDIDevice(MIDIOut* parent, const snd_seq_addr_t* address)
 
 MIDIDevice::~MIDIDevice()
 {
+    close();
     saveSettings();
     delete m_address;
     m_address = NULL;
@@ -135,6 +139,19 @@ QString MIDIDevice::infoText()
         info += tr("Mode: %1").arg(modeToString(m_mode));
         info += QString("</B>");
         info += QString("</P>");
+
+        m_schedulerMutex.lock();
+        info += QString("<P>");
+        info += tr("Values sent: %1").arg(m_scheduler.updates());
+        info += QString("<BR>");
+        info += tr("Update latency: %1ms average, %2ms maximum")
+                .arg(double(m_scheduler.averageLatency()) / 1000000.0, 0, 'f', 1)
+                .arg(double(m_scheduler.maxLatency()) / 1000000.0, 0, 'f', 1);
+        info += QString("<BR>");
+        info += tr("Worst case latency: %1ms")
+                .arg(double(m_scheduler.latencyBound()) / 1000000.0, 0, 'f', 1);
+        info += QString("</P>");
+        m_schedulerMutex.unlock();
     }
     else
     {
@@ -203,7 +220,83 @@ MIDIDevice::Mode MIDIDevice::stringToMode(const QString& mode)
  * Write
  ****************************************************************************/
 
+void MIDIDevice::open()
+{
+    if (isRunning() == true)
+        return;
+
+    /* The device may have been used by someone else in the meantime, so
+       send all values again */
+    m_schedulerMutex.lock();
+    m_scheduler.reset(QLCClock::monotonicTime());
+    m_schedulerMutex.unlock();
+
+    m_running = true;
+    start(QThread::TimeCriticalPriority);
+}
+
+void MIDIDevice::close()
+{
+    if (isRunning() == false)
+        return;
+
+    m_running = false;
+    m_wakeup.release();
+    wait();
+}
+
 void MIDIDevice::outputDMX(const QByteArray& universe)
+{
+    m_frames.write(universe);
+    m_wakeup.release();
+}
+
+void MIDIDevice::run()
+{
+    while (m_running == true)
+    {
+        /* When there's nothing left to send, wait for new values.
+           Otherwise wait until the link can take the next message. */
+        m_schedulerMutex.lock();
+        bool pending = m_scheduler.hasPending();
+        qint64 next = m_scheduler.nextSendTime();
+        m_schedulerMutex.unlock();
+
+        if (pending == false)
+            m_wakeup.tryAcquire(1, 100);
+        else
+            QLCClock::sleepUntil(next);
+        m_wakeup.tryAcquire(m_wakeup.available());
+
+        if (m_running == false)
+            break;
+
+        qint64 now = QLCClock::monotonicTime();
+
+        m_schedulerMutex.lock();
+        if (m_frames.read() == true)
+        {
+            /* Since MIDI devices can have only 128 real channels, we
+               don't attempt to write more than that */
+            const QByteArray& universe(m_frames.front());
+            int channels = MIN(universe.size(), MAX_MIDI_DMX_CHANNELS);
+            for (int channel = 0; channel < channels; channel++)
+            {
+                /* Scale 0-255 to 0-127 */
+                m_scheduler.setValue(channel, DMX2MIDI(universe[channel]),
+                                     now);
+            }
+        }
+
+        QVector <MIDIScheduler::Update> updates(m_scheduler.take(now));
+        m_schedulerMutex.unlock();
+
+        if (updates.isEmpty() == false)
+            sendUpdates(updates);
+    }
+}
+
+void MIDIDevice::sendUpdates(const QVector <MIDIScheduler::Update>& updates)
 {
     MIDIOut* plugin = static_cast<MIDIOut*> (parent());
     Q_ASSERT(plugin != NULL);
@@ -217,47 +310,36 @@ void MIDIDevice::outputDMX(const QByteArray& universe)
     snd_seq_ev_set_subs(&ev);
     snd_seq_ev_set_direct(&ev);
 
-    /* Since MIDI devices can have only 128 real channels, we don't
-       attempt to write more than that */
+    /* All devices share the plugin's sequencer handle */
+    QMutexLocker locker(plugin->alsaMutex());
 
-    for (unsigned char channel = 0; channel < MAX_MIDI_DMX_CHANNELS;
-            channel++)
+    QVectorIterator <MIDIScheduler::Update> it(updates);
+    while (it.hasNext() == true)
     {
-        /* Scale 0-255 to 0-127 */
-        char scaled = DMX2MIDI(universe[channel]);
-
-        /* Since MIDI is so slow, we only send values that are
-           	   actually changed. */
-        if (m_values[channel] == scaled)
-            continue;
-
-        /* Store the changed MIDI value */
-        m_values[channel] = scaled;
+        const MIDIScheduler::Update& update(it.next());
+        uchar channel = uchar(update.channel);
+        char value = char(update.value);
 
         if (mode() == Note)
         {
-            if (scaled == 0)
+            if (value == 0)
             {
                 /* 0 is sent as a note off command */
-                snd_seq_ev_set_noteoff(&ev, midiChannel(),
-                                       channel, scaled);
+                snd_seq_ev_set_noteoff(&ev, midiChannel(), channel, value);
             }
             else
             {
                 /* 1-127 is sent as note on command */
-                snd_seq_ev_set_noteon(&ev, midiChannel(),
-                                      channel, scaled);
+                snd_seq_ev_set_noteon(&ev, midiChannel(), channel, value);
             }
-
-            snd_seq_event_output(plugin->alsa(), &ev);
         }
         else
         {
             /* Control change */
-            snd_seq_ev_set_controller(&ev, midiChannel(),
-                                      channel, scaled);
-            snd_seq_event_output_buffer(plugin->alsa(), &ev);
+            snd_seq_ev_set_controller(&ev, midiChannel(), channel, value);
         }
+
+        snd_seq_event_output_buffer(plugin->alsa(), &ev);
     }
 
     /* Make sure that all values go to the MIDI endpoint */
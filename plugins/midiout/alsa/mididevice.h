@@ -22,11 +22,16 @@
 #ifndef MIDIDEVICE_H
 #define MIDIDEVICE_H
 
+#include <QSemaphore>
 #include <QObject>
+#include <QThread>
+#include <QMutex>
 #include <QFile>
 
 #include <alsa/asoundlib.h>
 
+#include "qlctriplebuffer.h"
+#include "midischeduler.h"
 #include "qlctypes.h"
 
 class MIDIDevice;
@@ -39,7 +44,7 @@ class QString;
  * MIDIDevice
  *****************************************************************************/
 
-class MIDIDevice : public QObject
+class MIDIDevice : public QThread
 {
     Q_OBJECT
 
@@ -140,15 +145,43 @@ protected:
      * Write
      ********************************************************************/
 public:
-    /** Write the given values to MIDI output */
+    /** Start sending values to the device */
+    void open();
+
+    /** Stop sending values to the device */
+    void close();
+
+    /**
+     * Hand the given values over to the device's output thread. Never
+     * blocks, no matter how far behind the MIDI link is.
+     */
     void outputDMX(const QByteArray& universe);
 
 protected:
     /**
-     * Cache values since MIDI is so slow that we need to send only those
-     * channels that have actually changed.
+     * Output thread worker method. Sends the values picked by the scheduler
+     * at the pace that the MIDI link can carry them.
+     */
+    void run();
+
+    /** Send the given values to the device thru ALSA */
+    void sendUpdates(const QVector <MIDIScheduler::Update>& updates);
+
+protected:
+    volatile bool m_running;
+
+    /** Universes from outputDMX(), picked up by the output thread */
+    QLCTripleBuffer m_frames;
+    QSemaphore m_wakeup;
+
+    /**
+     * Decides which values to send and when, since MIDI is so slow that
+     * it can't carry more than a few changed channels per DMX frame.
      */
-    uchar m_values[MAX_MIDI_DMX_CHANNELS];
+    MIDIScheduler m_scheduler;
+
+    /** Guards m_scheduler, which infoText() reads from another thread */
+    QMutex m_schedulerMutex;
 };
 
 #endif
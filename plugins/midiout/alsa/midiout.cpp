@@ -92,7 +92,10 @@ void MIDIOut::open(quint32 output)
 {
     MIDIDevice* dev = device(output);
     if (dev != NULL)
+    {
         subscribeDevice(dev);
+        dev->open();
+    }
     else
         qDebug() << name() << "has no output number:" << output;
 }
@@ -101,7 +104,10 @@ void MIDIOut::close(quint32 output)
 {
     MIDIDevice* dev = device(output);
     if (dev != NULL)
+    {
+        dev->close();
         unsubscribeDevice(dev);
+    }
     else
         qDebug() << name() << "has no output number:" << output;
 }
@@ -24,6 +24,7 @@
 
 #include <QStringList>
 #include <QtPlugin>
+#include <QMutex>
 #include <QList>
 
 #include <alsa/asoundlib.h>
@@ -113,10 +114,21 @@ public:
         return m_address;
     }
 
+    /**
+     * Get the mutex that devices must hold while writing events thru
+     * alsa(), since each device writes from a thread of its own.
+     */
+    QMutex* alsaMutex() {
+        return &m_alsaMutex;
+    }
+
 protected:
     /** The plugin's ALSA sequencer interface handle */
     snd_seq_t* m_alsa;
 
+    /** Serializes event output from device threads */
+    QMutex m_alsaMutex;
+
     /** This sequencer client's port address */
     snd_seq_addr_t* m_address;
 
@@ -0,0 +1,251 @@
+/*
+  Q Light Controller
+  midischeduler.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtGlobal>
+
+#include "midischeduler.h"
+
+/** Priority bonus for each step of change, in nanoseconds of waiting */
+#define KMIDIDeltaWeight Q_INT64_C(500000)
+
+/** The largest possible change of a 7-bit value */
+#define KMIDIMaxDelta 127
+
+/** Messages are handed out at most this many nanoseconds in advance */
+#define KMIDILookahead Q_INT64_C(5000000)
+
+/****************************************************************************
+ * Initialization
+ ****************************************************************************/
+
+MIDIScheduler::MIDIScheduler(int channels, int bytesPerSecond)
+    : m_bytesPerSecond(bytesPerSecond)
+    , m_runningStatus(false)
+    , m_statusSent(false)
+    , m_linkFree(0)
+    , m_channels(channels)
+    , m_pending(0)
+    , m_updates(0)
+    , m_totalLatency(0)
+    , m_maxLatency(0)
+{
+    Q_ASSERT(channels > 0);
+    Q_ASSERT(bytesPerSecond > 0);
+
+    for (int i = 0; i < m_channels.size(); i++)
+    {
+        Channel& ch(m_channels[i]);
+        ch.sent = 0;
+        ch.value = 0;
+        ch.pending = false;
+        ch.since = 0;
+    }
+}
+
+MIDIScheduler::~MIDIScheduler()
+{
+}
+
+int MIDIScheduler::channels() const
+{
+    return m_channels.size();
+}
+
+void MIDIScheduler::reset(qint64 now)
+{
+    m_pending = 0;
+    for (int i = 0; i < m_channels.size(); i++)
+    {
+        Channel& ch(m_channels[i]);
+        ch.sent = 0;
+        ch.pending = (ch.value != 0);
+        ch.since = now;
+        if (ch.pending == true)
+            m_pending++;
+    }
+
+    m_statusSent = false;
+}
+
+/****************************************************************************
+ * Link
+ ****************************************************************************/
+
+void MIDIScheduler::setRunningStatus(bool enable)
+{
+    m_runningStatus = enable;
+}
+
+bool MIDIScheduler::runningStatus() const
+{
+    return m_runningStatus;
+}
+
+qint64 MIDIScheduler::messageTime() const
+{
+    int bytes = (m_runningStatus == true) ? 2 : 3;
+    return (qint64(bytes) * Q_INT64_C(1000000000)) / m_bytesPerSecond;
+}
+
+qint64 MIDIScheduler::latencyBound() const
+{
+    /* Once a channel has waited longer than the biggest possible bonus,
+       only channels that have waited even longer can go before it, and
+       each of them only once. */
+    qint64 bonus = KMIDIDeltaWeight * KMIDIMaxDelta;
+    qint64 others = qint64(m_channels.size()) * messageTime();
+    return bonus + others + KMIDILookahead + messageTime();
+}
+
+qint64 MIDIScheduler::lookahead()
+{
+    return KMIDILookahead;
+}
+
+/****************************************************************************
+ * Scheduling
+ ****************************************************************************/
+
+void MIDIScheduler::setValue(int channel, uchar value, qint64 now)
+{
+    if (channel < 0 || channel >= m_channels.size())
+        return;
+
+    Channel& ch(m_channels[channel]);
+    ch.value = value;
+
+    if (ch.value == ch.sent)
+    {
+        /* Back to where it was, nothing to send */
+        if (ch.pending == true)
+        {
+            ch.pending = false;
+            m_pending--;
+        }
+    }
+    else if (ch.pending == false)
+    {
+        /* Intermediate values just replace the pending one, so the time
+           keeps counting from the first change */
+        ch.pending = true;
+        ch.since = now;
+        m_pending++;
+    }
+}
+
+bool MIDIScheduler::hasPending() const
+{
+    return (m_pending > 0);
+}
+
+qint64 MIDIScheduler::priority(const Channel& channel, qint64 now) const
+{
+    int delta = qAbs(int(channel.value) - int(channel.sent));
+    return (now - channel.since) + (qint64(delta) * KMIDIDeltaWeight);
+}
+
+QVector <MIDIScheduler::Update> MIDIScheduler::take(qint64 now)
+{
+    QVector <Update> updates;
+
+    /* The link has been idle */
+    if (m_linkFree < now)
+        m_linkFree = now;
+
+    while (m_pending > 0 && m_linkFree <= now + KMIDILookahead)
+    {
+        /* Find the most urgent channel. There are only 128 of them, so a
+           linear search costs less than keeping them in order. */
+        int best = -1;
+        qint64 bestPriority = 0;
+        for (int i = 0; i < m_channels.size(); i++)
+        {
+            const Channel& ch(m_channels[i]);
+            if (ch.pending == false)
+                continue;
+
+            qint64 p = priority(ch, now);
+            if (best == -1 || p > bestPriority)
+            {
+                best = i;
+                bestPriority = p;
+            }
+        }
+
+        Q_ASSERT(best != -1);
+        Channel& ch(m_channels[best]);
+        ch.sent = ch.value;
+        ch.pending = false;
+        m_pending--;
+
+        /* The first message always carries a status byte */
+        int bytes = (m_runningStatus == true && m_statusSent == true) ? 2 : 3;
+        m_statusSent = true;
+        m_linkFree += (qint64(bytes) * Q_INT64_C(1000000000)) / m_bytesPerSecond;
+
+        /* Latency lasts until the message has gone thru the link */
+        qint64 latency = m_linkFree - ch.since;
+        m_updates++;
+        m_totalLatency += latency;
+        m_maxLatency = qMax(m_maxLatency, latency);
+
+        Update update;
+        update.channel = best;
+        update.value = ch.value;
+        updates.append(update);
+    }
+
+    return updates;
+}
+
+qint64 MIDIScheduler::nextSendTime() const
+{
+    return m_linkFree - KMIDILookahead;
+}
+
+/****************************************************************************
+ * Statistics
+ ****************************************************************************/
+
+quint64 MIDIScheduler::updates() const
+{
+    return m_updates;
+}
+
+qint64 MIDIScheduler::averageLatency() const
+{
+    if (m_updates == 0)
+        return 0;
+    else
+        return m_totalLatency / qint64(m_updates);
+}
+
+qint64 MIDIScheduler::maxLatency() const
+{
+    return m_maxLatency;
+}
+
+void MIDIScheduler::resetStatistics()
+{
+    m_updates = 0;
+    m_totalLatency = 0;
+    m_maxLatency = 0;
+}
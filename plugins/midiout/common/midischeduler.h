@@ -0,0 +1,205 @@
+/*
+  Q Light Controller
+  midischeduler.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef MIDISCHEDULER_H
+#define MIDISCHEDULER_H
+
+#include <QVector>
+
+/** A MIDI cable carries 31250 bits per second, 10 bits per byte */
+#define MIDI_BYTES_PER_SECOND 3125
+
+/**
+ * MIDIScheduler decides which channel values a MIDI output device sends
+ * and when, so that the output never exceeds the bandwidth of a MIDI cable.
+ *
+ * New values are given with setValue(). A channel whose value differs from
+ * the value last sent becomes pending; further changes just replace the
+ * pending value, so intermediate values of a fade are never queued. take()
+ * returns the pending channels that fit on the cable right now. They are
+ * picked in order of priority, which is the time the channel has waited
+ * plus a bonus that grows with the size of the change. Big changes go out
+ * first, but no channel can be passed over for longer than latencyBound().
+ *
+ * Only a few milliseconds worth of messages are handed out ahead of time,
+ * so values that change meanwhile aren't stuck behind a long queue.
+ *
+ * All times are QLCClock::monotonicTime() nanoseconds.
+ */
+class MIDIScheduler
+{
+    /********************************************************************
+     * Initialization
+     ********************************************************************/
+public:
+    /**
+     * Create a new scheduler
+     *
+     * @param channels The number of channels to schedule
+     * @param bytesPerSecond The bandwidth of the MIDI link
+     */
+    MIDIScheduler(int channels, int bytesPerSecond = MIDI_BYTES_PER_SECOND);
+    ~MIDIScheduler();
+
+    /** Get the number of scheduled channels */
+    int channels() const;
+
+    /**
+     * Forget the values that have been sent, so that all channels having
+     * a non-zero value are sent again. Statistics are kept.
+     *
+     * @param now The current time
+     */
+    void reset(qint64 now);
+
+private:
+    Q_DISABLE_COPY(MIDIScheduler)
+
+    /********************************************************************
+     * Link
+     ********************************************************************/
+public:
+    /**
+     * Tell whether the link uses running status, i.e. leaves out the status
+     * byte of a message that has the same status as the previous one. All
+     * messages sent thru a scheduler must then have the same status byte.
+     * Without running status, each message takes three bytes.
+     *
+     * @param enable true to count two bytes per message, false for three
+     */
+    void setRunningStatus(bool enable);
+
+    /** Check, whether the link is assumed to use running status */
+    bool runningStatus() const;
+
+    /** Get the time it takes to send one message over the link */
+    qint64 messageTime() const;
+
+    /**
+     * Get the longest time a channel can stay pending before its value
+     * has been sent over the link, assuming take() is called on time.
+     */
+    qint64 latencyBound() const;
+
+    /** Get the longest time that take() hands messages out in advance */
+    static qint64 lookahead();
+
+private:
+    /** Bytes per second that the link can carry */
+    int m_bytesPerSecond;
+
+    /** True if messages after the first one take two bytes, not three */
+    bool m_runningStatus;
+
+    /** True if a status byte has been sent since reset() */
+    bool m_statusSent;
+
+    /** The time when everything handed out by take() has been sent */
+    qint64 m_linkFree;
+
+    /********************************************************************
+     * Scheduling
+     ********************************************************************/
+public:
+    /** A channel value to send */
+    struct Update
+    {
+        int channel;
+        uchar value;
+    };
+
+    /**
+     * Set a new value for a channel.
+     *
+     * @param channel The channel to set
+     * @param value The channel's new value (0-127)
+     * @param now The current time
+     */
+    void setValue(int channel, uchar value, qint64 now);
+
+    /** Check, whether there are values that haven't been sent yet */
+    bool hasPending() const;
+
+    /**
+     * Take the channel values that should be sent now, most urgent first.
+     * The returned values are considered sent.
+     *
+     * @param now The current time
+     * @return Values to send, possibly none
+     */
+    QVector <Update> take(qint64 now);
+
+    /**
+     * Get the time when take() can hand out the next message. If nothing
+     * is pending, the link is idle from then on.
+     */
+    qint64 nextSendTime() const;
+
+private:
+    /** Scheduling state of one channel */
+    struct Channel
+    {
+        /** The value last handed out with take() */
+        uchar sent;
+
+        /** The newest value given with setValue() */
+        uchar value;
+
+        /** True if value differs from sent */
+        bool pending;
+
+        /** The time when the channel last became pending */
+        qint64 since;
+    };
+
+    /** Get the priority of a pending channel at the given time */
+    qint64 priority(const Channel& channel, qint64 now) const;
+
+private:
+    QVector <Channel> m_channels;
+    int m_pending;
+
+    /********************************************************************
+     * Statistics
+     ********************************************************************/
+public:
+    /** Get the number of values sent */
+    quint64 updates() const;
+
+    /**
+     * Get the average time from a channel becoming pending until its value
+     * has been sent over the link.
+     */
+    qint64 averageLatency() const;
+
+    /** Get the longest observed latency (see averageLatency()) */
+    qint64 maxLatency() const;
+
+    /** Reset the above statistics */
+    void resetStatistics();
+
+private:
+    quint64 m_updates;
+    qint64 m_totalLatency;
+    qint64 m_maxLatency;
+};
+
+#endif
@@ -0,0 +1,217 @@
+/*
+  Q Light Controller
+  midischeduler_test.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QtTest>
+
+#include "midischeduler_test.h"
+#include "midischeduler.h"
+
+#define MSEC Q_INT64_C(1000000)
+
+void MIDIScheduler_Test::initial()
+{
+    MIDIScheduler sch(128);
+    QCOMPARE(sch.channels(), 128);
+    QVERIFY(sch.runningStatus() == false);
+    QVERIFY(sch.hasPending() == false);
+    QCOMPARE(sch.take(0).size(), 0);
+    QCOMPARE(sch.updates(), quint64(0));
+    QCOMPARE(sch.averageLatency(), qint64(0));
+    QCOMPARE(sch.maxLatency(), qint64(0));
+
+    /* Three bytes at 3125 bytes per second */
+    QCOMPARE(sch.messageTime(), qint64(960000));
+}
+
+void MIDIScheduler_Test::merge()
+{
+    MIDIScheduler sch(128);
+
+    /* Only the newest value goes out */
+    sch.setValue(3, 10, 0);
+    sch.setValue(3, 20, 0);
+    sch.setValue(3, 30, 0);
+    QVERIFY(sch.hasPending() == true);
+
+    QVector <MIDIScheduler::Update> updates(sch.take(0));
+    QCOMPARE(updates.size(), 1);
+    QCOMPARE(updates[0].channel, 3);
+    QCOMPARE(int(updates[0].value), 30);
+    QVERIFY(sch.hasPending() == false);
+
+    /* Changing back to the sent value cancels the change */
+    sch.setValue(3, 40, 10 * MSEC);
+    QVERIFY(sch.hasPending() == true);
+    sch.setValue(3, 30, 10 * MSEC);
+    QVERIFY(sch.hasPending() == false);
+    QCOMPARE(sch.take(10 * MSEC).size(), 0);
+
+    /* Invalid channels are ignored */
+    sch.setValue(-1, 10, 20 * MSEC);
+    sch.setValue(128, 10, 20 * MSEC);
+    QVERIFY(sch.hasPending() == false);
+}
+
+void MIDIScheduler_Test::bandwidth()
+{
+    MIDIScheduler sch(128);
+
+    for (int i = 0; i < 128; i++)
+        sch.setValue(i, 100, 0);
+
+    /* Only a few messages are handed out at once */
+    QVector <MIDIScheduler::Update> updates(sch.take(0));
+    QVERIFY(updates.size() > 0);
+    QVERIFY(qint64(updates.size() - 1) * sch.messageTime()
+            <= MIDIScheduler::lookahead());
+    QCOMPARE(sch.take(0).size(), 0);
+    QVERIFY(sch.nextSendTime() > 0);
+
+    /* Send the rest at the pace the link allows */
+    int sent = updates.size();
+    qint64 now = 0;
+    while (sch.hasPending() == true)
+    {
+        now += MSEC;
+        sent += sch.take(now).size();
+    }
+
+    QCOMPARE(sent, 128);
+    QCOMPARE(sch.updates(), quint64(128));
+
+    /* 128 messages take 123ms on the cable, minus the lookahead */
+    qint64 cable = 128 * sch.messageTime();
+    QVERIFY(now >= cable - MIDIScheduler::lookahead() - MSEC);
+    QVERIFY(now <= cable);
+}
+
+void MIDIScheduler_Test::runningStatus()
+{
+    MIDIScheduler sch(128);
+    sch.setRunningStatus(true);
+    QVERIFY(sch.runningStatus() == true);
+    QCOMPARE(sch.messageTime(), qint64(640000));
+
+    for (int i = 0; i < 128; i++)
+        sch.setValue(i, 100, 0);
+
+    qint64 now = 0;
+    while (sch.hasPending() == true)
+    {
+        sch.take(now);
+        now += MSEC;
+    }
+
+    /* One three-byte message and 127 two-byte messages */
+    qint64 cable = 3 * 320000 + 127 * sch.messageTime();
+    QVERIFY(now >= cable - MIDIScheduler::lookahead());
+    QVERIFY(now <= cable + MSEC);
+}
+
+void MIDIScheduler_Test::bigChangesFirst()
+{
+    MIDIScheduler sch(128);
+
+    sch.setValue(1, 1, 0);
+    sch.setValue(2, 127, 0);
+    sch.setValue(3, 64, 0);
+
+    QVector <MIDIScheduler::Update> updates(sch.take(0));
+    QCOMPARE(updates.size(), 3);
+    QCOMPARE(updates[0].channel, 2);
+    QCOMPARE(updates[1].channel, 3);
+    QCOMPARE(updates[2].channel, 1);
+}
+
+void MIDIScheduler_Test::staleChannelsFirst()
+{
+    MIDIScheduler sch(128);
+
+    /* A small change that has waited for long enough... */
+    sch.setValue(1, 1, 0);
+
+    /* ...goes before a big but fresh one */
+    sch.setValue(2, 127, 70 * MSEC);
+
+    QVector <MIDIScheduler::Update> updates(sch.take(70 * MSEC));
+    QCOMPARE(updates.size(), 2);
+    QCOMPARE(updates[0].channel, 1);
+    QCOMPARE(updates[1].channel, 2);
+
+    /* With a shorter wait, the big change wins */
+    sch.setValue(1, 2, 100 * MSEC);
+    sch.setValue(2, 0, 150 * MSEC);
+
+    updates = sch.take(150 * MSEC);
+    QCOMPARE(updates.size(), 2);
+    QCOMPARE(updates[0].channel, 2);
+    QCOMPARE(updates[1].channel, 1);
+}
+
+void MIDIScheduler_Test::latencyBound()
+{
+    MIDIScheduler sch(128);
+
+    /* Every channel changes on every 20ms DMX frame, which is far more
+       than MIDI can carry */
+    qsrand(1);
+    for (qint64 now = 0; now < 3000 * MSEC; now += MSEC)
+    {
+        if ((now % (20 * MSEC)) == 0)
+        {
+            for (int i = 0; i < 128; i++)
+                sch.setValue(i, uchar(qrand() % 128), now);
+        }
+
+        sch.take(now);
+    }
+
+    QVERIFY(sch.updates() > 0);
+    QVERIFY(sch.averageLatency() > 0);
+    QVERIFY(sch.averageLatency() <= sch.maxLatency());
+    QVERIFY(sch.maxLatency() <= sch.latencyBound());
+
+    sch.resetStatistics();
+    QCOMPARE(sch.updates(), quint64(0));
+    QCOMPARE(sch.averageLatency(), qint64(0));
+    QCOMPARE(sch.maxLatency(), qint64(0));
+}
+
+void MIDIScheduler_Test::reset()
+{
+    MIDIScheduler sch(128);
+
+    sch.setValue(1, 50, 0);
+    sch.setValue(2, 60, 0);
+    QCOMPARE(sch.take(0).size(), 2);
+    QVERIFY(sch.hasPending() == false);
+
+    /* Non-zero values are sent again after a reset */
+    sch.reset(100 * MSEC);
+    QVERIFY(sch.hasPending() == true);
+
+    QVector <MIDIScheduler::Update> updates(sch.take(100 * MSEC));
+    QCOMPARE(updates.size(), 2);
+    QCOMPARE(updates[0].channel, 2);
+    QCOMPARE(int(updates[0].value), 60);
+    QCOMPARE(updates[1].channel, 1);
+    QCOMPARE(int(updates[1].value), 50);
+}
@@ -0,0 +1,15 @@
+include(../../../../variables.pri)
+
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = test_midiout
+
+CONFIG  += qtestlib
+QTPLUGIN =
+
+INCLUDEPATH += ..
+DEPENDPATH  += ..
+INCLUDEPATH += ../../../interfaces
+
+HEADERS += midischeduler_test.h ../midischeduler.h
+SOURCES += midischeduler_test.cpp main.cpp ../midischeduler.cpp
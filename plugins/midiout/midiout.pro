@@ -1,4 +1,5 @@
 TEMPLATE            = subdirs
+SUBDIRS            += common/test
 unix:!macx:SUBDIRS += alsa
 macx:SUBDIRS       += macx
 win32:SUBDIRS      += win32
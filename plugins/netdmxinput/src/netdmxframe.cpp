@@ -0,0 +1,121 @@
+/*
+  Q Light Controller
+  netdmxframe.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <string.h>
+
+#include "netdmxframe.h"
+
+/* Maximum number of DMX values in a packet */
+#define NETDMX_CHANNELS 512
+
+/* Read a 16bit value in network byte order */
+static inline quint16 readShort(const char* data, int offset)
+{
+    return (quint16(uchar(data[offset])) << 8) | uchar(data[offset + 1]);
+}
+
+/* Read a 32bit value in network byte order */
+static inline quint32 readLong(const char* data, int offset)
+{
+    return (quint32(readShort(data, offset)) << 16) |
+           readShort(data, offset + 2);
+}
+
+NetDMXFrame::NetDMXFrame()
+    : protocol(ArtNet)
+    , universe(0)
+    , priority(E131_PRIORITY)
+    , sequence(-1)
+    , terminated(false)
+    , cid(NULL)
+    , values(NULL)
+    , count(0)
+{
+}
+
+bool NetDMXFrame::parse(const char* data, int size, Protocol protocol)
+{
+    Q_ASSERT(data != NULL);
+
+    this->protocol = protocol;
+
+    if (protocol == ArtNet)
+    {
+        if (size < ARTNET_HEADER_SIZE || memcmp(data, "Art-Net", 8) != 0)
+            return false;
+
+        /* OpCode is the only little-endian field */
+        quint16 opcode = quint16(uchar(data[8])) |
+                         (quint16(uchar(data[9])) << 8);
+        if (opcode != ARTNET_OPCODE_DMX)
+            return false;
+
+        int length = readShort(data, 16);
+        if (length > NETDMX_CHANNELS || ARTNET_HEADER_SIZE + length > size)
+            return false;
+
+        /* Zero means that the sender doesn't use sequencing */
+        sequence = uchar(data[12]);
+        if (sequence == 0)
+            sequence = -1;
+
+        universe = quint16(uchar(data[14])) |
+                   (quint16(uchar(data[15]) & 0x7F) << 8);
+        priority = E131_PRIORITY;
+        terminated = false;
+        cid = NULL;
+        values = reinterpret_cast<const uchar*> (data + ARTNET_HEADER_SIZE);
+        count = length;
+    }
+    else
+    {
+        /* Root layer: ACN identifier & data vector */
+        if (size < E131_HEADER_SIZE ||
+            memcmp(data + 4, "ASC-E1.17\0\0\0", 12) != 0 ||
+            readLong(data, 18) != 0x00000004)
+        {
+            return false;
+        }
+
+        /* Framing layer: data packet vector, not a preview */
+        if (readLong(data, 40) != 0x00000002 || (data[112] & 0x80) != 0)
+            return false;
+
+        /* DMP layer: set property, DMX start code 0 */
+        int valueCount = readShort(data, 123);
+        if (uchar(data[117]) != 0x02 || uchar(data[118]) != 0xA1 ||
+            valueCount < 1 || valueCount > NETDMX_CHANNELS + 1 ||
+            E131_HEADER_SIZE + valueCount - 1 > size || data[125] != 0)
+        {
+            return false;
+        }
+
+        cid = data + 22;
+        priority = qMin(uchar(data[108]), uchar(E131_PRIORITY_MAX));
+        sequence = uchar(data[111]);
+        terminated = ((data[112] & 0x40) != 0);
+        universe = readShort(data, 113);
+        values = reinterpret_cast<const uchar*> (data + E131_HEADER_SIZE);
+        count = valueCount - 1;
+    }
+
+    return true;
+}
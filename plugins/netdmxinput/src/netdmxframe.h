@@ -0,0 +1,107 @@
+/*
+  Q Light Controller
+  netdmxframe.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef NETDMXFRAME_H
+#define NETDMXFRAME_H
+
+#include <QtGlobal>
+
+#include "qlctypes.h"
+
+/****************************************************************************
+ * Art-Net (ArtDmx)
+ ****************************************************************************/
+
+#define ARTNET_PORT          6454
+#define ARTNET_HEADER_SIZE   18
+#define ARTNET_OPCODE_DMX    0x5000
+
+/****************************************************************************
+ * E1.31 (sACN)
+ ****************************************************************************/
+
+#define E131_PORT            5568
+#define E131_HEADER_SIZE     126
+#define E131_CID_SIZE        16
+#define E131_PRIORITY        100
+#define E131_PRIORITY_MAX    200
+
+/****************************************************************************
+ * NetDMXFrame
+ ****************************************************************************/
+
+/**
+ * NetDMXFrame is a view to one Art-Net or E1.31 DMX packet. parse() only
+ * validates the packet and picks its fields; the DMX values and the source
+ * identifier are left where they are, in the caller's receive buffer, so
+ * nothing is copied or allocated. The frame is valid only as long as the
+ * buffer stays untouched.
+ */
+class QLC_DECLSPEC NetDMXFrame
+{
+public:
+    enum Protocol
+    {
+        ArtNet,
+        E131
+    };
+
+    NetDMXFrame();
+
+    /**
+     * Parse a received datagram as an Art-Net or E1.31 DMX packet.
+     * Everything else (other Art-Net opcodes, E1.31 sync or discovery
+     * packets, DMX with a non-zero start code, malformed packets) is
+     * rejected.
+     *
+     * @param data The datagram
+     * @param size The size of the datagram in bytes
+     * @param protocol The protocol that the datagram is expected to use
+     * @return true if the datagram is a valid DMX packet, otherwise false
+     */
+    bool parse(const char* data, int size, Protocol protocol);
+
+public:
+    Protocol protocol;
+
+    /** Art-Net port-address or E1.31 universe */
+    quint16 universe;
+
+    /** E1.31 priority (0-200); always E131_PRIORITY with Art-Net */
+    uchar priority;
+
+    /** Sequence number, or -1 when the sender doesn't use sequencing */
+    int sequence;
+
+    /** true if the E1.31 source tells that it stops sending the universe */
+    bool terminated;
+
+    /** E1.31 component identifier (E131_CID_SIZE bytes), NULL with Art-Net */
+    const char* cid;
+
+    /** Pointer to the DMX values inside the parsed datagram */
+    const uchar* values;
+
+    /** Number of DMX values (0-512) */
+    int count;
+};
+
+#endif
@@ -0,0 +1,456 @@
+/*
+  Q Light Controller
+  netdmxinput.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QInputDialog>
+#include <QStringList>
+#include <QUdpSocket>
+#include <QSettings>
+#include <QDebug>
+#include <QTimer>
+
+#include "netdmxmerger.h"
+#include "netdmxinput.h"
+#include "qlcclock.h"
+
+#define DEFAULT_UNIVERSES 4
+
+/* Big enough for any Art-Net or E1.31 DMX packet */
+#define BUFFER_SIZE 1024
+
+/* How often quiet sources are looked for */
+#define EXPIRY_INTERVAL 1000
+
+/*****************************************************************************
+ * Initialization
+ *****************************************************************************/
+
+void NetDMXInput::init()
+{
+    QSettings settings;
+    m_universes = settings.value(SETTINGS_UNIVERSES, DEFAULT_UNIVERSES).toInt();
+    m_universes = CLAMP(m_universes, 1, int(KUniverseCountMax));
+    for (int i = 0; i < 2 * m_universes; i++)
+        m_mergers << NULL;
+
+    m_valueTimestamp = 0;
+    m_artNetSocket = NULL;
+    m_e131Socket = NULL;
+    m_buffer = QByteArray(BUFFER_SIZE, char(0));
+
+    m_expiryTimer = new QTimer(this);
+    m_expiryTimer->setInterval(EXPIRY_INTERVAL);
+    connect(m_expiryTimer, SIGNAL(timeout()), this, SLOT(slotExpireSources()));
+}
+
+NetDMXInput::~NetDMXInput()
+{
+    while (m_mergers.isEmpty() == false)
+        delete m_mergers.takeFirst();
+
+    delete m_artNetSocket;
+    delete m_e131Socket;
+}
+
+QString NetDMXInput::name()
+{
+    return QString("Art-Net & E1.31 Input");
+}
+
+/*****************************************************************************
+ * Inputs
+ *****************************************************************************/
+
+void NetDMXInput::open(quint32 input)
+{
+    if (input >= quint32(m_mergers.size()) || m_mergers[input] != NULL)
+        return;
+
+    NetDMXFrame::Protocol protocol = lineProtocol(input);
+    if (openSocket(protocol) == false)
+        return;
+
+    m_mergers[input] = new NetDMXMerger;
+
+    if (protocol == NetDMXFrame::E131)
+    {
+        QHostAddress group(multicastGroup(lineUniverse(input)));
+        if (m_e131Socket->joinMulticastGroup(group) == false)
+        {
+            qWarning() << Q_FUNC_INFO << "Unable to join" << group.toString()
+                       << m_e131Socket->errorString();
+        }
+    }
+
+    m_expiryTimer->start();
+}
+
+void NetDMXInput::close(quint32 input)
+{
+    if (input >= quint32(m_mergers.size()) || m_mergers[input] == NULL)
+        return;
+
+    delete m_mergers[input];
+    m_mergers[input] = NULL;
+
+    NetDMXFrame::Protocol protocol = lineProtocol(input);
+    if (protocol == NetDMXFrame::E131 && m_e131Socket != NULL)
+        m_e131Socket->leaveMulticastGroup(multicastGroup(lineUniverse(input)));
+    closeSocket(protocol);
+
+    if (m_artNetSocket == NULL && m_e131Socket == NULL)
+        m_expiryTimer->stop();
+}
+
+QStringList NetDMXInput::inputs()
+{
+    QStringList list;
+
+    for (int i = 0; i < 2 * m_universes; i++)
+    {
+        if (lineProtocol(i) == NetDMXFrame::ArtNet)
+        {
+            list << QString("%1: Art-Net universe %2").arg(i + 1)
+                                                      .arg(lineUniverse(i));
+        }
+        else
+        {
+            list << QString("%1: E1.31 universe %2").arg(i + 1)
+                                                    .arg(lineUniverse(i));
+        }
+    }
+
+    return list;
+}
+
+QString NetDMXInput::infoText(quint32 input)
+{
+    QString str;
+
+    str += QString("<HTML>");
+    str += QString("<HEAD>");
+    str += QString("<TITLE>%1</TITLE>").arg(name());
+    str += QString("</HEAD>");
+    str += QString("<BODY>");
+
+    if (input == KInputInvalid)
+    {
+        str += QString("<H3>%1</H3>").arg(name());
+        str += QString("<P>");
+        str += tr("This plugin receives DMX universes from the network "
+                  "using the Art-Net and E1.31 (sACN) protocols. When "
+                  "several sources send the same universe, the sources "
+                  "with the highest priority are merged, highest value "
+                  "taking precedence.");
+        str += QString("</P>");
+
+        if (m_errorString.isEmpty() == false)
+        {
+            str += QString("<P>");
+            str += tr("Unable to bind to UDP port: %1").arg(m_errorString);
+            str += QString("</P>");
+        }
+    }
+    else if (input < quint32(m_mergers.size()))
+    {
+        str += QString("<H3>%1</H3>").arg(inputs()[input]);
+        str += QString("<P>");
+        if (m_mergers[input] == NULL)
+        {
+            str += tr("This input is not open.");
+        }
+        else
+        {
+            str += tr("UDP port %1, %n source(s)", "",
+                      m_mergers[input]->sources())
+                   .arg(lineProtocol(input) == NetDMXFrame::ArtNet ?
+                        ARTNET_PORT : E131_PORT);
+        }
+        str += QString("</P>");
+    }
+
+    str += QString("</BODY>");
+    str += QString("</HTML>");
+
+    return str;
+}
+
+qint64 NetDMXInput::valueTimestamp()
+{
+    return m_valueTimestamp;
+}
+
+NetDMXFrame::Protocol NetDMXInput::lineProtocol(quint32 input) const
+{
+    if (input < quint32(m_universes))
+        return NetDMXFrame::ArtNet;
+    else
+        return NetDMXFrame::E131;
+}
+
+quint16 NetDMXInput::lineUniverse(quint32 input) const
+{
+    /* Art-Net port-addresses start from 0, E1.31 universes from 1 */
+    if (input < quint32(m_universes))
+        return quint16(input);
+    else
+        return quint16(input - m_universes + 1);
+}
+
+quint32 NetDMXInput::universeLine(NetDMXFrame::Protocol protocol,
+                                  quint16 universe) const
+{
+    if (protocol == NetDMXFrame::ArtNet)
+    {
+        if (universe < m_universes)
+            return universe;
+    }
+    else
+    {
+        if (universe >= 1 && universe <= m_universes)
+            return m_universes + universe - 1;
+    }
+
+    return KInputInvalid;
+}
+
+QHostAddress NetDMXInput::multicastGroup(quint16 universe)
+{
+    return QHostAddress((quint32(239) << 24) | (quint32(255) << 16) |
+                        universe);
+}
+
+void NetDMXInput::emitChanged(quint32 input)
+{
+    const NetDMXMerger* merger = m_mergers[input];
+    const uchar* values = merger->values();
+
+    QVectorIterator <int> it(merger->changed());
+    while (it.hasNext() == true)
+    {
+        int channel = it.next();
+        emit valueChanged(input, channel, values[channel]);
+    }
+}
+
+/*****************************************************************************
+ * Sockets
+ *****************************************************************************/
+
+bool NetDMXInput::openSocket(NetDMXFrame::Protocol protocol)
+{
+    QUdpSocket*& socket = (protocol == NetDMXFrame::ArtNet) ? m_artNetSocket
+                                                             : m_e131Socket;
+    if (socket != NULL)
+        return true;
+
+    /* Other programs on the same host may want to listen, too */
+    quint16 port = (protocol == NetDMXFrame::ArtNet) ? ARTNET_PORT : E131_PORT;
+    socket = new QUdpSocket;
+    if (socket->bind(QHostAddress::Any, port, QUdpSocket::ShareAddress |
+                                              QUdpSocket::ReuseAddressHint)
+        == false)
+    {
+        m_errorString = socket->errorString();
+        qWarning() << Q_FUNC_INFO << port << m_errorString;
+        delete socket;
+        socket = NULL;
+        return false;
+    }
+
+    m_errorString.clear();
+    if (protocol == NetDMXFrame::ArtNet)
+        connect(socket, SIGNAL(readyRead()), this, SLOT(slotReadArtNet()));
+    else
+        connect(socket, SIGNAL(readyRead()), this, SLOT(slotReadE131()));
+
+    return true;
+}
+
+void NetDMXInput::closeSocket(NetDMXFrame::Protocol protocol)
+{
+    for (int i = 0; i < m_mergers.size(); i++)
+    {
+        if (m_mergers[i] != NULL && lineProtocol(i) == protocol)
+            return;
+    }
+
+    if (protocol == NetDMXFrame::ArtNet)
+    {
+        delete m_artNetSocket;
+        m_artNetSocket = NULL;
+    }
+    else
+    {
+        delete m_e131Socket;
+        m_e131Socket = NULL;
+    }
+}
+
+void NetDMXInput::readSocket(QUdpSocket* socket,
+                             NetDMXFrame::Protocol protocol)
+{
+    QHostAddress sender;
+    NetDMXFrame frame;
+
+    while (socket->hasPendingDatagrams() == true)
+    {
+        qint64 size = socket->readDatagram(m_buffer.data(), m_buffer.size(),
+                                           &sender);
+        qint64 timestamp = QLCClock::monotonicTime();
+
+        if (size > 0 &&
+            frame.parse(m_buffer.constData(), size, protocol) == true)
+        {
+            processFrame(frame, sender, timestamp);
+        }
+    }
+}
+
+void NetDMXInput::processFrame(const NetDMXFrame& frame,
+                               const QHostAddress& sender, qint64 timestamp)
+{
+    quint32 input = universeLine(frame.protocol, frame.universe);
+    if (input == KInputInvalid || m_mergers[input] == NULL)
+        return;
+
+    NetDMXMerger* merger = m_mergers[input];
+
+    /* E1.31 sources are told apart by their CID, Art-Net sources by their
+       address. Neither is copied unless the source is new. */
+    QByteArray id;
+    char address[4];
+    if (frame.cid != NULL)
+    {
+        id = QByteArray::fromRawData(frame.cid, E131_CID_SIZE);
+    }
+    else
+    {
+        quint32 ipv4 = sender.toIPv4Address();
+        for (int i = 0; i < 4; i++)
+            address[i] = char((ipv4 >> (24 - i * 8)) & 0xFF);
+        id = QByteArray::fromRawData(address, 4);
+    }
+
+    bool merged;
+    if (frame.terminated == true)
+        merged = merger->remove(id);
+    else
+        merged = merger->update(id, frame.priority, frame.sequence,
+                                frame.values, frame.count, timestamp);
+
+    if (merged == true)
+    {
+        m_valueTimestamp = timestamp;
+        emitChanged(input);
+        m_valueTimestamp = 0;
+    }
+}
+
+void NetDMXInput::slotReadArtNet()
+{
+    if (m_artNetSocket != NULL)
+        readSocket(m_artNetSocket, NetDMXFrame::ArtNet);
+}
+
+void NetDMXInput::slotReadE131()
+{
+    if (m_e131Socket != NULL)
+        readSocket(m_e131Socket, NetDMXFrame::E131);
+}
+
+void NetDMXInput::slotExpireSources()
+{
+    qint64 now = QLCClock::monotonicTime();
+
+    for (int i = 0; i < m_mergers.size(); i++)
+    {
+        if (m_mergers[i] != NULL && m_mergers[i]->expire(now) == true)
+            emitChanged(i);
+    }
+}
+
+/*****************************************************************************
+ * Configuration
+ *****************************************************************************/
+
+void NetDMXInput::configure()
+{
+    bool ok = false;
+
+    int universes = QInputDialog::getInt(NULL, name(),
+                        tr("Number of universes for both Art-Net and E1.31"),
+                        m_universes, 1, KUniverseCountMax, 1, &ok);
+    if (ok == true && universes != m_universes)
+        setUniverses(universes);
+}
+
+bool NetDMXInput::canConfigure()
+{
+    return true;
+}
+
+void NetDMXInput::setUniverses(int universes)
+{
+    /* Line numbers may now stand for other protocols or universes, so
+       close everything and reopen the lines that were in use */
+    QList <quint32> opened;
+    for (int i = 0; i < m_mergers.size(); i++)
+    {
+        if (m_mergers[i] != NULL)
+        {
+            opened << i;
+            close(i);
+        }
+    }
+
+    m_universes = CLAMP(universes, 1, int(KUniverseCountMax));
+    m_mergers.clear();
+    for (int i = 0; i < 2 * m_universes; i++)
+        m_mergers << NULL;
+
+    QListIterator <quint32> it(opened);
+    while (it.hasNext() == true)
+        open(it.next());
+
+    QSettings settings;
+    settings.setValue(SETTINGS_UNIVERSES, m_universes);
+
+    emit configurationChanged();
+}
+
+/*****************************************************************************
+ * Feedback
+ *****************************************************************************/
+
+void NetDMXInput::feedBack(quint32 input, quint32 channel, uchar value)
+{
+    /* Feedback would mean sending DMX back to the network, which is the
+       output plugin's job */
+    Q_UNUSED(input);
+    Q_UNUSED(channel);
+    Q_UNUSED(value);
+}
+
+/*****************************************************************************
+ * Plugin export
+ ****************************************************************************/
+
+Q_EXPORT_PLUGIN2(netdmxinput, NetDMXInput)
@@ -0,0 +1,190 @@
+/*
+  Q Light Controller
+  netdmxinput.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef NETDMXINPUT_H
+#define NETDMXINPUT_H
+
+#include <QHostAddress>
+#include <QStringList>
+#include <QByteArray>
+#include <QString>
+#include <QList>
+
+#include "qlcinplugin.h"
+#include "netdmxframe.h"
+
+class NetDMXMerger;
+class QUdpSocket;
+class QTimer;
+
+#define SETTINGS_UNIVERSES "NetDMXInput/universes"
+
+/*****************************************************************************
+ * NetDMXInput
+ *****************************************************************************/
+
+/**
+ * NetDMXInput receives DMX universes from the network as Art-Net and E1.31
+ * (sACN) and provides their channels as input. Like the output plugin, it
+ * provides the same number of lines for both protocols: Art-Net universes
+ * (port-addresses) starting from 0, followed by E1.31 universes starting
+ * from 1. E1.31 lines join their universe's multicast group, but unicast
+ * packets are accepted as well.
+ *
+ * Datagrams are read into a single preallocated buffer and parsed in place.
+ * Each line merges its sources according to their priority and emits
+ * valueChanged() only for the channels that actually changed.
+ */
+class QLC_DECLSPEC NetDMXInput : public QLCInPlugin
+{
+    Q_OBJECT
+    Q_INTERFACES(QLCInPlugin)
+
+    /*********************************************************************
+     * Initialization
+     *********************************************************************/
+public:
+    /** @reimp */
+    void init();
+
+    /** @reimp */
+    virtual ~NetDMXInput();
+
+    /** @reimp */
+    QString name();
+
+    /*********************************************************************
+     * Inputs
+     *********************************************************************/
+public:
+    /** @reimp */
+    void open(quint32 input = 0);
+
+    /** @reimp */
+    void close(quint32 input = 0);
+
+    /** @reimp */
+    QStringList inputs();
+
+    /** @reimp */
+    QString infoText(quint32 input = KInputInvalid);
+
+    /** @reimp */
+    qint64 valueTimestamp();
+
+signals:
+    /** @reimp */
+    void valueChanged(quint32 input, quint32 channel, uchar value);
+
+protected:
+    /** Get the protocol used by the given input line */
+    NetDMXFrame::Protocol lineProtocol(quint32 input) const;
+
+    /** Get the protocol's universe number for the given input line */
+    quint16 lineUniverse(quint32 input) const;
+
+    /** Get the input line for a protocol's universe or KInputInvalid */
+    quint32 universeLine(NetDMXFrame::Protocol protocol,
+                         quint16 universe) const;
+
+    /** Get the E1.31 multicast group of the given universe */
+    static QHostAddress multicastGroup(quint16 universe);
+
+    /** Emit the channels that the latest merge changed on a line */
+    void emitChanged(quint32 input);
+
+protected:
+    /** Number of input lines per protocol */
+    int m_universes;
+
+    /** A merger for each input line; NULL when the line isn't open */
+    QList <NetDMXMerger*> m_mergers;
+
+    /** Timestamp of the value that is being emitted */
+    qint64 m_valueTimestamp;
+
+    /*********************************************************************
+     * Sockets
+     *********************************************************************/
+protected:
+    /** Create and bind the socket for the given protocol, if necessary */
+    bool openSocket(NetDMXFrame::Protocol protocol);
+
+    /** Destroy the protocol's socket if none of its lines are open */
+    void closeSocket(NetDMXFrame::Protocol protocol);
+
+    /** Read and process all pending datagrams from a socket */
+    void readSocket(QUdpSocket* socket, NetDMXFrame::Protocol protocol);
+
+    /** Merge a parsed frame into its line and emit changed channels */
+    void processFrame(const NetDMXFrame& frame, const QHostAddress& sender,
+                      qint64 timestamp);
+
+protected slots:
+    void slotReadArtNet();
+    void slotReadE131();
+
+    /** Drop sources that have gone quiet */
+    void slotExpireSources();
+
+protected:
+    QUdpSocket* m_artNetSocket;
+    QUdpSocket* m_e131Socket;
+    QString m_errorString;
+
+    /** Preallocated buffer that all datagrams are read into */
+    QByteArray m_buffer;
+
+    /** Periodically drops quiet sources while any line is open */
+    QTimer* m_expiryTimer;
+
+    /*********************************************************************
+     * Configuration
+     *********************************************************************/
+public:
+    /** @reimp */
+    void configure();
+
+    /** @reimp */
+    bool canConfigure();
+
+    /**
+     * Set the number of input lines per protocol and save it to settings.
+     * Open lines are re-created with fresh merge state and those that
+     * still exist are reopened, since the host keeps them patched.
+     *
+     * @param universes Number of lines per protocol (1-KUniverseCountMax)
+     */
+    void setUniverses(int universes);
+
+signals:
+    /** @reimp */
+    void configurationChanged();
+
+    /*********************************************************************
+     * Feedback
+     *********************************************************************/
+public:
+    /** @reimp */
+    void feedBack(quint32 input, quint32 channel, uchar value);
+};
+
+#endif
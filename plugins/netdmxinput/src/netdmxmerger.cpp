@@ -0,0 +1,266 @@
+/*
+  Q Light Controller
+  netdmxmerger.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <string.h>
+
+#include "netdmxmerger.h"
+
+#define NETDMX_CHANNELS 512
+
+/* E1.31 network data loss timeout, used for Art-Net as well */
+#define NETDMX_SOURCE_TIMEOUT Q_INT64_C(2500000000)
+
+/* Frames this much behind the previous one are considered out of order;
+   anything further back means that the source has restarted */
+#define NETDMX_SEQUENCE_WINDOW 20
+
+/****************************************************************************
+ * Initialization
+ ****************************************************************************/
+
+NetDMXMerger::NetDMXMerger()
+    : m_values(NETDMX_CHANNELS, char(0))
+    , m_merged(NETDMX_CHANNELS, char(0))
+{
+    m_changed.reserve(NETDMX_CHANNELS);
+}
+
+NetDMXMerger::~NetDMXMerger()
+{
+    clear();
+}
+
+int NetDMXMerger::channels()
+{
+    return NETDMX_CHANNELS;
+}
+
+qint64 NetDMXMerger::sourceTimeout()
+{
+    return NETDMX_SOURCE_TIMEOUT;
+}
+
+void NetDMXMerger::clear()
+{
+    while (m_sources.isEmpty() == false)
+        delete m_sources.takeFirst();
+
+    m_values.fill(char(0));
+    m_changed.resize(0);
+}
+
+/****************************************************************************
+ * Sources
+ ****************************************************************************/
+
+bool NetDMXMerger::update(const QByteArray& source, uchar priority,
+                          int sequence, const uchar* values, int count,
+                          qint64 now)
+{
+    Q_ASSERT(values != NULL || count == 0);
+
+    m_changed.resize(0);
+    count = qBound(0, count, NETDMX_CHANNELS);
+
+    Source* src = this->source(source);
+    if (src == NULL)
+    {
+        /* The only source so far has been applied directly, so its own
+           values haven't been kept. They're the merged values, though. */
+        if (m_sources.size() == 1)
+            m_sources.first()->values = m_values;
+
+        src = new Source;
+        src->id = QByteArray(source.constData(), source.size());
+        src->sequence = -1;
+        m_sources.append(src);
+    }
+    else if (sequence != -1 && src->sequence != -1)
+    {
+        int diff = qint8(quint8(sequence - src->sequence));
+        if (diff <= 0 && diff > -NETDMX_SEQUENCE_WINDOW)
+            return false;
+    }
+
+    src->priority = priority;
+    src->sequence = sequence;
+    src->lastSeen = now;
+
+    if (m_sources.size() == 1)
+    {
+        apply(values, count);
+    }
+    else
+    {
+        if (src->values.size() != NETDMX_CHANNELS)
+            src->values = QByteArray(NETDMX_CHANNELS, char(0));
+        char* data = src->values.data();
+        memcpy(data, values, count);
+        memset(data + count, 0, NETDMX_CHANNELS - count);
+        merge();
+    }
+
+    return true;
+}
+
+bool NetDMXMerger::remove(const QByteArray& source)
+{
+    m_changed.resize(0);
+
+    Source* src = this->source(source);
+    if (src == NULL)
+        return false;
+
+    m_sources.removeAll(src);
+    delete src;
+    merge();
+
+    return true;
+}
+
+bool NetDMXMerger::expire(qint64 now)
+{
+    bool expired = false;
+
+    m_changed.resize(0);
+
+    QMutableListIterator <Source*> it(m_sources);
+    while (it.hasNext() == true)
+    {
+        Source* src = it.next();
+        if (now - src->lastSeen >= NETDMX_SOURCE_TIMEOUT)
+        {
+            it.remove();
+            delete src;
+            expired = true;
+        }
+    }
+
+    if (expired == true)
+        merge();
+
+    return expired;
+}
+
+int NetDMXMerger::sources() const
+{
+    return m_sources.size();
+}
+
+NetDMXMerger::Source* NetDMXMerger::source(const QByteArray& id) const
+{
+    QListIterator <Source*> it(m_sources);
+    while (it.hasNext() == true)
+    {
+        Source* src = it.next();
+        if (src->id == id)
+            return src;
+    }
+
+    return NULL;
+}
+
+void NetDMXMerger::merge()
+{
+    /* When the last source goes away, its values stay. Dropping input
+       channels to zero just because a desk went quiet would be worse. */
+    if (m_sources.isEmpty() == true)
+        return;
+
+    /* A single remaining source has had its values kept up to date
+       while there were others */
+    if (m_sources.size() == 1)
+    {
+        const QByteArray& values(m_sources.first()->values);
+        apply(reinterpret_cast<const uchar*> (values.constData()),
+              values.size());
+        return;
+    }
+
+    uchar* merged = reinterpret_cast<uchar*> (m_merged.data());
+    memset(merged, 0, NETDMX_CHANNELS);
+
+    /* Only the sources with the highest priority count */
+    int highest = -1;
+    QListIterator <Source*> it(m_sources);
+    while (it.hasNext() == true)
+        highest = qMax(highest, int(it.next()->priority));
+
+    it.toFront();
+    while (it.hasNext() == true)
+    {
+        Source* src = it.next();
+        if (src->priority != highest || src->values.size() != NETDMX_CHANNELS)
+            continue;
+
+        const uchar* values = reinterpret_cast<const uchar*>
+                                                (src->values.constData());
+        for (int i = 0; i < NETDMX_CHANNELS; i++)
+        {
+            if (values[i] > merged[i])
+                merged[i] = values[i];
+        }
+    }
+
+    apply(merged, NETDMX_CHANNELS);
+}
+
+void NetDMXMerger::apply(const uchar* values, int count)
+{
+    uchar* current = reinterpret_cast<uchar*> (m_values.data());
+
+    /* Usually only a few channels change, so skip equal blocks quickly */
+    for (int block = 0; block < NETDMX_CHANNELS; block += 64)
+    {
+        int end = qMin(block + 64, NETDMX_CHANNELS);
+        int valid = qBound(0, count - block, end - block);
+
+        if (valid == end - block &&
+            memcmp(current + block, values + block, valid) == 0)
+        {
+            continue;
+        }
+
+        for (int i = block; i < end; i++)
+        {
+            uchar value = (i < count) ? values[i] : 0;
+            if (current[i] != value)
+            {
+                current[i] = value;
+                m_changed.append(i);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Values
+ ****************************************************************************/
+
+const uchar* NetDMXMerger::values() const
+{
+    return reinterpret_cast<const uchar*> (m_values.constData());
+}
+
+const QVector <int>& NetDMXMerger::changed() const
+{
+    return m_changed;
+}
@@ -0,0 +1,152 @@
+/*
+  Q Light Controller
+  netdmxmerger.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef NETDMXMERGER_H
+#define NETDMXMERGER_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QList>
+
+#include "qlctypes.h"
+
+/**
+ * NetDMXMerger merges the frames that one or more network sources send to
+ * the same universe, and keeps track of which channels changed.
+ *
+ * Only the sources with the highest priority are merged; among them, the
+ * highest value of each channel wins (HTP). Sources that haven't sent
+ * anything for sourceTimeout() are dropped with expire(). When the last
+ * source is gone, the merged values are left as they were.
+ *
+ * When there's just one source, which is by far the most common case, its
+ * frames are compared directly against the merged values, without being
+ * copied anywhere first.
+ */
+class QLC_DECLSPEC NetDMXMerger
+{
+    Q_DISABLE_COPY(NetDMXMerger)
+
+    /********************************************************************
+     * Initialization
+     ********************************************************************/
+public:
+    NetDMXMerger();
+    ~NetDMXMerger();
+
+    /** Number of channels in a universe */
+    static int channels();
+
+    /** Nanoseconds after which a silent source is dropped */
+    static qint64 sourceTimeout();
+
+    /** Drop all sources and reset all values to zero without reporting
+        them as changes */
+    void clear();
+
+    /********************************************************************
+     * Sources
+     ********************************************************************/
+public:
+    /**
+     * Merge a new frame from a source. Frames that arrive out of order
+     * are discarded.
+     *
+     * @param source An identifier of the source (E1.31 CID or Art-Net
+     *               sender address). It's copied only for new sources.
+     * @param priority The source's priority
+     * @param sequence The frame's sequence number, or -1 if not known
+     * @param values The frame's DMX values
+     * @param count The number of values; missing channels are zero
+     * @param now Current time in QLCClock nanoseconds
+     * @return true if the frame was merged, false if it was discarded
+     */
+    bool update(const QByteArray& source, uchar priority, int sequence,
+                const uchar* values, int count, qint64 now);
+
+    /**
+     * Remove a source, for example when it tells that it stops sending.
+     *
+     * @param source The source to remove
+     * @return true if the source was removed, false if it wasn't found
+     */
+    bool remove(const QByteArray& source);
+
+    /**
+     * Drop sources that haven't sent anything in sourceTimeout().
+     *
+     * @param now Current time in QLCClock nanoseconds
+     * @return true if any sources were dropped, otherwise false
+     */
+    bool expire(qint64 now);
+
+    /** Get the number of sources */
+    int sources() const;
+
+protected:
+    struct Source
+    {
+        QByteArray id;
+        uchar priority;
+        int sequence;
+        qint64 lastSeen;
+
+        /** The source's own values; not kept up to date while the
+            source is the only one */
+        QByteArray values;
+    };
+
+    /** Find a source by its ID */
+    Source* source(const QByteArray& id) const;
+
+    /** Merge all sources and compare the result with m_values */
+    void merge();
+
+    /** Compare the given values with m_values, update them and record
+        changed channels */
+    void apply(const uchar* values, int count);
+
+protected:
+    QList <Source*> m_sources;
+
+    /************************************************************************
+     * Values
+     ************************************************************************/
+public:
+    /** Get the current merged values (channels() of them) */
+    const uchar* values() const;
+
+    /** Get the channels changed by the latest update(), remove() or
+        expire() call */
+    const QVector <int>& changed() const;
+
+protected:
+    /** Merged values, as last reported */
+    QByteArray m_values;
+
+    /** Scratch buffer for merging several sources */
+    QByteArray m_merged;
+
+    /** Channels changed by the latest call; never shrinks its buffer */
+    QVector <int> m_changed;
+};
+
+#endif
@@ -0,0 +1,22 @@
+include(../../../variables.pri)
+
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = test_netdmxinput
+
+QT     += core gui network testlib
+
+INCLUDEPATH += ../../interfaces
+INCLUDEPATH += ../src
+LIBS   += -L../src -lnetdmxinput
+
+SOURCES += testpackets.cpp \
+           testnetdmxframe.cpp \
+           testnetdmxmerger.cpp \
+           testnetdmxinput.cpp \
+           main.cpp
+
+HEADERS += testpackets.h \
+           testnetdmxframe.h \
+           testnetdmxmerger.h \
+           testnetdmxinput.h
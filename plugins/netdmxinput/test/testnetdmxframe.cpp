@@ -0,0 +1,137 @@
+#include <QByteArray>
+#include <QtTest>
+
+#include "netdmxframe.h"
+#include "testnetdmxframe.h"
+#include "testpackets.h"
+
+void TestNetDMXFrame::initial()
+{
+    NetDMXFrame frame;
+    QVERIFY(frame.values == NULL);
+    QVERIFY(frame.cid == NULL);
+    QVERIFY(frame.count == 0);
+    QVERIFY(frame.sequence == -1);
+    QVERIFY(frame.terminated == false);
+}
+
+void TestNetDMXFrame::artNet()
+{
+    QByteArray data(artNetPacket(0x1234, 7, QByteArray(512, 'x')));
+    NetDMXFrame frame;
+
+    QVERIFY(frame.parse(data.constData(), data.size(),
+                        NetDMXFrame::ArtNet) == true);
+    QVERIFY(frame.protocol == NetDMXFrame::ArtNet);
+    QCOMPARE(int(frame.universe), 0x1234);
+    QCOMPARE(int(frame.priority), E131_PRIORITY);
+    QCOMPARE(frame.sequence, 7);
+    QVERIFY(frame.cid == NULL);
+    QCOMPARE(frame.count, 512);
+
+    /* Values are not copied */
+    QVERIFY(frame.values ==
+            reinterpret_cast<const uchar*> (data.constData() + 18));
+
+    /* Shorter universes are fine, zero sequence means none */
+    data = artNetPacket(1, 0, QByteArray(24, 'y'));
+    QVERIFY(frame.parse(data.constData(), data.size(),
+                        NetDMXFrame::ArtNet) == true);
+    QCOMPARE(frame.count, 24);
+    QCOMPARE(frame.sequence, -1);
+}
+
+void TestNetDMXFrame::artNetInvalid()
+{
+    QByteArray data(artNetPacket(0, 1, QByteArray(512, 'x')));
+    NetDMXFrame frame;
+
+    /* Wrong protocol */
+    QVERIFY(frame.parse(data.constData(), data.size(),
+                        NetDMXFrame::E131) == false);
+
+    /* Truncated */
+    QVERIFY(frame.parse(data.constData(), 17, NetDMXFrame::ArtNet) == false);
+    QVERIFY(frame.parse(data.constData(), data.size() - 1,
+                        NetDMXFrame::ArtNet) == false);
+
+    /* Not ArtDmx (ArtPoll) */
+    QByteArray poll(data);
+    poll[9] = char(0x20);
+    QVERIFY(frame.parse(poll.constData(), poll.size(),
+                        NetDMXFrame::ArtNet) == false);
+
+    /* Bad ID */
+    QByteArray id(data);
+    id[0] = 'a';
+    QVERIFY(frame.parse(id.constData(), id.size(),
+                        NetDMXFrame::ArtNet) == false);
+
+    /* Too many channels */
+    QByteArray big(artNetPacket(0, 1, QByteArray(514, 'x')));
+    QVERIFY(frame.parse(big.constData(), big.size(),
+                        NetDMXFrame::ArtNet) == false);
+}
+
+void TestNetDMXFrame::e131()
+{
+    QByteArray cid("0123456789abcdef");
+    QByteArray data(e131Packet(0x0102, cid, 150, 0, QByteArray(512, 'x')));
+    NetDMXFrame frame;
+
+    QVERIFY(frame.parse(data.constData(), data.size(),
+                        NetDMXFrame::E131) == true);
+    QVERIFY(frame.protocol == NetDMXFrame::E131);
+    QCOMPARE(int(frame.universe), 0x0102);
+    QCOMPARE(int(frame.priority), 150);
+    QCOMPARE(frame.sequence, 0);
+    QVERIFY(frame.terminated == false);
+    QCOMPARE(QByteArray(frame.cid, 16), cid);
+    QVERIFY(frame.cid == data.constData() + 22);
+    QCOMPARE(frame.count, 512);
+    QVERIFY(frame.values ==
+            reinterpret_cast<const uchar*> (data.constData() + 126));
+
+    /* Stream terminated */
+    data = e131Packet(1, cid, 100, 5, QByteArray(512, 'x'), 0x40);
+    QVERIFY(frame.parse(data.constData(), data.size(),
+                        NetDMXFrame::E131) == true);
+    QVERIFY(frame.terminated == true);
+
+    /* Priority is clamped */
+    data = e131Packet(1, cid, 255, 5, QByteArray(512, 'x'));
+    QVERIFY(frame.parse(data.constData(), data.size(),
+                        NetDMXFrame::E131) == true);
+    QCOMPARE(int(frame.priority), E131_PRIORITY_MAX);
+}
+
+void TestNetDMXFrame::e131Invalid()
+{
+    QByteArray cid("0123456789abcdef");
+    QByteArray data(e131Packet(1, cid, 100, 0, QByteArray(512, 'x')));
+    NetDMXFrame frame;
+
+    QVERIFY(frame.parse(data.constData(), data.size(),
+                        NetDMXFrame::ArtNet) == false);
+    QVERIFY(frame.parse(data.constData(), 125, NetDMXFrame::E131) == false);
+    QVERIFY(frame.parse(data.constData(), data.size() - 1,
+                        NetDMXFrame::E131) == false);
+
+    /* Preview data */
+    QByteArray preview(e131Packet(1, cid, 100, 0, QByteArray(512, 'x'),
+                                  0x80));
+    QVERIFY(frame.parse(preview.constData(), preview.size(),
+                        NetDMXFrame::E131) == false);
+
+    /* Non-zero start code */
+    QByteArray startCode(data);
+    startCode[125] = char(0xDD);
+    QVERIFY(frame.parse(startCode.constData(), startCode.size(),
+                        NetDMXFrame::E131) == false);
+
+    /* Synchronization packet (different framing vector) */
+    QByteArray sync(data);
+    sync[43] = char(0x01);
+    QVERIFY(frame.parse(sync.constData(), sync.size(),
+                        NetDMXFrame::E131) == false);
+}
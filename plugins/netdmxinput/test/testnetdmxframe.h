@@ -0,0 +1,18 @@
+#ifndef TESTNETDMXFRAME_H
+#define TESTNETDMXFRAME_H
+
+#include <QObject>
+
+class TestNetDMXFrame : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initial();
+    void artNet();
+    void artNetInvalid();
+    void e131();
+    void e131Invalid();
+};
+
+#endif
@@ -0,0 +1,243 @@
+#include <QUdpSocket>
+#include <QByteArray>
+#include <QtTest>
+
+#define protected public
+#include "netdmxmerger.h"
+#include "netdmxinput.h"
+#undef protected
+
+#include "testnetdmxinput.h"
+#include "testpackets.h"
+
+void TestNetDMXInput::send(const QByteArray& datagram, quint16 port)
+{
+    QVERIFY(m_sender->writeDatagram(datagram, QHostAddress::LocalHost, port)
+            == datagram.size());
+
+    /* Wait for the plugin's socket to get it */
+    QUdpSocket* socket = (port == ARTNET_PORT) ? m_plugin->m_artNetSocket
+                                               : m_plugin->m_e131Socket;
+    QVERIFY(socket != NULL);
+    QVERIFY(socket->waitForReadyRead(1000) == true);
+    QTest::qWait(10);
+}
+
+void TestNetDMXInput::initTestCase()
+{
+    m_plugin = new NetDMXInput;
+    m_plugin->init();
+    m_plugin->setUniverses(2);
+
+    m_sender = new QUdpSocket(this);
+    QVERIFY(m_sender->bind() == true);
+}
+
+void TestNetDMXInput::name()
+{
+    QCOMPARE(m_plugin->name(), QString("Art-Net & E1.31 Input"));
+    QVERIFY(m_plugin->canConfigure() == true);
+    QVERIFY(m_plugin->valueTimestamp() == 0);
+}
+
+void TestNetDMXInput::inputs()
+{
+    QSignalSpy spy(m_plugin, SIGNAL(configurationChanged()));
+
+    QStringList inputs(m_plugin->inputs());
+    QCOMPARE(inputs.size(), 4);
+    QCOMPARE(inputs[0], QString("1: Art-Net universe 0"));
+    QCOMPARE(inputs[1], QString("2: Art-Net universe 1"));
+    QCOMPARE(inputs[2], QString("3: E1.31 universe 1"));
+    QCOMPARE(inputs[3], QString("4: E1.31 universe 2"));
+
+    m_plugin->setUniverses(3);
+    QCOMPARE(m_plugin->inputs().size(), 6);
+    QCOMPARE(spy.size(), 1);
+
+    QVERIFY(m_plugin->universeLine(NetDMXFrame::ArtNet, 0) == 0);
+    QVERIFY(m_plugin->universeLine(NetDMXFrame::ArtNet, 2) == 2);
+    QVERIFY(m_plugin->universeLine(NetDMXFrame::ArtNet, 3) == KInputInvalid);
+    QVERIFY(m_plugin->universeLine(NetDMXFrame::E131, 0) == KInputInvalid);
+    QVERIFY(m_plugin->universeLine(NetDMXFrame::E131, 1) == 3);
+    QVERIFY(m_plugin->universeLine(NetDMXFrame::E131, 3) == 5);
+    QVERIFY(m_plugin->universeLine(NetDMXFrame::E131, 4) == KInputInvalid);
+
+    m_plugin->setUniverses(2);
+}
+
+void TestNetDMXInput::openClose()
+{
+    QVERIFY(m_plugin->m_artNetSocket == NULL);
+    QVERIFY(m_plugin->m_e131Socket == NULL);
+
+    m_plugin->open(0);
+    if (m_plugin->m_artNetSocket == NULL)
+        QSKIP("Unable to bind to the Art-Net port", SkipSingle);
+    QVERIFY(m_plugin->m_mergers[0] != NULL);
+    QVERIFY(m_plugin->m_e131Socket == NULL);
+    QVERIFY(m_plugin->m_expiryTimer->isActive() == true);
+
+    m_plugin->open(1);
+    QVERIFY(m_plugin->m_mergers[1] != NULL);
+
+    m_plugin->close(0);
+    QVERIFY(m_plugin->m_mergers[0] == NULL);
+    QVERIFY(m_plugin->m_artNetSocket != NULL);
+
+    m_plugin->close(1);
+    QVERIFY(m_plugin->m_artNetSocket == NULL);
+    QVERIFY(m_plugin->m_expiryTimer->isActive() == false);
+
+    /* Invalid lines are ignored */
+    m_plugin->open(4);
+    QVERIFY(m_plugin->m_artNetSocket == NULL);
+    QVERIFY(m_plugin->m_e131Socket == NULL);
+}
+
+void TestNetDMXInput::artNet()
+{
+    m_plugin->open(1);
+    if (m_plugin->m_artNetSocket == NULL)
+        QSKIP("Unable to bind to the Art-Net port", SkipSingle);
+
+    QSignalSpy spy(m_plugin, SIGNAL(valueChanged(quint32,quint32,uchar)));
+    QByteArray values(512, char(0));
+
+    /* Nothing has changed */
+    send(artNetPacket(1, 1, values), ARTNET_PORT);
+    QCOMPARE(spy.size(), 0);
+
+    /* One fader moves, one signal */
+    values[100] = char(127);
+    send(artNetPacket(1, 2, values), ARTNET_PORT);
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(spy[0][0].toUInt(), quint32(1));
+    QCOMPARE(spy[0][1].toUInt(), quint32(100));
+    QCOMPARE(spy[0][2].value<uchar>(), uchar(127));
+
+    /* Universes that aren't open are ignored */
+    values[100] = char(0);
+    send(artNetPacket(0, 3, values), ARTNET_PORT);
+    QCOMPARE(spy.size(), 1);
+
+    /* Out-of-order frames are ignored */
+    send(artNetPacket(1, 1, values), ARTNET_PORT);
+    QCOMPARE(spy.size(), 1);
+
+    /* Garbage is ignored */
+    send(QByteArray("Art-Net but not really"), ARTNET_PORT);
+    QCOMPARE(spy.size(), 1);
+
+    send(artNetPacket(1, 4, values), ARTNET_PORT);
+    QCOMPARE(spy.size(), 2);
+    QCOMPARE(spy[1][1].toUInt(), quint32(100));
+    QCOMPARE(spy[1][2].value<uchar>(), uchar(0));
+
+    m_plugin->close(1);
+}
+
+void TestNetDMXInput::e131()
+{
+    m_plugin->open(3);
+    if (m_plugin->m_e131Socket == NULL)
+        QSKIP("Unable to bind to the E1.31 port", SkipSingle);
+
+    QSignalSpy spy(m_plugin, SIGNAL(valueChanged(quint32,quint32,uchar)));
+    QByteArray cid("0123456789abcdef");
+    QByteArray values(512, char(0));
+
+    values[0] = char(1);
+    values[511] = char(255);
+    send(e131Packet(2, cid, 100, 0, values), E131_PORT);
+    QCOMPARE(spy.size(), 2);
+    QCOMPARE(spy[0][0].toUInt(), quint32(3));
+    QCOMPARE(spy[0][1].toUInt(), quint32(0));
+    QCOMPARE(spy[0][2].value<uchar>(), uchar(1));
+    QCOMPARE(spy[1][1].toUInt(), quint32(511));
+    QCOMPARE(spy[1][2].value<uchar>(), uchar(255));
+
+    /* Preview data is ignored */
+    send(e131Packet(2, cid, 100, 1, QByteArray(512, 'x'), 0x80), E131_PORT);
+    QCOMPARE(spy.size(), 2);
+
+    /* Source terminates; values stay */
+    send(e131Packet(2, cid, 100, 2, values, 0x40), E131_PORT);
+    QCOMPARE(spy.size(), 2);
+    QCOMPARE(m_plugin->m_mergers[3]->sources(), 0);
+
+    m_plugin->close(3);
+    QVERIFY(m_plugin->m_e131Socket == NULL);
+}
+
+void TestNetDMXInput::merging()
+{
+    m_plugin->open(2);
+    if (m_plugin->m_e131Socket == NULL)
+        QSKIP("Unable to bind to the E1.31 port", SkipSingle);
+
+    QSignalSpy spy(m_plugin, SIGNAL(valueChanged(quint32,quint32,uchar)));
+    QByteArray low(512, char(0));
+    QByteArray high(512, char(0));
+
+    low[0] = char(200);
+    send(e131Packet(1, QByteArray(16, 'L'), 100, 0, low), E131_PORT);
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(spy[0][2].value<uchar>(), uchar(200));
+
+    /* Higher priority source wins */
+    high[0] = char(50);
+    send(e131Packet(1, QByteArray(16, 'H'), 150, 0, high), E131_PORT);
+    QCOMPARE(spy.size(), 2);
+    QCOMPARE(spy[1][2].value<uchar>(), uchar(50));
+
+    /* Lower priority source is ignored */
+    low[0] = char(255);
+    send(e131Packet(1, QByteArray(16, 'L'), 100, 1, low), E131_PORT);
+    QCOMPARE(spy.size(), 2);
+
+    /* Until the higher one goes away */
+    send(e131Packet(1, QByteArray(16, 'H'), 150, 1, high, 0x40), E131_PORT);
+    QCOMPARE(m_plugin->m_mergers[2]->sources(), 1);
+    QCOMPARE(spy.size(), 3);
+    QCOMPARE(spy[2][2].value<uchar>(), uchar(255));
+
+    m_plugin->close(2);
+}
+
+void TestNetDMXInput::reconfigure()
+{
+    m_plugin->open(1);
+    if (m_plugin->m_artNetSocket == NULL)
+        QSKIP("Unable to bind to the Art-Net port", SkipSingle);
+
+    /* Open lines survive a new line count */
+    m_plugin->setUniverses(3);
+    QVERIFY(m_plugin->m_mergers[1] != NULL);
+    QVERIFY(m_plugin->m_artNetSocket != NULL);
+
+    QSignalSpy spy(m_plugin, SIGNAL(valueChanged(quint32,quint32,uchar)));
+    QByteArray values(512, char(0));
+    values[10] = char(42);
+    send(artNetPacket(1, 1, values), ARTNET_PORT);
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(spy[0][0].toUInt(), quint32(1));
+    QCOMPARE(spy[0][1].toUInt(), quint32(10));
+    QCOMPARE(spy[0][2].value<uchar>(), uchar(42));
+
+    /* Lines that are gone aren't reopened */
+    m_plugin->open(5);
+    m_plugin->setUniverses(2);
+    QCOMPARE(m_plugin->m_mergers.size(), 4);
+    QVERIFY(m_plugin->m_mergers[1] != NULL);
+    QVERIFY(m_plugin->m_e131Socket == NULL);
+
+    m_plugin->close(1);
+    QVERIFY(m_plugin->m_artNetSocket == NULL);
+}
+
+void TestNetDMXInput::cleanupTestCase()
+{
+    delete m_plugin;
+    m_plugin = NULL;
+}
@@ -0,0 +1,35 @@
+#ifndef TESTNETDMXINPUT_H
+#define TESTNETDMXINPUT_H
+
+#include <QObject>
+
+class NetDMXInput;
+class QUdpSocket;
+
+class TestNetDMXInput : public QObject
+{
+    Q_OBJECT
+
+protected:
+    /** Send a datagram to the local host and let the plugin read it */
+    void send(const QByteArray& datagram, quint16 port);
+
+private slots:
+    void initTestCase();
+
+    void name();
+    void inputs();
+    void openClose();
+    void artNet();
+    void e131();
+    void merging();
+    void reconfigure();
+
+    void cleanupTestCase();
+
+private:
+    NetDMXInput* m_plugin;
+    QUdpSocket* m_sender;
+};
+
+#endif
@@ -0,0 +1,229 @@
+#include <QByteArray>
+#include <QtTest>
+
+#include "netdmxmerger.h"
+#include "testnetdmxmerger.h"
+
+#define SEC Q_INT64_C(1000000000)
+
+static const uchar* bytes(const QByteArray& array)
+{
+    return reinterpret_cast<const uchar*> (array.constData());
+}
+
+void TestNetDMXMerger::initial()
+{
+    NetDMXMerger merger;
+    QCOMPARE(NetDMXMerger::channels(), 512);
+    QVERIFY(NetDMXMerger::sourceTimeout() == 25 * SEC / 10);
+    QCOMPARE(merger.sources(), 0);
+    QCOMPARE(merger.changed().size(), 0);
+    for (int i = 0; i < 512; i++)
+        QCOMPARE(int(merger.values()[i]), 0);
+}
+
+void TestNetDMXMerger::singleSource()
+{
+    NetDMXMerger merger;
+    QByteArray frame(512, char(0));
+
+    /* A frame of zeros changes nothing */
+    QVERIFY(merger.update("A", 100, 1, bytes(frame), 512, 0) == true);
+    QCOMPARE(merger.sources(), 1);
+    QCOMPARE(merger.changed().size(), 0);
+
+    /* One fader moves, one channel changes */
+    frame[42] = char(200);
+    QVERIFY(merger.update("A", 100, 2, bytes(frame), 512, 0) == true);
+    QCOMPARE(merger.changed().size(), 1);
+    QCOMPARE(merger.changed()[0], 42);
+    QCOMPARE(int(merger.values()[42]), 200);
+
+    /* Same frame again, no changes */
+    QVERIFY(merger.update("A", 100, 3, bytes(frame), 512, 0) == true);
+    QCOMPARE(merger.changed().size(), 0);
+
+    /* Changes on both ends of the universe, in channel order */
+    frame[0] = char(1);
+    frame[511] = char(2);
+    frame[42] = char(0);
+    QVERIFY(merger.update("A", 100, 4, bytes(frame), 512, 0) == true);
+    QCOMPARE(merger.changed().size(), 3);
+    QCOMPARE(merger.changed()[0], 0);
+    QCOMPARE(merger.changed()[1], 42);
+    QCOMPARE(merger.changed()[2], 511);
+    QCOMPARE(int(merger.values()[0]), 1);
+    QCOMPARE(int(merger.values()[42]), 0);
+    QCOMPARE(int(merger.values()[511]), 2);
+}
+
+void TestNetDMXMerger::shortFrame()
+{
+    NetDMXMerger merger;
+
+    QVERIFY(merger.update("A", 100, -1, bytes(QByteArray(512, 'x')), 512, 0)
+            == true);
+    QCOMPARE(merger.changed().size(), 512);
+
+    /* Missing channels are zero */
+    QVERIFY(merger.update("A", 100, -1, bytes(QByteArray(10, 'x')), 10, 0)
+            == true);
+    QCOMPARE(merger.changed().size(), 502);
+    QCOMPARE(int(merger.values()[9]), int('x'));
+    QCOMPARE(int(merger.values()[10]), 0);
+}
+
+void TestNetDMXMerger::sequence()
+{
+    NetDMXMerger merger;
+    QByteArray frame(512, char(0));
+
+    frame[0] = char(10);
+    QVERIFY(merger.update("A", 100, 100, bytes(frame), 512, 0) == true);
+
+    /* Late and duplicate frames are discarded */
+    frame[0] = char(20);
+    QVERIFY(merger.update("A", 100, 99, bytes(frame), 512, 0) == false);
+    QVERIFY(merger.update("A", 100, 100, bytes(frame), 512, 0) == false);
+    QCOMPARE(merger.changed().size(), 0);
+    QCOMPARE(int(merger.values()[0]), 10);
+
+    /* Wrap-around is in order */
+    QVERIFY(merger.update("A", 100, 255, bytes(frame), 512, 0) == true);
+    QVERIFY(merger.update("A", 100, 0, bytes(frame), 512, 0) == true);
+    QVERIFY(merger.update("A", 100, 1, bytes(frame), 512, 0) == true);
+
+    /* A big jump backwards means that the source has restarted */
+    frame[0] = char(30);
+    QVERIFY(merger.update("A", 100, 200, bytes(frame), 512, 0) == true);
+    QCOMPARE(int(merger.values()[0]), 30);
+
+    /* Frames without sequence are always accepted */
+    QVERIFY(merger.update("A", 100, -1, bytes(frame), 512, 0) == true);
+    QVERIFY(merger.update("A", 100, -1, bytes(frame), 512, 0) == true);
+}
+
+void TestNetDMXMerger::htp()
+{
+    NetDMXMerger merger;
+    QByteArray a(512, char(0));
+    QByteArray b(512, char(0));
+
+    a[0] = char(100);
+    a[1] = char(50);
+    QVERIFY(merger.update("A", 100, -1, bytes(a), 512, 0) == true);
+    QCOMPARE(merger.changed().size(), 2);
+
+    /* A second source with the same priority: highest value wins */
+    b[1] = char(150);
+    b[2] = char(10);
+    QVERIFY(merger.update("B", 100, -1, bytes(b), 512, 0) == true);
+    QCOMPARE(merger.sources(), 2);
+    QCOMPARE(merger.changed().size(), 2);
+    QCOMPARE(merger.changed()[0], 1);
+    QCOMPARE(merger.changed()[1], 2);
+    QCOMPARE(int(merger.values()[0]), 100);
+    QCOMPARE(int(merger.values()[1]), 150);
+    QCOMPARE(int(merger.values()[2]), 10);
+
+    /* First source's values were kept even though it was alone before */
+    b[1] = char(0);
+    QVERIFY(merger.update("B", 100, -1, bytes(b), 512, 0) == true);
+    QCOMPARE(merger.changed().size(), 1);
+    QCOMPARE(int(merger.values()[1]), 50);
+
+    a[0] = char(0);
+    QVERIFY(merger.update("A", 100, -1, bytes(a), 512, 0) == true);
+    QCOMPARE(merger.changed().size(), 1);
+    QCOMPARE(int(merger.values()[0]), 0);
+}
+
+void TestNetDMXMerger::priority()
+{
+    NetDMXMerger merger;
+    QByteArray low(512, char(200));
+    QByteArray high(512, char(0));
+
+    QVERIFY(merger.update("L", 100, -1, bytes(low), 512, 0) == true);
+    QCOMPARE(int(merger.values()[0]), 200);
+
+    /* A higher priority source takes over completely, even with lower
+       values */
+    high[0] = char(5);
+    QVERIFY(merger.update("H", 150, -1, bytes(high), 512, 0) == true);
+    QCOMPARE(merger.changed().size(), 512);
+    QCOMPARE(int(merger.values()[0]), 5);
+    QCOMPARE(int(merger.values()[1]), 0);
+
+    /* Lower priority source changes nothing */
+    low.fill(char(255));
+    QVERIFY(merger.update("L", 100, -1, bytes(low), 512, 0) == true);
+    QCOMPARE(merger.changed().size(), 0);
+
+    /* Until it raises its priority */
+    QVERIFY(merger.update("L", 150, -1, bytes(low), 512, 0) == true);
+    QCOMPARE(merger.changed().size(), 512);
+    QCOMPARE(int(merger.values()[0]), 255);
+}
+
+void TestNetDMXMerger::remove()
+{
+    NetDMXMerger merger;
+    QByteArray low(512, char(200));
+    QByteArray high(512, char(10));
+
+    QVERIFY(merger.update("L", 100, -1, bytes(low), 512, 0) == true);
+    QVERIFY(merger.update("H", 150, -1, bytes(high), 512, 0) == true);
+    QCOMPARE(int(merger.values()[0]), 10);
+
+    QVERIFY(merger.remove("X") == false);
+    QCOMPARE(merger.changed().size(), 0);
+
+    /* Lower priority source takes over again */
+    QVERIFY(merger.remove("H") == true);
+    QCOMPARE(merger.sources(), 1);
+    QCOMPARE(merger.changed().size(), 512);
+    QCOMPARE(int(merger.values()[0]), 200);
+
+    /* Values stay when the last source is gone */
+    QVERIFY(merger.remove("L") == true);
+    QCOMPARE(merger.sources(), 0);
+    QCOMPARE(merger.changed().size(), 0);
+    QCOMPARE(int(merger.values()[0]), 200);
+}
+
+void TestNetDMXMerger::expire()
+{
+    NetDMXMerger merger;
+    QByteArray a(512, char(1));
+    QByteArray b(512, char(2));
+
+    QVERIFY(merger.update("A", 100, -1, bytes(a), 512, 0) == true);
+    QVERIFY(merger.update("B", 100, -1, bytes(b), 512, 2 * SEC) == true);
+    QCOMPARE(int(merger.values()[0]), 2);
+
+    QVERIFY(merger.expire(2 * SEC) == false);
+    QCOMPARE(merger.sources(), 2);
+
+    /* A has been quiet for too long */
+    QVERIFY(merger.expire(3 * SEC) == true);
+    QCOMPARE(merger.sources(), 1);
+    QCOMPARE(merger.changed().size(), 0);
+
+    /* B too; values stay */
+    QVERIFY(merger.expire(5 * SEC) == true);
+    QCOMPARE(merger.sources(), 0);
+    QCOMPARE(int(merger.values()[0]), 2);
+}
+
+void TestNetDMXMerger::clear()
+{
+    NetDMXMerger merger;
+    QByteArray a(512, char(1));
+
+    QVERIFY(merger.update("A", 100, -1, bytes(a), 512, 0) == true);
+    merger.clear();
+    QCOMPARE(merger.sources(), 0);
+    QCOMPARE(merger.changed().size(), 0);
+    QCOMPARE(int(merger.values()[0]), 0);
+}
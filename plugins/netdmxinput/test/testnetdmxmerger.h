@@ -0,0 +1,22 @@
+#ifndef TESTNETDMXMERGER_H
+#define TESTNETDMXMERGER_H
+
+#include <QObject>
+
+class TestNetDMXMerger : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initial();
+    void singleSource();
+    void shortFrame();
+    void sequence();
+    void htp();
+    void priority();
+    void remove();
+    void expire();
+    void clear();
+};
+
+#endif
@@ -0,0 +1,54 @@
+#include <string.h>
+
+#include "testpackets.h"
+
+static void writeShort(QByteArray& data, int offset, quint16 value)
+{
+    data[offset] = char(value >> 8);
+    data[offset + 1] = char(value & 0xFF);
+}
+
+QByteArray artNetPacket(quint16 universe, uchar sequence,
+                        const QByteArray& values)
+{
+    QByteArray data(18, char(0));
+    memcpy(data.data(), "Art-Net", 8);
+    data[8] = char(0x00); /* OpDmx, little-endian */
+    data[9] = char(0x50);
+    writeShort(data, 10, 14);
+    data[12] = char(sequence);
+    data[14] = char(universe & 0xFF);
+    data[15] = char(universe >> 8);
+    writeShort(data, 16, values.size());
+    return data + values;
+}
+
+QByteArray e131Packet(quint16 universe, const QByteArray& cid, uchar priority,
+                      uchar sequence, const QByteArray& values,
+                      uchar options)
+{
+    QByteArray data(126, char(0));
+    int size = data.size() + values.size();
+
+    writeShort(data, 0, 0x0010);
+    memcpy(data.data() + 4, "ASC-E1.17\0\0\0", 12);
+    writeShort(data, 16, 0x7000 | (size - 16));
+    writeShort(data, 20, 0x0004);
+    memcpy(data.data() + 22, cid.constData(), 16);
+
+    writeShort(data, 38, 0x7000 | (size - 38));
+    writeShort(data, 42, 0x0002);
+    memcpy(data.data() + 44, "Test", 4);
+    data[108] = char(priority);
+    data[111] = char(sequence);
+    data[112] = char(options);
+    writeShort(data, 113, universe);
+
+    writeShort(data, 115, 0x7000 | (size - 115));
+    data[117] = char(0x02);
+    data[118] = char(0xA1);
+    writeShort(data, 121, 0x0001);
+    writeShort(data, 123, values.size() + 1);
+
+    return data + values;
+}
@@ -0,0 +1,15 @@
+#ifndef TESTPACKETS_H
+#define TESTPACKETS_H
+
+#include <QByteArray>
+
+/** Build an Art-Net ArtDmx packet */
+QByteArray artNetPacket(quint16 universe, uchar sequence,
+                        const QByteArray& values);
+
+/** Build an E1.31 data packet */
+QByteArray e131Packet(quint16 universe, const QByteArray& cid, uchar priority,
+                      uchar sequence, const QByteArray& values,
+                      uchar options = 0);
+
+#endif
@@ -0,0 +1,331 @@
+/*
+  Q Light Controller
+  netdmxout.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QMutexLocker>
+#include <QInputDialog>
+#include <QStringList>
+#include <QLineEdit>
+#include <QSettings>
+#include <QString>
+#include <QDebug>
+#include <QUuid>
+
+#include "netdmxsender.h"
+#include "netdmxout.h"
+
+#define DEFAULT_UNIVERSES 4
+
+/*****************************************************************************
+ * Initialization
+ *****************************************************************************/
+
+NetDMXOut::~NetDMXOut()
+{
+    QMutexLocker locker(&m_mutex);
+    destroyLines();
+    delete m_sender;
+    m_sender = NULL;
+}
+
+void NetDMXOut::init()
+{
+    QSettings settings;
+
+    m_universes = settings.value(SETTINGS_UNIVERSES, DEFAULT_UNIVERSES).toInt();
+    m_universes = CLAMP(m_universes, 1, int(KUniverseCountMax));
+
+    QString address = settings.value(SETTINGS_ADDRESS).toString();
+    if (address.isEmpty() == false)
+        m_address.setAddress(address);
+
+    /* E1.31 receivers tell sources apart by CID, so it's kept the same */
+    m_cid = settings.value(SETTINGS_CID).toByteArray();
+    if (m_cid.size() != E131_CID_SIZE)
+    {
+        QUuid uuid(QUuid::createUuid());
+        m_cid.clear();
+        for (int i = 3; i >= 0; i--)
+            m_cid.append(char((uuid.data1 >> (i * 8)) & 0xFF));
+        m_cid.append(char(uuid.data2 >> 8)).append(char(uuid.data2 & 0xFF));
+        m_cid.append(char(uuid.data3 >> 8)).append(char(uuid.data3 & 0xFF));
+        m_cid.append(reinterpret_cast<const char*> (uuid.data4), 8);
+        settings.setValue(SETTINGS_CID, m_cid);
+    }
+
+    m_sender = new NetDMXSender(2 * KUniverseCountMax);
+
+    QMutexLocker locker(&m_mutex);
+    createLines();
+}
+
+QString NetDMXOut::name()
+{
+    return QString("Art-Net & E1.31 Output");
+}
+
+/*****************************************************************************
+ * Outputs
+ *****************************************************************************/
+
+void NetDMXOut::open(quint32 output)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (output >= quint32(m_open.size()))
+        return;
+
+    if (m_sender->open() == true)
+        m_open[output] = true;
+}
+
+void NetDMXOut::close(quint32 output)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (output >= quint32(m_open.size()))
+        return;
+
+    m_open[output] = false;
+
+    /* Keep the socket only as long as there are open lines */
+    if (m_open.contains(true) == false)
+    {
+        m_sender->close();
+        m_queued.fill(false);
+    }
+}
+
+QStringList NetDMXOut::outputs()
+{
+    QStringList list;
+
+    for (int i = 0; i < 2 * m_universes; i++)
+    {
+        if (lineProtocol(i) == NetDMXPacket::ArtNet)
+        {
+            list << QString("%1: Art-Net universe %2").arg(i + 1)
+                                                      .arg(lineUniverse(i));
+        }
+        else
+        {
+            list << QString("%1: E1.31 universe %2").arg(i + 1)
+                                                    .arg(lineUniverse(i));
+        }
+    }
+
+    return list;
+}
+
+QString NetDMXOut::infoText(quint32 output)
+{
+    QString str;
+
+    str += QString("<HTML>");
+    str += QString("<HEAD>");
+    str += QString("<TITLE>%1</TITLE>").arg(name());
+    str += QString("</HEAD>");
+    str += QString("<BODY>");
+
+    if (output == KOutputInvalid)
+    {
+        str += QString("<H3>%1</H3>").arg(name());
+        str += QString("<P>");
+        str += tr("This plugin sends DMX universes over the network using "
+                  "the Art-Net and E1.31 (sACN) protocols.");
+        str += QString(" ");
+        if (m_address.isNull() == true)
+        {
+            str += tr("Art-Net is broadcast and E1.31 is multicast to each "
+                      "universe's own group.");
+        }
+        else
+        {
+            str += tr("All universes are sent to %1.")
+                   .arg(m_address.toString());
+        }
+        str += QString("</P>");
+    }
+    else if (output < quint32(2 * m_universes))
+    {
+        QMutexLocker locker(&m_mutex);
+
+        str += QString("<H3>%1</H3>").arg(outputs()[output]);
+        str += QString("<P>");
+        str += tr("Destination: %1, port %2")
+               .arg(m_destinations[output].toString())
+               .arg(NetDMXPacket::port(lineProtocol(output)));
+        str += QString("<BR>");
+        if (m_open[output] == true)
+            str += tr("Packets sent by all outputs: %1")
+                   .arg(m_sender->packetsSent());
+        else
+            str += tr("This output is not open.");
+        str += QString("</P>");
+    }
+
+    str += QString("</BODY>");
+    str += QString("</HTML>");
+
+    return str;
+}
+
+void NetDMXOut::outputDMX(quint32 output, const QByteArray& universe)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (output >= quint32(m_open.size()) || m_open[output] == false)
+        return;
+
+    m_packets[output]->setValues(universe);
+
+    /* A line written twice before flushing is sent once, with the newest
+       values already in its packet */
+    if (m_queued[output] == false)
+    {
+        m_sender->queue(m_packets[output], m_destinations[output],
+                        NetDMXPacket::port(lineProtocol(output)));
+        m_queued[output] = true;
+    }
+}
+
+void NetDMXOut::flushDMX()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_sender->queued() == 0)
+        return;
+
+    m_sender->send();
+    m_queued.fill(false);
+}
+
+NetDMXPacket::Protocol NetDMXOut::lineProtocol(quint32 output) const
+{
+    if (output < quint32(m_universes))
+        return NetDMXPacket::ArtNet;
+    else
+        return NetDMXPacket::E131;
+}
+
+quint16 NetDMXOut::lineUniverse(quint32 output) const
+{
+    /* Art-Net port-addresses start from 0, E1.31 universes from 1 */
+    if (output < quint32(m_universes))
+        return quint16(output);
+    else
+        return quint16(output - m_universes + 1);
+}
+
+void NetDMXOut::createLines()
+{
+    /* Packets may be queued; they must be gone before the lines. Line
+       numbers may now mean different universes, or even protocols, so
+       all lines start closed and the host reopens the ones it uses. */
+    m_sender->close();
+    destroyLines();
+
+    int lines = 2 * m_universes;
+    m_open.fill(false, lines);
+    m_queued.fill(false, lines);
+
+    for (int i = 0; i < lines; i++)
+    {
+        NetDMXPacket::Protocol protocol = lineProtocol(i);
+        m_packets << new NetDMXPacket(protocol, lineUniverse(i), m_cid,
+                                      QString("Q Light Controller"));
+        if (m_address.isNull() == true)
+            m_destinations << NetDMXPacket::defaultAddress(protocol,
+                                                           lineUniverse(i));
+        else
+            m_destinations << m_address;
+    }
+}
+
+void NetDMXOut::destroyLines()
+{
+    while (m_packets.isEmpty() == false)
+        delete m_packets.takeFirst();
+    m_destinations.clear();
+}
+
+/*****************************************************************************
+ * Configuration
+ *****************************************************************************/
+
+void NetDMXOut::configure()
+{
+    bool ok = false;
+
+    int universes = QInputDialog::getInt(NULL, name(),
+                        tr("Number of universes for both Art-Net and E1.31"),
+                        m_universes, 1, KUniverseCountMax, 1, &ok);
+    if (ok == false)
+        return;
+
+    QString address = QInputDialog::getText(NULL, name(),
+                        tr("Unicast address for all universes.\n"
+                           "Leave empty to broadcast Art-Net and to multicast "
+                           "E1.31."),
+                        QLineEdit::Normal,
+                        m_address.isNull() ? QString() : m_address.toString(),
+                        &ok);
+    if (ok == false)
+        return;
+
+    QHostAddress host;
+    if (address.trimmed().isEmpty() == false &&
+        host.setAddress(address.trimmed()) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Invalid address:" << address;
+        return;
+    }
+
+    setConfiguration(universes, host);
+}
+
+bool NetDMXOut::canConfigure()
+{
+    return true;
+}
+
+void NetDMXOut::setConfiguration(int universes, const QHostAddress& address)
+{
+    m_mutex.lock();
+    m_universes = CLAMP(universes, 1, int(KUniverseCountMax));
+    m_address = address;
+    createLines();
+    m_mutex.unlock();
+
+    QSettings settings;
+    settings.setValue(SETTINGS_UNIVERSES, m_universes);
+    if (m_address.isNull() == true)
+        settings.remove(SETTINGS_ADDRESS);
+    else
+        settings.setValue(SETTINGS_ADDRESS, m_address.toString());
+
+    emit configurationChanged();
+}
+
+/*****************************************************************************
+ * Plugin export
+ ****************************************************************************/
+
+Q_EXPORT_PLUGIN2(netdmxout, NetDMXOut)
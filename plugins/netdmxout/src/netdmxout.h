@@ -0,0 +1,156 @@
+/*
+  Q Light Controller
+  netdmxout.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef NETDMXOUT_H
+#define NETDMXOUT_H
+
+#include <QHostAddress>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QString>
+#include <QMutex>
+#include <QList>
+
+#include "qlcoutplugin.h"
+#include "netdmxpacket.h"
+
+class NetDMXSender;
+
+#define SETTINGS_UNIVERSES "NetDMXOut/universes"
+#define SETTINGS_ADDRESS "NetDMXOut/address"
+#define SETTINGS_CID "NetDMXOut/cid"
+
+/**
+ * NetDMXOut sends DMX universes over the network as Art-Net and E1.31
+ * (sACN). The plugin provides the same number of output lines for both
+ * protocols: the first half of the lines are Art-Net universes, starting
+ * from port-address 0, and the second half are E1.31 universes, starting
+ * from universe 1.
+ *
+ * By default, Art-Net is broadcast and E1.31 is multicast to each
+ * universe's own group. Alternatively, all lines can be unicast to a
+ * single configured address.
+ *
+ * Universes written with outputDMX() are only copied into their packets;
+ * all of them are sent together in one batch from flushDMX().
+ */
+class NetDMXOut : public QLCOutPlugin
+{
+    Q_OBJECT
+    Q_INTERFACES(QLCOutPlugin)
+
+    /*********************************************************************
+     * Initialization
+     *********************************************************************/
+public:
+    /** @reimp */
+    virtual ~NetDMXOut();
+
+    /** @reimp */
+    void init();
+
+    /** @reimp */
+    QString name();
+
+    /*********************************************************************
+     * Outputs
+     *********************************************************************/
+public:
+    /** @reimp */
+    void open(quint32 output = 0);
+
+    /** @reimp */
+    void close(quint32 output = 0);
+
+    /** @reimp */
+    QStringList outputs();
+
+    /** @reimp */
+    QString infoText(quint32 output = KOutputInvalid);
+
+    /** @reimp */
+    void outputDMX(quint32 output, const QByteArray& universe);
+
+    /** @reimp */
+    void flushDMX();
+
+protected:
+    /** Get the protocol used by the given output line */
+    NetDMXPacket::Protocol lineProtocol(quint32 output) const;
+
+    /** Get the protocol's universe number for the given output line */
+    quint16 lineUniverse(quint32 output) const;
+
+    /** (Re)create packets and destinations for all output lines, closing
+        all of them. m_mutex must be held. */
+    void createLines();
+
+    /** Destroy all packets. m_mutex must be held. */
+    void destroyLines();
+
+protected:
+    /** Number of output lines per protocol */
+    int m_universes;
+
+    /** Unicast destination for all lines, or null for the defaults */
+    QHostAddress m_address;
+
+    /** E1.31 component identifier of this QLC instance */
+    QByteArray m_cid;
+
+    /** One packet, destination and state flags for each output line */
+    QList <NetDMXPacket*> m_packets;
+    QList <QHostAddress> m_destinations;
+    QVector <bool> m_open;
+    QVector <bool> m_queued;
+
+    /** Sends the queued packets of all lines in one batch */
+    NetDMXSender* m_sender;
+
+    /** Guards everything above; outputDMX() and flushDMX() are called
+        by an output worker thread, everything else by the main thread */
+    QMutex m_mutex;
+
+    /*********************************************************************
+     * Configuration
+     *********************************************************************/
+public:
+    /** @reimp */
+    void configure();
+
+    /** @reimp */
+    bool canConfigure();
+
+    /**
+     * Set the number of output lines per protocol and the destination
+     * address, and save them to settings. All lines are closed, since
+     * their numbers may now stand for other universes; the host reopens
+     * the lines it has patched when it gets configurationChanged().
+     *
+     * @param universes Number of lines per protocol (1-KUniverseCountMax)
+     * @param address A unicast destination for all lines, or a null
+     *                address to use the protocols' default destinations
+     */
+    void setConfiguration(int universes, const QHostAddress& address);
+};
+
+#endif
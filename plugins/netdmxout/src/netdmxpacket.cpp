@@ -0,0 +1,193 @@
+/*
+  Q Light Controller
+  netdmxpacket.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <string.h>
+
+#include "netdmxpacket.h"
+
+/* Number of DMX values in each packet */
+#define NETDMX_CHANNELS 512
+
+/* Write a 16bit value in network byte order */
+static inline void writeShort(char* data, int offset, quint16 value)
+{
+    data[offset] = char(value >> 8);
+    data[offset + 1] = char(value & 0xFF);
+}
+
+/* Write a 32bit value in network byte order */
+static inline void writeLong(char* data, int offset, quint32 value)
+{
+    writeShort(data, offset, quint16(value >> 16));
+    writeShort(data, offset + 2, quint16(value & 0xFFFF));
+}
+
+/* Write an E1.31 PDU flags & length field for a PDU starting at offset */
+static inline void writeFlagsLength(char* data, int offset, int size)
+{
+    writeShort(data, offset, quint16(0x7000 | (size - offset)));
+}
+
+/****************************************************************************
+ * Initialization
+ ****************************************************************************/
+
+NetDMXPacket::NetDMXPacket(Protocol protocol, quint16 universe,
+                           const QByteArray& cid, const QString& source)
+    : m_protocol(protocol)
+    , m_universe(universe)
+    , m_data(NULL)
+    , m_valuesOffset(0)
+    , m_sequenceOffset(0)
+    , m_sequence(0)
+{
+    if (m_protocol == ArtNet)
+        initArtNet();
+    else
+        initE131(cid, source);
+}
+
+NetDMXPacket::~NetDMXPacket()
+{
+}
+
+NetDMXPacket::Protocol NetDMXPacket::protocol() const
+{
+    return m_protocol;
+}
+
+quint16 NetDMXPacket::universe() const
+{
+    return m_universe;
+}
+
+quint16 NetDMXPacket::port(Protocol protocol)
+{
+    if (protocol == ArtNet)
+        return ARTNET_PORT;
+    else
+        return E131_PORT;
+}
+
+QHostAddress NetDMXPacket::defaultAddress(Protocol protocol, quint16 universe)
+{
+    if (protocol == ArtNet)
+        return QHostAddress(QHostAddress::Broadcast);
+    else
+        return QHostAddress((quint32(239) << 24) | (quint32(255) << 16) |
+                            universe);
+}
+
+void NetDMXPacket::initArtNet()
+{
+    m_packet = QByteArray(ARTNET_HEADER_SIZE + NETDMX_CHANNELS, char(0));
+    m_data = m_packet.data();
+
+    /* ID */
+    memcpy(m_data, "Art-Net", 8);
+
+    /* OpCode is the only little-endian field */
+    m_data[8] = char(ARTNET_OPCODE_DMX & 0xFF);
+    m_data[9] = char(ARTNET_OPCODE_DMX >> 8);
+
+    writeShort(m_data, 10, ARTNET_VERSION);
+
+    /* 12: Sequence, 13: Physical */
+    m_sequenceOffset = 12;
+
+    /* Port-address: SubUni & Net */
+    m_data[14] = char(m_universe & 0xFF);
+    m_data[15] = char((m_universe >> 8) & 0x7F);
+
+    writeShort(m_data, 16, NETDMX_CHANNELS);
+
+    m_valuesOffset = ARTNET_HEADER_SIZE;
+}
+
+void NetDMXPacket::initE131(const QByteArray& cid, const QString& source)
+{
+    m_packet = QByteArray(E131_HEADER_SIZE + NETDMX_CHANNELS, char(0));
+    m_data = m_packet.data();
+    int size = m_packet.size();
+
+    /* Root layer */
+    writeShort(m_data, 0, 0x0010); /* Preamble size */
+    writeShort(m_data, 2, 0x0000); /* Postamble size */
+    memcpy(m_data + 4, "ASC-E1.17\0\0\0", 12);
+    writeFlagsLength(m_data, 16, size);
+    writeLong(m_data, 18, 0x00000004); /* VECTOR_ROOT_E131_DATA */
+    memcpy(m_data + 22, cid.constData(), qMin(cid.size(), E131_CID_SIZE));
+
+    /* Framing layer */
+    writeFlagsLength(m_data, 38, size);
+    writeLong(m_data, 40, 0x00000002); /* VECTOR_E131_DATA_PACKET */
+    QByteArray name(source.toUtf8().left(E131_SOURCE_SIZE - 1));
+    memcpy(m_data + 44, name.constData(), name.size());
+    m_data[108] = char(E131_PRIORITY);
+    writeShort(m_data, 109, 0); /* Synchronization address */
+    m_sequenceOffset = 111;
+    m_data[112] = 0; /* Options */
+    writeShort(m_data, 113, m_universe);
+
+    /* DMP layer */
+    writeFlagsLength(m_data, 115, size);
+    m_data[117] = char(0x02); /* VECTOR_DMP_SET_PROPERTY */
+    m_data[118] = char(0xA1); /* Address & data type */
+    writeShort(m_data, 119, 0x0000); /* First property address */
+    writeShort(m_data, 121, 0x0001); /* Address increment */
+    writeShort(m_data, 123, NETDMX_CHANNELS + 1); /* Property value count */
+    m_data[125] = 0; /* DMX start code */
+
+    m_valuesOffset = E131_HEADER_SIZE;
+}
+
+/****************************************************************************
+ * Values
+ ****************************************************************************/
+
+void NetDMXPacket::setValues(const QByteArray& values)
+{
+    int count = qMin(values.size(), NETDMX_CHANNELS);
+    memcpy(m_data + m_valuesOffset, values.constData(), count);
+    if (count < NETDMX_CHANNELS)
+        memset(m_data + m_valuesOffset + count, 0, NETDMX_CHANNELS - count);
+
+    /* Zero means "no sequencing" in Art-Net, so it's skipped there */
+    m_sequence++;
+    if (m_sequence == 0 && m_protocol == ArtNet)
+        m_sequence = 1;
+    m_data[m_sequenceOffset] = char(m_sequence);
+}
+
+uchar NetDMXPacket::sequence() const
+{
+    return m_sequence;
+}
+
+const char* NetDMXPacket::data() const
+{
+    return m_data;
+}
+
+int NetDMXPacket::size() const
+{
+    return m_packet.size();
+}
@@ -0,0 +1,148 @@
+/*
+  Q Light Controller
+  netdmxpacket.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef NETDMXPACKET_H
+#define NETDMXPACKET_H
+
+#include <QHostAddress>
+#include <QByteArray>
+#include <QString>
+
+#include "qlctypes.h"
+
+/****************************************************************************
+ * Art-Net (ArtDmx)
+ ****************************************************************************/
+
+#define ARTNET_PORT          6454
+#define ARTNET_HEADER_SIZE   18
+#define ARTNET_OPCODE_DMX    0x5000
+#define ARTNET_VERSION       14
+
+/****************************************************************************
+ * E1.31 (sACN)
+ ****************************************************************************/
+
+#define E131_PORT            5568
+#define E131_HEADER_SIZE     126
+#define E131_CID_SIZE        16
+#define E131_SOURCE_SIZE     64
+#define E131_PRIORITY        100
+#define E131_UNIVERSE_MAX    63999
+
+/****************************************************************************
+ * NetDMXPacket
+ ****************************************************************************/
+
+/**
+ * NetDMXPacket is a complete, ready-to-send network packet carrying one DMX
+ * universe, either as Art-Net or E1.31. The whole packet is allocated and
+ * its headers are filled once, at construction. After that, setValues()
+ * only copies the channel values into place and advances the sequence
+ * number, so nothing is allocated while sending.
+ */
+class QLC_DECLSPEC NetDMXPacket
+{
+public:
+    enum Protocol
+    {
+        ArtNet,
+        E131
+    };
+
+    /**
+     * Create a new packet
+     *
+     * @param protocol The protocol to use
+     * @param universe Art-Net port-address (0-32767) or E1.31 universe
+     *                 number (1-63999)
+     * @param cid E1.31 component identifier (16 bytes), unused with Art-Net
+     * @param source E1.31 source name, unused with Art-Net
+     */
+    NetDMXPacket(Protocol protocol, quint16 universe,
+                 const QByteArray& cid = QByteArray(),
+                 const QString& source = QString());
+    ~NetDMXPacket();
+
+    /** Get the packet's protocol */
+    Protocol protocol() const;
+
+    /** Get the packet's universe (port-address with Art-Net) */
+    quint16 universe() const;
+
+    /** Get the UDP port that the protocol is sent to */
+    static quint16 port(Protocol protocol);
+
+    /**
+     * Get the default destination for the given protocol & universe:
+     * limited broadcast for Art-Net and the universe's multicast group
+     * (239.255.<universe hi>.<universe lo>) for E1.31.
+     */
+    static QHostAddress defaultAddress(Protocol protocol, quint16 universe);
+
+protected:
+    /** Fill in all the parts of the packet that never change */
+    void initArtNet();
+    void initE131(const QByteArray& cid, const QString& source);
+
+protected:
+    Protocol m_protocol;
+    quint16 m_universe;
+
+    /************************************************************************
+     * Values
+     ************************************************************************/
+public:
+    /**
+     * Copy the given DMX values into the packet and advance the packet's
+     * sequence number. Universes shorter than 512 channels are padded
+     * with zeros and longer ones are truncated.
+     *
+     * @param values The DMX values to send
+     */
+    void setValues(const QByteArray& values);
+
+    /** Get the sequence number of the current packet contents */
+    uchar sequence() const;
+
+    /** Get the raw packet data */
+    const char* data() const;
+
+    /** Get the size of the raw packet data in bytes */
+    int size() const;
+
+protected:
+    /** The whole packet, headers and values */
+    QByteArray m_packet;
+
+    /** Raw pointer to m_packet's data; all writes go through this */
+    char* m_data;
+
+    /** Offset of the first DMX value in the packet */
+    int m_valuesOffset;
+
+    /** Offset of the sequence number in the packet */
+    int m_sequenceOffset;
+
+    uchar m_sequence;
+};
+
+#endif
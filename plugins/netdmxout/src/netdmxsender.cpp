@@ -0,0 +1,227 @@
+/*
+  Q Light Controller
+  netdmxsender.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QUdpSocket>
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <string.h>
+#include <errno.h>
+#endif
+
+#include "netdmxsender.h"
+#include "netdmxpacket.h"
+
+/****************************************************************************
+ * Initialization
+ ****************************************************************************/
+
+NetDMXSender::NetDMXSender(int capacity)
+    : m_socket(NULL)
+    , m_datagrams(qMax(capacity, 1))
+    , m_queued(0)
+    , m_packetsSent(0)
+{
+#ifdef Q_OS_LINUX
+    m_headers.resize(m_datagrams.size());
+    m_iovecs.resize(m_datagrams.size());
+    m_addresses.resize(m_datagrams.size());
+    memset(m_headers.data(), 0, m_headers.size() * sizeof(struct mmsghdr));
+    memset(m_addresses.data(), 0,
+           m_addresses.size() * sizeof(struct sockaddr_in));
+
+    /* Each header always points to the same iovec and address */
+    for (int i = 0; i < m_headers.size(); i++)
+    {
+        m_headers[i].msg_hdr.msg_name = &m_addresses[i];
+        m_headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        m_headers[i].msg_hdr.msg_iov = &m_iovecs[i];
+        m_headers[i].msg_hdr.msg_iovlen = 1;
+        m_addresses[i].sin_family = AF_INET;
+    }
+#endif
+}
+
+NetDMXSender::~NetDMXSender()
+{
+    close();
+}
+
+int NetDMXSender::capacity() const
+{
+    return m_datagrams.size();
+}
+
+/****************************************************************************
+ * Socket
+ ****************************************************************************/
+
+bool NetDMXSender::open()
+{
+    if (m_socket != NULL)
+        return true;
+
+    m_socket = new QUdpSocket;
+    if (m_socket->bind() == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Unable to bind a UDP socket:"
+                   << m_socket->errorString();
+        delete m_socket;
+        m_socket = NULL;
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    /* sendmmsg() bypasses QUdpSocket, which would otherwise take care of
+       allowing broadcast destinations */
+    int broadcast = 1;
+    setsockopt(m_socket->socketDescriptor(), SOL_SOCKET, SO_BROADCAST,
+               &broadcast, sizeof(broadcast));
+#endif
+
+    return true;
+}
+
+void NetDMXSender::close()
+{
+    m_queued = 0;
+
+    delete m_socket;
+    m_socket = NULL;
+}
+
+bool NetDMXSender::isOpen() const
+{
+    return (m_socket != NULL);
+}
+
+/****************************************************************************
+ * Sending
+ ****************************************************************************/
+
+bool NetDMXSender::queue(const NetDMXPacket* packet,
+                         const QHostAddress& address, quint16 port)
+{
+    Q_ASSERT(packet != NULL);
+
+    if (m_queued >= m_datagrams.size())
+        return false;
+
+    Datagram& datagram(m_datagrams[m_queued]);
+    datagram.packet = packet;
+    datagram.address = address;
+    datagram.port = port;
+
+#ifdef Q_OS_LINUX
+    m_iovecs[m_queued].iov_base = const_cast<char*> (packet->data());
+    m_iovecs[m_queued].iov_len = packet->size();
+    m_addresses[m_queued].sin_addr.s_addr = htonl(address.toIPv4Address());
+    m_addresses[m_queued].sin_port = htons(port);
+#endif
+
+    m_queued++;
+    return true;
+}
+
+int NetDMXSender::queued() const
+{
+    return m_queued;
+}
+
+int NetDMXSender::send()
+{
+    int sent = 0;
+
+    if (m_socket != NULL && m_queued > 0)
+    {
+#ifdef Q_OS_LINUX
+        sent = sendBatch();
+#else
+        sent = sendEach();
+#endif
+        m_packetsSent += sent;
+    }
+
+    m_queued = 0;
+    return sent;
+}
+
+quint64 NetDMXSender::packetsSent() const
+{
+    return m_packetsSent;
+}
+
+int NetDMXSender::sendEach()
+{
+    int sent = 0;
+
+    for (int i = 0; i < m_queued; i++)
+    {
+        const Datagram& datagram(m_datagrams[i]);
+        if (m_socket->writeDatagram(datagram.packet->data(),
+                                    datagram.packet->size(),
+                                    datagram.address,
+                                    datagram.port) != -1)
+        {
+            sent++;
+        }
+    }
+
+    return sent;
+}
+
+#ifdef Q_OS_LINUX
+int NetDMXSender::sendBatch()
+{
+    int fd = m_socket->socketDescriptor();
+    int next = 0;
+    int sent = 0;
+
+    /* The kernel may accept only a part of the batch in one call */
+    while (next < m_queued)
+    {
+        int r = sendmmsg(fd, m_headers.data() + next, m_queued - next, 0);
+        if (r > 0)
+        {
+            next += r;
+            sent += r;
+        }
+        else if (errno == EINTR)
+        {
+            continue;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+        {
+            /* Socket buffer is full; drop the rest */
+            break;
+        }
+        else
+        {
+            /* The first remaining packet failed. Skip it so that a single
+               unreachable destination doesn't hold back the others. */
+            qWarning() << Q_FUNC_INFO << "Unable to send:" << strerror(errno);
+            next++;
+        }
+    }
+
+    return sent;
+}
+#endif
@@ -0,0 +1,150 @@
+/*
+  Q Light Controller
+  netdmxsender.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef NETDMXSENDER_H
+#define NETDMXSENDER_H
+
+#include <QHostAddress>
+#include <QVector>
+
+#ifdef Q_OS_LINUX
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#include "qlctypes.h"
+
+class NetDMXPacket;
+class QUdpSocket;
+
+/**
+ * NetDMXSender sends a batch of NetDMXPackets at a time. Packets are first
+ * queued with queue() and then sent all at once with send(). On Linux,
+ * the whole batch goes to the kernel with a single sendmmsg() call; on
+ * other platforms, the packets are sent one by one.
+ *
+ * The sender has a fixed capacity that is allocated at construction, so
+ * queueing and sending don't allocate anything.
+ */
+class QLC_DECLSPEC NetDMXSender
+{
+    Q_DISABLE_COPY(NetDMXSender)
+
+    /********************************************************************
+     * Initialization
+     ********************************************************************/
+public:
+    /**
+     * Create a new sender
+     *
+     * @param capacity The maximum number of packets in one batch
+     */
+    NetDMXSender(int capacity);
+    ~NetDMXSender();
+
+    /** Get the maximum number of packets in one batch */
+    int capacity() const;
+
+    /********************************************************************
+     * Socket
+     ********************************************************************/
+public:
+    /**
+     * Open a UDP socket for sending. Does nothing if the socket is already
+     * open.
+     *
+     * @return true if the socket is open, otherwise false
+     */
+    bool open();
+
+    /** Close the socket and drop all queued packets */
+    void close();
+
+    /** Check, whether the socket is open */
+    bool isOpen() const;
+
+protected:
+    QUdpSocket* m_socket;
+
+    /********************************************************************
+     * Sending
+     ********************************************************************/
+public:
+    /**
+     * Queue a packet to be sent with the next send(). The packet is not
+     * copied, so it must not be changed or destroyed before send().
+     *
+     * @param packet The packet to send
+     * @param address The destination address (unicast, broadcast or
+     *                multicast IPv4 address)
+     * @param port The destination UDP port
+     * @return true if the packet was queued, false if the batch is full
+     */
+    bool queue(const NetDMXPacket* packet, const QHostAddress& address,
+               quint16 port);
+
+    /** Get the number of currently queued packets */
+    int queued() const;
+
+    /**
+     * Send all queued packets and empty the queue. Packets that the network
+     * stack doesn't accept at the moment are dropped, since newer values
+     * will follow soon anyway.
+     *
+     * @return The number of packets sent
+     */
+    int send();
+
+    /** Get the total number of packets sent since construction */
+    quint64 packetsSent() const;
+
+protected:
+    /** Send queued packets one by one with QUdpSocket */
+    int sendEach();
+
+#ifdef Q_OS_LINUX
+    /** Send queued packets with as few sendmmsg() calls as possible */
+    int sendBatch();
+#endif
+
+protected:
+    struct Datagram
+    {
+        const NetDMXPacket* packet;
+        QHostAddress address;
+        quint16 port;
+    };
+
+    /** Queued datagrams, m_queued of them are valid */
+    QVector <Datagram> m_datagrams;
+    int m_queued;
+
+    quint64 m_packetsSent;
+
+#ifdef Q_OS_LINUX
+    /** sendmmsg() structures for each queued datagram */
+    QVector <struct mmsghdr> m_headers;
+    QVector <struct iovec> m_iovecs;
+    QVector <struct sockaddr_in> m_addresses;
+#endif
+};
+
+#endif
@@ -0,0 +1,39 @@
+include(../../../variables.pri)
+include(../../../coverage.pri)
+
+TEMPLATE = lib
+LANGUAGE = C++
+TARGET   = netdmxout
+
+INCLUDEPATH   += ../../interfaces
+CONFIG        += plugin
+QT            += network
+win32:DEFINES += QLC_EXPORT
+QTPLUGIN       =
+
+win32 {
+    # Qt Libraries
+    qtnetwork.path = $$INSTALLROOT/$$LIBSDIR
+    CONFIG(release, debug|release) qtnetwork.files = $$(QTDIR)/bin/QtNetwork4.dll
+    CONFIG(debug, debug|release) qtnetwork.files = $$(QTDIR)/bin/QtNetworkd4.dll
+    INSTALLS    += qtnetwork
+}
+
+HEADERS += netdmxout.h \
+           netdmxpacket.h \
+           netdmxsender.h
+
+SOURCES += netdmxout.cpp \
+           netdmxpacket.cpp \
+           netdmxsender.cpp
+
+HEADERS += ../../interfaces/qlcoutplugin.h
+
+# This must be after "TARGET = " and before target installation so that
+# install_name_tool can be run before target installation
+macx {
+    include(../../../macx/nametool.pri)
+}
+
+target.path = $$INSTALLROOT/$$OUTPUTPLUGINDIR
+INSTALLS   += target
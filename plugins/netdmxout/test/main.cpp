@@ -0,0 +1,32 @@
+#include <QtTest>
+
+#include "testnetdmxpacket.h"
+#include "testnetdmxsender.h"
+#include "testnetdmxout.h"
+
+int main(int argc, char** argv)
+{
+    QApplication qapp(argc, argv);
+    int r;
+
+    /* Keep the tests from touching the user's own settings */
+    QCoreApplication::setOrganizationName("qlc-test");
+    QCoreApplication::setApplicationName("test_netdmx");
+
+    TestNetDMXPacket test1;
+    r = QTest::qExec(&test1, argc, argv);
+    if (r != 0)
+        return r;
+
+    TestNetDMXSender test2;
+    r = QTest::qExec(&test2, argc, argv);
+    if (r != 0)
+        return r;
+
+    TestNetDMXOut test3;
+    r = QTest::qExec(&test3, argc, argv);
+    if (r != 0)
+        return r;
+
+    return 0;
+}
@@ -0,0 +1,20 @@
+include(../../../variables.pri)
+
+TEMPLATE = app
+LANGUAGE = C++
+TARGET   = test_netdmx
+
+QT     += core gui network testlib
+
+INCLUDEPATH += ../../interfaces
+INCLUDEPATH += ../src
+LIBS   += -L../src -lnetdmxout
+
+SOURCES += testnetdmxpacket.cpp \
+           testnetdmxsender.cpp \
+           testnetdmxout.cpp \
+           main.cpp
+
+HEADERS += testnetdmxpacket.h \
+           testnetdmxsender.h \
+           testnetdmxout.h
@@ -0,0 +1,146 @@
+#include <QUdpSocket>
+#include <QByteArray>
+#include <QtTest>
+
+#define protected public
+#include "netdmxsender.h"
+#include "netdmxout.h"
+#undef protected
+
+#include "testnetdmxout.h"
+
+void TestNetDMXOut::initTestCase()
+{
+    m_plugin = new NetDMXOut;
+    m_plugin->init();
+    m_plugin->setConfiguration(2, QHostAddress());
+}
+
+void TestNetDMXOut::name()
+{
+    QCOMPARE(m_plugin->name(), QString("Art-Net & E1.31 Output"));
+    QVERIFY(m_plugin->canConfigure() == true);
+    QVERIFY(m_plugin->m_cid.size() == E131_CID_SIZE);
+}
+
+void TestNetDMXOut::outputs()
+{
+    QStringList outputs(m_plugin->outputs());
+    QCOMPARE(outputs.size(), 4);
+    QCOMPARE(outputs[0], QString("1: Art-Net universe 0"));
+    QCOMPARE(outputs[1], QString("2: Art-Net universe 1"));
+    QCOMPARE(outputs[2], QString("3: E1.31 universe 1"));
+    QCOMPARE(outputs[3], QString("4: E1.31 universe 2"));
+
+    m_plugin->setConfiguration(3, QHostAddress());
+    QCOMPARE(m_plugin->outputs().size(), 6);
+    QCOMPARE(m_plugin->m_packets.size(), 6);
+
+    /* Line count is clamped */
+    m_plugin->setConfiguration(0, QHostAddress());
+    QCOMPARE(m_plugin->outputs().size(), 2);
+    m_plugin->setConfiguration(KUniverseCountMax + 1, QHostAddress());
+    QCOMPARE(m_plugin->outputs().size(), int(2 * KUniverseCountMax));
+
+    m_plugin->setConfiguration(2, QHostAddress());
+}
+
+void TestNetDMXOut::destinations()
+{
+    QCOMPARE(m_plugin->m_destinations[0], QHostAddress(QHostAddress::Broadcast));
+    QCOMPARE(m_plugin->m_destinations[1], QHostAddress(QHostAddress::Broadcast));
+    QCOMPARE(m_plugin->m_destinations[2], QHostAddress("239.255.0.1"));
+    QCOMPARE(m_plugin->m_destinations[3], QHostAddress("239.255.0.2"));
+
+    QCOMPARE(m_plugin->m_packets[1]->protocol(), NetDMXPacket::ArtNet);
+    QCOMPARE(int(m_plugin->m_packets[1]->universe()), 1);
+    QCOMPARE(m_plugin->m_packets[3]->protocol(), NetDMXPacket::E131);
+    QCOMPARE(int(m_plugin->m_packets[3]->universe()), 2);
+
+    m_plugin->setConfiguration(2, QHostAddress("192.168.1.2"));
+    for (int i = 0; i < 4; i++)
+        QCOMPARE(m_plugin->m_destinations[i], QHostAddress("192.168.1.2"));
+
+    m_plugin->setConfiguration(2, QHostAddress());
+    QCOMPARE(m_plugin->m_destinations[0], QHostAddress(QHostAddress::Broadcast));
+}
+
+void TestNetDMXOut::openClose()
+{
+    QVERIFY(m_plugin->m_sender->isOpen() == false);
+
+    m_plugin->open(1);
+    QVERIFY(m_plugin->m_open[1] == true);
+    QVERIFY(m_plugin->m_sender->isOpen() == true);
+
+    m_plugin->open(3);
+    QVERIFY(m_plugin->m_open[3] == true);
+
+    /* Invalid lines are ignored */
+    m_plugin->open(4);
+    QCOMPARE(m_plugin->m_open.size(), 4);
+
+    m_plugin->close(1);
+    QVERIFY(m_plugin->m_open[1] == false);
+    QVERIFY(m_plugin->m_sender->isOpen() == true);
+
+    /* Line 3 was E1.31 universe 2 and becomes Art-Net universe 2, so
+       re-created lines are all closed until they're opened again */
+    m_plugin->setConfiguration(3, QHostAddress());
+    QCOMPARE(m_plugin->m_open.size(), 6);
+    QVERIFY(m_plugin->m_open.contains(true) == false);
+    QVERIFY(m_plugin->m_sender->isOpen() == false);
+
+    m_plugin->open(3);
+    QVERIFY(m_plugin->m_open[3] == true);
+    QVERIFY(m_plugin->m_sender->isOpen() == true);
+
+    m_plugin->close(3);
+    QVERIFY(m_plugin->m_sender->isOpen() == false);
+
+    m_plugin->setConfiguration(2, QHostAddress());
+}
+
+void TestNetDMXOut::batching()
+{
+    QUdpSocket receiver;
+    if (receiver.bind(QHostAddress::LocalHost, ARTNET_PORT) == false)
+        QSKIP("Art-Net port is already in use", SkipSingle);
+
+    m_plugin->setConfiguration(2, QHostAddress::LocalHost);
+    m_plugin->open(0);
+
+    /* Nothing is sent before flushDMX() */
+    m_plugin->outputDMX(0, QByteArray(512, 'a'));
+    m_plugin->outputDMX(0, QByteArray(512, 'b'));
+    QVERIFY(m_plugin->m_sender->queued() == 1);
+    QVERIFY(receiver.waitForReadyRead(100) == false);
+
+    /* Closed lines aren't written to */
+    m_plugin->outputDMX(1, QByteArray(512, 'c'));
+    QVERIFY(m_plugin->m_sender->queued() == 1);
+
+    /* A line written twice is sent once, with the newest values */
+    m_plugin->flushDMX();
+    QVERIFY(m_plugin->m_sender->queued() == 0);
+    QVERIFY(receiver.waitForReadyRead(1000) == true);
+    QByteArray datagram(receiver.pendingDatagramSize(), char(0));
+    receiver.readDatagram(datagram.data(), datagram.size());
+    QCOMPARE(datagram.size(), ARTNET_HEADER_SIZE + 512);
+    QCOMPARE(int(uchar(datagram[12])), 2);
+    QCOMPARE(datagram.mid(ARTNET_HEADER_SIZE), QByteArray(512, 'b'));
+    QVERIFY(receiver.waitForReadyRead(100) == false);
+
+    /* Flushing with nothing written sends nothing */
+    m_plugin->flushDMX();
+    QVERIFY(receiver.waitForReadyRead(100) == false);
+
+    m_plugin->close(0);
+    m_plugin->setConfiguration(2, QHostAddress());
+}
+
+void TestNetDMXOut::cleanupTestCase()
+{
+    delete m_plugin;
+    m_plugin = NULL;
+}
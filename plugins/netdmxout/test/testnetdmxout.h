@@ -0,0 +1,27 @@
+#ifndef TESTNETDMXOUT_H
+#define TESTNETDMXOUT_H
+
+#include <QObject>
+
+class NetDMXOut;
+
+class TestNetDMXOut : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void name();
+    void outputs();
+    void destinations();
+    void openClose();
+    void batching();
+
+    void cleanupTestCase();
+
+private:
+    NetDMXOut* m_plugin;
+};
+
+#endif
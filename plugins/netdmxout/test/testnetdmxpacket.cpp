@@ -0,0 +1,156 @@
+#include <QByteArray>
+#include <QtTest>
+
+#include "netdmxpacket.h"
+#include "testnetdmxpacket.h"
+
+/* Read a 16bit value in network byte order */
+static quint16 readShort(const char* data, int offset)
+{
+    return (quint16(uchar(data[offset])) << 8) | uchar(data[offset + 1]);
+}
+
+void TestNetDMXPacket::artNet()
+{
+    NetDMXPacket packet(NetDMXPacket::ArtNet, 0x1234);
+    QVERIFY(packet.protocol() == NetDMXPacket::ArtNet);
+    QVERIFY(packet.universe() == 0x1234);
+    QVERIFY(NetDMXPacket::port(NetDMXPacket::ArtNet) == 6454);
+
+    const char* data = packet.data();
+    QCOMPARE(packet.size(), 18 + 512);
+    QCOMPARE(QByteArray(data, 8), QByteArray("Art-Net\0", 8));
+
+    /* OpDmx is little-endian, everything else big-endian */
+    QCOMPARE(uchar(data[8]), uchar(0x00));
+    QCOMPARE(uchar(data[9]), uchar(0x50));
+    QCOMPARE(readShort(data, 10), quint16(14));
+
+    /* No values set yet, no sequence */
+    QCOMPARE(uchar(data[12]), uchar(0));
+    QCOMPARE(uchar(data[13]), uchar(0));
+
+    /* SubUni, Net */
+    QCOMPARE(uchar(data[14]), uchar(0x34));
+    QCOMPARE(uchar(data[15]), uchar(0x12));
+
+    QCOMPARE(readShort(data, 16), quint16(512));
+}
+
+void TestNetDMXPacket::e131()
+{
+    QByteArray cid("0123456789abcdef");
+    NetDMXPacket packet(NetDMXPacket::E131, 0x0102, cid, "QLC");
+    QVERIFY(packet.protocol() == NetDMXPacket::E131);
+    QVERIFY(packet.universe() == 0x0102);
+    QVERIFY(NetDMXPacket::port(NetDMXPacket::E131) == 5568);
+
+    const char* data = packet.data();
+    QCOMPARE(packet.size(), 638);
+
+    /* Root layer */
+    QCOMPARE(readShort(data, 0), quint16(0x0010));
+    QCOMPARE(readShort(data, 2), quint16(0x0000));
+    QCOMPARE(QByteArray(data + 4, 12), QByteArray("ASC-E1.17\0\0\0", 12));
+    QCOMPARE(readShort(data, 16), quint16(0x7000 | 622));
+    QCOMPARE(readShort(data, 18), quint16(0));
+    QCOMPARE(readShort(data, 20), quint16(4));
+    QCOMPARE(QByteArray(data + 22, 16), cid);
+
+    /* Framing layer */
+    QCOMPARE(readShort(data, 38), quint16(0x7000 | 600));
+    QCOMPARE(readShort(data, 40), quint16(0));
+    QCOMPARE(readShort(data, 42), quint16(2));
+    QCOMPARE(QByteArray(data + 44, 4), QByteArray("QLC\0", 4));
+    QCOMPARE(QByteArray(data + 44 + 63, 1), QByteArray(1, '\0'));
+    QCOMPARE(uchar(data[108]), uchar(100));
+    QCOMPARE(readShort(data, 109), quint16(0));
+    QCOMPARE(uchar(data[111]), uchar(0));
+    QCOMPARE(uchar(data[112]), uchar(0));
+    QCOMPARE(readShort(data, 113), quint16(0x0102));
+
+    /* DMP layer */
+    QCOMPARE(readShort(data, 115), quint16(0x7000 | 523));
+    QCOMPARE(uchar(data[117]), uchar(0x02));
+    QCOMPARE(uchar(data[118]), uchar(0xA1));
+    QCOMPARE(readShort(data, 119), quint16(0));
+    QCOMPARE(readShort(data, 121), quint16(1));
+    QCOMPARE(readShort(data, 123), quint16(513));
+    QCOMPARE(uchar(data[125]), uchar(0));
+}
+
+void TestNetDMXPacket::values()
+{
+    NetDMXPacket artnet(NetDMXPacket::ArtNet, 0);
+    NetDMXPacket e131(NetDMXPacket::E131, 1, QByteArray(16, 'c'));
+
+    QByteArray universe(512, char(0));
+    for (int i = 0; i < universe.size(); i++)
+        universe[i] = char(i & 0xFF);
+
+    artnet.setValues(universe);
+    QCOMPARE(QByteArray(artnet.data() + 18, 512), universe);
+
+    e131.setValues(universe);
+    QCOMPARE(QByteArray(e131.data() + 126, 512), universe);
+
+    /* Writing values doesn't move or resize the packet */
+    const char* data = artnet.data();
+    artnet.setValues(QByteArray(3, 'x'));
+    QVERIFY(artnet.data() == data);
+    QCOMPARE(artnet.size(), 18 + 512);
+
+    /* Short universes are padded with zeros */
+    QCOMPARE(QByteArray(artnet.data() + 18, 3), QByteArray(3, 'x'));
+    QCOMPARE(QByteArray(artnet.data() + 21, 509), QByteArray(509, '\0'));
+
+    /* Long ones are truncated */
+    e131.setValues(QByteArray(600, 'y'));
+    QCOMPARE(e131.size(), 638);
+    QCOMPARE(QByteArray(e131.data() + 126, 512), QByteArray(512, 'y'));
+}
+
+void TestNetDMXPacket::artNetSequence()
+{
+    NetDMXPacket packet(NetDMXPacket::ArtNet, 0);
+    QByteArray universe(512, char(0));
+
+    for (int i = 1; i <= 255; i++)
+    {
+        packet.setValues(universe);
+        QCOMPARE(int(packet.sequence()), i);
+        QCOMPARE(int(uchar(packet.data()[12])), i);
+    }
+
+    /* Zero disables sequencing in Art-Net, so it's never used */
+    packet.setValues(universe);
+    QCOMPARE(int(packet.sequence()), 1);
+    QCOMPARE(int(uchar(packet.data()[12])), 1);
+}
+
+void TestNetDMXPacket::e131Sequence()
+{
+    NetDMXPacket packet(NetDMXPacket::E131, 1, QByteArray(16, 'c'));
+    QByteArray universe(512, char(0));
+
+    for (int i = 1; i <= 255; i++)
+    {
+        packet.setValues(universe);
+        QCOMPARE(int(packet.sequence()), i);
+        QCOMPARE(int(uchar(packet.data()[111])), i);
+    }
+
+    packet.setValues(universe);
+    QCOMPARE(int(packet.sequence()), 0);
+    QCOMPARE(int(uchar(packet.data()[111])), 0);
+}
+
+void TestNetDMXPacket::defaultAddress()
+{
+    QCOMPARE(NetDMXPacket::defaultAddress(NetDMXPacket::ArtNet, 5),
+             QHostAddress(QHostAddress::Broadcast));
+    QCOMPARE(NetDMXPacket::defaultAddress(NetDMXPacket::E131, 1),
+             QHostAddress("239.255.0.1"));
+    QCOMPARE(NetDMXPacket::defaultAddress(NetDMXPacket::E131, 0x0102),
+             QHostAddress("239.255.1.2"));
+}
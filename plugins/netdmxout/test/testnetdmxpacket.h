@@ -0,0 +1,19 @@
+#ifndef TESTNETDMXPACKET_H
+#define TESTNETDMXPACKET_H
+
+#include <QObject>
+
+class TestNetDMXPacket : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void artNet();
+    void e131();
+    void values();
+    void artNetSequence();
+    void e131Sequence();
+    void defaultAddress();
+};
+
+#endif
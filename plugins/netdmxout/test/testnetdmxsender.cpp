@@ -0,0 +1,177 @@
+#include <QUdpSocket>
+#include <QByteArray>
+#include <QtTest>
+
+#include "qlcclock.h"
+#include "netdmxsender.h"
+#include "netdmxpacket.h"
+#include "testnetdmxsender.h"
+
+/* Universes per protocol & frames per second in the throughput test */
+#define THROUGHPUT_UNIVERSES 64
+#define THROUGHPUT_FRAMES 44
+
+int TestNetDMXSender::receive(int count, QByteArray* last)
+{
+    int received = 0;
+
+    while (received < count)
+    {
+        if (m_receiver->hasPendingDatagrams() == false &&
+            m_receiver->waitForReadyRead(1000) == false)
+        {
+            break;
+        }
+
+        while (m_receiver->hasPendingDatagrams() == true)
+        {
+            QByteArray datagram(m_receiver->pendingDatagramSize(), char(0));
+            m_receiver->readDatagram(datagram.data(), datagram.size());
+            if (last != NULL)
+                *last = datagram;
+            received++;
+        }
+    }
+
+    return received;
+}
+
+void TestNetDMXSender::initTestCase()
+{
+    m_receiver = new QUdpSocket(this);
+    QVERIFY(m_receiver->bind(QHostAddress::LocalHost, 0) == true);
+}
+
+void TestNetDMXSender::openClose()
+{
+    NetDMXSender sender(4);
+    QVERIFY(sender.capacity() == 4);
+    QVERIFY(sender.isOpen() == false);
+
+    QVERIFY(sender.open() == true);
+    QVERIFY(sender.isOpen() == true);
+    QVERIFY(sender.open() == true);
+    QVERIFY(sender.isOpen() == true);
+
+    sender.close();
+    QVERIFY(sender.isOpen() == false);
+}
+
+void TestNetDMXSender::queue()
+{
+    NetDMXPacket packet(NetDMXPacket::ArtNet, 0);
+    NetDMXSender sender(2);
+    quint16 port = m_receiver->localPort();
+
+    QVERIFY(sender.queued() == 0);
+    QVERIFY(sender.queue(&packet, QHostAddress::LocalHost, port) == true);
+    QVERIFY(sender.queue(&packet, QHostAddress::LocalHost, port) == true);
+    QVERIFY(sender.queued() == 2);
+
+    /* Batch is full */
+    QVERIFY(sender.queue(&packet, QHostAddress::LocalHost, port) == false);
+    QVERIFY(sender.queued() == 2);
+
+    /* Nothing is sent without a socket, but the queue is emptied */
+    QVERIFY(sender.send() == 0);
+    QVERIFY(sender.queued() == 0);
+    QVERIFY(sender.packetsSent() == 0);
+
+    QVERIFY(sender.queue(&packet, QHostAddress::LocalHost, port) == true);
+    sender.close();
+    QVERIFY(sender.queued() == 0);
+}
+
+void TestNetDMXSender::send()
+{
+    NetDMXPacket artnet(NetDMXPacket::ArtNet, 1);
+    NetDMXPacket e131(NetDMXPacket::E131, 2, QByteArray(16, 'c'));
+    NetDMXSender sender(8);
+    QVERIFY(sender.open() == true);
+
+    artnet.setValues(QByteArray(512, 'a'));
+    e131.setValues(QByteArray(512, 'e'));
+
+    quint16 port = m_receiver->localPort();
+    QVERIFY(sender.queue(&artnet, QHostAddress::LocalHost, port) == true);
+    QVERIFY(sender.queue(&e131, QHostAddress::LocalHost, port) == true);
+    QVERIFY(sender.send() == 2);
+    QVERIFY(sender.queued() == 0);
+    QVERIFY(sender.packetsSent() == 2);
+
+    /* Packets arrive intact and in order */
+    QVERIFY(m_receiver->waitForReadyRead(1000) == true);
+    QByteArray datagram(m_receiver->pendingDatagramSize(), char(0));
+    m_receiver->readDatagram(datagram.data(), datagram.size());
+    QCOMPARE(datagram, QByteArray(artnet.data(), artnet.size()));
+
+    QByteArray last;
+    QVERIFY(receive(1, &last) == 1);
+    QCOMPARE(last, QByteArray(e131.data(), e131.size()));
+
+    /* Sending again with nothing queued does nothing */
+    QVERIFY(sender.send() == 0);
+    QVERIFY(sender.packetsSent() == 2);
+}
+
+void TestNetDMXSender::throughput()
+{
+    QList <NetDMXPacket*> packets;
+    for (int i = 0; i < THROUGHPUT_UNIVERSES; i++)
+    {
+        packets << new NetDMXPacket(NetDMXPacket::ArtNet, i);
+        packets << new NetDMXPacket(NetDMXPacket::E131, i + 1,
+                                    QByteArray(16, 'c'));
+    }
+
+    NetDMXSender sender(packets.size());
+    QVERIFY(sender.open() == true);
+
+    QByteArray universe(512, char(0));
+    quint16 port = m_receiver->localPort();
+    qint64 sendTime = 0;
+    int received = 0;
+
+    /* One second's worth of frames, each with all universes changed */
+    for (int frame = 0; frame < THROUGHPUT_FRAMES; frame++)
+    {
+        universe.fill(char(frame));
+
+        qint64 start = QLCClock::monotonicTime();
+
+        QListIterator <NetDMXPacket*> it(packets);
+        while (it.hasNext() == true)
+        {
+            NetDMXPacket* packet = it.next();
+            packet->setValues(universe);
+            sender.queue(packet, QHostAddress::LocalHost, port);
+        }
+        QCOMPARE(sender.send(), packets.size());
+
+        sendTime += QLCClock::monotonicTime() - start;
+
+        /* Read everything before the next frame so that the receiver's
+           socket buffer never overflows */
+        received += receive(packets.size());
+    }
+
+    QCOMPARE(received, THROUGHPUT_FRAMES * packets.size());
+
+    qDebug() << "Sent" << THROUGHPUT_FRAMES << "frames of"
+             << packets.size() << "universes in"
+             << (sendTime / 1000) << "us,"
+             << (sendTime / (THROUGHPUT_FRAMES * packets.size()))
+             << "ns per packet";
+
+    /* A whole second of frames must take only a fraction of a second */
+    QVERIFY(sendTime < Q_INT64_C(500000000));
+
+    while (packets.isEmpty() == false)
+        delete packets.takeFirst();
+}
+
+void TestNetDMXSender::cleanupTestCase()
+{
+    delete m_receiver;
+    m_receiver = NULL;
+}
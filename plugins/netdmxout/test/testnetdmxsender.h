@@ -0,0 +1,31 @@
+#ifndef TESTNETDMXSENDER_H
+#define TESTNETDMXSENDER_H
+
+#include <QObject>
+
+class QUdpSocket;
+
+class TestNetDMXSender : public QObject
+{
+    Q_OBJECT
+
+protected:
+    /** Receive datagrams from m_receiver until $count have arrived or
+        nothing arrives for a while. Returns the number received. */
+    int receive(int count, QByteArray* last = NULL);
+
+private slots:
+    void initTestCase();
+
+    void openClose();
+    void queue();
+    void send();
+    void throughput();
+
+    void cleanupTestCase();
+
+private:
+    QUdpSocket* m_receiver;
+};
+
+#endif
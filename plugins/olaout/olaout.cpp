@@ -210,10 +210,20 @@ QString OLAOut::infoText(quint32 output)
 
 void OLAOut::outputDMX(quint32 output, const QByteArray& universe)
 {
-    if (output > K_UNIVERSE_COUNT || !m_thread)
+    if (output >= K_UNIVERSE_COUNT || !m_thread)
         return;
 
-    m_thread->write_dmx(m_output_list[output], universe);
+    m_thread->write_dmx(output, m_output_list[output], universe);
+}
+
+
+/*
+ * Wake the OLA thread up once all universes of a tick have been written
+ */
+void OLAOut::flushDMX()
+{
+    if (m_thread)
+        m_thread->flush();
 }
 
 /*
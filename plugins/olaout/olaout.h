@@ -33,9 +33,6 @@
 
 class ConfigureOlaOut;
 
-// Number of output universes
-enum { K_UNIVERSE_COUNT = 4 };
-
 typedef QList<unsigned int> OutputList;
 
 // The OLA Output plugin
@@ -57,6 +54,7 @@ public:
     QString infoText(quint32 output = KOutputInvalid);
 
     void outputDMX(quint32 output, const QByteArray& universe);
+    void flushDMX();
 
     const OutputList outputMapping() const;
     void setOutputUniverse(quint32 output, unsigned int universe);
@@ -26,7 +26,8 @@ SOURCES += olaout.cpp \
            configureolaout.cpp \
            qlclogdestination.cpp
 
-HEADERS += ../interfaces/qlcoutplugin.h
+HEADERS += ../interfaces/qlcoutplugin.h \
+           ../interfaces/qlctriplebuffer.h
 
 PRO_FILE = olaout.pro
 TRANSLATIONS += OLA_Output_fi_FI.ts
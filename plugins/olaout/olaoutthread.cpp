@@ -25,6 +25,22 @@
 #include "olaoutthread.h"
 
 
+/*
+ * Preallocate the slots for all outputs.
+ */
+OlaOutThread::OlaOutThread():
+        m_init_run(false),
+        m_ss(NULL),
+        m_pipe(NULL),
+        m_client(NULL),
+        m_written(0),
+        m_signalled(0)
+{
+    for (unsigned int i = 0; i < K_UNIVERSE_COUNT; ++i)
+        m_slots[i] = new QLCTripleBuffer(K_UNIVERSE_SIZE);
+}
+
+
 /*
  * Clean up.
  */
@@ -41,6 +57,9 @@ OlaOutThread::~OlaOutThread()
         delete m_pipe;
 
     cleanup();
+
+    for (unsigned int i = 0; i < K_UNIVERSE_COUNT; ++i)
+        delete m_slots[i];
 }
 
 
@@ -92,21 +111,47 @@ void OlaOutThread::run()
 
 
 /*
- * Send the new data over the socket so that the other thread picks it up.
- * @param universe the universe nmuber this data is for
- * @param data a pointer to the data
- * @param channels the number of channels
+ * Store the new data in the output's slot so that the other thread picks it
+ * up on the next flush(). Must be called from one thread only.
+ * @param output the output (slot) number
+ * @param universe the universe number this data is for
+ * @param data the data
  */
-int OlaOutThread::write_dmx(unsigned int universe, const QByteArray& data)
+int OlaOutThread::write_dmx(unsigned int output, unsigned int universe,
+                            const QByteArray& data)
 {
-    m_data.universe = universe;
-    memcpy(m_data.data, data.data(), data.size());
-    if (m_pipe)
-        m_pipe->Send((uint8_t*) &m_data, sizeof(m_data));
+    if (output >= K_UNIVERSE_COUNT)
+        return -1;
+
+    m_universes[output] = int(universe);
+    m_slots[output]->write(data);
+    m_written = 1;
     return 0;
 }
 
 
+/*
+ * Wake the other thread up if there are new frames. Called once per tick,
+ * so a single wakeup covers all universes written during the tick.
+ */
+void OlaOutThread::flush()
+{
+    if (m_written.testAndSetOrdered(1, 0) == false)
+        return;
+
+    // The other thread hasn't got to the previous wakeup yet; it will find
+    // the new frames too.
+    if (m_signalled.testAndSetOrdered(0, 1) == false)
+        return;
+
+    if (m_pipe)
+    {
+        uint8_t wakeup = 0;
+        m_pipe->Send(&wakeup, sizeof(wakeup));
+    }
+}
+
+
 /*
  * Called when the pipe used to communicate between QLC and OLA is closed
  */
@@ -118,20 +163,33 @@ void OlaOutThread::pipe_closed() {
 
 
 /*
- * Called when there is data to be read on the pipe socket.
+ * Called when there is data to be read on the pipe socket. Sends all
+ * universes that have changed since the last time.
  */
 void OlaOutThread::new_pipe_data() {
-    dmx_data data;
+    uint8_t wakeups[K_UNIVERSE_COUNT];
     unsigned int data_read;
-    int ret = m_pipe->Receive((uint8_t*) &data, sizeof(data), data_read);
+    int ret = m_pipe->Receive(wakeups, sizeof(wakeups), data_read);
     if (ret < 0)
     {
         qCritical() << "olaout: socket receive failed";
         return;
     }
-    m_buffer.Set(data.data, data_read - sizeof(data.universe));
-    if (!m_client->SendDmx(data.universe, m_buffer))
-        qWarning() << "olaout:: SendDmx() failed";
+
+    // Frames written after this get a wakeup of their own
+    m_signalled = 0;
+
+    for (unsigned int i = 0; i < K_UNIVERSE_COUNT; ++i)
+    {
+        if (!m_slots[i]->read())
+            continue;
+
+        const QByteArray& frame = m_slots[i]->front();
+        m_buffer.Set(reinterpret_cast<const uint8_t*>(frame.constData()),
+                     frame.size());
+        if (!m_client->SendDmx(int(m_universes[i]), m_buffer))
+            qWarning() << "olaout:: SendDmx() failed";
+    }
 }
 
 
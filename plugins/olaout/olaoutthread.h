@@ -24,31 +24,32 @@
 #define OLAOUTTHREAD_H
 
 #include <qthread.h>
+#include <QAtomicInt>
 #include <ola/DmxBuffer.h>
 #include <ola/OlaClient.h>
 #include <ola/network/SelectServer.h>
 #include <ola/network/Socket.h>
 #include <olad/OlaDaemon.h>
+#include "qlctriplebuffer.h"
 #include "qlctypes.h"
 
 // This should really be in qlctypes.h!
 enum { K_UNIVERSE_SIZE = 512 };
 
-// Used to pass data between the threads
-typedef struct
-{
-    unsigned int universe;
-    uchar data[K_UNIVERSE_SIZE];
-} dmx_data;
+// Number of output universes
+enum { K_UNIVERSE_COUNT = 4 };
 
 
 /*
  * The OLA thread.
  *
  * Basic design: qlc plugins aren't allowed to block in calls, so we start a
- * new thread which runs a select server. Calls to write_dmx in the plugin send
- * data over a pipe which the OLA thread listens on. It then uses the OlaClient
- * api to send the data to the OLA Server.
+ * new thread which runs a select server. Calls to write_dmx in the plugin
+ * copy the data into a preallocated slot of the output, which is a lock-free
+ * triple buffer, so the OLA thread always finds the newest complete frame
+ * there. Once all universes of a tick have been written, flush() wakes the
+ * OLA thread up with a single byte over a pipe. The OLA thread then uses the
+ * OlaClient api to send all changed universes to the OLA Server in one go.
  *
  * The thread can either run as a OLA Client or embed the OLA server. As a
  * client, we connect to the OLA server using a TCP socket.
@@ -64,17 +65,15 @@ typedef struct
  */
 class OlaOutThread : public QThread {
 public:
-    OlaOutThread():
-            m_init_run(false),
-            m_ss(NULL),
-            m_pipe(NULL),
-            m_client(NULL) {}
+    OlaOutThread();
     virtual ~OlaOutThread();
 
     void run();
     bool start(Priority priority=InheritPriority);
     void stop();
-    int write_dmx(unsigned int universe, const QByteArray& data);
+    int write_dmx(unsigned int output, unsigned int universe,
+                  const QByteArray& data);
+    void flush();
     void new_pipe_data();
     void pipe_closed();
 
@@ -88,8 +87,17 @@ private:
     virtual void cleanup() {};
     ola::network::LoopbackSocket *m_pipe; // the pipe to get new dmx data on
     ola::OlaClient *m_client;
-    dmx_data m_data;
     ola::DmxBuffer m_buffer;
+
+    // One slot per output, written by QLC and read by the OLA thread
+    QLCTripleBuffer *m_slots[K_UNIVERSE_COUNT];
+    QAtomicInt m_universes[K_UNIVERSE_COUNT];
+
+    // Set when there's a frame that the OLA thread hasn't been woken up for
+    QAtomicInt m_written;
+
+    // Set when the OLA thread has been woken up but hasn't read the slots
+    QAtomicInt m_signalled;
 };
 
 
@@ -17,7 +17,8 @@ HEADERS += ../unix/peperonidevice.h \
 SOURCES += ../unix/peperonidevice.cpp \
            ../unix/peperoniout.cpp
 
-HEADERS += ../../interfaces/qlcoutplugin.h
+HEADERS += ../../interfaces/qlcoutplugin.h \
+           ../../interfaces/qlcoutputwriter.h
 
 # This must be after "TARGET = " and before target installation so that
 # install_name_tool can be run before target installation
@@ -60,7 +60,7 @@
  ****************************************************************************/
 
 PeperoniDevice::PeperoniDevice(QObject* parent, struct usb_device* device)
-        : QObject(parent)
+        : QLCOutputWriter(parent)
 {
     Q_ASSERT(device != NULL);
 
@@ -117,13 +117,14 @@ void PeperoniDevice::extractName()
 
     Q_ASSERT(m_device != NULL);
 
+    /* Don't use open() here, since there's no need for a writer thread */
     if (m_handle == NULL)
     {
         needToClose = true;
-        open();
+        m_handle = usb_open(m_device);
     }
 
-    /* Check, whether open() was successful */
+    /* Check, whether usb_open() was successful */
     if (m_handle == NULL)
         return;
 
@@ -140,7 +141,10 @@ void PeperoniDevice::extractName()
 
     /* Close the device if it was opened for this function only. */
     if (needToClose == true)
-        close();
+    {
+        usb_close(m_handle);
+        m_handle = NULL;
+    }
 }
 
 QString PeperoniDevice::name() const
@@ -156,10 +160,28 @@ QString PeperoniDevice::infoText() const
     {
         info += QString("<B>%1</B>").arg(name());
         info += QString("<P>");
-        info += tr("Device is working correctly.");
+        if (isFailing() == true)
+            info += tr("Device is not accepting DMX data.");
+        else
+            info += tr("Device is working correctly.");
         info += QString("<BR/>");
         info += tr("Firmware version: %1").arg(m_firmwareVersion, 4, 16, QChar('0'));
         info += QString("</P>");
+
+        if (isRunning() == true)
+        {
+            info += QString("<P>");
+            info += tr("Frames written: %1").arg(transfers() - failures());
+            info += QString("<BR/>");
+            info += tr("Failed transfers: %1").arg(failures());
+            info += QString("<BR/>");
+            info += tr("Frames skipped while busy: %1").arg(skippedFrames());
+            info += QString("<BR/>");
+            info += tr("Transfer time: %1ms average, %2ms maximum")
+                    .arg(double(averageTransferTime()) / 1000000.0, 0, 'f', 2)
+                    .arg(double(maxTransferTime()) / 1000000.0, 0, 'f', 2);
+            info += QString("</P>");
+        }
     }
     else
     {
@@ -202,10 +224,16 @@ void PeperoniDevice::open()
             qWarning() << "PeperoniDevice:" << "Unable to reset endpoint";
         }
     }
+
+    if (m_handle != NULL)
+        startWriter();
 }
 
 void PeperoniDevice::close()
 {
+    /* Let the current transfer finish before releasing the device */
+    stopWriter();
+
     if (m_device != NULL && m_handle != NULL)
     {
         /* Release the interface in case we claimed it */
@@ -237,11 +265,16 @@ const usb_dev_handle* PeperoniDevice::handle() const
 
 void PeperoniDevice::outputDMX(const QByteArray& universe)
 {
-    int r = -1;
-
     if (m_handle == NULL)
         return;
 
+    post(universe);
+}
+
+bool PeperoniDevice::transfer(const QByteArray& universe)
+{
+    int r = -1;
+
     /* Choose write method based on firmware version. One has to unplug
        and then re-plug the dongle in apple for bulk write to work,
        so disable it for apple, since control msg should work for all. */
@@ -282,7 +315,15 @@ void PeperoniDevice::outputDMX(const QByteArray& universe)
 
     if (r < 0)
     {
-        qWarning() << name() << "is unable to write DMX universe:"
-                   << usb_strerror();
+        /* Warn only about the first failure, not each frame after it */
+        if (isFailing() == false)
+        {
+            qWarning() << name() << "is unable to write DMX universe:"
+                       << usb_strerror();
+        }
+
+        return false;
     }
+
+    return true;
 }
@@ -24,6 +24,7 @@
 
 #include <QObject>
 
+#include "qlcoutputwriter.h"
 #include "qlctypes.h"
 
 struct usb_dev_handle;
@@ -31,7 +32,7 @@ struct usb_device;
 class QString;
 class QByteArray;
 
-class PeperoniDevice : public QObject
+class PeperoniDevice : public QLCOutputWriter
 {
     Q_OBJECT
 
@@ -78,7 +79,12 @@ protected:
      * Write
      ********************************************************************/
 public:
+    /** Post a universe to the device's writer thread. Never blocks. */
     void outputDMX(const QByteArray& universe);
+
+protected:
+    /** @reimp */
+    bool transfer(const QByteArray& universe);
 };
 
 #endif
@@ -14,7 +14,8 @@ HEADERS += peperonidevice.h \
 SOURCES += peperonidevice.cpp \
            peperoniout.cpp
 
-HEADERS += ../../interfaces/qlcoutplugin.h
+HEADERS += ../../interfaces/qlcoutplugin.h \
+           ../../interfaces/qlcoutputwriter.h
 
 PRO_FILE = unix.pro
 TRANSLATIONS += Peperoni_Output_fi_FI.ts
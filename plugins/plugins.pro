@@ -5,6 +5,7 @@ SUBDIRS              += enttecdmxusbout
 SUBDIRS              += peperoniout
 SUBDIRS              += udmxout
 SUBDIRS              += midiout
+SUBDIRS              += netdmxout
 #unix:SUBDIRS         += olaout
 !macx:!win32:SUBDIRS += dmx4linuxout
 win32:SUBDIRS        += vellemanout
@@ -12,4 +13,5 @@ win32:SUBDIRS        += vellemanout
 # Input plugins
 SUBDIRS              += ewinginput
 SUBDIRS              += midiinput
+SUBDIRS              += netdmxinput
 !macx:!win32:SUBDIRS += hidinput
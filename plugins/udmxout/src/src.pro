@@ -20,7 +20,8 @@ win32 {
     SOURCES += libusb_dyn.c
 }
 
-HEADERS += ../../interfaces/qlcoutplugin.h
+HEADERS += ../../interfaces/qlcoutplugin.h \
+           ../../interfaces/qlcoutputwriter.h
 
 PRO_FILE = src.pro
 TRANSLATIONS += uDMX_Output_fi_FI.ts
@@ -40,7 +40,7 @@
  ****************************************************************************/
 
 UDMXDevice::UDMXDevice(QObject* parent, struct usb_device* device)
-        : QObject(parent)
+        : QLCOutputWriter(parent)
 {
     Q_ASSERT(device != NULL);
 
@@ -83,13 +83,14 @@ void UDMXDevice::extractName()
 
     Q_ASSERT(m_device != NULL);
 
+    /* Don't use open() here, since there's no need for a writer thread */
     if (m_handle == NULL)
     {
         needToClose = true;
-        open();
+        m_handle = usb_open(m_device);
     }
 
-    /* Check, whether open() was successful */
+    /* Check, whether usb_open() was successful */
     if (m_handle == NULL)
         return;
 
@@ -103,7 +104,10 @@ void UDMXDevice::extractName()
 
     /* Close the device if it was opened for this function only. */
     if (needToClose == true)
-        close();
+    {
+        usb_close(m_handle);
+        m_handle = NULL;
+    }
 }
 
 QString UDMXDevice::name() const
@@ -119,8 +123,26 @@ QString UDMXDevice::infoText() const
     {
         info += QString("<B>%1</B>").arg(name());
         info += QString("<P>");
-        info += tr("Device is working correctly.");
+        if (isFailing() == true)
+            info += tr("Device is not accepting DMX data.");
+        else
+            info += tr("Device is working correctly.");
         info += QString("</P>");
+
+        if (isRunning() == true)
+        {
+            info += QString("<P>");
+            info += tr("Frames written: %1").arg(transfers() - failures());
+            info += QString("<BR/>");
+            info += tr("Failed transfers: %1").arg(failures());
+            info += QString("<BR/>");
+            info += tr("Frames skipped while busy: %1").arg(skippedFrames());
+            info += QString("<BR/>");
+            info += tr("Transfer time: %1ms average, %2ms maximum")
+                    .arg(double(averageTransferTime()) / 1000000.0, 0, 'f', 2)
+                    .arg(double(maxTransferTime()) / 1000000.0, 0, 'f', 2);
+            info += QString("</P>");
+        }
     }
     else
     {
@@ -141,10 +163,16 @@ void UDMXDevice::open()
 {
     if (m_device != NULL && m_handle == NULL)
         m_handle = usb_open(m_device);
+
+    if (m_handle != NULL)
+        startWriter();
 }
 
 void UDMXDevice::close()
 {
+    /* Let the current transfer finish before closing the handle */
+    stopWriter();
+
     if (m_device != NULL && m_handle != NULL)
         usb_close(m_handle);
     m_handle = NULL;
@@ -169,6 +197,11 @@ void UDMXDevice::outputDMX(const QByteArray& universe)
     if (m_handle == NULL)
         return;
 
+    post(universe);
+}
+
+bool UDMXDevice::transfer(const QByteArray& universe)
+{
     /* Write all 512 channels */
     int r = usb_control_msg(m_handle,
                             USB_TYPE_VENDOR | USB_RECIP_DEVICE | USB_ENDPOINT_OUT,
@@ -179,5 +212,12 @@ void UDMXDevice::outputDMX(const QByteArray& universe)
                             universe.size(),        /* Size of values */
                             500);                   /* Timeout 0.5s */
     if (r < 0)
-        qWarning() << "uDMX: unable to write universe:" << usb_strerror();
+    {
+        /* Warn only about the first failure, not each frame after it */
+        if (isFailing() == false)
+            qWarning() << "uDMX: unable to write universe:" << usb_strerror();
+        return false;
+    }
+
+    return true;
 }
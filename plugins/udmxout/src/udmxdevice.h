@@ -25,13 +25,14 @@
 
 #include <QObject>
 
+#include "qlcoutputwriter.h"
 #include "qlctypes.h"
 
 struct usb_dev_handle;
 struct usb_device;
 class QString;
 
-class UDMXDevice : public QObject
+class UDMXDevice : public QLCOutputWriter
 {
     Q_OBJECT
 
@@ -76,7 +77,12 @@ protected:
      * Write
      ********************************************************************/
 public:
+    /** Post a universe to the device's writer thread. Never blocks. */
     void outputDMX(const QByteArray& universe);
+
+protected:
+    /** @reimp */
+    bool transfer(const QByteArray& universe);
 };
 
 #endif
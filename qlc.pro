@@ -23,5 +23,10 @@ QMAKE_EXTRA_TARGETS += unittests
 unix:unittests.commands += ./unittest.sh
 win32:unittests.commands += unittest.bat
 
+# Engine benchmark thru "make benchmark"
+benchmark.target = benchmark
+QMAKE_EXTRA_TARGETS += benchmark
+unix:benchmark.commands += ./benchmark.sh
+
 # Leave this on the last row of this file
 macx:SUBDIRS += macx
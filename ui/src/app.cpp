@@ -36,6 +36,7 @@
 #include <QMenuBar>
 #include <QToolBar>
 #include <QToolTip>
+#include <QVector>
 #include <QAction>
 #include <QDebug>
 #include <QLabel>
@@ -43,6 +44,7 @@
 #include <QTimer>
 #include <QStyle>
 #include <QMenu>
+#include <QPair>
 #include <QRect>
 #include <QFile>
 #include <QIcon>
@@ -53,12 +55,15 @@
 #include "outputmanager.h"
 #include "inputmanager.h"
 #include "mastertimer.h"
+#include "outputpatch.h"
 #include "docbrowser.h"
 #include "busmanager.h"
 #include "outputmap.h"
 #include "inputmap.h"
 #include "aboutbox.h"
+#include "fixture.h"
 #include "monitor.h"
+#include "tickprofiler.h"
 #include "bus.h"
 #include "app.h"
 #include "doc.h"
@@ -133,6 +138,9 @@ App::~App()
     if (Monitor::instance() != NULL)
         delete Monitor::instance();
 
+    if (TickProfiler::instance() != NULL)
+        delete TickProfiler::instance();
+
     if (FunctionManager::instance() != NULL)
         delete FunctionManager::instance();
 
@@ -156,6 +164,10 @@ App::~App()
     if (m_inputMap != NULL)
         m_inputMap->saveDefaults();
 
+    // Store master timer defaults
+    if (m_masterTimer != NULL)
+        m_masterTimer->saveDefaults();
+
     // Delete doc
     if (m_doc != NULL)
         delete m_doc;
@@ -257,8 +269,13 @@ void App::init()
 
     /* Function running engine/master timer */
     m_masterTimer = new MasterTimer(this, m_outputMap);
+    m_masterTimer->loadDefaults();
     m_masterTimer->start();
 
+    /* Let master timer measure the latency from input to output */
+    connect(m_inputMap, SIGNAL(inputDelivered(qint64)),
+            m_masterTimer, SLOT(slotInputDelivered(qint64)));
+
     /* Buses */
     Bus::init(this);
 
@@ -361,7 +378,8 @@ void App::slotSetProgressText(const QString& text)
 
 void App::initOutputMap()
 {
-    m_outputMap = new OutputMap(this, KUniverseCount);
+    /* Universes are added by initDoc() to match the workspace */
+    m_outputMap = new OutputMap(this, 0);
     Q_ASSERT(m_outputMap != NULL);
 
     /* Get progress information from output map */
@@ -459,9 +477,73 @@ void App::initDoc()
     connect(m_doc, SIGNAL(modeChanged(Doc::Mode)),
             this, SLOT(slotModeChanged(Doc::Mode)));
 
+    /* The workspace decides how many universes the mappers must have */
+    connect(m_doc, SIGNAL(universesChanged(quint32)),
+            this, SLOT(slotDocUniversesChanged(quint32)));
+    slotDocUniversesChanged(m_doc->universes());
+
+    /* Output patches need to know the workspace's 16-bit channels */
+    connect(m_doc, SIGNAL(fixtureAdded(quint32)),
+            this, SLOT(slotDocFixturesChanged()));
+    connect(m_doc, SIGNAL(fixtureRemoved(quint32)),
+            this, SLOT(slotDocFixturesChanged()));
+    connect(m_doc, SIGNAL(fixtureChanged(quint32)),
+            this, SLOT(slotDocFixturesChanged()));
+
     emit documentChanged(m_doc);
 }
 
+void App::slotDocUniversesChanged(quint32 universes)
+{
+    Q_ASSERT(m_outputMap != NULL);
+    Q_ASSERT(m_inputMap != NULL);
+
+    /* Remember the patches of the universes that go away with the previous
+       workspace and bring them back when a workspace needs them again */
+    quint32 previous = m_outputMap->universes();
+    for (quint32 i = universes; i < previous; i++)
+        m_outputMap->saveDefaults(i);
+
+    m_outputMap->setUniverses(universes);
+    for (quint32 i = previous; i < m_outputMap->universes(); i++)
+        m_outputMap->loadDefaults(i);
+
+    m_inputMap->setUniverses(universes);
+
+    /* New patches don't know about the fixtures in their universes yet */
+    slotDocFixturesChanged();
+}
+
+void App::slotDocFixturesChanged()
+{
+    Q_ASSERT(m_outputMap != NULL);
+    Q_ASSERT(m_doc != NULL);
+
+    /* Interpolating output patches fade 16-bit pan & tilt as one value */
+    QVector <QList <QPair <int,int> > > pairs(m_outputMap->universes());
+    QListIterator <Fixture*> it(m_doc->fixtures());
+    while (it.hasNext() == true)
+    {
+        Fixture* fxi = it.next();
+        Q_ASSERT(fxi != NULL);
+
+        if (fxi->universe() >= quint32(pairs.size()))
+            continue;
+
+        QListIterator <QPair <quint32,quint32> > pit(fxi->fineChannels());
+        while (pit.hasNext() == true)
+        {
+            QPair <quint32,quint32> pair(pit.next());
+            pairs[fxi->universe()] << QPair <int,int> (
+                int(fxi->address() + pair.first),
+                int(fxi->address() + pair.second));
+        }
+    }
+
+    for (int i = 0; i < pairs.size(); i++)
+        m_outputMap->patch(i)->setFineChannels(pairs.at(i));
+}
+
 void App::slotDocModified(bool state)
 {
     QString caption(App::longName());
@@ -765,6 +847,11 @@ void App::initActions()
     connect(m_controlMonitorAction, SIGNAL(triggered(bool)),
             this, SLOT(slotControlMonitor()));
 
+    m_controlProfilerAction = new QAction(QIcon(":/clock.png"),
+                                          tr("Tick &Profiler"), this);
+    connect(m_controlProfilerAction, SIGNAL(triggered(bool)),
+            this, SLOT(slotControlProfiler()));
+
 #ifndef __APPLE__
     // Full screen is rather pointless in Apple
     m_controlFullScreenAction = new QAction(QIcon(":/fullscreen.png"),
@@ -850,6 +937,7 @@ void App::initMenuBar()
     m_controlMenu->addSeparator();
     m_controlMenu->addAction(m_controlVCAction);
     m_controlMenu->addAction(m_controlMonitorAction);
+    m_controlMenu->addAction(m_controlProfilerAction);
     m_controlMenu->addSeparator();
 #ifndef __APPLE__
     // Full screen is rather pointless in Apple
@@ -1183,6 +1271,11 @@ void App::slotControlMonitor()
     Monitor::create(this);
 }
 
+void App::slotControlProfiler()
+{
+    TickProfiler::create(this);
+}
+
 #ifndef __APPLE__
 void App::slotControlFullScreen()
 {
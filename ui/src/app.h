@@ -151,6 +151,8 @@ signals:
 
 protected slots:
     void slotDocModified(bool state);
+    void slotDocUniversesChanged(quint32 universes);
+    void slotDocFixturesChanged();
 
 protected:
     void initDoc();
@@ -245,6 +247,7 @@ public slots:
 
     void slotControlVC();
     void slotControlMonitor();
+    void slotControlProfiler();
 #ifndef __APPLE__
     void slotControlFullScreen();
 #endif
@@ -278,6 +281,7 @@ protected:
     QAction* m_modeToggleAction;
     QAction* m_controlVCAction;
     QAction* m_controlMonitorAction;
+    QAction* m_controlProfilerAction;
 #ifndef __APPLE__
     QAction* m_controlFullScreenAction;
 #endif
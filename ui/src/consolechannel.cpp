@@ -522,7 +522,7 @@ void ConsoleChannel::enable(bool state)
     setChecked(state);
 
     const UniverseArray* unis(_app->outputMap()->peekUniverses());
-    m_value = unis->preGMValues()[m_fixture->universeAddress() + m_channel];
+    m_value = unis->preGMValue(m_fixture->universeAddress() + m_channel);
 
     emit valueChanged(m_channel, m_value, isEnabled());
 }
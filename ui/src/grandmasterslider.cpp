@@ -67,15 +67,13 @@ GrandMasterSlider::GrandMasterSlider(QWidget* parent) : QFrame(parent)
     // Get the current grand master value
     m_slider->setValue(_app->outputMap()->peekUniverses()->gMValue());
 
-    /* External input connection */
-    connect(_app->inputMap(), SIGNAL(inputValueChanged(quint32, quint32, uchar)),
-            this, SLOT(slotInputValueChanged(quint32, quint32, uchar)));
-
     refreshProperties();
 }
 
 GrandMasterSlider::~GrandMasterSlider()
 {
+    if (_app != NULL && _app->inputMap() != NULL)
+        _app->inputMap()->removeListener(this);
 }
 
 void GrandMasterSlider::refreshProperties()
@@ -106,6 +104,12 @@ void GrandMasterSlider::refreshProperties()
 
     setToolTip(tooltip);
 
+    /* External input source */
+    _app->inputMap()->removeListener(this);
+    _app->inputMap()->addListener(
+        VirtualConsole::properties().grandMasterInputUniverse(),
+        VirtualConsole::properties().grandMasterInputChannel(), this);
+
     /* Set properties to UniverseArray */
     UniverseArray* uni = _app->outputMap()->claimUniverses();
     uni->setGMChannelMode(VirtualConsole::properties().grandMasterChannelMode());
@@ -139,6 +143,12 @@ void GrandMasterSlider::slotValueChanged(int value)
  * External input
  *****************************************************************************/
 
+void GrandMasterSlider::receiveInput(quint32 universe, quint32 channel,
+                                     uchar value)
+{
+    slotInputValueChanged(universe, channel, value);
+}
+
 void GrandMasterSlider::slotInputValueChanged(quint32 universe, quint32 channel,
                                               uchar value)
 {
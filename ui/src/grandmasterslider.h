@@ -24,10 +24,12 @@
 
 #include <QFrame>
 
+#include "inputlistener.h"
+
 class QSlider;
 class QLabel;
 
-class GrandMasterSlider : public QFrame
+class GrandMasterSlider : public QFrame, public InputListener
 {
     Q_OBJECT
     Q_DISABLE_COPY(GrandMasterSlider)
@@ -49,6 +51,10 @@ protected:
     /*************************************************************************
      * External input
      *************************************************************************/
+public:
+    /** @reimp Passes routed input values to slotInputValueChanged() */
+    void receiveInput(quint32 universe, quint32 channel, uchar value);
+
 protected slots:
     void slotInputValueChanged(quint32 universe, quint32 channel, uchar value);
 };
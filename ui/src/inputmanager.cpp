@@ -107,6 +107,8 @@ InputManager::InputManager(QWidget* parent, Qt::WindowFlags flags)
     /* Listen to plugin configuration changes */
     connect(_app->inputMap(), SIGNAL(pluginConfigurationChanged(const QString&)),
             this, SLOT(slotPluginConfigurationChanged()));
+    connect(_app->inputMap(), SIGNAL(universesChanged(quint32)),
+            this, SLOT(slotUniversesChanged()));
 }
 
 InputManager::~InputManager()
@@ -223,6 +225,11 @@ void InputManager::slotPluginConfigurationChanged()
     updateTree();
 }
 
+void InputManager::slotUniversesChanged()
+{
+    updateTree();
+}
+
 void InputManager::slotInputValueChanged(quint32 universe, quint32 channel,
                                          uchar value)
 {
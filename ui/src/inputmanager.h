@@ -79,6 +79,9 @@ protected slots:
     /** Updates the tree whwn plugin configuration changes */
     void slotPluginConfigurationChanged();
 
+    /** Updates the tree when the number of universes changes */
+    void slotUniversesChanged();
+
     /** Listens to input data and displays a small icon to indicate a
         working connection between a plugin and an input device. */
     void slotInputValueChanged(quint32 universe, quint32 channel, uchar value);
@@ -363,9 +363,14 @@ void Monitor::timerEvent(QTimerEvent* e)
 {
     Q_UNUSED(e);
 
-    const UniverseArray* universes = _app->outputMap()->peekUniverses();
+    /* Take one consistent snapshot of the values that the timer thread is
+       writing and let all fixtures read from that */
+    UniverseArray* universes = _app->outputMap()->claimUniverses();
+    QByteArray values(universes->postGMValues());
+    _app->outputMap()->releaseUniverses();
+
     QList <MonitorFixture*> list = findChildren <MonitorFixture*>();
     QListIterator <MonitorFixture*> it(list);
     while (it.hasNext() == true)
-        it.next()->updateValues(universes->postGMValues());
+        it.next()->updateValues(values);
 }
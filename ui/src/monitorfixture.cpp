@@ -222,7 +222,12 @@ void MonitorFixture::updateValues(const QByteArray& universes)
         label = it.next();
         Q_ASSERT(label != NULL);
 
-        value = uchar(universes[fxi->universeAddress() + i]);
+        /* The snapshot may be shorter while universes are being resized */
+        int address = fxi->universeAddress() + i;
+        if (address < universes.size())
+            value = uchar(universes[address]);
+        else
+            value = 0;
         i++;
 
         /* Set the label's text to reflect the changed value */
@@ -63,6 +63,8 @@ OutputManager::OutputManager(QWidget* parent, Qt::WindowFlags flags)
     m_toolbar = new QToolBar(tr("Output Manager"), this);
     m_toolbar->addAction(QIcon(":/edit.png"), tr("Edit Mapping"),
                          this, SLOT(slotEditClicked()));
+    m_toolbar->addAction(QIcon(":/edit_add.png"), tr("Add Universe"),
+                         this, SLOT(slotAddUniverseClicked()));
     layout()->addWidget(m_toolbar);
 
     /* Tree */
@@ -89,6 +91,8 @@ OutputManager::OutputManager(QWidget* parent, Qt::WindowFlags flags)
 
     connect(_app->outputMap(), SIGNAL(pluginConfigurationChanged(const QString&)),
             this, SLOT(slotPluginConfigurationChanged()));
+    connect(_app->outputMap(), SIGNAL(universesChanged(quint32)),
+            this, SLOT(slotUniversesChanged()));
 }
 
 OutputManager::~OutputManager()
@@ -172,7 +176,7 @@ void OutputManager::slotDocumentChanged(Doc* doc)
 void OutputManager::updateTree()
 {
     m_tree->clear();
-    for (quint32 uni = 0; uni < KUniverseCount; uni++)
+    for (quint32 uni = 0; uni < _app->outputMap()->universes(); uni++)
     {
         OutputPatch* op = _app->outputMap()->patch(uni);
         updateItem(new QTreeWidgetItem(m_tree), op, uni);
@@ -196,6 +200,11 @@ void OutputManager::slotPluginConfigurationChanged()
     updateTree();
 }
 
+void OutputManager::slotUniversesChanged()
+{
+    updateTree();
+}
+
 /****************************************************************************
  * Toolbar
  ****************************************************************************/
@@ -218,3 +227,10 @@ void OutputManager::slotEditClicked()
     if (ope.exec() == QDialog::Accepted)
         updateItem(item, patch, universe);
 }
+
+void OutputManager::slotAddUniverseClicked()
+{
+    /* Universes belong to the workspace. App passes the change on to
+       OutputMap, which then has this tree updated. */
+    _app->doc()->setUniverses(_app->doc()->universes() + 1);
+}
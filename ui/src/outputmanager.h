@@ -78,6 +78,9 @@ protected slots:
     /** Updates the mapping tree */
     void slotPluginConfigurationChanged();
 
+    /** Updates the mapping tree when universes are added */
+    void slotUniversesChanged();
+
 protected:
     QTreeWidget* m_tree;
 
@@ -86,6 +89,7 @@ protected:
      *********************************************************************/
 protected slots:
     void slotEditClicked();
+    void slotAddUniverseClicked();
 
 protected:
     QToolBar* m_toolbar;
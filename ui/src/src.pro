@@ -53,6 +53,7 @@ HEADERS += aboutbox.h \
            outputpatcheditor.h \
            sceneeditor.h \
            selectinputchannel.h \
+           tickprofiler.h \
            vcbutton.h \
            vcbuttonproperties.h \
            vccuelist.h \
@@ -131,6 +132,7 @@ SOURCES += aboutbox.cpp \
            outputpatcheditor.cpp \
            sceneeditor.cpp \
            selectinputchannel.cpp \
+           tickprofiler.cpp \
            vcbutton.cpp \
            vcbuttonproperties.cpp \
            vccuelist.cpp \
@@ -0,0 +1,302 @@
+/*
+  Q Light Controller
+  tickprofiler.cpp
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <QTreeWidgetItem>
+#include <QMdiSubWindow>
+#include <QTreeWidget>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <QSettings>
+#include <QMdiArea>
+#include <QToolBar>
+#include <QAction>
+#include <QIcon>
+
+#include "tickprofiler.h"
+#include "mastertimer.h"
+#include "dmxsource.h"
+#include "function.h"
+#include "vcwidget.h"
+#include "apputil.h"
+#include "app.h"
+#include "doc.h"
+
+#define SETTINGS_GEOMETRY "tickprofiler/geometry"
+
+#define KColumnName    0
+#define KColumnCount   1
+#define KColumnAverage 2
+#define KColumnMax     3
+#define KColumnTotal   4
+
+extern App* _app;
+
+TickProfiler* TickProfiler::s_instance = NULL;
+
+/*****************************************************************************
+ * Initialization
+ *****************************************************************************/
+
+TickProfiler::TickProfiler(QWidget* parent, Qt::WindowFlags f)
+    : QWidget(parent, f)
+{
+    new QVBoxLayout(this);
+
+    m_tree = new QTreeWidget(this);
+    m_tree->setRootIsDecorated(true);
+    m_tree->setAllColumnsShowFocus(true);
+    m_tree->setSelectionMode(QAbstractItemView::NoSelection);
+    m_tree->setHeaderLabels(QStringList() << tr("Name") << tr("Count")
+                                          << tr("Average (usec)")
+                                          << tr("Max (usec)")
+                                          << tr("Total (msec)"));
+    layout()->addWidget(m_tree);
+
+    m_ticksItem = new QTreeWidgetItem(m_tree);
+    m_ticksItem->setText(KColumnName, tr("Tick"));
+    m_ticksItem->setExpanded(true);
+
+    m_functionsItem = new QTreeWidgetItem(m_tree);
+    m_functionsItem->setText(KColumnName, tr("Functions"));
+    m_functionsItem->setExpanded(true);
+
+    m_dmxSourcesItem = new QTreeWidgetItem(m_tree);
+    m_dmxSourcesItem->setText(KColumnName, tr("DMX sources"));
+    m_dmxSourcesItem->setExpanded(true);
+
+    m_inputItem = new QTreeWidgetItem(m_tree);
+    m_inputItem->setText(KColumnName, tr("Input to output"));
+
+    initToolBar();
+    updateTree();
+
+    m_timer = startTimer(500);
+    QWidget::show();
+}
+
+TickProfiler::~TickProfiler()
+{
+    killTimer(m_timer);
+    m_timer = 0;
+
+    QSettings settings;
+#ifdef __APPLE__
+    settings.setValue(SETTINGS_GEOMETRY, saveGeometry());
+#else
+    settings.setValue(SETTINGS_GEOMETRY, parentWidget()->saveGeometry());
+#endif
+
+    /* Reset the singleton instance */
+    TickProfiler::s_instance = NULL;
+}
+
+void TickProfiler::create(QWidget* parent)
+{
+    QWidget* window;
+
+    /* Must not create more than one instance */
+    if (s_instance != NULL)
+        return;
+
+#ifdef __APPLE__
+    /* Create a separate window for OSX */
+    s_instance = new TickProfiler(parent, Qt::Window);
+    window = s_instance;
+#else
+    /* Create an MDI window for X11 & Win32 */
+    QMdiArea* area = qobject_cast<QMdiArea*> (_app->centralWidget());
+    Q_ASSERT(area != NULL);
+    s_instance = new TickProfiler(parent);
+    window = area->addSubWindow(s_instance);
+#endif
+
+    /* Set some common properties for the window and show it */
+    window->setAttribute(Qt::WA_DeleteOnClose);
+    window->setWindowIcon(QIcon(":/clock.png"));
+    window->setWindowTitle(tr("Tick Profiler"));
+    window->setContextMenuPolicy(Qt::CustomContextMenu);
+
+    QSettings settings;
+    QVariant var = settings.value(SETTINGS_GEOMETRY);
+    if (var.isValid() == true)
+        window->restoreGeometry(var.toByteArray());
+    AppUtil::ensureWidgetIsVisible(window);
+    window->show();
+}
+
+/*****************************************************************************
+ * Tool bar
+ *****************************************************************************/
+
+void TickProfiler::initToolBar()
+{
+    QToolBar* toolBar = new QToolBar(this);
+
+    Q_ASSERT(layout() != NULL);
+    layout()->setMenuBar(toolBar);
+
+    m_profilingAction = toolBar->addAction(QIcon(":/clock.png"),
+                                           tr("Enable profiling"));
+    m_profilingAction->setToolTip(tr("Measure the time spent in each tick"));
+    m_profilingAction->setCheckable(true);
+    m_profilingAction->setChecked(_app->masterTimer()->isProfiling());
+    connect(m_profilingAction, SIGNAL(toggled(bool)),
+            this, SLOT(slotProfilingToggled(bool)));
+
+    toolBar->addAction(QIcon(":/editclear.png"), tr("Reset"),
+                       this, SLOT(slotResetClicked()));
+}
+
+void TickProfiler::slotProfilingToggled(bool enable)
+{
+    _app->masterTimer()->setProfiling(enable);
+}
+
+void TickProfiler::slotResetClicked()
+{
+    _app->masterTimer()->resetProfile();
+    updateTree();
+}
+
+/*****************************************************************************
+ * Profile tree
+ *****************************************************************************/
+
+static bool costGreaterThan(const QPair <QString,TickProfile::Cost>& a,
+                            const QPair <QString,TickProfile::Cost>& b)
+{
+    return a.second.total > b.second.total;
+}
+
+void TickProfiler::updateTree()
+{
+    MasterTimer* timer = _app->masterTimer();
+    Q_ASSERT(timer != NULL);
+
+    TickProfile profile = timer->profile();
+
+    /* Tick stages, in the order they are run */
+    m_ticksItem->setText(KColumnCount, QString::number(profile.ticks));
+    for (int i = 0; i < TickProfile::SpanCount; i++)
+    {
+        TickProfile::Span span = TickProfile::Span(i);
+        updateItem(m_ticksItem, i, TickProfile::spanToString(span),
+                   profile.spans[i]);
+    }
+
+    /* Functions, most expensive first */
+    QList <QPair <QString,TickProfile::Cost> > functions;
+    QHashIterator <t_function_id,TickProfile::Cost> fit(profile.functions);
+    while (fit.hasNext() == true)
+    {
+        fit.next();
+
+        QString name;
+        Function* function = _app->doc()->function(fit.key());
+        if (function != NULL)
+            name = function->name();
+        else
+            name = tr("Removed function %1").arg(fit.key());
+
+        functions << QPair <QString,TickProfile::Cost> (name, fit.value());
+    }
+
+    qSort(functions.begin(), functions.end(), costGreaterThan);
+    for (int i = 0; i < functions.size(); i++)
+        updateItem(m_functionsItem, i, functions[i].first, functions[i].second);
+    removeItems(m_functionsItem, functions.size());
+
+    /* DMX sources that are still registered, most expensive first */
+    QList <DMXSource*> registered = timer->dmxSources();
+    QList <QPair <QString,TickProfile::Cost> > sources;
+    QHashIterator <DMXSource*,TickProfile::Cost> sit(profile.dmxSources);
+    while (sit.hasNext() == true)
+    {
+        sit.next();
+        if (registered.contains(sit.key()) == false)
+            continue;
+
+        sources << QPair <QString,TickProfile::Cost> (dmxSourceName(sit.key()),
+                                                      sit.value());
+    }
+
+    qSort(sources.begin(), sources.end(), costGreaterThan);
+    for (int i = 0; i < sources.size(); i++)
+        updateItem(m_dmxSourcesItem, i, sources[i].first, sources[i].second);
+    removeItems(m_dmxSourcesItem, sources.size());
+
+    /* Latency from input plugins to the tick that writes out the input */
+    setCost(m_inputItem, profile.inputLatency);
+}
+
+void TickProfiler::updateItem(QTreeWidgetItem* parent, int index,
+                              const QString& name,
+                              const TickProfile::Cost& cost)
+{
+    Q_ASSERT(parent != NULL);
+
+    QTreeWidgetItem* item = parent->child(index);
+    if (item == NULL)
+        item = new QTreeWidgetItem(parent);
+
+    item->setText(KColumnName, name);
+    setCost(item, cost);
+}
+
+void TickProfiler::setCost(QTreeWidgetItem* item,
+                           const TickProfile::Cost& cost)
+{
+    Q_ASSERT(item != NULL);
+
+    item->setText(KColumnCount, QString::number(cost.count));
+    item->setText(KColumnAverage,
+                  QString::number(double(cost.average()) / 1000.0, 'f', 1));
+    item->setText(KColumnMax, QString::number(double(cost.max) / 1000.0, 'f', 1));
+    item->setText(KColumnTotal,
+                  QString::number(double(cost.total) / 1000000.0, 'f', 1));
+}
+
+void TickProfiler::removeItems(QTreeWidgetItem* parent, int index)
+{
+    Q_ASSERT(parent != NULL);
+
+    while (parent->childCount() > index)
+        delete parent->takeChild(parent->childCount() - 1);
+}
+
+QString TickProfiler::dmxSourceName(DMXSource* source) const
+{
+    VCWidget* widget = dynamic_cast <VCWidget*> (source);
+    if (widget != NULL)
+        return widget->caption();
+    else
+        return tr("Unknown source");
+}
+
+/*****************************************************************************
+ * Timer
+ *****************************************************************************/
+
+void TickProfiler::timerEvent(QTimerEvent* e)
+{
+    Q_UNUSED(e);
+    updateTree();
+}
@@ -0,0 +1,118 @@
+/*
+  Q Light Controller
+  tickprofiler.h
+
+  Copyright (c) Heikki Junnila
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  Version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details. The license is
+  in the file "COPYING".
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef TICKPROFILER_H
+#define TICKPROFILER_H
+
+#include <QWidget>
+
+#include "tickprofile.h"
+
+class QTreeWidgetItem;
+class QTreeWidget;
+class DMXSource;
+class QAction;
+
+class TickProfiler : public QWidget
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(TickProfiler)
+
+    /*********************************************************************
+     * Initialization
+     *********************************************************************/
+public:
+    /** Get the profiler singleton instance. Can be NULL. */
+    static TickProfiler* instance() {
+        return s_instance;
+    }
+
+    /** Create a TickProfiler with parent. Fails if s_instance is not NULL. */
+    static void create(QWidget* parent);
+
+    /** Normal public destructor */
+    ~TickProfiler();
+
+protected:
+    /** Protected constructor to prevent multiple instances. */
+    TickProfiler(QWidget* parent, Qt::WindowFlags f = 0);
+
+protected:
+    /** The singleton TickProfiler instance */
+    static TickProfiler* s_instance;
+
+    /*********************************************************************
+     * Tool bar
+     *********************************************************************/
+protected:
+    /** Create tool bar */
+    void initToolBar();
+
+protected slots:
+    /** Enable or disable profiling in MasterTimer */
+    void slotProfilingToggled(bool enable);
+
+    /** Clear the accumulated profile */
+    void slotResetClicked();
+
+protected:
+    QAction* m_profilingAction;
+
+    /*********************************************************************
+     * Profile tree
+     *********************************************************************/
+protected:
+    /** Fill the tree with the latest profile from MasterTimer */
+    void updateTree();
+
+    /** Update (or create) a child item under $parent for one cost */
+    void updateItem(QTreeWidgetItem* parent, int index, const QString& name,
+                    const TickProfile::Cost& cost);
+
+    /** Show one cost in the given item's columns */
+    void setCost(QTreeWidgetItem* item, const TickProfile::Cost& cost);
+
+    /** Remove children from $parent, starting from $index */
+    void removeItems(QTreeWidgetItem* parent, int index);
+
+    /** Get a name for a DMX source */
+    QString dmxSourceName(DMXSource* source) const;
+
+protected:
+    QTreeWidget* m_tree;
+    QTreeWidgetItem* m_ticksItem;
+    QTreeWidgetItem* m_functionsItem;
+    QTreeWidgetItem* m_dmxSourcesItem;
+    QTreeWidgetItem* m_inputItem;
+
+    /*********************************************************************
+     * Timer
+     *********************************************************************/
+protected:
+    /** Timer that periodically fetches the latest profile */
+    void timerEvent(QTimerEvent* e);
+
+protected:
+    /** Timer ID */
+    int m_timer;
+};
+
+#endif
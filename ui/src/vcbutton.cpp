@@ -659,7 +659,7 @@ void VCButton::pressFunction()
     {
         f = _app->doc()->function(m_function);
         if (f != NULL)
-            f->flash(_app->masterTimer());
+            _app->masterTimer()->flashFunction(f, true);
     }
 }
 
@@ -671,7 +671,7 @@ void VCButton::releaseFunction()
     {
         f = _app->doc()->function(m_function);
         if (f != NULL)
-            f->unFlash(_app->masterTimer());
+            _app->masterTimer()->flashFunction(f, false);
     }
 }
 
@@ -84,14 +84,17 @@ VCCueList::VCCueList(QWidget* parent) : VCWidget(parent)
     connect(_app->doc(), SIGNAL(functionChanged(t_function_id)),
             this, SLOT(slotFunctionChanged(t_function_id)));
 
-    setNextInputSource(InputMap::invalidUniverse(), KInputChannelInvalid);
-    setPreviousInputSource(InputMap::invalidUniverse(), KInputChannelInvalid);
+    m_nextInputUniverse = InputMap::invalidUniverse();
+    m_nextInputChannel = KInputChannelInvalid;
+    m_previousInputUniverse = InputMap::invalidUniverse();
+    m_previousInputChannel = KInputChannelInvalid;
     m_nextLatestValue = 0;
     m_previousLatestValue = 0;
 }
 
 VCCueList::~VCCueList()
 {
+    /* VCWidget removes all input routes, including next & previous */
 }
 
 /*****************************************************************************
@@ -286,24 +289,32 @@ void VCCueList::slotKeyPressed(const QKeySequence& keySequence)
 
 void VCCueList::setNextInputSource(quint32 uni, quint32 ch)
 {
-    disconnect(_app->inputMap(), SIGNAL(inputValueChanged(quint32, quint32, uchar)),
-               this, SLOT(slotNextInputValueChanged(quint32, quint32, uchar)));
     m_nextInputUniverse = uni;
     m_nextInputChannel = ch;
-    if (uni != InputMap::invalidUniverse() && ch != KInputChannelInvalid)
-        connect(_app->inputMap(), SIGNAL(inputValueChanged(quint32, quint32, uchar)),
-                this, SLOT(slotNextInputValueChanged(quint32, quint32, uchar)));
+    updateInputRoutes();
 }
 
 void VCCueList::setPreviousInputSource(quint32 uni, quint32 ch)
 {
-    disconnect(_app->inputMap(), SIGNAL(inputValueChanged(quint32, quint32, uchar)),
-               this, SLOT(slotPreviousInputValueChanged(quint32, quint32, uchar)));
     m_previousInputUniverse = uni;
     m_previousInputChannel = ch;
-    if (uni != InputMap::invalidUniverse() && ch != KInputChannelInvalid)
-        connect(_app->inputMap(), SIGNAL(inputValueChanged(quint32, quint32, uchar)),
-                this, SLOT(slotPreviousInputValueChanged(quint32, quint32, uchar)));
+    updateInputRoutes();
+}
+
+void VCCueList::updateInputRoutes()
+{
+    /* Next & previous sources may share the same channel, so remove this
+       from all channels and add it back to each of the current ones. */
+    clearInputRoutes();
+    addInputRoute(m_inputUniverse, m_inputChannel);
+    addInputRoute(m_nextInputUniverse, m_nextInputChannel);
+    addInputRoute(m_previousInputUniverse, m_previousInputChannel);
+}
+
+void VCCueList::receiveInput(quint32 universe, quint32 channel, uchar value)
+{
+    slotNextInputValueChanged(universe, channel, value);
+    slotPreviousInputValueChanged(universe, channel, value);
 }
 
 void VCCueList::slotNextInputValueChanged(quint32 universe, quint32 channel, uchar value)
@@ -172,6 +172,13 @@ public:
         return m_previousInputChannel;
     }
 
+    /** @reimp Passes routed input values to next & previous handlers */
+    void receiveInput(quint32 universe, quint32 channel, uchar value);
+
+protected:
+    /** @reimp Listen to the current, next & previous input sources */
+    void updateInputRoutes();
+
 protected slots:
     void slotNextInputValueChanged(quint32 universe, quint32 channel, uchar value);
     void slotPreviousInputValueChanged(quint32 universe, quint32 channel, uchar value);
@@ -77,10 +77,6 @@ VCDockSlider::VCDockSlider(QWidget* parent, quint32 bus) : QFrame(parent)
     connect(Bus::instance(), SIGNAL(valueChanged(quint32, quint32)),
             this, SLOT(slotBusValueChanged(quint32, quint32)));
 
-    /* External input connection */
-    connect(_app->inputMap(), SIGNAL(inputValueChanged(quint32, quint32, uchar)),
-            this, SLOT(slotInputValueChanged(quint32, quint32, uchar)));
-
     /* Property refresh has effect on bus value, store it now and restore below */
     quint32 busValue = Bus::instance()->value(m_bus);
 
@@ -96,6 +92,8 @@ VCDockSlider::VCDockSlider(QWidget* parent, quint32 bus) : QFrame(parent)
 
 VCDockSlider::~VCDockSlider()
 {
+    if (_app != NULL && _app->inputMap() != NULL)
+        _app->inputMap()->removeListener(this);
 }
 
 /*****************************************************************************
@@ -106,18 +104,28 @@ void VCDockSlider::refreshProperties()
 {
     quint32 low = 0;
     quint32 high = 10;
+    quint32 uni;
+    quint32 ch;
 
     if (m_bus == Bus::defaultFade())
     {
         low = VirtualConsole::properties().fadeLowLimit();
         high = VirtualConsole::properties().fadeHighLimit();
+        uni = VirtualConsole::properties().fadeInputUniverse();
+        ch = VirtualConsole::properties().fadeInputChannel();
     }
     else
     {
         low = VirtualConsole::properties().holdLowLimit();
         high = VirtualConsole::properties().holdHighLimit();
+        uni = VirtualConsole::properties().holdInputUniverse();
+        ch = VirtualConsole::properties().holdInputChannel();
     }
 
+    /* External input source */
+    _app->inputMap()->removeListener(this);
+    _app->inputMap()->addListener(uni, ch, this);
+
     Q_ASSERT(m_slider != NULL);
     m_slider->setRange(low * MasterTimer::frequency(), high * MasterTimer::frequency());
 
@@ -208,6 +216,12 @@ void VCDockSlider::slotTapButtonClicked()
  * External input
  *****************************************************************************/
 
+void VCDockSlider::receiveInput(quint32 universe, quint32 channel,
+                                uchar value)
+{
+    slotInputValueChanged(universe, channel, value);
+}
+
 void VCDockSlider::slotInputValueChanged(quint32 universe, quint32 channel,
                                          uchar value)
 {
@@ -25,13 +25,14 @@
 #include <QFrame>
 #include <QTime>
 
+#include "inputlistener.h"
 #include "qlctypes.h"
 
 class QToolButton;
 class QSlider;
 class QLabel;
 
-class VCDockSlider : public QFrame
+class VCDockSlider : public QFrame, public InputListener
 {
     Q_OBJECT
     Q_DISABLE_COPY(VCDockSlider)
@@ -79,6 +80,10 @@ protected:
     /*************************************************************************
      * External input
      *************************************************************************/
+public:
+    /** @reimp Passes routed input values to slotInputValueChanged() */
+    void receiveInput(quint32 universe, quint32 channel, uchar value);
+
 protected slots:
     /** Slot for external input value change signals */
     void slotInputValueChanged(quint32 universe, quint32 channel, uchar value);
@@ -81,6 +81,7 @@ VCSlider::VCSlider(QWidget* parent) : VCWidget(parent)
     m_sliderValue = 0;
     m_levelValue = 0;
     m_levelValueChanged = false;
+    m_levelIntensityChannels = 0;
 
     m_time = NULL;
 
@@ -144,6 +145,12 @@ VCSlider::VCSlider(QWidget* parent) : VCWidget(parent)
        they no longer point to an existing fixture->channel */
     connect(_app->doc(), SIGNAL(fixtureRemoved(quint32)),
             this, SLOT(slotFixtureRemoved(quint32)));
+
+    /* Fixtures' addresses and modes are needed for resolving channels */
+    connect(_app->doc(), SIGNAL(fixtureAdded(quint32)),
+            this, SLOT(slotFixtureChanged(quint32)));
+    connect(_app->doc(), SIGNAL(fixtureChanged(quint32)),
+            this, SLOT(slotFixtureChanged(quint32)));
 }
 
 VCSlider::~VCSlider()
@@ -187,6 +194,7 @@ bool VCSlider::copyFrom(VCWidget* widget)
     setLevelLowLimit(slider->levelLowLimit());
     setLevelHighLimit(slider->levelHighLimit());
     m_levelChannels = slider->m_levelChannels;
+    resolveLevelChannels();
 
     /* Copy bus stuff */
     setBusLowLimit(slider->busLowLimit());
@@ -471,18 +479,21 @@ void VCSlider::addLevelChannel(quint32 fixture, quint32 channel)
     {
         m_levelChannels.append(lch);
         qSort(m_levelChannels.begin(), m_levelChannels.end());
+        resolveLevelChannels();
     }
 }
 
 void VCSlider::removeLevelChannel(quint32 fixture, quint32 channel)
 {
     LevelChannel lch(fixture, channel);
-    m_levelChannels.removeAll(lch);
+    if (m_levelChannels.removeAll(lch) > 0)
+        resolveLevelChannels();
 }
 
 void VCSlider::clearLevelChannels()
 {
     m_levelChannels.clear();
+    resolveLevelChannels();
 }
 
 QList <VCSlider::LevelChannel> VCSlider::levelChannels()
@@ -515,6 +526,7 @@ void VCSlider::setLevelValue(uchar value)
     m_levelValueMutex.lock();
     m_levelValue = value;
     m_levelValueChanged = true;
+    m_levelValues.fill(value);
     m_levelValueMutex.unlock();
 }
 
@@ -523,14 +535,76 @@ uchar VCSlider::levelValue() const
     return m_levelValue;
 }
 
+void VCSlider::resolveLevelChannels()
+{
+    QVector <int> intensityAddresses;
+    QVector <int> addresses;
+    QVector <QLCChannel::Group> groups;
+
+    QListIterator <LevelChannel> it(m_levelChannels);
+    while (it.hasNext() == true)
+    {
+        LevelChannel lch(it.next());
+        Fixture* fxi = _app->doc()->fixture(lch.fixture);
+        if (fxi == NULL)
+            continue;
+
+        const QLCChannel* qlcch = fxi->channel(lch.channel);
+        if (qlcch == NULL)
+            continue;
+
+        /* Intensity channels are written on every tick (HTP), others only
+           when the value changes (LTP), so keep them apart */
+        quint32 address = fxi->channelAddress(lch.channel);
+        if (qlcch->group() == QLCChannel::Intensity)
+        {
+            intensityAddresses << int(address);
+        }
+        else
+        {
+            addresses << int(address);
+            groups << qlcch->group();
+        }
+    }
+
+    m_levelValueMutex.lock();
+    m_levelIntensityChannels = intensityAddresses.size();
+    m_levelAddresses = intensityAddresses + addresses;
+    m_levelGroups.fill(QLCChannel::Intensity, m_levelIntensityChannels);
+    m_levelGroups += groups;
+    m_levelValues.fill(m_levelValue, m_levelAddresses.size());
+    m_levelValueMutex.unlock();
+}
+
 void VCSlider::slotFixtureRemoved(quint32 fxi_id)
 {
+    bool removed = false;
+
     QMutableListIterator <LevelChannel> it(m_levelChannels);
     while (it.hasNext() == true)
     {
         it.next();
         if (it.value().fixture == fxi_id)
+        {
             it.remove();
+            removed = true;
+        }
+    }
+
+    if (removed == true)
+        resolveLevelChannels();
+}
+
+void VCSlider::slotFixtureChanged(quint32 fxi_id)
+{
+    QListIterator <LevelChannel> it(m_levelChannels);
+    while (it.hasNext() == true)
+    {
+        if (it.next().fixture == fxi_id)
+        {
+            resolveLevelChannels();
+            break;
+        }
     }
 }
 
@@ -544,29 +618,19 @@ void VCSlider::writeDMX(MasterTimer* timer, UniverseArray* universes)
 
     m_levelValueMutex.lock();
 
-    QListIterator <LevelChannel> it(m_levelChannels);
-    while (it.hasNext() == true)
-    {
-        LevelChannel lch(it.next());
-        Fixture* fxi = _app->doc()->fixture(lch.fixture);
-        if (fxi != NULL)
-        {
-            const QLCChannel* qlcch = fxi->channel(lch.channel);
-            if (qlcch == NULL)
-                continue;
+    /* Unless the value has changed, only intensity channels are written.
+       LTP in effect for the rest. */
+    int count = m_levelAddresses.size();
+    if (m_levelValueChanged == false)
+        count = m_levelIntensityChannels;
 
-            if (qlcch->group() != QLCChannel::Intensity &&
-                m_levelValueChanged == false)
-            {
-                /* Value has not changed and this is not an intensity channel.
-                   LTP in effect. */
-                continue;
-            }
-
-            quint32 dmx_ch = fxi->channelAddress(lch.channel);
-            universes->write(dmx_ch, m_levelValue, qlcch->group());
-        }
+    if (count > 0)
+    {
+        universes->writeBlock(m_levelAddresses.constData(),
+                              m_levelValues.constData(),
+                              m_levelGroups.constData(), count);
     }
+
     m_levelValueChanged = false;
     m_levelValueMutex.unlock();
 }
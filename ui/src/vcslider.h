@@ -22,9 +22,11 @@
 #ifndef VCSLIDER_H
 #define VCSLIDER_H
 
+#include <QVector>
 #include <QMutex>
 #include <QList>
 
+#include "qlcchannel.h"
 #include "dmxsource.h"
 #include "vcwidget.h"
 #include "qlctypes.h"
@@ -340,19 +342,38 @@ protected:
      */
     uchar levelValue() const;
 
+    /**
+     * Resolve the level channels into DMX addresses & channel groups for
+     * writeDMX(), so that the timer thread doesn't need to look up fixtures.
+     * Must be called whenever the level channels or their fixtures change.
+     */
+    void resolveLevelChannels();
+
 protected slots:
     /** Removes all level channels related to removed fixture */
     void slotFixtureRemoved(quint32 fxi_id);
 
+    /** Resolves the level channels again when a fixture is added/changed */
+    void slotFixtureChanged(quint32 fxi_id);
+
 protected:
     QList <VCSlider::LevelChannel> m_levelChannels;
     uchar m_levelLowLimit;
     uchar m_levelHighLimit;
 
+    /** Guards the level value and the resolved channels below */
     QMutex m_levelValueMutex;
     bool m_levelValueChanged;
     uchar m_levelValue;
 
+    /** Resolved level channels, intensity channels first */
+    QVector <int> m_levelAddresses;
+    QVector <QLCChannel::Group> m_levelGroups;
+    int m_levelIntensityChannels;
+
+    /** The level value for each resolved channel */
+    QVector <uchar> m_levelValues;
+
     /*********************************************************************
      * DMXSource
      *********************************************************************/
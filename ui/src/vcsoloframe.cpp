@@ -35,6 +35,7 @@
 #include "qlcfile.h"
 #include "virtualconsole.h"
 #include "vcsoloframe.h"
+#include "mastertimer.h"
 #include "vcbutton.h"
 #include "function.h"
 #include "app.h"
@@ -134,6 +135,7 @@ void VCSoloFrame::slotButtonFunctionStarting()
         // get every button that is a child of this soloFrame and turn their
         // functions off
         QListIterator <VCButton*> it(findChildren<VCButton*>());
+        TimerFuture stopped;
 
         while (it.hasNext() == true)
         {
@@ -143,10 +145,15 @@ void VCSoloFrame::slotButtonFunctionStarting()
                 Function* f = _app->doc()->function(button->function());
                 if (f != NULL)
                 {
-                    f->stopAndWait();
+                    stopped = _app->masterTimer()->stopFunction(f);
                 }
             }
         }
+
+        // all of them are stopped on the same tick, but don't block the UI
+        // for more than 2s in case the timer is stuck
+        if (stopped.waitForFinished(2000) == false)
+            qWarning() << Q_FUNC_INFO << "Functions didn't stop within 2s";
     }
 }
 
@@ -92,6 +92,9 @@ VCWidget::VCWidget(QWidget* parent) : QWidget(parent)
 
 VCWidget::~VCWidget()
 {
+    /* Stop receiving external input */
+    if (_app != NULL && _app->inputMap() != NULL)
+        clearInputRoutes();
 }
 
 /*****************************************************************************
@@ -311,48 +314,55 @@ void VCWidget::setInputSource(quint32 uni, quint32 ch)
     if (uni == InputMap::invalidUniverse() || ch == KInputChannelInvalid)
     {
         /* If either one of the new values is invalid we end up here
-           to disconnect from inputmap and setting both of the values
-           invalid. */
+           to stop listening and setting both of the values invalid. */
         m_inputUniverse = InputMap::invalidUniverse();
         m_inputChannel = KInputChannelInvalid;
-
-        /* Even though we might not be connected, it is safe to do a
-           disconnect in any case. */
-        disconnect(_app->inputMap(),
-                   SIGNAL(inputValueChanged(quint32,
-                                            quint32,
-                                            uchar)),
-                   this, SLOT(slotInputValueChanged(quint32,
-                                                    quint32,
-                                                    uchar)));
     }
-    else if (m_inputUniverse == InputMap::invalidUniverse() ||
-             m_inputChannel == KInputChannelInvalid)
+    else
     {
-        /* Execution comes here only if both of the new values
-           are valid and the existing values are invalid, in which
-           case a new connection must be made. */
+        /* Input map delivers only the values of this universe & channel */
         m_inputUniverse = uni;
         m_inputChannel = ch;
-
-        connect(_app->inputMap(),
-                SIGNAL(inputValueChanged(quint32,
-                                         quint32,
-                                         uchar)),
-                this,
-                SLOT(slotInputValueChanged(quint32,
-                                           quint32,
-                                           uchar)));
     }
-    else
+
+    updateInputRoutes();
+}
+
+void VCWidget::updateInputRoutes()
+{
+    clearInputRoutes();
+    addInputRoute(m_inputUniverse, m_inputChannel);
+}
+
+void VCWidget::addInputRoute(quint32 uni, quint32 ch)
+{
+    /* Invalid sources are ignored by InputMap, so don't track them either */
+    if (uni == InputMap::invalidUniverse() || ch == KInputChannelInvalid)
+        return;
+
+    QPair <quint32,quint32> route(uni, ch);
+    if (m_inputRoutes.contains(route) == true)
+        return;
+
+    _app->inputMap()->addListener(uni, ch, this);
+    m_inputRoutes.append(route);
+}
+
+void VCWidget::clearInputRoutes()
+{
+    QListIterator <QPair <quint32,quint32> > it(m_inputRoutes);
+    while (it.hasNext() == true)
     {
-        /* Execution comes here only if the current uni & channel are
-         * valid and the new ones are valid as well. So we don't do a
-         * new connection, which would end up in duplicate values.
-         * Just update the new values and get it over with. */
-        m_inputUniverse = uni;
-        m_inputChannel = ch;
+        QPair <quint32,quint32> route(it.next());
+        _app->inputMap()->removeListener(route.first, route.second, this);
     }
+
+    m_inputRoutes.clear();
+}
+
+void VCWidget::receiveInput(quint32 universe, quint32 channel, uchar value)
+{
+    slotInputValueChanged(universe, channel, value);
 }
 
 void VCWidget::slotInputValueChanged(quint32 universe,
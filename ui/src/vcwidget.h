@@ -23,8 +23,11 @@
 #define VCWIDGET_H
 
 #include <QKeySequence>
+#include <QList>
+#include <QPair>
 #include <QWidget>
 
+#include "inputlistener.h"
 #include "qlctypes.h"
 #include "app.h"
 
@@ -59,7 +62,7 @@ class QFile;
 #define KXMLQLCVCWidgetInputUniverse "Universe"
 #define KXMLQLCVCWidgetInputChannel "Channel"
 
-class VCWidget : public QWidget
+class VCWidget : public QWidget, public InputListener
 {
     Q_OBJECT
 
@@ -235,16 +238,35 @@ public:
         return m_inputChannel;
     }
 
+    /** @reimp Passes routed input values to slotInputValueChanged() */
+    void receiveInput(quint32 universe, quint32 channel, uchar value);
+
 protected slots:
     /** Slot that receives external input data */
     virtual void slotInputValueChanged(quint32 universe,
                                        quint32 channel,
                                        uchar value);
 
+protected:
+    /** Register this widget to all of its input sources in InputMap.
+        The default implementation listens to inputUniverse() & inputChannel()
+        only; widgets with more sources reimplement this and call
+        addInputRoute() for each one of them. */
+    virtual void updateInputRoutes();
+
+    /** Listen to the given universe & channel and remember the route */
+    void addInputRoute(quint32 uni, quint32 ch);
+
+    /** Stop listening to all routes added with addInputRoute() */
+    void clearInputRoutes();
+
 protected:
     quint32 m_inputUniverse;
     quint32 m_inputChannel;
 
+    /** Routes (universe, channel) that this widget is registered to */
+    QList <QPair <quint32,quint32> > m_inputRoutes;
+
     /*********************************************************************
      * Key sequence handler
      *********************************************************************/
@@ -37,6 +37,7 @@
 
 #include "vcxypadproperties.h"
 #include "virtualconsole.h"
+#include "universearray.h"
 #include "mastertimer.h"
 #include "vcxypad.h"
 #include "fixture.h"
@@ -66,6 +67,16 @@ VCXYPad::VCXYPad(QWidget* parent) : VCWidget(parent)
     m_currentXYPosition.setX(width() / 2);
     m_currentXYPosition.setY(height() / 2);
     m_currentXYPositionChanged = false;
+    m_currentX = 0.5;
+    m_currentY = 0.5;
+
+    /* Armed fixtures need to be resolved again when fixtures change */
+    connect(_app->doc(), SIGNAL(fixtureAdded(quint32)),
+            this, SLOT(slotFixtureChanged(quint32)));
+    connect(_app->doc(), SIGNAL(fixtureChanged(quint32)),
+            this, SLOT(slotFixtureChanged(quint32)));
+    connect(_app->doc(), SIGNAL(fixtureRemoved(quint32)),
+            this, SLOT(slotFixtureChanged(quint32)));
 }
 
 VCXYPad::~VCXYPad()
@@ -143,14 +154,68 @@ void VCXYPad::clearFixtures()
     m_fixtures.clear();
 }
 
+void VCXYPad::resolveFixtures()
+{
+    QVector <VCXYPadFixture> fixtures;
+    QVector <int> addresses;
+    QVector <QLCChannel::Group> groups;
+
+    QListIterator <VCXYPadFixture> it(m_fixtures);
+    while (it.hasNext() == true)
+    {
+        const VCXYPadFixture& fixture(it.next());
+        if (fixture.resolveChannels(addresses, groups) > 0)
+            fixtures << fixture;
+    }
+
+    m_currentXYPositionMutex.lock();
+    m_armedFixtures = fixtures;
+    m_armedAddresses = addresses;
+    m_armedGroups = groups;
+    m_armedValues.fill(0, addresses.size());
+    m_currentXYPositionMutex.unlock();
+}
+
+void VCXYPad::slotFixtureChanged(quint32 fxi_id)
+{
+    if (mode() != Doc::Operate)
+        return;
+
+    QMutableListIterator <VCXYPadFixture> it(m_fixtures);
+    while (it.hasNext() == true)
+    {
+        if (it.next().fixture() == fxi_id)
+        {
+            VCXYPadFixture fxi(it.value());
+            fxi.arm();
+            it.setValue(fxi);
+        }
+    }
+
+    resolveFixtures();
+}
+
 /*****************************************************************************
  * Current XY position
  *****************************************************************************/
 
 void VCXYPad::setCurrentXYPosition(const QPoint& point)
 {
+    /* Scale XY coordinate values to 0.0 - 1.0 */
+    double x = 0;
+    double y = 0;
+    if (width() > 0 && height() > 0)
+    {
+        x = SCALE(double(point.x()), double(0), double(width()),
+                  double(0), double(1));
+        y = SCALE(double(point.y()), double(0), double(height()),
+                  double(0), double(1));
+    }
+
     m_currentXYPositionMutex.lock();
     m_currentXYPosition = point;
+    m_currentX = x;
+    m_currentY = y;
     m_currentXYPositionChanged = true;
     m_currentXYPositionMutex.unlock();
 
@@ -166,22 +231,22 @@ void VCXYPad::writeDMX(MasterTimer* timer, UniverseArray* universes)
     {
         m_currentXYPositionChanged = false;
 
-        /* Scale XY coordinate values to 0.0 - 1.0 */
-        float x = SCALE(float(m_currentXYPosition.x()),
-                        float(0), float(width()), float(0), float(1));
-        float y = SCALE(float(m_currentXYPosition.y()),
-                        float(0), float(height()), float(0), float(1));
+        uchar* values = m_armedValues.data();
+        int count = 0;
+        for (int i = 0; i < m_armedFixtures.size(); i++)
+        {
+            count += m_armedFixtures.at(i).computeValues(m_currentX, m_currentY,
+                                                         values + count);
+        }
+        Q_ASSERT(count == m_armedAddresses.size());
 
-        /* Write values outside mutex lock to keep UI snappy */
-        m_currentXYPositionMutex.unlock();
-        foreach (VCXYPadFixture fixture, m_fixtures)
-            fixture.writeDMX(x, y, universes);
-    }
-    else
-    {
-        /* No changes in values, unlock and get out */
-        m_currentXYPositionMutex.unlock();
+        if (count > 0)
+        {
+            universes->writeBlock(m_armedAddresses.constData(), values,
+                                  m_armedGroups.constData(), count);
+        }
     }
+    m_currentXYPositionMutex.unlock();
 }
 
 /*****************************************************************************
@@ -201,6 +266,8 @@ void VCXYPad::slotModeChanged(Doc::Mode mode)
         it.setValue(fxi);
     }
 
+    resolveFixtures();
+
     if (mode == Doc::Operate)
         _app->masterTimer()->registerDMXSource(this);
     else
@@ -24,6 +24,7 @@
 
 #include <QWidget>
 #include <QPixmap>
+#include <QVector>
 #include <QString>
 #include <QMutex>
 #include <QList>
@@ -89,9 +90,28 @@ public:
         return m_fixtures;
     }
 
+protected:
+    /**
+     * Compile the armed fixtures' channels into the tables that writeDMX()
+     * uses, so that the timer thread needn't touch m_fixtures. Must be
+     * called whenever the fixtures are armed, disarmed or changed.
+     */
+    void resolveFixtures();
+
+protected slots:
+    /** Arms the fixtures again if one of them has been added/changed */
+    void slotFixtureChanged(quint32 fxi_id);
+
 protected:
     QList <VCXYPadFixture> m_fixtures;
 
+    /** Armed fixtures and their resolved channels. Guarded by
+        m_currentXYPositionMutex. */
+    QVector <VCXYPadFixture> m_armedFixtures;
+    QVector <int> m_armedAddresses;
+    QVector <QLCChannel::Group> m_armedGroups;
+    QVector <uchar> m_armedValues;
+
     /*********************************************************************
      * Current position
      *********************************************************************/
@@ -114,6 +134,11 @@ protected:
     bool m_currentXYPositionChanged;
     QMutex m_currentXYPositionMutex;
 
+    /** The current position scaled to 0.0 - 1.0 in the UI thread, since
+        the widget's size can't be read in writeDMX() */
+    double m_currentX;
+    double m_currentY;
+
     /*********************************************************************
      * QLC mode
      *********************************************************************/
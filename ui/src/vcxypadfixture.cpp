@@ -23,13 +23,13 @@
 #include <QVariant>
 #include <QString>
 #include <QtXml>
+#include <cmath>
 
 #include "qlcfixturemode.h"
 #include "qlcchannel.h"
 #include "qlcfile.h"
 
 #include "vcxypadfixture.h"
-#include "universearray.h"
 #include "fixture.h"
 #include "app.h"
 #include "doc.h"
@@ -232,12 +232,30 @@ void VCXYPadFixture::disarm()
     m_yMSB = QLCChannel::invalid();
 }
 
-void VCXYPadFixture::writeDMX(double xmul, double ymul, UniverseArray* universes)
+int VCXYPadFixture::resolveChannels(QVector <int>& addresses,
+                                    QVector <QLCChannel::Group>& groups) const
 {
-    Q_ASSERT(universes != NULL);
+    if (m_xMSB == QLCChannel::invalid() || m_yMSB == QLCChannel::invalid())
+        return 0;
+
+    addresses << int(m_xMSB) << int(m_yMSB);
+    groups << QLCChannel::Pan << QLCChannel::Tilt;
+
+    if (m_xLSB == QLCChannel::invalid() || m_yLSB == QLCChannel::invalid())
+        return 2;
+
+    addresses << int(m_xLSB) << int(m_yLSB);
+    groups << QLCChannel::Pan << QLCChannel::Tilt;
+
+    return 4;
+}
+
+int VCXYPadFixture::computeValues(double xmul, double ymul, uchar* values) const
+{
+    Q_ASSERT(values != NULL);
 
     if (m_xMSB == QLCChannel::invalid() || m_yMSB == QLCChannel::invalid())
-        return;
+        return 0;
 
     double xMSB = ((m_xMax - m_xMin) * xmul) + m_xMin;
     double yMSB = ((m_yMax - m_yMin) * ymul) + m_yMin;
@@ -247,18 +265,20 @@ void VCXYPadFixture::writeDMX(double xmul, double ymul, UniverseArray* universes
     if (m_yReverse == true)
         yMSB = m_yMax - yMSB;
 
-    universes->write(m_xMSB, char(xMSB * UCHAR_MAX), QLCChannel::Pan);
-    universes->write(m_yMSB, char(yMSB * UCHAR_MAX), QLCChannel::Tilt);
+    values[0] = uchar(char(xMSB * UCHAR_MAX));
+    values[1] = uchar(char(yMSB * UCHAR_MAX));
 
-    if (m_xLSB != QLCChannel::invalid() && m_yLSB != QLCChannel::invalid())
-    {
-        /* Leave only the fraction part from the value */
-        double xLSB = (xMSB * double(UCHAR_MAX)) - floor(xMSB * double(UCHAR_MAX));
-        double yLSB = (yMSB * double(UCHAR_MAX)) - floor(yMSB * double(UCHAR_MAX));
+    if (m_xLSB == QLCChannel::invalid() || m_yLSB == QLCChannel::invalid())
+        return 2;
 
-        universes->write(m_xLSB, char(xLSB * UCHAR_MAX), QLCChannel::Pan);
-        universes->write(m_yLSB, char(yLSB * UCHAR_MAX), QLCChannel::Tilt);
-    }
+    /* Leave only the fraction part from the value */
+    double xLSB = (xMSB * double(UCHAR_MAX)) - floor(xMSB * double(UCHAR_MAX));
+    double yLSB = (yMSB * double(UCHAR_MAX)) - floor(yMSB * double(UCHAR_MAX));
+
+    values[2] = uchar(char(xLSB * UCHAR_MAX));
+    values[3] = uchar(char(yLSB * UCHAR_MAX));
+
+    return 4;
 }
 
 /****************************************************************************
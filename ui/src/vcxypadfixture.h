@@ -24,12 +24,13 @@
 
 #include <QStringList>
 #include <QVariant>
+#include <QVector>
 #include <QString>
 
+#include "qlcchannel.h"
 #include "qlctypes.h"
 
 class VCXYPadFixture;
-class UniverseArray;
 class QDomDocument;
 class QDomElement;
 
@@ -78,8 +79,27 @@ public:
     void arm();
     void disarm();
 
-    /** Write the value using x & y multipliers for the actual range */
-    void writeDMX(double xmul, double ymul, UniverseArray* universes);
+    /**
+     * Append the armed fixture's pan & tilt channels to the given tables:
+     * X & Y MSB and, if the fixture has both, X & Y LSB.
+     *
+     * @param addresses DMX addresses to append to
+     * @param groups Channel groups to append to
+     * @return The number of channels appended (0, 2 or 4)
+     */
+    int resolveChannels(QVector <int>& addresses,
+                        QVector <QLCChannel::Group>& groups) const;
+
+    /**
+     * Calculate the values of the channels given by resolveChannels(),
+     * using x & y multipliers for the actual range.
+     *
+     * @param xmul X multiplier (0.0 - 1.0)
+     * @param ymul Y multiplier (0.0 - 1.0)
+     * @param values Array to put as many values as there are channels
+     * @return The number of values calculated
+     */
+    int computeValues(double xmul, double ymul, uchar* values) const;
 
 protected:
     quint32 m_fixture;
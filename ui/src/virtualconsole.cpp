@@ -110,8 +110,7 @@ VirtualConsole::VirtualConsole(QWidget* parent, Qt::WindowFlags flags)
             this, SLOT(slotRunningFunctionsChanged()));
     slotRunningFunctionsChanged();
 
-    connect(_app->inputMap(), SIGNAL(inputValueChanged(quint32,quint32,uchar)),
-            this, SLOT(slotInputValueChanged(quint32,quint32,uchar)));
+    refreshInputSource();
 
     connect(_app->outputMap(), SIGNAL(blackoutChanged(bool)),
             this, SLOT(slotBlackoutChanged(bool)));
@@ -134,6 +133,9 @@ VirtualConsole::~VirtualConsole()
     s_properties.store(parentWidget());
 #endif
 
+    if (_app != NULL && _app->inputMap() != NULL)
+        _app->inputMap()->removeListener(this);
+
     s_instance = NULL;
 }
 
@@ -920,6 +922,7 @@ void VirtualConsole::slotToolsSettings()
     {
         s_properties = vcpe.properties();
         m_dockArea->refreshProperties();
+        refreshInputSource();
         _app->doc()->setModified();
     }
 }
@@ -1404,6 +1407,7 @@ void VirtualConsole::resetContents()
     if (s_instance != NULL)
     {
         s_instance->dockArea()->refreshProperties();
+        s_instance->refreshInputSource();
         s_instance->initContents();
     }
 }
@@ -1475,6 +1479,19 @@ void VirtualConsole::keyReleaseEvent(QKeyEvent* event)
  * External input
  *****************************************************************************/
 
+void VirtualConsole::receiveInput(quint32 universe, quint32 channel,
+                                  uchar value)
+{
+    slotInputValueChanged(universe, channel, value);
+}
+
+void VirtualConsole::refreshInputSource()
+{
+    _app->inputMap()->removeListener(this);
+    _app->inputMap()->addListener(s_properties.blackoutInputUniverse(),
+                                  s_properties.blackoutInputChannel(), this);
+}
+
 void VirtualConsole::slotInputValueChanged(quint32 uni, quint32 ch, uchar value)
 {
     if (uni == s_properties.blackoutInputUniverse() &&
@@ -1637,7 +1654,10 @@ bool VirtualConsole::loadXML(const QDomElement* vc_root)
     /* Make the dock area update itself after loading its settings. The
        contents area is already updated. */
     if (s_instance != NULL)
+    {
         s_instance->dockArea()->refreshProperties();
+        s_instance->refreshInputSource();
+    }
 
     return retval;
 }
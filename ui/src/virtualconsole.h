@@ -27,6 +27,7 @@
 #include <QFrame>
 #include <QList>
 
+#include "inputlistener.h"
 #include "vcproperties.h"
 #include "app.h"
 
@@ -58,7 +59,7 @@ class QMenu;
 #define KFrameStyleRaised QFrame::StyledPanel | QFrame::Raised
 #define KFrameStyleNone   QFrame::NoFrame
 
-class VirtualConsole : public QWidget
+class VirtualConsole : public QWidget, public InputListener
 {
     Q_OBJECT
     Q_DISABLE_COPY(VirtualConsole)
@@ -370,6 +371,14 @@ signals:
     /*************************************************************************
      * External input
      *************************************************************************/
+public:
+    /** @reimp Passes routed input values to slotInputValueChanged() */
+    void receiveInput(quint32 universe, quint32 channel, uchar value);
+
+protected:
+    /** Listen to the current blackout input source */
+    void refreshInputSource();
+
 public slots:
     /** Listens to external input data */
     void slotInputValueChanged(quint32 uni, quint32 ch, uchar value);
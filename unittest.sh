@@ -43,6 +43,36 @@ if [ $RESULT != 0 ]; then
 fi
 popd
 
+#############################################################################
+# Art-Net & E1.31 output tests
+#############################################################################
+
+pushd .
+cd plugins/netdmxout/test
+DYLD_FALLBACK_LIBRARY_PATH=$DYLD_FALLBACK_LIBRARY_PATH:../src \
+	LD_LIBRARY_PATH=$LD_LIBRARY_PATH:../src ./test_netdmx
+RESULT=$?
+if [ $RESULT != 0 ]; then
+	echo "Art-Net & E1.31 output unit test failed ($RESULT). Please fix before commit."
+	exit $RESULT
+fi
+popd
+
+#############################################################################
+# Art-Net & E1.31 input tests
+#############################################################################
+
+pushd .
+cd plugins/netdmxinput/test
+DYLD_FALLBACK_LIBRARY_PATH=$DYLD_FALLBACK_LIBRARY_PATH:../src \
+	LD_LIBRARY_PATH=$LD_LIBRARY_PATH:../src ./test_netdmxinput
+RESULT=$?
+if [ $RESULT != 0 ]; then
+	echo "Art-Net & E1.31 input unit test failed ($RESULT). Please fix before commit."
+	exit $RESULT
+fi
+popd
+
 #############################################################################
 # MIDI Input tests
 #############################################################################
@@ -58,6 +88,20 @@ if [ $RESULT != 0 ]; then
 fi
 popd
 
+#############################################################################
+# MIDI Output tests
+#############################################################################
+
+pushd .
+cd plugins/midiout/common/test
+./test_midiout
+RESULT=$?
+if [ $RESULT != 0 ]; then
+    echo "MIDI Output unit test failed ($RESULT). Please fix before commit."
+    exit $RESULT
+fi
+popd
+
 #############################################################################
 # Final judgment
 #############################################################################